@@ -171,6 +171,8 @@ int main(int argc, char** argv) {
   unsigned int maxAMRlevels 	= root["mgsolver"].get("maxAMRlevels", 0).asInt();
   std::string  AMRnorm 	= root["mgsolver"].get("AMRnorm", "l2").asString();
   double       AMRthreshold 	= root["mgsolver"].get("AMRthreshold", "0.001").asDouble();
+  std::string  AMRestimator 	= root["mgsolver"].get("AMRestimator", "none").asString();
+  double       AMRtheta 	= root["mgsolver"].get("AMRtheta", 0.5).asDouble();
   unsigned int npresmoothing 	= root["mgsolver"].get("npresmoothing", 1).asUInt();
   unsigned int npostmoothing 	= root["mgsolver"].get("npostsmoothing", 1).asUInt();
   std::string smoother_type  	= root["mgsolver"].get("smoother_type", "gmres").asString();
@@ -361,6 +363,8 @@ int main(int argc, char** argv) {
 
         //system2.SetAMRSetOptions(AMR,AMRlevels,AMRnorm,AMRthreshold,SetRefinementFlag);
         system2.SetAMRSetOptions(AMR, maxAMRlevels, AMRnorm, AMRthreshold);
+        // the source is given through the parser, so only the recovery estimator can be used here
+        if(!strcmp("ZZ", AMRestimator.c_str())) system2.SetAMRErrorEstimator("ZZ", AMRtheta);
 
         //common smoother option
         //system2.SetSolverFineGrids(GMRES);
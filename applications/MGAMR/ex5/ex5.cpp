@@ -0,0 +1,379 @@
+/** MGAMR/ex5
+ * This example solves the Poisson problem
+ *                    $$ - \Delta u = 2 \pi^2 \sin(\pi x) \sin(\pi y) \text{ on } \Omega = [0,1]x[0,1], $$
+ *                    $$ u = 0 \text{ on } \Gamma, $$
+ * with exact solution u = \sin(\pi x) \sin(\pi y), with serendipity and biquadratic elements and a multigrid with a p-level:
+ * on the finest mesh the second order unknown is coarsened to the linear one (SetPMultigrid), then the h-levels are linear.
+ * For each mesh the problem is solved with the h-multigrid and with the hp-multigrid, with the same V-cycles and smoothers.
+ * The example checks that
+ * the hp-multigrid reaches the linear tolerance within the maximum number of V-cycles,
+ * the two solutions have the same error,
+ * the L2 error decreases with order 3.
+ **/
+
+#include "FemusInit.hpp"
+#include "MultiLevelSolution.hpp"
+#include "MultiLevelProblem.hpp"
+#include "NumericVector.hpp"
+#include "LinearImplicitSystem.hpp"
+
+#include <cmath>
+
+using namespace femus;
+
+bool SetBoundaryCondition(const std::vector < double >& x, const char solName[], double& value, const int faceName, const double time) {
+  bool dirichlet = true; //dirichlet
+  value = 0.;
+  return dirichlet;
+}
+
+double GetExactSolutionValue(const std::vector < double >& x) {
+  double pi = acos(-1.);
+  return sin(pi * x[0]) * sin(pi * x[1]);
+};
+
+double GetExactSolutionLaplace(const std::vector < double >& x) {
+  double pi = acos(-1.);
+  return -2. * pi * pi * sin(pi * x[0]) * sin(pi * x[1]);
+};
+
+void AssemblePoissonProblem(MultiLevelProblem& ml_prob);
+
+double GetErrorNormL2(MultiLevelSolution* mlSol);
+
+int main(int argc, char** args) {
+
+  // init Petsc-MPI communicator
+  FemusInit mpinit(argc, args, MPI_COMM_WORLD);
+
+  const unsigned numberOfMeshes = 3;
+  const unsigned numberOfOrders = 2;
+  FEOrder feOrder[numberOfOrders] = {SERENDIPITY, SECOND};
+  const char* feOrderName[numberOfOrders] = {"SERENDIPITY", "SECOND"};
+
+  const unsigned maxNumberOfVCycles = 30;
+  const double linearTolerance = 1.e-10;
+  const double expectedOrder = 3.;
+
+  // l2Norm[i][j][p]: mesh i, order j, h-multigrid (p = 0) or hp-multigrid (p = 1)
+  std::vector < std::vector < std::vector < double > > > l2Norm(numberOfMeshes);
+
+  bool passed = true;
+
+  for(unsigned i = 0; i < numberOfMeshes; i++) {   // loop on the mesh level
+
+    // define multilevel mesh: the coarse levels are kept, they are the h-levels of the multigrid
+    MultiLevelMesh mlMsh;
+    mlMsh.GenerateCoarseBoxMesh(2, 2, 0, 0., 1., 0., 1., 0., 0., QUAD9, "seventh");
+
+    unsigned numberOfUniformLevels = i + 2;
+    unsigned numberOfSelectiveLevels = 0;
+    mlMsh.RefineMesh(numberOfUniformLevels, numberOfUniformLevels + numberOfSelectiveLevels, NULL);
+    mlMsh.PrintInfo();
+
+    l2Norm[i].resize(numberOfOrders);
+
+    for(unsigned j = 0; j < numberOfOrders; j++) {   // loop on the FE Order
+      l2Norm[i][j].resize(2);
+
+      for(unsigned p = 0; p < 2; p++) {   // h-multigrid and hp-multigrid
+
+        // define the multilevel solution and attach the mlMsh object to it
+        MultiLevelSolution mlSol(&mlMsh);
+        mlSol.AddSolution("u", LAGRANGE, feOrder[j]);
+        mlSol.Initialize("All");
+
+        // attach the boundary condition function and generate boundary data
+        mlSol.AttachSetBoundaryConditionFunction(SetBoundaryCondition);
+        mlSol.GenerateBdc("u");
+
+        // define the multilevel problem attach the mlSol object to it
+        MultiLevelProblem mlProb(&mlSol);
+
+        LinearImplicitSystem& system = mlProb.add_system < LinearImplicitSystem > ("Poisson");
+        system.AddSolutionToSystemPDE("u");
+        system.SetAssembleFunction(AssemblePoissonProblem);
+
+        system.SetMaxNumberOfLinearIterations(maxNumberOfVCycles);
+        system.SetAbsoluteLinearConvergenceTolerance(linearTolerance);
+        system.SetMgType(V_CYCLE);
+        system.SetNumberPreSmoothingStep(1);
+        system.SetNumberPostSmoothingStep(1);
+        // the p-level has to be set before init
+        system.SetPMultigrid(p == 1);
+
+        system.init();
+
+        system.SetSolverFineGrids(GMRES);
+        system.SetPreconditionerFineGrids(ILU_PRECOND);
+        system.SetTolerances(1.e-20, 1.e-20, 1.e+50, 40);
+
+        system.SetOuterSolver(PREONLY);
+        system.MGsolve();
+
+        // the residual of the last V-cycle is stored in _Res of the finest level
+        unsigned finestLevel = mlMsh.GetNumberOfLevels() - 1u;
+        double residual = mlSol.GetSolutionLevel(finestLevel)->_Res[mlSol.GetIndex("u")]->l2_norm();
+        if(p == 1 && !(residual < linearTolerance)) {
+          std::cout << "Error in MGAMR/ex5: the hp-multigrid did not converge in " << maxNumberOfVCycles << " V-cycles for "
+                    << feOrderName[j] << " on mesh " << i + 1 << ", residual = " << residual << std::endl;
+          passed = false;
+        }
+
+        l2Norm[i][j][p] = GetErrorNormL2(&mlSol);
+      }
+
+      // both multigrids solve the same discrete problem
+      if(fabs(l2Norm[i][j][1] - l2Norm[i][j][0]) > 1.e-2 * l2Norm[i][j][0]) {
+        std::cout << "Error in MGAMR/ex5: the h and hp-multigrid errors differ for " << feOrderName[j] << " on mesh " << i + 1 << std::endl;
+        passed = false;
+      }
+    }
+  }
+
+  // print the l2 error of the hp-multigrid solution and the order of convergence between different levels
+  std::cout << std::endl;
+  std::cout << "l2 ERROR and ORDER OF CONVERGENCE of the hp-multigrid solution:\n\n";
+  std::cout << "LEVEL\tSERENDIPITY\t\tSECOND\n";
+
+  for(unsigned i = 0; i < numberOfMeshes; i++) {
+    std::cout << i + 2 << "\t";
+    std::cout.precision(14);
+
+    for(unsigned j = 0; j < numberOfOrders; j++) {
+      std::cout << l2Norm[i][j][1] << "\t";
+    }
+
+    std::cout << std::endl;
+
+    if(i < numberOfMeshes - 1) {
+      std::cout.precision(3);
+      std::cout << "\t\t";
+
+      for(unsigned j = 0; j < numberOfOrders; j++) {
+        double order = log(l2Norm[i][j][1] / l2Norm[i + 1][j][1]) / log(2.);
+        std::cout << order << "\t\t\t";
+        if(i == numberOfMeshes - 2 && order < 0.9 * expectedOrder) {
+          passed = false;
+        }
+      }
+
+      std::cout << std::endl;
+    }
+  }
+
+  if(!passed) {
+    std::cout << "Error in MGAMR/ex5: the p-multigrid check failed" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+/**
+ * This function assemble the stiffnes matrix KK and the residual vector RES
+ * such that
+ *                  KK w = RES = F - KK u0,
+ * and consequently
+ *        u = u0 + w satisfies KK u = F.
+ * It is called only on the finest level, with the V-cycle the coarse operators are Galerkin
+ **/
+void AssemblePoissonProblem(MultiLevelProblem& ml_prob) {
+
+  LinearImplicitSystem* mlPdeSys  = &ml_prob.get_system<LinearImplicitSystem> ("Poisson");   // pointer to the linear implicit system named "Poisson"
+  const unsigned level = mlPdeSys->GetLevelToAssemble();
+
+  Mesh*                    msh = ml_prob._ml_msh->GetLevel(level);    // pointer to the mesh (level) object
+  MultiLevelSolution*    mlSol = ml_prob._ml_sol;  // pointer to the multilevel solution object
+  Solution*                sol = ml_prob._ml_sol->GetSolutionLevel(level);    // pointer to the solution (level) object
+
+  LinearEquationSolver* pdeSys = mlPdeSys->_LinSolver[level]; // pointer to the equation (level) object
+  SparseMatrix*             KK = pdeSys->_KK;  // pointer to the global stifness matrix object in pdeSys (level)
+  NumericVector*           RES = pdeSys->_RES; // pointer to the global residual vector object in pdeSys (level)
+
+  const unsigned  dim = msh->GetDimension(); // get the domain dimension of the problem
+  const unsigned maxSize = static_cast< unsigned >(ceil(pow(3, dim)));  // conservative: based on line3, quad9, hex27
+
+  unsigned    iproc = msh->processor_id(); // get the process_id (for parallel computation)
+
+  unsigned soluIndex = mlSol->GetIndex("u");    // get the position of "u" in the ml_sol object
+  unsigned soluType = mlSol->GetSolutionType(soluIndex);    // get the finite element type for "u"
+  unsigned soluPdeIndex = mlPdeSys->GetSolPdeIndex("u");    // get the position of "u" in the pdeSys object
+
+  std::vector < double >  solu; // local solution
+  solu.reserve(maxSize);
+
+  std::vector < std::vector < double > > x(dim);    // local coordinates
+  unsigned xType = 2; // get the finite element type for "x", it is always 2 (LAGRANGE BI/TRIQUADRATIC)
+  for(unsigned k = 0; k < dim; k++) {
+    x[k].reserve(maxSize);
+  }
+
+  std::vector < double > phi;  // local test function
+  std::vector < double > phi_x; // local test function first order partial derivatives
+  double weight; // gauss point weight
+
+  phi.reserve(maxSize);
+  phi_x.reserve(maxSize * dim);
+
+  std::vector < double > Res; // local redidual vector
+  Res.reserve(maxSize);
+
+  std::vector < double > Jac; //local Jacobian matrix
+  Jac.reserve(maxSize * maxSize);
+
+  std::vector < int > l2GMap; // local to global mapping
+  l2GMap.reserve(maxSize);
+
+  KK->zero(); // Set to zero all the entries of the Global Matrix
+  RES->zero(); // Set to zero all the entries of the Global Residual Vector
+
+  // element loop: each process loops only on the elements that owns
+  for(int iel = msh->_elementOffset[iproc]; iel < msh->_elementOffset[iproc + 1]; iel++) {
+
+    short unsigned ielGeom = msh->GetElementType(iel);
+    unsigned nDofu  = msh->GetElementDofNumber(iel, soluType);    // number of solution element dofs
+    unsigned nDofx = msh->GetElementDofNumber(iel, xType);    // number of coordinate element dofs
+
+    solu.resize(nDofu);
+    l2GMap.resize(nDofu);
+    for(int k = 0; k < dim; k++) {
+      x[k].resize(nDofx);
+    }
+
+    Res.assign(nDofu, 0.);    //resize and set to zero
+    Jac.assign(nDofu * nDofu, 0.);    //resize and set to zero
+
+    // local storage of global mapping and solution
+    for(unsigned i = 0; i < nDofu; i++) {
+      unsigned solDof = msh->GetSolutionDof(i, iel, soluType);    // local to global solution mapping
+      solu[i] = (*sol->_Sol[soluIndex])(solDof);      // local storage of solution
+      l2GMap[i] = pdeSys->GetSystemDof(soluIndex, soluPdeIndex, i, iel);   // local to global system solution mapping
+    }
+
+    // local storage of coordinates
+    for(unsigned i = 0; i < nDofx; i++) {
+      unsigned xDof  = msh->GetSolutionDof(i, iel, xType);    // local to global mapping between coordinates node and coordinate dof
+      for(unsigned k = 0; k < dim; k++) {
+        x[k][i] = (*msh->_topology->_Sol[k])(xDof);      // global extraction and local storage for the element coordinates
+      }
+    }
+
+    // *** Gauss point loop ***
+    for(unsigned ig = 0; ig < msh->_finiteElement[ielGeom][soluType]->GetGaussPointNumber(); ig++) {
+      // *** get gauss point weight, test function and test function partial derivatives ***
+      msh->_finiteElement[ielGeom][soluType]->Jacobian(x, ig, weight, phi, phi_x);
+
+      // evaluate the solution gradient and the coordinates in the gauss point
+      std::vector < double > gradSolu_gss(dim, 0.);
+      std::vector < double > x_gss(dim, 0.);
+      for(unsigned i = 0; i < nDofu; i++) {
+        for(unsigned k = 0; k < dim; k++) {
+          gradSolu_gss[k] += phi_x[i * dim + k] * solu[i];
+          x_gss[k] += x[k][i] * phi[i];
+        }
+      }
+
+      // *** phi_i loop ***
+      for(unsigned i = 0; i < nDofu; i++) {
+
+        double laplace = 0.;
+        for(unsigned k = 0; k < dim; k++) {
+          laplace += phi_x[i * dim + k] * gradSolu_gss[k];
+        }
+
+        Res[i] += (- GetExactSolutionLaplace(x_gss) * phi[i] - laplace) * weight;
+
+        // *** phi_j loop ***
+        for(unsigned j = 0; j < nDofu; j++) {
+          double laplacej = 0.;
+          for(unsigned k = 0; k < dim; k++) {
+            laplacej += phi_x[i * dim + k] * phi_x[j * dim + k];
+          }
+          Jac[i * nDofu + j] += laplacej * weight;
+        } // end phi_j loop
+      } // end phi_i loop
+    } // end gauss point loop
+
+    // Add the local Matrix/Vector into the global Matrix/Vector
+    RES->add_vector_blocked(Res, l2GMap);
+    KK->add_matrix_blocked(Jac, l2GMap, l2GMap);
+
+  } //end element loop for each process
+
+  RES->close();
+  KK->close();
+}
+
+
+double GetErrorNormL2(MultiLevelSolution* mlSol) {
+
+  unsigned level = mlSol->_mlMesh->GetNumberOfLevels() - 1u;
+
+  Mesh*     msh = mlSol->_mlMesh->GetLevel(level);    // pointer to the mesh (level) object
+  Solution* sol = mlSol->GetSolutionLevel(level);    // pointer to the solution (level) object
+
+  const unsigned  dim = msh->GetDimension(); // get the domain dimension of the problem
+  unsigned iproc = msh->processor_id(); // get the process_id (for parallel computation)
+
+  unsigned soluIndex = mlSol->GetIndex("u");    // get the position of "u" in the ml_sol object
+  unsigned soluType = mlSol->GetSolutionType(soluIndex);    // get the finite element type for "u"
+
+  std::vector < double >  solu; // local solution
+  std::vector < std::vector < double > > x(dim);    // local coordinates
+  unsigned xType = 2; // get the finite element type for "x", it is always 2 (LAGRANGE QUADRATIC)
+
+  std::vector < double > phi;  // local test function
+  std::vector < double > phi_x; // local test function first order partial derivatives
+  double weight; // gauss point weight
+
+  double l2norm = 0.;
+
+  // element loop: each process loops only on the elements that owns
+  for(int iel = msh->_elementOffset[iproc]; iel < msh->_elementOffset[iproc + 1]; iel++) {
+
+    short unsigned ielGeom = msh->GetElementType(iel);
+    unsigned nDofu  = msh->GetElementDofNumber(iel, soluType);    // number of solution element dofs
+    unsigned nDofx = msh->GetElementDofNumber(iel, xType);    // number of coordinate element dofs
+
+    solu.resize(nDofu);
+    for(int k = 0; k < dim; k++) {
+      x[k].resize(nDofx);
+    }
+
+    for(unsigned i = 0; i < nDofu; i++) {
+      unsigned solDof = msh->GetSolutionDof(i, iel, soluType);    // global to global mapping between solution node and solution dof
+      solu[i] = (*sol->_Sol[soluIndex])(solDof);      // global extraction and local storage for the solution
+    }
+
+    for(unsigned i = 0; i < nDofx; i++) {
+      unsigned xDof  = msh->GetSolutionDof(i, iel, xType);    // global to global mapping between coordinates node and coordinate dof
+      for(unsigned k = 0; k < dim; k++) {
+        x[k][i] = (*msh->_topology->_Sol[k])(xDof);  // global extraction and local storage for the element coordinates
+      }
+    }
+
+    // *** Gauss point loop ***
+    for(unsigned ig = 0; ig < msh->_finiteElement[ielGeom][soluType]->GetGaussPointNumber(); ig++) {
+      msh->_finiteElement[ielGeom][soluType]->Jacobian(x, ig, weight, phi, phi_x);
+
+      double solu_gss = 0.;
+      std::vector < double > x_gss(dim, 0.);
+      for(unsigned i = 0; i < nDofu; i++) {
+        solu_gss += phi[i] * solu[i];
+        for(unsigned k = 0; k < dim; k++) {
+          x_gss[k] += x[k][i] * phi[i];
+        }
+      }
+
+      double exactSol = GetExactSolutionValue(x_gss);
+      l2norm += (exactSol - solu_gss) * (exactSol - solu_gss) * weight;
+    } // end gauss point loop
+  } //end element loop for each process
+
+  // add the norms of all processes
+  double l2normAll;
+  MPI_Allreduce(&l2norm, &l2normAll, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+  return sqrt(l2normAll);
+}
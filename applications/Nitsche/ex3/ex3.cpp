@@ -27,12 +27,16 @@
 #include "Solid.hpp"
 #include "Parameter.hpp"
 
+#include "../include/cutElementCache.hpp"
+
 using namespace femus;
 
 Line* line1;
 Line* line2;
 Line* lineI;
 
+CutElementCache cutElementCache;
+
 unsigned DIM = 2;
 
 void AssembleNitscheProblem_AD(MultiLevelProblem& mlProb);
@@ -301,7 +305,8 @@ int main(int argc, char** args) {
   GetInterfaceElementEigenvalues(mlSol);
 
   system.MGsolve();
-  
+
+  cutElementCache.PrintInfo();
   
   mlSol.GetWriter()->Write("./output", "linear", print_vars, 0);
 
@@ -587,14 +592,17 @@ void AssembleNitscheProblem_AD(MultiLevelProblem& ml_prob) {
 
 
 
-      //bulk1
-      while(imarker1 < markerOffset1[iproc + 1] && iel == particle1[imarker1]->GetMarkerElement()) {
+      CutElement& cutElement = cutElementCache.GetElement(level, iel, msh, solDType, x,
+                                                          particle1, markerOffset1, imarker1,
+                                                          particle2, markerOffset2, imarker2,
+                                                          particleI, markerOffsetI, imarkerI);
 
-        // the local coordinates of the particles are the Gauss points in this context
-        std::vector <double> xi = particle1[imarker1]->GetMarkerLocalCoordinates();
-        msh->_finiteElement[ielGeom][solDType]->Jacobian(x, xi, weight, phi, phi_x);
-        double weight = particle1[imarker1]->GetMarkerMass();
+      //bulk1
+      for(unsigned iq = 0; iq < cutElement.bulk[0].size(); iq++) {
 
+        const std::vector <double> &phi = cutElement.bulk[0][iq].phi;
+        const std::vector <double> &phi_x = cutElement.bulk[0][iq].phi_x;
+        double weight = cutElement.bulk[0][iq].weight;
 
         // evaluate the solution, the solution derivatives and the coordinates in the gauss point
         std::vector < std::vector < adept::adouble > > gradSolD1(dim);
@@ -627,16 +635,14 @@ void AssembleNitscheProblem_AD(MultiLevelProblem& ml_prob) {
             aResD1[k][i] += (- rho1 * g[k] * phi[i] + sigma1) * weight;
           }
         } // end phi_i loop
-        imarker1++;
       }
 
       //bulk2
-      while(imarker2 < markerOffset2[iproc + 1] && iel == particle2[imarker2]->GetMarkerElement()) {
+      for(unsigned iq = 0; iq < cutElement.bulk[1].size(); iq++) {
 
-        // the local coordinates of the particles are the Gauss points in this context
-        std::vector <double> xi = particle2[imarker2]->GetMarkerLocalCoordinates();
-        msh->_finiteElement[ielGeom][solDType]->Jacobian(x, xi, weight, phi, phi_x);
-        double weight = particle2[imarker2]->GetMarkerMass();
+        const std::vector <double> &phi = cutElement.bulk[1][iq].phi;
+        const std::vector <double> &phi_x = cutElement.bulk[1][iq].phi_x;
+        double weight = cutElement.bulk[1][iq].weight;
 
         std::vector < std::vector < adept::adouble > > gradSolD2(dim);
 
@@ -667,37 +673,15 @@ void AssembleNitscheProblem_AD(MultiLevelProblem& ml_prob) {
             aResD2[k][i] += (- rho2 * g[k] * phi[i] + sigma2) * weight;
           }
         }
-        imarker2++;
       }
 
       // interface
-      while(imarkerI < markerOffsetI[iproc + 1] && iel == particleI[imarkerI]->GetMarkerElement()) {
-
-        // the local coordinates of the particles are the Gauss points in this context
-        std::vector <double> xi = particleI[imarkerI]->GetMarkerLocalCoordinates();
-        msh->_finiteElement[ielGeom][solDType]->Jacobian(x, xi, weight, phi, phi_x);
-
-        std::vector <std::vector < double > > T;
-        particleI[imarkerI]->GetMarkerTangent(T);
-
-        double weight;
-        std::vector < double > N(dim);
-        if(dim == 2) {
-          N[0] =  T[0][1];
-          N[1] = -T[0][0];
-          weight = sqrt(N[0] * N[0] + N[1] * N[1]);
-          N[0] /= weight;
-          N[1] /= weight;
-        }
-        else {
-          N[0] = T[0][1] * T[1][2] - T[0][2] * T[1][1];
-          N[1] = T[0][2] * T[1][0] - T[0][0] * T[1][2];
-          N[2] = T[0][0] * T[1][1] - T[0][1] * T[1][0];
-          weight = sqrt(N[0] * N[0] + N[1] * N[1] + N[2] * N[2]);
-          N[0] /= weight;
-          N[1] /= weight;
-          N[2] /= weight;
-        }
+      for(unsigned iq = 0; iq < cutElement.interface.size(); iq++) {
+
+        const std::vector <double> &phi = cutElement.interface[iq].phi;
+        const std::vector <double> &phi_x = cutElement.interface[iq].phi_x;
+        const std::vector <double> &N = cutElement.interface[iq].N;
+        double weight = cutElement.interface[iq].weight;
 
         std::vector < adept::adouble > u1(dim, 0.);
         std::vector < adept::adouble > u2(dim, 0.);
@@ -748,7 +732,6 @@ void AssembleNitscheProblem_AD(MultiLevelProblem& ml_prob) {
 
           }
         } // end phi_i loop
-        imarkerI++;
       }
 
     }
@@ -950,7 +933,6 @@ void GetInterfaceElementEigenvalues(MultiLevelSolution& mlSol) {
     unsigned eFlag = static_cast <unsigned>(floor((*sol->_Sol[eflagIndex])(iel) + 0.5));
     if(eFlag == 1) {
 
-      short unsigned ielGeom = msh->GetElementType(iel);
       unsigned nDofu  = msh->GetElementDofNumber(iel, soluType);  // number of solution element dofs
 
       unsigned sizeAll = dim * nDofu;
@@ -974,13 +956,25 @@ void GetInterfaceElementEigenvalues(MultiLevelSolution& mlSol) {
         }
       }
 
+      CutElement& cutElement = cutElementCache.GetElement(level, iel, msh, soluType, x,
+                                                          particle1, markerOffset1, imarker1,
+                                                          particle2, markerOffset2, imarker2,
+                                                          particleI, markerOffsetI, imarkerI);
+
+      // the interface markers did not move: reuse the eigenvalues
+      if(cutElement.eigenvaluesAreValid) {
+        for(unsigned s = 0; s < 2; s++) {
+          sol->_Sol[CMIndex[s]]->set(iel, cutElement.CM[s]);
+          sol->_Sol[CLIndex[s]]->set(iel, cutElement.CL[s]);
+        }
+        continue;
+      }
+
       //bulk1
-      while(imarker1 < markerOffset1[iproc + 1] && iel == particle1[imarker1]->GetMarkerElement()) {
+      for(unsigned iq = 0; iq < cutElement.bulk[0].size(); iq++) {
 
-        // the local coordinates of the particles are the Gauss points in this context
-        std::vector <double> xi = particle1[imarker1]->GetMarkerLocalCoordinates();
-        msh->_finiteElement[ielGeom][soluType]->Jacobian(x, xi, weight, phi, phi_x);
-        double weight = particle1[imarker1]->GetMarkerMass();
+        const std::vector <double> &phi_x = cutElement.bulk[0][iq].phi_x;
+        double weight = cutElement.bulk[0][iq].weight;
 
         // *** phi_i loop ***
 
@@ -997,16 +991,13 @@ void GetInterfaceElementEigenvalues(MultiLevelSolution& mlSol) {
             }
           }
         }
-        imarker1++;
       }
 
       //bulk2
-      while(imarker2 < markerOffset2[iproc + 1] && iel == particle2[imarker2]->GetMarkerElement()) {
+      for(unsigned iq = 0; iq < cutElement.bulk[1].size(); iq++) {
 
-        // the local coordinates of the particles are the Gauss points in this context
-        std::vector <double> xi = particle2[imarker2]->GetMarkerLocalCoordinates();
-        msh->_finiteElement[ielGeom][soluType]->Jacobian(x, xi, weight, phi, phi_x);
-        double weight = particle2[imarker2]->GetMarkerMass();
+        const std::vector <double> &phi_x = cutElement.bulk[1][iq].phi_x;
+        double weight = cutElement.bulk[1][iq].weight;
 
         // *** phi_i loop ***
 
@@ -1022,37 +1013,14 @@ void GetInterfaceElementEigenvalues(MultiLevelSolution& mlSol) {
             }
           }
         }
-        imarker2++;
       }
 
       // interface
-      while(imarkerI < markerOffsetI[iproc + 1] && iel == particleI[imarkerI]->GetMarkerElement()) {
-
-        // the local coordinates of the particles are the Gauss points in this context
-        std::vector <double> xi = particleI[imarkerI]->GetMarkerLocalCoordinates();
-        msh->_finiteElement[ielGeom][soluType]->Jacobian(x, xi, weight, phi, phi_x);
-
-        std::vector <std::vector < double > > T;
-        particleI[imarkerI]->GetMarkerTangent(T);
-
-        double weight;
-        std::vector < double > N(dim);
-        if(dim == 2) {
-          N[0] =  T[0][1];
-          N[1] = -T[0][0];
-          weight = sqrt(N[0] * N[0] + N[1] * N[1]);
-          N[0] /= weight;
-          N[1] /= weight;
-        }
-        else {
-          N[0] = T[0][1] * T[1][2] - T[0][2] * T[1][1];
-          N[1] = T[0][2] * T[1][0] - T[0][0] * T[1][2];
-          N[2] = T[0][0] * T[1][1] - T[0][1] * T[1][0];
-          weight = sqrt(N[0] * N[0] + N[1] * N[1] + N[2] * N[2]);
-          N[0] /= weight;
-          N[1] /= weight;
-          N[2] /= weight;
-        }
+      for(unsigned iq = 0; iq < cutElement.interface.size(); iq++) {
+
+        const std::vector <double> &phi_x = cutElement.interface[iq].phi_x;
+        const std::vector <double> &N = cutElement.interface[iq].N;
+        double weight = cutElement.interface[iq].weight;
 
         // *** phi_i loop ***
 
@@ -1082,7 +1050,6 @@ void GetInterfaceElementEigenvalues(MultiLevelSolution& mlSol) {
             }
           } // end phi_i loop
         }
-        imarkerI++;
       }
 
       unsigned sizeAll0 = sizeAll;
@@ -1213,6 +1180,7 @@ void GetInterfaceElementEigenvalues(MultiLevelSolution& mlSol) {
         std::cout << real << " " << std::endl;
 
         sol->_Sol[CMIndex[s]]->set(iel, real);
+        cutElement.CM[s] = real;
 
         EPSDestroy(&eps);
         MatDestroy(&A);
@@ -1344,12 +1312,14 @@ void GetInterfaceElementEigenvalues(MultiLevelSolution& mlSol) {
         std::cout << real << " " << std::endl;
 
         sol->_Sol[CLIndex[s]]->set(iel, real);
+        cutElement.CL[s] = real;
 
         EPSDestroy(&eps);
         MatDestroy(&A);
         MatDestroy(&B);
 
       }
+      cutElement.eigenvaluesAreValid = true;
     }
   }
 
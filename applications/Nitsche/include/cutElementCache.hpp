@@ -0,0 +1,179 @@
+#ifndef __femus_include_cutElementCache_hpp__
+#define __femus_include_cutElementCache_hpp__
+
+#include "MultiLevelSolution.hpp"
+#include "Marker.hpp"
+#include "Line.hpp"
+
+#include <map>
+
+// Cache of the cut-cell quadrature of the interface elements, used by the Nitsche assembly and by the eigenvalue
+// problems of the stabilization parameters. The bulk points are the markers of the two bodies and the interface points
+// are the markers of the interface line. An element is recomputed only when its state, i.e. the element coordinates
+// and the data of the markers it contains, changes; otherwise phi, phi_x, the weights and the normals are reused,
+// together with the eigenvalues CM1, CM2, CL1, CL2.
+
+using namespace femus;
+
+struct CutQuadraturePoint {
+  double weight;
+  std::vector < double > phi;
+  std::vector < double > phi_x;
+  std::vector < double > N; // unit normal, only for the interface points
+};
+
+struct CutElement {
+  std::vector < double > state;
+  std::vector < CutQuadraturePoint > bulk[2];
+  std::vector < CutQuadraturePoint > interface;
+  bool eigenvaluesAreValid;
+  double CM[2];
+  double CL[2];
+};
+
+class CutElementCache {
+  public:
+
+    CutElementCache() : _hits(0), _updates(0) {};
+
+    /// Return the cut quadrature of the interface element iel at the given level, computing it only if its state changed.
+    /// The marker cursors imarker1, imarker2 and imarkerI are moved past the markers of iel, as in the assembly loops
+    CutElement& GetElement(const unsigned &level, const unsigned &iel, Mesh* msh, const unsigned &solType,
+                           const std::vector < std::vector <double> > &x,
+                           std::vector < Marker* > &particle1, const std::vector < unsigned > &markerOffset1, unsigned &imarker1,
+                           std::vector < Marker* > &particle2, const std::vector < unsigned > &markerOffset2, unsigned &imarker2,
+                           std::vector < Marker* > &particleI, const std::vector < unsigned > &markerOffsetI, unsigned &imarkerI) {
+
+      unsigned iproc = msh->processor_id();
+      const unsigned dim = msh->GetDimension();
+
+      if(_elements.size() <= level) _elements.resize(level + 1);
+
+      // BEGIN build the state of the element
+      _state.resize(0);
+      for(unsigned k = 0; k < dim; k++) {
+        _state.insert(_state.end(), x[k].begin(), x[k].end());
+      }
+
+      unsigned jmarker1 = imarker1;
+      while(jmarker1 < markerOffset1[iproc + 1] && iel == particle1[jmarker1]->GetMarkerElement()) {
+        particle1[jmarker1]->GetMarkerLocalCoordinates(_xi);
+        _state.insert(_state.end(), _xi.begin(), _xi.end());
+        _state.push_back(particle1[jmarker1]->GetMarkerMass());
+        jmarker1++;
+      }
+      _state.push_back(-1.); // separator, the number of markers of each group can change
+
+      unsigned jmarker2 = imarker2;
+      while(jmarker2 < markerOffset2[iproc + 1] && iel == particle2[jmarker2]->GetMarkerElement()) {
+        particle2[jmarker2]->GetMarkerLocalCoordinates(_xi);
+        _state.insert(_state.end(), _xi.begin(), _xi.end());
+        _state.push_back(particle2[jmarker2]->GetMarkerMass());
+        jmarker2++;
+      }
+      _state.push_back(-1.);
+
+      unsigned jmarkerI = imarkerI;
+      while(jmarkerI < markerOffsetI[iproc + 1] && iel == particleI[jmarkerI]->GetMarkerElement()) {
+        particleI[jmarkerI]->GetMarkerLocalCoordinates(_xi);
+        _state.insert(_state.end(), _xi.begin(), _xi.end());
+        particleI[jmarkerI]->GetMarkerTangent(_T);
+        for(unsigned l = 0; l < _T.size(); l++) {
+          _state.insert(_state.end(), _T[l].begin(), _T[l].end());
+        }
+        jmarkerI++;
+      }
+      // END build the state of the element
+
+      CutElement& cutElement = _elements[level][iel];
+
+      if(cutElement.state == _state) {
+        _hits++;
+      }
+      else {
+        _updates++;
+        cutElement.state.swap(_state);
+        cutElement.eigenvaluesAreValid = false;
+
+        short unsigned ielGeom = msh->GetElementType(iel);
+        double weight;
+
+        std::vector < Marker* > *particle[2] = {&particle1, &particle2};
+        unsigned imarker[2] = {imarker1, imarker2};
+        unsigned jmarker[2] = {jmarker1, jmarker2};
+
+        for(unsigned s = 0; s < 2; s++) {
+          cutElement.bulk[s].resize(jmarker[s] - imarker[s]);
+          for(unsigned im = imarker[s]; im < jmarker[s]; im++) {
+            CutQuadraturePoint &qp = cutElement.bulk[s][im - imarker[s]];
+            // the local coordinates of the particles are the Gauss points in this context
+            (*particle[s])[im]->GetMarkerLocalCoordinates(_xi);
+            msh->_finiteElement[ielGeom][solType]->Jacobian(x, _xi, weight, qp.phi, qp.phi_x);
+            qp.weight = (*particle[s])[im]->GetMarkerMass();
+          }
+        }
+
+        cutElement.interface.resize(jmarkerI - imarkerI);
+        for(unsigned im = imarkerI; im < jmarkerI; im++) {
+          CutQuadraturePoint &qp = cutElement.interface[im - imarkerI];
+          particleI[im]->GetMarkerLocalCoordinates(_xi);
+          msh->_finiteElement[ielGeom][solType]->Jacobian(x, _xi, weight, qp.phi, qp.phi_x);
+
+          particleI[im]->GetMarkerTangent(_T);
+
+          std::vector < double > &N = qp.N;
+          N.resize(dim);
+          if(dim == 2) {
+            N[0] =  _T[0][1];
+            N[1] = -_T[0][0];
+          }
+          else {
+            N[0] = _T[0][1] * _T[1][2] - _T[0][2] * _T[1][1];
+            N[1] = _T[0][2] * _T[1][0] - _T[0][0] * _T[1][2];
+            N[2] = _T[0][0] * _T[1][1] - _T[0][1] * _T[1][0];
+          }
+          qp.weight = 0.;
+          for(unsigned k = 0; k < dim; k++) qp.weight += N[k] * N[k];
+          qp.weight = sqrt(qp.weight);
+          for(unsigned k = 0; k < dim; k++) N[k] /= qp.weight;
+        }
+      }
+
+      imarker1 = jmarker1;
+      imarker2 = jmarker2;
+      imarkerI = jmarkerI;
+
+      return cutElement;
+    }
+
+    /// Remove all the stored elements, e.g. after a change of the mesh or of the partition
+    void Clear() {
+      _elements.clear();
+      _hits = 0;
+      _updates = 0;
+    }
+
+    /// Print, on process 0, the element updates and the reused elements summed over the processes
+    void PrintInfo() const {
+      unsigned local[2] = {_updates, _hits};
+      unsigned global[2];
+      MPI_Reduce(local, global, 2, MPI_UNSIGNED, MPI_SUM, 0, MPI_COMM_WORLD);
+      int iproc;
+      MPI_Comm_rank(MPI_COMM_WORLD, &iproc);
+      if(iproc == 0) {
+        std::cout << "CutElementCache: " << global[0] << " element updates, " << global[1] << " reused elements" << std::endl;
+      }
+    }
+
+  private:
+
+    std::vector < std::map < unsigned, CutElement > > _elements;
+    unsigned _hits;
+    unsigned _updates;
+
+    std::vector < double > _state;
+    std::vector < double > _xi;
+    std::vector < std::vector < double > > _T;
+};
+
+#endif
@@ -21,6 +21,7 @@
 #include "paral.hpp"//to get iproc HAVE_MPI is inside here
 
 #include "Assemble_jacobian.hpp"
+#include "KKTFieldSplitTree.hpp"
 
 #include "ElemType.hpp"
 
@@ -40,6 +41,7 @@
 #define exact_sol_flag 0 // 1 = if we want to use manufactured solution; 0 = if we use regular convention
 #define compute_conv_flag 0 // 1 = if we want to compute the convergence and error ; 0 =  no error computation
 #define no_of_ref 2     //mesh refinements
+#define kkt_block_flag 0 // 1 = MG with the KKT Schur block preconditioner as smoother ; 0 = direct solver on the monolithic system
 
 #define NO_OF_L2_NORMS 11   //U,V,P,UADJ,VADJ,PADJ,UCTRL,VCTRL,PCTRL,U+U0,V+V0
 #define NO_OF_H1_NORMS 8    //U,V,UADJ,VADJ,UCTRL,VCTRL,U+U0,V+V0
@@ -332,12 +334,45 @@ int main(int argc, char** args) {
   // attach the assembling function to system
 //   system_opt.SetAssembleFunction(AssembleNavierStokesOpt_AD);
   system_opt.SetAssembleFunction(AssembleNavierStokesOpt_nonAD);
+
+#if kkt_block_flag == 1
+  // state, adjoint and control blocks of the KKT system
+  const char* stateName[]   = {"U", "V", "W", "P"};
+  const char* adjointName[] = {"UADJ", "VADJ", "WADJ", "PADJ"};
+  const char* controlName[] = {"UCTRL", "VCTRL", "WCTRL", "PCTRL"};
+  std::vector < unsigned > stateField, stateType, adjointField, adjointType, controlField, controlType;
+  for (unsigned k = 0; k < 4; k++) {
+    if (dim == 2 && k == 2) continue;
+    stateField.push_back(system_opt.GetSolPdeIndex(stateName[k]));
+    stateType.push_back(mlSol.GetSolutionType(stateName[k]));
+    adjointField.push_back(system_opt.GetSolPdeIndex(adjointName[k]));
+    adjointType.push_back(mlSol.GetSolutionType(adjointName[k]));
+    controlField.push_back(system_opt.GetSolPdeIndex(controlName[k]));
+    controlType.push_back(mlSol.GetSolutionType(controlName[k]));
+  }
+  KKTFieldSplitTree kkt(KKT_SCHUR, stateField, stateType, adjointField, adjointType, controlField, controlType);
+  // control Schur complement ~ lumped control mass: tracking plus control cost on the control velocity, 1 / beta on the control pressure
+  std::vector < double > controlMassScaling(controlField.size(), cost_functional_coeff + alpha);
+  controlMassScaling.back() = (beta > 0.) ? 1. / beta : 1.;
+  kkt.SetControlMassScaling(controlMassScaling);
+  kkt.PrintFieldSplitTree();
+
+  system_opt.SetLinearEquationSolverType(FEMuS_FIELDSPLIT);
+#endif
     
   // initilaize and solve the system
   system_opt.init();
   system_opt.ClearVariablesToBeSolved();
   system_opt.AddVariableToBeSolved("All");
 
+#if kkt_block_flag == 1
+  system_opt.SetFieldSplitTree(kkt.GetFieldSplitTree());
+  system_opt.SetMgType(V_CYCLE);
+  system_opt.SetNumberPreSmoothingStep(1);
+  system_opt.SetNumberPostSmoothingStep(1);
+  system_opt.SetTolerances(1.e-10, 1.e-20, 1.e+50, 50, 30);
+#endif
+
   mlSol.SetWriter(VTK);
   mlSol.GetWriter()->SetDebugOutput(true);
   
@@ -350,7 +385,11 @@ int main(int argc, char** args) {
 //   system_opt.SetMaxNumberOfLinearIterations(6);
 //   system_opt.SetAbsoluteLinearConvergenceTolerance(1.e-14);
 
+#if kkt_block_flag == 1
+  system_opt.SetOuterSolver(GMRES);
+#else
   system_opt.SetOuterSolver(PREONLY);
+#endif
   system_opt.MGsolve();
 
 #if compute_conv_flag == 1
@@ -463,7 +463,7 @@ void AssembleSolidMech(MultiLevelProblem& ml_prob,
   
 
       
-     assemble_jac.prepare_before_integration_loop(stack);
+     assemble_jac.prepare_before_integration_loop(stack, SolVAR_eldofs);
      
   
     // *** Gauss point loop ***
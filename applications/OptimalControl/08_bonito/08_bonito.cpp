@@ -44,8 +44,6 @@ void BuildU(MultiLevelSolution& mlSol);
 
 void AssemblePoissonProblem(MultiLevelProblem& ml_prob);
 
-int n_sys;
-
 int main(int argc, char** args) {
   
   const std::string fe_quad_rule_1 = "seventh";
@@ -110,22 +108,28 @@ int main(int argc, char** args) {
   MultiLevelProblem mlProb(&mlSol);
 
   // add system Poisson in mlProb as a Linear Implicit System
-  
+  // the sinc quadrature problems (M + exp(2 q n) K) w_n = exp(2 s q n) F are solved as the shifted family
+  // (K + exp(-2 q n) M) w_n = exp(2 (s - 1) q n) F on the same multigrid hierarchy, u is the work solution
+  LinearImplicitSystem& system = mlProb.add_system < LinearImplicitSystem > ("Poisson");
+  system.AddSolutionToSystemPDE("u");
+  system.SetAssembleFunction(AssemblePoissonProblem);
+  system.init();
+  system.SetOuterSolver(PREONLY);
+  // the coarse pattern is the same for all the shifts, the symbolic LU factorization is computed once
+  system.SetCoarseGridDirectSolver();
+
+  std::vector < double > shift;
+  std::vector < double > rhsScale;
+  std::vector < std::string > wName;
   for (int i = - N_minus; i < N_plus + 1; i++) {
 //   for (int i = - N; i < N + 1; i++) {
-    char sysName[20];
-    sprintf (sysName, "Poisson%d", i);
-    LinearImplicitSystem& system = mlProb.add_system < LinearImplicitSystem > (sysName);
     char solName[20];
     sprintf (solName, "w%d", i);
-    system.AddSolutionToSystemPDE(solName);
-    system.SetAssembleFunction(AssemblePoissonProblem);
-     
-    system.init();
-    n_sys = i;
-    system.SetOuterSolver(PREONLY);
-    system.MGsolve();
+    wName.push_back(solName);
+    shift.push_back(exp( - 2 * q_step * i ));
+    rhsScale.push_back(exp( 2 * (S_FRAC - 1) * q_step * i ));
   }
+  system.MGsolveShiftedFamily(shift, rhsScale, wName);
 
   BuildU(mlSol);
   
@@ -151,12 +155,9 @@ void AssemblePoissonProblem(MultiLevelProblem& ml_prob) {
   adept::Stack& s = FemusInit::_adeptStack;
   //  extract pointers to the several objects that we are going to use
 
-  char sysName[20];
-  sprintf (sysName, "Poisson%d", n_sys);
-  char solName[10];
-  sprintf (solName, "w%d", n_sys);  
-  
-  LinearImplicitSystem* mlPdeSys  = &ml_prob.get_system<LinearImplicitSystem> (sysName);   // pointer to the linear implicit system named "Poisson"
+  LinearImplicitSystem* mlPdeSys  = &ml_prob.get_system<LinearImplicitSystem> ("Poisson");   // pointer to the linear implicit system named "Poisson"
+  const bool assembleMass = mlPdeSys->GetAssembleMassMatrix(); // the shifted family is assembled as stiffness and right hand side, then mass
+  const char solName[] = "u";
   const unsigned level = mlPdeSys->GetLevelToAssemble();
 
   Mesh*                    msh = ml_prob._ml_msh->GetLevel(level);    // pointer to the mesh (level) object
@@ -283,7 +284,12 @@ void AssemblePoissonProblem(MultiLevelProblem& ml_prob) {
           x_gss[jdim] += x[jdim][i] * phi[i];
         }
 
-        aRes[i] += ( + exp( 2 * S_FRAC * q_step * n_sys ) /** sin(2 * acos(0.0) * x[0][i]) * sin(2 * acos(0.0) * x[1][i]) */* phi[i] - solu_gss * phi[i] - exp( 2 * q_step * n_sys ) * laplace) * weight ;
+        if (assembleMass) {
+          aRes[i] += ( - solu_gss * phi[i] ) * weight;
+        }
+        else {
+          aRes[i] += ( + 1. /** sin(2 * acos(0.0) * x[0][i]) * sin(2 * acos(0.0) * x[1][i]) */* phi[i] - laplace) * weight ;
+        }
 
       } // end phi_i loop
       
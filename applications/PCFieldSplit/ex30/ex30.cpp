@@ -10,6 +10,8 @@
  *  \f}
  *  in a unit box domain (in 2D and 3D) with given temperature 0 and 1 on
  *  the left and right walls, respectively, and insulated walls elsewhere.
+ *  The temperature is T = Ts + T0, and the two systems are coupled both ways:
+ *  the velocity advects T and T drives the velocity through the buoyancy term.
  *  \author Eugenio Aulisa
  */
 
@@ -23,10 +25,14 @@
 #include "LinearImplicitSystem.hpp"
 #include "adept.h"
 #include "FieldSplitTree.hpp"
+#include "PartitionedCoupling.hpp"
 
 
 using namespace femus;
 
+/** Boussinesq buoyancy coefficient beta in the momentum equation */
+const double buoyancy = 0.1;
+
 bool SetBoundaryCondition(const std::vector < double >& x, const char SolName[], double& value, const int facename, const double time) {
   bool dirichlet = true; //dirichlet
   value = 0.;
@@ -205,8 +211,6 @@ int main(int argc, char** args) {
   system.SetNumberOfSchurVariables(1);
   system.SetElementBlockNumber(4);
 
-  system.MGsolve();
-
   LinearImplicitSystem& system2 = mlProb.add_system < LinearImplicitSystem > ("T");
 
   // add solution to system2
@@ -280,7 +284,18 @@ int main(int argc, char** args) {
   system2.SetElementBlockNumber(4);
   //system.SetElementBlockNumber("All");
 
-  system2.MGsolve();
+  // solve NS and T in a block Gauss-Seidel coupling loop: NS reads the temperature through the buoyancy term,
+  // so the temperature is the interface solution that is relaxed
+  PartitionedCoupling coupling(mlProb);
+  coupling.AddSystem("NS");
+  coupling.AddSystem("T");
+  coupling.AddInterfaceSolution("Ts");
+  coupling.AddInterfaceSolution("T0");
+  coupling.SetCouplingScheme(GAUSS_SEIDEL_COUPLING);
+  coupling.SetAcceleration(AITKEN_ACCELERATION);
+  coupling.SetCouplingConvergenceTolerance(1.e-8);
+  coupling.SetMaxNumberOfCouplingIterations(20);
+  coupling.Solve();
 
 
 
@@ -353,6 +368,11 @@ void AssembleNavierStokes(MultiLevelProblem& ml_prob) {
   solPIndex = mlSol->GetIndex("P");    // get the position of "P" in the ml_sol object
   unsigned solPType = mlSol->GetSolutionType(solPIndex);    // get the finite element type for "u"
 
+  // the temperature T = Ts + T0 is data for the NS system, it enters the buoyancy term
+  unsigned solTsIndex = mlSol->GetIndex("Ts");
+  unsigned solT0Index = mlSol->GetIndex("T0");
+  unsigned solTType = mlSol->GetSolutionType(solTsIndex);
+
   vector < unsigned > solVPdeIndex(dim);
   solVPdeIndex[0] = mlPdeSys->GetSolPdeIndex("U");    // get the position of "U" in the pdeSys object
   solVPdeIndex[1] = mlPdeSys->GetSolPdeIndex("V");    // get the position of "V" in the pdeSys object
@@ -364,6 +384,7 @@ void AssembleNavierStokes(MultiLevelProblem& ml_prob) {
 
   vector < vector < adept::adouble > >  solV(dim);    // local solution
   vector < adept::adouble >  solP; // local solution
+  vector < double >  solT; // local temperature
 
   vector< vector < adept::adouble > > aResV(dim);    // local redidual vector
   vector< adept::adouble > aResP; // local redidual vector
@@ -379,6 +400,7 @@ void AssembleNavierStokes(MultiLevelProblem& ml_prob) {
 
   solP.reserve(maxSize);
   aResP.reserve(maxSize);
+  solT.reserve(maxSize);
 
 
   vector <double> phiV;  // local test function
@@ -390,6 +412,7 @@ void AssembleNavierStokes(MultiLevelProblem& ml_prob) {
   phiV_xx.reserve(maxSize * dim2);
 
   double* phiP;
+  double* phiT;
   double weight; // gauss point weight
 
   vector< int > sysDof; // local to global pdeSys dofs
@@ -413,6 +436,7 @@ void AssembleNavierStokes(MultiLevelProblem& ml_prob) {
     unsigned nDofsV = msh->GetElementDofNumber(iel, solVType);    // number of solution element dofs
     unsigned nDofsP = msh->GetElementDofNumber(iel, solPType);    // number of solution element dofs
     unsigned nDofsX = msh->GetElementDofNumber(iel, coordXType);    // number of coordinate element dofs
+    unsigned nDofsT = msh->GetElementDofNumber(iel, solTType);    // number of temperature element dofs
 
     unsigned nDofsVP = dim * nDofsV + nDofsP;
     // resize local arrays
@@ -449,6 +473,12 @@ void AssembleNavierStokes(MultiLevelProblem& ml_prob) {
       sysDof[i + dim * nDofsV] = pdeSys->GetSystemDof(solPIndex, solPPdeIndex, i, iel);    // global to global mapping between solution node and pdeSys dof
     }
 
+    solT.resize(nDofsT);
+    for(unsigned i = 0; i < nDofsT; i++) {
+      unsigned solTDof = msh->GetSolutionDof(i, iel, solTType);
+      solT[i] = (*sol->_Sol[solTsIndex])(solTDof) + (*sol->_Sol[solT0Index])(solTDof);
+    }
+
     // local storage of coordinates
     for(unsigned i = 0; i < nDofsX; i++) {
       unsigned coordXDof  = msh->GetSolutionDof(i, iel, coordXType);    // global to global mapping between coordinates node and coordinate dof
@@ -467,6 +497,7 @@ void AssembleNavierStokes(MultiLevelProblem& ml_prob) {
       // *** get gauss point weight, test function and test function partial derivatives ***
       msh->_finiteElement[ielGeom][solVType]->Jacobian(coordX, ig, weight, phiV, phiV_x, phiV_xx);
       phiP = msh->_finiteElement[ielGeom][solPType]->GetPhi(ig);
+      phiT = msh->_finiteElement[ielGeom][solTType]->GetPhi(ig);
 
       // evaluate the solution, the solution derivatives and the coordinates in the gauss point
 
@@ -496,6 +527,12 @@ void AssembleNavierStokes(MultiLevelProblem& ml_prob) {
         solP_gss += phiP[i] * solP[i];
       }
 
+      double solT_gss = 0.;
+
+      for(unsigned i = 0; i < nDofsT; i++) {
+        solT_gss += phiT[i] * solT[i];
+      }
+
 
       // *** phiV_i loop ***
       for(unsigned i = 0; i < nDofsV; i++) {
@@ -512,6 +549,8 @@ void AssembleNavierStokes(MultiLevelProblem& ml_prob) {
           NSV[k] += -solP_gss * phiV_x[i * dim + k];
         }
 
+        NSV[1] += - buoyancy * solT_gss * phiV[i]; // Boussinesq buoyancy beta T j
+
         for(unsigned  k = 0; k < dim; k++) {
           aResV[k][i] += - NSV[k] * weight;
         }
@@ -0,0 +1,151 @@
+/** \file ex_ns_stab.cpp
+ *  \brief This example shows how to solve the steady Navier-Stokes equations
+ *
+ *  \f{eqnarray*}
+ *  && \rho \mathbf{V} \cdot \nabla \mathbf{V} - \nabla \cdot \mu \nabla \mathbf{V} +\nabla P = 0 \\
+ *  && \nabla \cdot \mathbf{V} = 0
+ *  \f}
+ *  in the lid-driven cavity with equal-order Q1/Q1 velocity and pressure.
+ *  The inf-sup condition is not satisfied, the assembly is the one of the StabilizedNavierStokes kernel (SUPG, PSPG and LSIC).
+ *  The PSPG term fills the pressure diagonal, so the Vanka (ASM) smoother works without the Taylor-Hood pair.
+ *  \author Eugenio Aulisa
+ */
+
+#include "FemusInit.hpp"
+#include "MultiLevelSolution.hpp"
+#include "MultiLevelProblem.hpp"
+#include "NumericVector.hpp"
+#include "VTKWriter.hpp"
+#include "NonLinearImplicitSystem.hpp"
+#include "StabilizedNavierStokes.hpp"
+
+
+using namespace femus;
+
+const double Re = 100.;
+
+StabilizedNavierStokes *stabilizedNS;
+
+bool SetBoundaryCondition(const std::vector < double >& x, const char SolName[], double& value, const int facename, const double time) {
+  //1: bottom  //2: right  //3: top  //4: left
+
+  bool dirichlet = true; //dirichlet
+  value = 0.;
+  if (!strcmp(SolName, "U")) {
+    if (facename == 3) {
+      value = 1.;
+    }
+  } else if (!strcmp(SolName, "P")) {
+    dirichlet = false;
+  }
+  return dirichlet;
+}
+
+
+void AssembleStabilizedNS(MultiLevelProblem& ml_prob);
+
+
+int main(int argc, char** args) {
+
+  // init Petsc-MPI communicator
+  FemusInit mpinit(argc, args, MPI_COMM_WORLD);
+
+  // ======= Files ========================
+  Files files;
+        files.CheckIODirectories(true);
+	files.RedirectCout(true);
+
+  // define multilevel mesh
+  MultiLevelMesh mlMsh;
+  // read coarse level mesh and generate finers level meshes
+  mlMsh.GenerateCoarseBoxMesh(8, 8, 0, 0., 1., 0., 1., 0., 0., QUAD9, "seventh");
+  unsigned dim = mlMsh.GetDimension();
+
+  unsigned numberOfUniformLevels = 4;
+  unsigned numberOfSelectiveLevels = 0;
+  mlMsh.RefineMesh(numberOfUniformLevels , numberOfUniformLevels + numberOfSelectiveLevels, NULL);
+
+  // print mesh info
+  mlMsh.PrintInfo();
+
+  MultiLevelSolution mlSol(&mlMsh);
+
+  // add variables to mlSol, velocity and pressure are both Q1
+  mlSol.AddSolution("U", LAGRANGE, FIRST);
+  mlSol.AddSolution("V", LAGRANGE, FIRST);
+
+  if (dim == 3) mlSol.AddSolution("W", LAGRANGE, FIRST);
+
+  mlSol.AddSolution("P", LAGRANGE, FIRST);
+
+  mlSol.AssociatePropertyToSolution("P", "Pressure");
+  mlSol.Initialize("All");
+
+  // attach the boundary condition function and generate boundary data
+  mlSol.AttachSetBoundaryConditionFunction(SetBoundaryCondition);
+  mlSol.FixSolutionAtOnePoint("P");
+  mlSol.GenerateBdc("All");
+
+  // define the multilevel problem attach the mlSol object to it
+  MultiLevelProblem mlProb(&mlSol);
+
+  // add system NS in mlProb as a Non Linear Implicit System
+  NonLinearImplicitSystem& system = mlProb.add_system < NonLinearImplicitSystem > ("NS");
+
+  system.AddSolutionToSystemPDE("U");
+  system.AddSolutionToSystemPDE("V");
+
+  if (dim == 3) system.AddSolutionToSystemPDE("W");
+
+  system.AddSolutionToSystemPDE("P");
+
+  // the stabilized kernel, mu = rho U L / Re with unit lid velocity and cavity size
+  std::vector < std::string > velocityName(dim);
+  velocityName[0] = "U";
+  velocityName[1] = "V";
+  if (dim == 3) velocityName[2] = "W";
+
+  StabilizedNavierStokes ns(velocityName, "P", 1. / Re);
+  stabilizedNS = &ns;
+
+  system.SetLinearEquationSolverType(FEMuS_ASM); // Additive Swartz Method
+  // attach the assembling function to system
+  system.SetAssembleFunction(AssembleStabilizedNS);
+
+  system.SetMaxNumberOfNonLinearIterations(20);
+  system.SetMaxNumberOfLinearIterations(3);
+  system.SetAbsoluteLinearConvergenceTolerance(1.e-12);
+  system.SetNonLinearConvergenceTolerance(1.e-8);
+  system.SetMgType(V_CYCLE);
+
+  system.SetNumberPreSmoothingStep(1);
+  system.SetNumberPostSmoothingStep(1);
+
+  // initilaize and solve the system
+  system.init();
+
+  system.SetSolverFineGrids(GMRES);
+  system.SetPreconditionerFineGrids(ILU_PRECOND);
+
+  system.SetTolerances(1.e-3, 1.e-20, 1.e+50, 5);
+
+  system.ClearVariablesToBeSolved();
+  system.AddVariableToBeSolved("All");
+  system.SetNumberOfSchurVariables(1);
+  system.SetElementBlockNumber(4);
+  system.MGsolve();
+
+  // print solutions
+  std::vector < std::string > variablesToBePrinted;
+  variablesToBePrinted.push_back("All");
+
+  VTKWriter vtkIO(&mlSol);
+  vtkIO.Write(files.GetOutputPath(), "linear", variablesToBePrinted);
+
+  return 0;
+}
+
+
+void AssembleStabilizedNS(MultiLevelProblem& ml_prob) {
+  stabilizedNS->Assemble(ml_prob, "NS");
+}
@@ -0,0 +1,305 @@
+/** RK/ex3explicit
+ * This example advances the heat equation with the explicit lumped-mass Runge-Kutta of ExplicitSystem
+ *          $$ \dfrac{\partial u}{ \partial t} = \Delta u  \text{ in } \Omega = [0,1]x[0,1] $$
+ *          $$ u = 0 \text{ on } \partial \Omega $$
+ *          $$ u = \sin(\pi x) \sin(\pi y) \text{ at } t = 0 $$
+ * whose exact solution is u = exp(-2 \pi^2 t) \sin(\pi x) \sin(\pi y).
+ * No matrix is assembled: the assemble function only evaluates the residual R(u) = - \int \nabla u \cdot \nabla \phi_i,
+ * and ExplicitSystem advances M du/dt = R(u) with the lumped mass M and SSP-RK3.
+ * The problem is solved on a sequence of uniformly refined meshes with dt proportional to h^2 (explicit stability),
+ * so the time error O(dt^3) is negligible and the L2 error at the final time has to decrease as h^2 (linear elements).
+ **/
+
+#include "FemusInit.hpp"
+#include "MultiLevelSolution.hpp"
+#include "MultiLevelProblem.hpp"
+#include "NumericVector.hpp"
+#include "VTKWriter.hpp"
+#include "TransientSystem.hpp"
+#include "ExplicitSystem.hpp"
+
+#include <cmath>
+
+using namespace femus;
+
+bool SetBoundaryCondition(const std::vector < double >& x, const char solName[], double& value, const int faceIndex, const double time) {
+  bool dirichlet = true;
+  value = 0.;
+  return dirichlet;
+}
+
+double InitalValue(const std::vector < double >& x) {
+  double pi = acos(-1.);
+  return sin(pi * x[0]) * sin(pi * x[1]);
+}
+
+double ExactSolution(const std::vector < double >& x, const double &time) {
+  double pi = acos(-1.);
+  return exp(-2. * pi * pi * time) * sin(pi * x[0]) * sin(pi * x[1]);
+}
+
+void AssembleHeatResidual(MultiLevelProblem& ml_prob);
+
+double GetErrorNormL2(MultiLevelSolution* mlSol, const double &time);
+
+int main(int argc, char** args) {
+
+  // init Petsc-MPI communicator
+  FemusInit mpinit(argc, args, MPI_COMM_WORLD);
+
+  const double finalTime = 0.1;
+  const double dtOverH2 = 0.1;  // the SSP-RK3 stability limit for the lumped linear Laplacian is about 0.3 h^2
+  const unsigned numberOfMeshes = 4;
+  const double expectedOrder = 2.;
+
+  std::vector < double > errorL2(numberOfMeshes);
+
+  for(unsigned i = 0; i < numberOfMeshes; i++) {
+
+    // define multilevel mesh: 2 x 2 coarse elements refined i times, h = 1 / 2^(i + 1)
+    MultiLevelMesh mlMsh;
+    mlMsh.GenerateCoarseBoxMesh(2, 2, 0, 0., 1., 0., 1., 0., 0., QUAD9, "seventh");
+
+    unsigned numberOfUniformLevels = i + 1;
+    unsigned numberOfSelectiveLevels = 0;
+    mlMsh.RefineMesh(numberOfUniformLevels, numberOfUniformLevels + numberOfSelectiveLevels, NULL);
+
+    // erase all the coarse mesh levels
+    mlMsh.EraseCoarseLevels(numberOfUniformLevels - 1);
+
+    double h = 1. / pow(2., i + 1);
+    unsigned numberOfTimeSteps = static_cast < unsigned >(floor(finalTime / (dtOverH2 * h * h) + 0.5));
+    double dt = finalTime / numberOfTimeSteps;
+
+    // define the multilevel solution and attach the mlMsh object to it
+    MultiLevelSolution mlSol(&mlMsh);
+
+    mlSol.AddSolution("u", LAGRANGE, FIRST);
+    mlSol.Initialize("u", InitalValue);
+
+    // attach the boundary condition function and generate boundary data
+    mlSol.AttachSetBoundaryConditionFunction(SetBoundaryCondition);
+    mlSol.GenerateBdc("u", "Steady");
+
+    // define the multilevel problem attach the mlSol object to it
+    MultiLevelProblem mlProb(&mlSol);
+
+    // add system Heat in mlProb as an explicit transient system: no matrix and no solver are allocated
+    TransientExplicitSystem& system = mlProb.add_system < TransientExplicitSystem > ("Heat");
+    system.AddSolutionToSystemPDE("u");
+    system.SetAssembleFunction(AssembleHeatResidual);
+    system.SetExplicitTimeSteppingScheme(SSP_RK3);
+    system.SetLumpedMassType(ROW_SUM_LUMPING);
+
+    system.init();
+    system.SetIntervalTime(dt);
+
+    for(unsigned timeStep = 0; timeStep < numberOfTimeSteps; timeStep++) {
+      system.MGsolve();
+    }
+
+    errorL2[i] = GetErrorNormL2(&mlSol, system.GetTime());
+
+    std::cout << "h = " << h << " dt = " << dt << " time steps = " << numberOfTimeSteps << " L2 error = " << errorL2[i] << std::endl;
+
+    if(i == numberOfMeshes - 1) {
+      std::vector < std::string > variablesToBePrinted;
+      variablesToBePrinted.push_back("All");
+
+      VTKWriter vtkIO(&mlSol);
+      vtkIO.Write(DEFAULT_OUTPUTDIR, "biquadratic", variablesToBePrinted);
+    }
+
+    mlProb.clear();
+  }
+
+  // convergence order check
+  bool orderIsMet = true;
+  for(unsigned i = 1; i < numberOfMeshes; i++) {
+    double order = log(errorL2[i - 1] / errorL2[i]) / log(2.);
+    std::cout << "L2 convergence order between meshes " << i - 1 << " and " << i << ": " << order << std::endl;
+    if(i == numberOfMeshes - 1 && order < 0.9 * expectedOrder) orderIsMet = false;
+  }
+
+  if(!orderIsMet) {
+    std::cout << "Error in ex3explicit: the L2 convergence order is below the expected " << expectedOrder << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+
+/**
+ * Residual of the heat equation for ExplicitSystem.
+ * Unlike the implicit systems there is no KKoffset/_RESC numbering and no matrix: the element contributions of
+ * R(u) = - \int \nabla u \cdot \nabla \phi_i are added to sol->_Res of the unknown, in the solution dof numbering.
+ * ExplicitSystem zeroes _Res before the call, closes it after, and zeroes the Dirichlet rows.
+ **/
+void AssembleHeatResidual(MultiLevelProblem& ml_prob) {
+
+  TransientExplicitSystem* mlPdeSys = &ml_prob.get_system < TransientExplicitSystem > ("Heat");
+  const unsigned level = mlPdeSys->GetLevelToAssemble();
+
+  Mesh*                    msh = ml_prob._ml_msh->GetLevel(level);   // pointer to the mesh (level) object
+  MultiLevelSolution*    mlSol = ml_prob._ml_sol;  // pointer to the multilevel solution object
+  Solution*                sol = ml_prob._ml_sol->GetSolutionLevel(level);   // pointer to the solution (level) object
+
+  const unsigned  dim = msh->GetDimension(); // get the domain dimension of the problem
+  const unsigned maxSize = static_cast< unsigned >(ceil(pow(3, dim)));    // conservative: based on line3, quad9, hex27
+
+  unsigned    iproc = msh->processor_id(); // get the process_id (for parallel computation)
+
+  unsigned soluIndex = mlSol->GetIndex("u");    // get the position of "u" in the ml_sol object
+  unsigned soluType = mlSol->GetSolutionType(soluIndex);    // get the finite element type for "u"
+
+  NumericVector* RES = sol->_Res[soluIndex];   // residual of "u", in the solution numbering
+
+  std::vector < double >  solu;  // local solution
+  solu.reserve(maxSize);
+
+  std::vector < std::vector < double > > x(dim);    // local coordinates
+  unsigned xType = 2; // get the finite element type for "x", it is always 2 (LAGRANGE QUADRATIC)
+  for(unsigned k = 0; k < dim; k++) {
+    x[k].reserve(maxSize);
+  }
+
+  std::vector < double > phi;  // local test function
+  std::vector < double > phi_x; // local test function first order partial derivatives
+  double weight; // gauss point weight
+
+  phi.reserve(maxSize);
+  phi_x.reserve(maxSize * dim);
+
+  std::vector < double > Res; // local residual vector
+  std::vector < int > solDof; // local to global solution dofs
+  Res.reserve(maxSize);
+  solDof.reserve(maxSize);
+
+  // element loop: each process loops only on the elements that owns
+  for(int iel = msh->_elementOffset[iproc]; iel < msh->_elementOffset[iproc + 1]; iel++) {
+
+    short unsigned ielGeom = msh->GetElementType(iel);
+    unsigned nDofs  = msh->GetElementDofNumber(iel, soluType);    // number of solution element dofs
+    unsigned nDofsX = msh->GetElementDofNumber(iel, xType);    // number of coordinate element dofs
+
+    solu.resize(nDofs);
+    solDof.resize(nDofs);
+    Res.assign(nDofs, 0.);
+    for(int k = 0; k < dim; k++) {
+      x[k].resize(nDofsX);
+    }
+
+    // local storage of global mapping and solution
+    for(unsigned i = 0; i < nDofs; i++) {
+      solDof[i] = msh->GetSolutionDof(i, iel, soluType);    // local to global mapping between solution node and solution dof
+      solu[i] = (*sol->_Sol[soluIndex])(solDof[i]);      // global extraction and local storage for the solution
+    }
+
+    // local storage of coordinates
+    for(unsigned i = 0; i < nDofsX; i++) {
+      unsigned xDof  = msh->GetSolutionDof(i, iel, xType);    // local to global mapping between coordinates node and coordinate dof
+      for(unsigned k = 0; k < dim; k++) {
+        x[k][i] = (*msh->_topology->_Sol[k])(xDof);      // global extraction and local storage for the element coordinates
+      }
+    }
+
+    // *** Gauss point loop ***
+    for(unsigned ig = 0; ig < msh->_finiteElement[ielGeom][soluType]->GetGaussPointNumber(); ig++) {
+      // *** get gauss point weight, test function and test function partial derivatives ***
+      msh->_finiteElement[ielGeom][soluType]->Jacobian(x, ig, weight, phi, phi_x);
+
+      std::vector < double > gradSolu_gss(dim, 0.);
+      for(unsigned i = 0; i < nDofs; i++) {
+        for(unsigned k = 0; k < dim; k++) {
+          gradSolu_gss[k] += phi_x[i * dim + k] * solu[i];
+        }
+      }
+
+      // *** phi_i loop ***
+      for(unsigned i = 0; i < nDofs; i++) {
+        double laplace = 0.;
+        for(unsigned k = 0; k < dim; k++) {
+          laplace += phi_x[i * dim + k] * gradSolu_gss[k];
+        }
+        Res[i] -= laplace * weight;
+      }
+    }
+
+    RES->add_vector_blocked(Res, solDof);
+  } //end element loop for each process
+
+}
+
+
+double GetErrorNormL2(MultiLevelSolution* mlSol, const double &time) {
+
+  unsigned level = mlSol->_mlMesh->GetNumberOfLevels() - 1u;
+
+  Mesh*     msh = mlSol->_mlMesh->GetLevel(level);
+  Solution* sol = mlSol->GetSolutionLevel(level);
+
+  const unsigned  dim = msh->GetDimension();
+  unsigned iproc = msh->processor_id();
+
+  unsigned soluIndex = mlSol->GetIndex("u");
+  unsigned soluType = mlSol->GetSolutionType(soluIndex);
+
+  std::vector < double > solu;
+  std::vector < std::vector < double > > x(dim);
+  unsigned xType = 2;
+
+  std::vector < double > phi;
+  std::vector < double > phi_x;
+  double weight;
+
+  double errorL2 = 0.;
+
+  for(int iel = msh->_elementOffset[iproc]; iel < msh->_elementOffset[iproc + 1]; iel++) {
+
+    short unsigned ielGeom = msh->GetElementType(iel);
+    unsigned nDofs  = msh->GetElementDofNumber(iel, soluType);
+    unsigned nDofsX = msh->GetElementDofNumber(iel, xType);
+
+    solu.resize(nDofs);
+    for(int k = 0; k < dim; k++) {
+      x[k].resize(nDofsX);
+    }
+
+    for(unsigned i = 0; i < nDofs; i++) {
+      unsigned solDof = msh->GetSolutionDof(i, iel, soluType);
+      solu[i] = (*sol->_Sol[soluIndex])(solDof);
+    }
+
+    for(unsigned i = 0; i < nDofsX; i++) {
+      unsigned xDof  = msh->GetSolutionDof(i, iel, xType);
+      for(unsigned k = 0; k < dim; k++) {
+        x[k][i] = (*msh->_topology->_Sol[k])(xDof);
+      }
+    }
+
+    for(unsigned ig = 0; ig < msh->_finiteElement[ielGeom][soluType]->GetGaussPointNumber(); ig++) {
+      msh->_finiteElement[ielGeom][soluType]->Jacobian(x, ig, weight, phi, phi_x);
+
+      double solu_gss = 0.;
+      std::vector < double > x_gss(dim, 0.);
+      for(unsigned i = 0; i < nDofs; i++) {
+        solu_gss += phi[i] * solu[i];
+      }
+      // the coordinates are interpolated with the linear shape functions, exact on the affine elements of the box mesh
+      for(unsigned i = 0; i < nDofs; i++) {
+        for(unsigned k = 0; k < dim; k++) {
+          x_gss[k] += phi[i] * x[k][i];
+        }
+      }
+
+      double diff = solu_gss - ExactSolution(x_gss, time);
+      errorL2 += diff * diff * weight;
+    }
+  }
+
+  double errorL2All;
+  MPI_Allreduce(&errorL2, &errorL2All, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+  return sqrt(errorL2All);
+}
@@ -0,0 +1,371 @@
+#include "MultiLevelSolution.hpp"
+#include "NumericVector.hpp"
+
+#include <mpi.h>
+
+#include <map>
+#include <cmath>
+#include <cstdio>
+
+// Explicit finite volume transport of the layer tracers T%d, HT%d = h%d T%d on the 1D layered SW meshes.
+// h%d and T%d are piecewise constant, v%d is linear Lagrange: the horizontal fluxes live at the element nodes,
+// the vertical fluxes at the layer interfaces. The face connectivity and the geometry are computed once in the constructor,
+// T is reconstructed with limited MUSCL slopes on the upwind side and advanced with SSP-RK2. Step is matrix-free and
+// subcycles the given dt with the stable CFL time step, so it can replace the implicit tracer solve inside the barotropic step.
+
+using namespace femus;
+
+enum TracerLimiter {
+  UPWIND = 0,
+  MINMOD,
+  VAN_LEER,
+  SUPERBEE
+};
+
+class TracerTransport {
+  public:
+
+    TracerTransport(Solution* sol, const unsigned &numberOfLayers, const TracerLimiter &limiter = VAN_LEER) :
+      _sol(sol),
+      _msh(sol->GetMesh()),
+      _NLayers(numberOfLayers),
+      _limiter(limiter),
+      _cfl(0.5),
+      _kh(0.),
+      _openBoundary(false),
+      _verticalVelocity(NULL) {
+
+      _iproc = _msh->processor_id();
+      _elementOffset = _msh->_elementOffset[_iproc];
+      _nel = _msh->_elementOffset[_iproc + 1] - _elementOffset;
+
+      _solIndexh.resize(_NLayers);
+      _solIndexv.resize(_NLayers);
+      _solIndexT.resize(_NLayers);
+      _solIndexHT.resize(_NLayers);
+      for(unsigned k = 0; k < _NLayers; k++) {
+        char name[10];
+        sprintf(name, "h%d", k);
+        _solIndexh[k] = sol->GetIndex(name);
+        sprintf(name, "v%d", k);
+        _solIndexv[k] = sol->GetIndex(name);
+        sprintf(name, "T%d", k);
+        _solIndexT[k] = sol->GetIndex(name);
+        sprintf(name, "HT%d", k);
+        _solIndexHT[k] = sol->GetIndex(name);
+      }
+      _solTypev = sol->GetSolutionType(_solIndexv[0]);
+
+      // BEGIN face connectivity and geometry
+      // _neighbor[2 * i + j] is the position, in the owned + ghost arrays, of the element across the face j of the owned element i,
+      // or -1 on the boundary
+      _neighbor.assign(2 * _nel, -1);
+      _dx.resize(_nel);
+      _xMid.resize(_nel);
+      _vDof.resize(2 * _nel);
+
+      std::vector < int > ghost;
+      std::map < unsigned, unsigned > ghostPosition;
+
+      for(unsigned i = 0; i < _nel; i++) {
+        unsigned iel = _elementOffset + i;
+
+        double x[2];
+        for(unsigned j = 0; j < 2; j++) {
+          unsigned xDof  = _msh->GetSolutionDof(j, iel, 2);
+          x[j] = (*_msh->_topology->_Sol[0])(xDof);
+          _vDof[2 * i + j] = _msh->GetSolutionDof(j, iel, _solTypev);
+        }
+        _dx[i] = x[1] - x[0];
+        _xMid[i] = 0.5 * (x[0] + x[1]);
+
+        for(unsigned j = 0; j < 2; j++) {
+          int jel = _msh->el->GetFaceElementIndex(iel, j) - 1;
+          if(jel >= 0) {
+            if(jel >= static_cast < int >(_elementOffset) && jel < static_cast < int >(_elementOffset + _nel)) {
+              _neighbor[2 * i + j] = jel - _elementOffset;
+            }
+            else {
+              std::map < unsigned, unsigned >::iterator it = ghostPosition.find(jel);
+              if(it == ghostPosition.end()) {
+                ghostPosition[jel] = _nel + ghost.size();
+                ghost.push_back(jel);
+              }
+              _neighbor[2 * i + j] = ghostPosition[jel];
+            }
+          }
+        }
+      }
+      _ghost = ghost;
+
+      // piecewise constant solutions have no ghost dofs, the exchange goes through this vector
+      _exchange = NumericVector::build().release();
+      _exchange->init(_msh->GetNumberOfElements(), _nel, _ghost, false, GHOSTED);
+      // END face connectivity and geometry
+
+      _h.resize(_NLayers);
+      _T.resize(_NLayers);
+      _HT.resize(_NLayers);
+      _HT0.resize(_NLayers);
+      _slope.resize(_NLayers);
+      _v.resize(_NLayers);
+      _rhs.resize(_NLayers);
+      for(unsigned k = 0; k < _NLayers; k++) {
+        _h[k].resize(_nel + _ghost.size());
+        _T[k].resize(_nel + _ghost.size());
+        _slope[k].resize(_nel + _ghost.size());
+        _HT[k].resize(_nel);
+        _HT0[k].resize(_nel);
+        _v[k].resize(2 * _nel);
+        _rhs[k].resize(_nel);
+      }
+      _w.assign(_nel, std::vector < double > (_NLayers + 1, 0.));
+    }
+
+    ~TracerTransport() {
+      delete _exchange;
+    }
+
+    void SetLimiter(const TracerLimiter &limiter) {
+      _limiter = limiter;
+    }
+
+    void SetCFL(const double &cfl) {
+      _cfl = cfl;
+    }
+
+    void SetHorizontalDiffusivity(const double &kh) {
+      _kh = kh;
+    }
+
+    /// By default the boundary faces are closed, if open the tracer leaves with the outflow and enters with T = 0
+    void SetOpenBoundary(const bool &openBoundary) {
+      _openBoundary = openBoundary;
+    }
+
+    /// Set the function that gives the velocities w[0], ..., w[NLayers] at the layer interfaces of the column at x,
+    /// w[k] is the top interface of layer k, w[0] and w[NLayers] are zero for a closed column
+    void SetVerticalVelocityFunction(void (*verticalVelocity)(const double &x, const std::vector < double > &h, std::vector < double > &w)) {
+      _verticalVelocity = verticalVelocity;
+    }
+
+    /// Largest stable time step for the current h and v, the same on all processes
+    double GetStableTimeStep() {
+      ReadVelocityAndThickness();
+      return ComputeStableTimeStep();
+    }
+
+    /// Advance T and HT by dt with h and v frozen, subcycling with the stable time step. Returns the number of substeps
+    unsigned Step(const double &dt) {
+
+      ReadVelocityAndThickness();
+
+      for(unsigned k = 0; k < _NLayers; k++) {
+        for(unsigned i = 0; i < _nel; i++) {
+          _T[k][i] = (*_sol->_Sol[_solIndexT[k]])(_elementOffset + i);
+          _HT[k][i] = _h[k][i] * _T[k][i];
+        }
+      }
+
+      double dtStable = ComputeStableTimeStep();
+      unsigned nSubsteps = (dtStable < dt) ? static_cast < unsigned >(ceil(dt / dtStable)) : 1u;
+      double dts = dt / nSubsteps;
+
+      for(unsigned n = 0; n < nSubsteps; n++) {
+        for(unsigned k = 0; k < _NLayers; k++) {
+          _HT0[k] = _HT[k];
+        }
+
+        // SSP-RK2: HT1 = HT0 + dt L(T0), HT = 1/2 HT0 + 1/2 (HT1 + dt L(T1))
+        for(unsigned stage = 0; stage < 2; stage++) {
+          ComputeRightHandSide();
+          for(unsigned k = 0; k < _NLayers; k++) {
+            for(unsigned i = 0; i < _nel; i++) {
+              double HT1 = _HT[k][i] + dts * _rhs[k][i];
+              _HT[k][i] = (stage == 0) ? HT1 : 0.5 * (_HT0[k][i] + HT1);
+              _T[k][i] = _HT[k][i] / _h[k][i];
+            }
+          }
+        }
+      }
+
+      for(unsigned k = 0; k < _NLayers; k++) {
+        for(unsigned i = 0; i < _nel; i++) {
+          _sol->_Sol[_solIndexT[k]]->set(_elementOffset + i, _T[k][i]);
+          _sol->_Sol[_solIndexHT[k]]->set(_elementOffset + i, _HT[k][i]);
+        }
+        _sol->_Sol[_solIndexT[k]]->close();
+        _sol->_Sol[_solIndexHT[k]]->close();
+      }
+
+      return nSubsteps;
+    }
+
+  private:
+
+    /// Copy the owned values of u into the exchange vector and read back owned and ghost values
+    void Exchange(std::vector < double > &u) {
+      for(unsigned i = 0; i < _nel; i++) {
+        _exchange->set(_elementOffset + i, u[i]);
+      }
+      _exchange->close();
+      for(unsigned i = 0; i < _ghost.size(); i++) {
+        u[_nel + i] = (*_exchange)(_ghost[i]);
+      }
+    }
+
+    void ReadVelocityAndThickness() {
+      for(unsigned k = 0; k < _NLayers; k++) {
+        for(unsigned i = 0; i < _nel; i++) {
+          _h[k][i] = (*_sol->_Sol[_solIndexh[k]])(_elementOffset + i);
+          _v[k][2 * i] = (*_sol->_Sol[_solIndexv[k]])(_vDof[2 * i]);
+          _v[k][2 * i + 1] = (*_sol->_Sol[_solIndexv[k]])(_vDof[2 * i + 1]);
+        }
+        Exchange(_h[k]);
+      }
+
+      if(_verticalVelocity) {
+        std::vector < double > h(_NLayers);
+        for(unsigned i = 0; i < _nel; i++) {
+          for(unsigned k = 0; k < _NLayers; k++) h[k] = _h[k][i];
+          _verticalVelocity(_xMid[i], h, _w[i]);
+        }
+      }
+    }
+
+    double ComputeStableTimeStep() {
+      double dtMin = 1.e300;
+      for(unsigned i = 0; i < _nel; i++) {
+        for(unsigned k = 0; k < _NLayers; k++) {
+          // outgoing horizontal and vertical volume fluxes over the layer volume
+          double out = (std::max(-_v[k][2 * i], 0.) + std::max(_v[k][2 * i + 1], 0.)) / _dx[i]
+                       + (std::max(_w[i][k], 0.) + std::max(-_w[i][k + 1], 0.)) / _h[k][i];
+          if(out > 0.) dtMin = std::min(dtMin, _cfl / out);
+          if(_kh > 0.) dtMin = std::min(dtMin, 0.5 * _cfl * _dx[i] * _dx[i] / _kh);
+        }
+      }
+      double dtStable;
+      MPI_Allreduce(&dtMin, &dtStable, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+      return dtStable;
+    }
+
+    double Limiter(const double &a, const double &b) const {
+      if(a * b <= 0.) return 0.;
+      switch(_limiter) {
+        case UPWIND:
+          return 0.;
+        case MINMOD:
+          return (fabs(a) < fabs(b)) ? a : b;
+        case VAN_LEER:
+          return 2. * a * b / (a + b);
+        case SUPERBEE: {
+            double s = (a > 0.) ? 1. : -1.;
+            return s * std::max(std::min(2. * fabs(a), fabs(b)), std::min(fabs(a), 2. * fabs(b)));
+          }
+      }
+      return 0.;
+    }
+
+    /// Value of T of the owned or ghost element p reconstructed at its face j
+    double FaceValue(const unsigned &k, const unsigned &p, const unsigned &j) const {
+      return _T[k][p] + ((j == 0) ? -0.5 : 0.5) * _slope[k][p];
+    }
+
+    /// d(HT)/dt of all the owned elements: horizontal and vertical advection plus horizontal diffusion
+    void ComputeRightHandSide() {
+
+      // limited slopes times dx of the owned elements, then of the ghost ones
+      for(unsigned k = 0; k < _NLayers; k++) {
+        Exchange(_T[k]);
+        for(unsigned i = 0; i < _nel; i++) {
+          int l = _neighbor[2 * i];
+          int r = _neighbor[2 * i + 1];
+          _slope[k][i] = (l >= 0 && r >= 0) ? Limiter(_T[k][i] - _T[k][l], _T[k][r] - _T[k][i]) : 0.;
+        }
+        Exchange(_slope[k]);
+      }
+
+      for(unsigned i = 0; i < _nel; i++) {
+        for(unsigned k = 0; k < _NLayers; k++) {
+
+          double rhs = 0.;
+
+          // horizontal fluxes, the face j = 0 is the left node, j = 1 the right node
+          for(unsigned j = 0; j < 2; j++) {
+            int p = _neighbor[2 * i + j];
+            double v = _v[k][2 * i + j];
+            double sign = (j == 0) ? 1. : -1.;
+            if(p < 0) {
+              if(_openBoundary && (j == 1) == (v > 0.)) rhs += sign * _h[k][i] * v * FaceValue(k, i, j) / _dx[i];
+              continue;
+            }
+            double hFace = 0.5 * (_h[k][i] + _h[k][p]);
+            double TFace;
+            if((j == 1) == (v > 0.)) TFace = FaceValue(k, i, j);  // outflow, the element itself is upwind
+            else TFace = FaceValue(k, p, 1 - j);
+            rhs += sign * hFace * v * TFace / _dx[i];
+
+            if(_kh > 0.) {
+              rhs += _kh * hFace * (_T[k][p] - _T[k][i]) / (_dx[i] * _dx[i]);
+            }
+          }
+
+          // vertical fluxes, w[k] is the top interface of layer k and w > 0 points upwards
+          if(k < _NLayers - 1) {
+            double w = _w[i][k + 1];
+            double TFace = (w > 0.) ? VerticalFaceValue(i, k + 1, 0) : VerticalFaceValue(i, k, 1);
+            rhs += w * TFace;
+          }
+          if(k > 0) {
+            double w = _w[i][k];
+            double TFace = (w > 0.) ? VerticalFaceValue(i, k, 0) : VerticalFaceValue(i, k - 1, 1);
+            rhs -= w * TFace;
+          }
+
+          _rhs[k][i] = rhs;
+        }
+      }
+    }
+
+    /// Value of T of the layer k of the owned column i reconstructed at its top (j = 0) or bottom (j = 1) interface
+    double VerticalFaceValue(const unsigned &i, const unsigned &k, const unsigned &j) const {
+      if(k == 0 || k == _NLayers - 1 || _limiter == UPWIND) return _T[k][i];
+      double slope = Limiter(_T[k - 1][i] - _T[k][i], _T[k][i] - _T[k + 1][i]); // top minus bottom
+      return _T[k][i] + ((j == 0) ? 0.5 : -0.5) * slope;
+    }
+
+    Solution *_sol;
+    Mesh *_msh;
+    unsigned _NLayers;
+    TracerLimiter _limiter;
+    double _cfl;
+    double _kh;
+    bool _openBoundary;
+    void (*_verticalVelocity)(const double &x, const std::vector < double > &h, std::vector < double > &w);
+
+    unsigned _iproc;
+    unsigned _elementOffset;
+    unsigned _nel;
+
+    std::vector < unsigned > _solIndexh;
+    std::vector < unsigned > _solIndexv;
+    std::vector < unsigned > _solIndexT;
+    std::vector < unsigned > _solIndexHT;
+    unsigned _solTypev;
+
+    std::vector < int > _neighbor;
+    std::vector < int > _ghost;
+    std::vector < double > _dx;
+    std::vector < double > _xMid;
+    std::vector < unsigned > _vDof;
+    NumericVector *_exchange;
+
+    std::vector < std::vector < double > > _h;
+    std::vector < std::vector < double > > _T;
+    std::vector < std::vector < double > > _HT;
+    std::vector < std::vector < double > > _HT0;
+    std::vector < std::vector < double > > _slope;
+    std::vector < std::vector < double > > _v;
+    std::vector < std::vector < double > > _w;
+    std::vector < std::vector < double > > _rhs;
+};
@@ -24,6 +24,8 @@
 #include "slepceps.h"
 #include <slepcmfn.h>
 
+#include "../include/tracerTransport.hpp"
+
 using namespace femus;
 
 double dt = 0.01 /*1./10.*/; //= dx / maxWaveSpeed * 0.85;
@@ -83,6 +85,8 @@ bool SetBoundaryCondition ( const std::vector < double >& x, const char SolName[
 
 void ETD2 ( MultiLevelProblem& ml_prob );
 
+void GetVerticalVelocity ( const double &x, const std::vector < double > &h, std::vector < double > &w );
+
 void RK ( MultiLevelProblem& ml_prob, const unsigned & numberOfTimeSteps );
 
 
@@ -176,6 +180,12 @@ int main ( int argc, char** args ) {
   //mlSol.GetWriter()->SetDebugOutput(true);
   mlSol.GetWriter()->Write ( DEFAULT_OUTPUTDIR, "linear", print_vars, 0 );
 
+  // explicit flux-limited transport of T and HT on the finest level
+  TracerTransport transport ( mlSol.GetSolutionLevel ( mlMsh.GetNumberOfLevels() - 1u ), NumberOfLayers, VAN_LEER );
+  transport.SetVerticalVelocityFunction ( GetVerticalVelocity );
+  transport.SetHorizontalDiffusivity ( k_h );
+  transport.SetOpenBoundary ( true );
+
   unsigned numberOfTimeSteps = 5000; //17h=1020 with dt=60, 17h=10200 with dt=6
   dt = 0.02;
   for ( unsigned i = 0; i < numberOfTimeSteps; i++ ) {
@@ -184,7 +194,8 @@ int main ( int argc, char** args ) {
 //     ETD ( ml_prob );
 //     dt = 60.;
     //ETD2 ( ml_prob );
-    RK ( ml_prob, numberOfTimeSteps );
+    //RK ( ml_prob, numberOfTimeSteps );
+    transport.Step ( dt );
     mlSol.GetWriter()->Write ( DEFAULT_OUTPUTDIR, "linear", print_vars, ( i + 1 ) / 1 );
     counter++;
   }
@@ -192,6 +203,20 @@ int main ( int argc, char** args ) {
 }
 
 
+void GetVerticalVelocity ( const double &x, const std::vector < double > &h, std::vector < double > &w ) {
+  // same vertical velocity as in RK
+  std::vector < double > zTop ( NumberOfLayers );
+  zTop[0] = 0;
+  for ( unsigned k = 1; k < NumberOfLayers; k++ ) {
+    zTop[k] = zTop[k - 1] - h[k];
+  }
+  w[0] = w[NumberOfLayers] = 0.;
+  for ( unsigned k = NumberOfLayers; k > 1; k-- ) {
+    w[k - 1] = - 0.1 * zTop[k - 1];
+  }
+}
+
+
 void ETD2 ( MultiLevelProblem& ml_prob ) {
 
   const unsigned& NLayers = NumberOfLayers;
@@ -24,6 +24,8 @@
 #include "slepceps.h"
 #include <slepcmfn.h>
 
+#include "../include/tracerTransport.hpp"
+
 using namespace femus;
 
 double dt = 1./10.; //= dx / maxWaveSpeed * 0.85;
@@ -77,6 +79,10 @@ bool SetBoundaryCondition ( const std::vector < double >& x, const char SolName[
 void ETD ( MultiLevelProblem& ml_prob );
 void ETD2 ( MultiLevelProblem& ml_prob );
 
+void GetVerticalVelocity ( const double &x, const std::vector < double > &h, std::vector < double > &w );
+
+bool explicitTracerTransport = true; // subcycled flux-limited tracer step instead of ETD2
+
 
 int main ( int argc, char** args ) {
 
@@ -168,13 +174,23 @@ int main ( int argc, char** args ) {
   //mlSol.GetWriter()->SetDebugOutput(true);
   mlSol.GetWriter()->Write ( DEFAULT_OUTPUTDIR, "linear", print_vars, 0 );
 
+  TracerTransport transport ( mlSol.GetSolutionLevel ( mlMsh.GetNumberOfLevels() - 1u ), NumberOfLayers, VAN_LEER );
+  transport.SetVerticalVelocityFunction ( GetVerticalVelocity );
+  transport.SetHorizontalDiffusivity ( k_h );
+
   unsigned numberOfTimeSteps = 100; //17h=1020 with dt=60, 17h=10200 with dt=6
   for ( unsigned i = 0; i < numberOfTimeSteps; i++ ) {
     system.CopySolutionToOldSolution();
 //     dt = 60.;
     ETD ( ml_prob );
 //     dt = 60.;
-    ETD2 ( ml_prob );
+    if ( explicitTracerTransport ) {
+      unsigned subSteps = transport.Step ( dt );
+      std::cout << "tracer transport substeps = " << subSteps << std::endl;
+    }
+    else {
+      ETD2 ( ml_prob );
+    }
     mlSol.GetWriter()->Write ( DEFAULT_OUTPUTDIR, "linear", print_vars, ( i + 1 ) / 1 );
   }
   return 0;
@@ -535,6 +551,23 @@ void ETD ( MultiLevelProblem& ml_prob ) {
 }
 
 
+void GetVerticalVelocity ( const double &x, const std::vector < double > &h, std::vector < double > &w ) {
+  // same vertical velocity as in ETD2
+  double b = InitalValueB ( std::vector < double > ( 1, x ) );
+  std::vector < double > zMid ( NumberOfLayers );
+  for ( unsigned k = 0; k < NumberOfLayers; k++ ) {
+    zMid[k] = -b + h[k] / 2.;
+    for ( unsigned i = k + 1; i < NumberOfLayers; i++ ) {
+      zMid[k] += h[i];
+    }
+  }
+  w[0] = w[NumberOfLayers] = 0.;
+  for ( unsigned k = NumberOfLayers; k > 1; k-- ) {
+    w[k - 1] = - 0.1 * zMid[k - 1];
+  }
+}
+
+
 void ETD2 ( MultiLevelProblem& ml_prob ) {
 
   const unsigned& NLayers = NumberOfLayers;
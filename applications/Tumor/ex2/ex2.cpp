@@ -18,12 +18,13 @@
 #include "NonLinearImplicitSystem.hpp"
 #include "adept.h"
 #include "Marker.hpp"
+#include "VoxelData.hpp"
 
 using namespace femus;
 
 void getKFromFile (MultiLevelSolution &mlCubeSol);
 
-void ProjectK (MultiLevelSolution &mlCubeSol, MultiLevelSolution &mlSphereSol);
+void ProjectK (const std::string &filename, MultiLevelSolution &mlSphereSol);
 
 double GetTimeStep (const double time) {
   double dt = .01;
@@ -221,7 +222,7 @@ int main (int argc, char** args) {
 //     mlSol.Initialize ("u", InitalValueU3D);
 //     mlSol.Initialize ("d", InitalValueD);
 // 
-//     ProjectK (mlSolCube, mlSol);
+//     ProjectK ("./input/TensorData.raw", mlSol);
 // 
 //     // attach the boundary condition function and generate boundary data
 //     mlSol.AttachSetBoundaryConditionFunction (SetBoundaryCondition);
@@ -683,162 +684,46 @@ bool GetDeadCells (const double &time, MultiLevelSolution &mlSol) {
 }
 
 
-void ProjectK (MultiLevelSolution &mlCubeSol, MultiLevelSolution &mlSphereSol) {
+/** Open the voxel tensor data: a header with n1, n2, n3 (unsigned) followed by the 6 tensor components of every voxel
+ * in C order [n1][n2][n3][6] (double), the voxels are cubes of side 0.01 starting from the origin */
+VoxelData* OpenKFile (const std::string &filename, unsigned long &headerBytes) {
 
-
-  unsigned cLevel = mlCubeSol._mlMesh->GetNumberOfLevels() - 1;
-  unsigned sLevel = mlSphereSol._mlMesh->GetNumberOfLevels() - 1;
-
-  Solution *cSol  = mlCubeSol.GetSolutionLevel (cLevel);
-  Mesh     *cMsh   = mlCubeSol._mlMesh->GetLevel (cLevel);
-
-  Solution *sSol  = mlSphereSol.GetSolutionLevel (sLevel);
-  Mesh     *sMsh   = mlSphereSol._mlMesh->GetLevel (sLevel);
-
-  unsigned iproc  = cMsh->processor_id();
-  unsigned nprocs  = cMsh->n_processors();
-
-  std::string kname[6] = {"K11", "K12", "K13", "K22", "K23", "K33"};
-
-  unsigned cKIndex[6];
-  unsigned sKIndex[6];
-  for (unsigned i = 0; i < 6; i++) {
-    cKIndex[i] = mlCubeSol.GetIndex (kname[i].c_str());
-    sKIndex[i] = mlSphereSol.GetIndex (kname[i].c_str());
+  std::ifstream fin (filename.c_str(), std::ios::binary);
+  if (!fin.is_open()) {
+    std::cout << std::endl << " The input file " << filename << " cannot be opened.\n";
+    abort();
   }
+  unsigned n[3];
+  fin.read (reinterpret_cast < char* > (n), 3 * sizeof (unsigned));
+  fin.close();
 
-  unsigned cKType = mlCubeSol.GetSolutionType (cKIndex[0]);
-  unsigned sKType = mlSphereSol.GetSolutionType (sKIndex[0]);
-
-  const unsigned  dim = sMsh->GetDimension(); // get the domain dimension of the problem
-
-  std::vector<double> x (dim);
-  std::vector<double> phi (dim);
-
-  for (unsigned inode = 0; inode < sMsh->_dofOffset[sKType][nprocs]; inode++) {
-
-    unsigned sProc = 0;
-    while (inode > sMsh->_dofOffset[sKType][sProc + 1]) {
-      sProc++;
-    }
+  headerBytes = 3 * sizeof (unsigned);
 
-    if (sProc == iproc) {
-      for (unsigned k = 0; k < dim; k++) {
-        x[k] = (*sMsh->_topology->_Sol[k]) (inode);     // global extraction and local storage for the element coordinates
-      }
-    }
-    MPI_Bcast (&x[0], dim, MPI_DOUBLE, sProc, MPI_COMM_WORLD);
-
-    Marker i = Marker (x, 1., VOLUME , cSol, cKType);
+  double h = 0.01;
+  std::vector < unsigned > nv (n, n + 3);
+  std::vector < double > origin (3, 0.);
+  std::vector < double > hv (3, h);
 
-    unsigned cProc = i.GetMarkerProc (cSol);
+  return new VoxelData (nv, origin, hv, 6);
+}
 
-    if (cProc == iproc) {
-      unsigned iel = i.GetMarkerElement();
-      short unsigned ielGeom = cMsh->GetElementType (iel);
-      unsigned nDofK  = cMsh->GetElementDofNumber (iel, cKType); // number of solution element dofs
 
+void ProjectK (const std::string &filename, MultiLevelSolution &mlSphereSol) {
 
-      std::vector <double> xi = i.GetMarkerLocalCoordinates();
-      basis* base = cMsh->GetBasis (ielGeom, cKType);
+  // every process reads the voxels around its own elements and samples them at its own dofs
+  unsigned long headerBytes;
+  VoxelData* voxelK = OpenKFile (filename, headerBytes);
 
-      phi.resize (nDofK);
-      for (unsigned i = 0; i < nDofK; i++) {
-        phi[i] = base->eval_phi (i, xi);
-      }
-      double value[6] = {0., 0., 0., 0., 0., 0.};
-      for (unsigned i = 0; i < nDofK; i++) {
-        unsigned solDof = cMsh->GetSolutionDof (i, iel, cKType);   // global to global mapping between solution node and solution dof
-        for (unsigned j = 0; j < 6; j++) {
-          value[j] += phi[i] * (*cSol->_Sol[cKIndex[j]]) (solDof);                 // global extraction and local storage for the solution
-        }
-      }
+  unsigned sLevel = mlSphereSol._mlMesh->GetNumberOfLevels() - 1;
+  voxelK->ReadRaw (filename, mlSphereSol._mlMesh->GetLevel (sLevel), headerBytes);
 
-      MPI_Send (value, 6, MPI_DOUBLE, sProc, 1, MPI_COMM_WORLD);
+  std::string kname[6] = {"K11", "K12", "K13", "K22", "K23", "K33"};
+  voxelK->Project (mlSphereSol, std::vector < std::string > (kname, kname + 6));
 
-    }
-    if (iproc == sProc) {
-      double value[6];
-      MPI_Recv (value, 6, MPI_DOUBLE, cProc, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-      for (unsigned j = 0; j < 6; j++) {
-        sSol->_Sol[sKIndex[j]]->set (inode, value[j]);
-      }
-    }
-  }
-  for (unsigned j = 0; j < 6; j++) {
-    sSol->_Sol[sKIndex[j]]->close();
-  }
+  delete voxelK;
 }
 
 
-void getKFromFile (MultiLevelSolution &mlSol){
-  
-  unsigned Level = mlSol._mlMesh->GetNumberOfLevels() - 1;
-    
-  Solution *sol  = mlSol.GetSolutionLevel (Level);
-  Mesh     *msh   = mlSol._mlMesh->GetLevel (Level);
-  
-  std::ifstream fin;
-  
-  fin.open( "./input/TensorData.txt" );
-  if( !fin.is_open() ) {
-    std::cout << std::endl << " The output file " << "./input/tensor.txt" << " cannot be opened.\n";
-    abort();
-  }
-  
-  unsigned n1,n2,n3;
-  fin >> n1; 
-  fin >> n2;
-  fin >> n3;
-  
-  
-  std::string kname[6] = {"K11", "K12", "K13", "K22", "K23", "K33"};
-  
-  unsigned kIndex[6];
-  for (unsigned i = 0; i < 6; i++) {
-    kIndex[i] = mlSol.GetIndex (kname[i].c_str());
-  }
-  
-  unsigned kType = mlSol.GetSolutionType (kIndex[0]);
-  
-  const unsigned  dim = msh->GetDimension(); // get the domain dimension of the problem
-  std::vector<double> x (dim);
-  double h = 0.01;
-  
-  unsigned iproc  = msh->processor_id();
-  
-  for(unsigned i = 0;i < n1; i++){
-    for(unsigned j = 0; j < n2; j++){
-      for(unsigned k = 0; k < n3; k++){
-        x[0] = h * i + 0.5 * h;
-        x[1] = h * j + 0.5 * h;
-        x[2] = h * k + 0.5 * h;
-                
-        double value[6];
-        for (unsigned l = 0; l < 6; l++) {
-          fin >> value[l];
-        }
-        
-        Marker i = Marker (x, 1., VOLUME , sol, 0);
-        unsigned mproc = i.GetMarkerProc (sol);
-        
-        if (mproc == iproc) {
-          unsigned iel = i.GetMarkerElement();
-          for (unsigned l = 0; l < 6; l++) {       
-            sol->_Sol[kIndex[l]]->set (iel, value[l]);
-          }
-        }
-        
-      }
-    }
-  }
-  
-  for (unsigned l = 0; l < 6; l++) {
-    sol->_Sol[kIndex[l]]->close();
-  }
-  
-  fin.close();
-  
-  
-  
+void getKFromFile (MultiLevelSolution &mlSol) {
+  ProjectK ("./input/TensorData.raw", mlSol);
 }
@@ -29,6 +29,9 @@ unsigned L = 6; //max refinement level
 bool output = false; //for debugging
 bool matlabView = true;
 bool histoView = false;
+bool adaptive = true; //dimension-adaptive index set instead of the isotropic one
+double adaptiveTolerance = 1.e-3;
+unsigned maxNumberOfWs = 200;
 
 double xmin = - 5.5;   //-1.5 for uniform // -5.5 for Gaussian
 double xmax = 5.5;     //1.5 for uniform // 5.5 for Gaussian
@@ -105,7 +108,14 @@ int main ( int argc, char** argv )
               << static_cast<double> ( ( clock() - grid_time ) ) / CLOCKS_PER_SEC << " s" << std::endl;
 
     clock_t nodal_time = clock();
-    spg.EvaluateNodalValuesPDF ( samples );
+    if ( adaptive ) {
+        spg.BuildDimensionAdaptive ( samples, adaptiveTolerance, maxNumberOfWs );
+    }
+    else {
+        spg.EvaluateNodalValuesPDF ( samples );
+    }
+
+    std::cout << " Number of W sets = " << spg.GetNumberOfWs() << " , number of dofs = " << spg.GetNumberOfDofs() << std::endl;
 //     spg.PrintNodalValuesPDF();
 
     std::cout << std::endl << " Builds nodal values in: " << std::setw ( 11 ) << std::setprecision ( 6 ) << std::fixed
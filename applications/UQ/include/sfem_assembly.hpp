@@ -39,6 +39,10 @@ boost::mt19937 rng1; // I don't seed it on purpouse (it's not relevant)
 boost::random::uniform_real_distribution<> un ( - 1., 1. );
 boost::variate_generator < boost::mt19937&, boost::random::uniform_real_distribution<> > var_unif ( rng1, un );
 
+//FOR SAMPLES PRESCRIBED OUTSIDE THE ASSEMBLY (e.g. multilevel Monte Carlo)
+bool useGivenSample = false;
+std::vector <double> givenSample;
+
 double GetExactSolutionLaplace ( const std::vector < double >& x )
 {
     double pi = acos ( -1. );
@@ -135,7 +139,11 @@ void AssembleUQSys ( MultiLevelProblem& ml_prob )
     std::vector <double> yOmega ( numberOfEigPairs, 0. );
 
     for ( unsigned eig = 0; eig < numberOfEigPairs; eig++ ) {
-        if ( iproc == 0 ) {
+        if ( useGivenSample ) {
+            yOmega[eig] = givenSample[eig];
+        }
+
+        else if ( iproc == 0 ) {
             if ( quadratureType == 0 ) {
                 yOmega[eig] = var_nor();
             }
@@ -219,6 +219,9 @@ int main (int argc, char** args) {
       // attach the assembling function to system
       system.SetAssembleFunction (AssembleWillmoreProblem_AD);
 
+      // the line search trial steps are assembled without the Jacobian
+      system.SetLineSearch (CUBIC_LINE_SEARCH);
+
       // initilaize and solve the system
       system.init();
       system.MGsolve();
@@ -338,6 +341,11 @@ void AssembleWillmoreProblem_AD (MultiLevelProblem& ml_prob) {
   NonLinearImplicitSystem* mlPdeSys   = &ml_prob.get_system<NonLinearImplicitSystem> ("Willmore");   // pointer to the linear implicit system named "Poisson"
 
   const unsigned level = mlPdeSys->GetLevelToAssemble();
+  bool assembleMatrix = mlPdeSys->GetAssembleMatrix();
+
+  // without the matrix there is no need to record the tape
+  if (assembleMatrix) s.continue_recording();
+  else s.pause_recording();
 
   Mesh*          msh          = ml_prob._ml_msh->GetLevel (level);   // pointer to the mesh (level) object
   elem*          el         = msh->el;  // pointer to the elem object in msh (level)
@@ -408,7 +416,7 @@ void AssembleWillmoreProblem_AD (MultiLevelProblem& ml_prob) {
   vector < double > Jac; // local Jacobian matrix (ordered by column, adept)
   Jac.reserve (4 * maxSize * maxSize);
 
-  KK->zero(); // Set to zero all the entries of the Global Matrix
+  if (assembleMatrix) KK->zero(); // Set to zero all the entries of the Global Matrix
 
   // element loop: each process loops only on the elements that owns
   for (int iel = msh->_elementOffset[iproc]; iel < msh->_elementOffset[iproc + 1]; iel++) {
@@ -452,7 +460,7 @@ void AssembleWillmoreProblem_AD (MultiLevelProblem& ml_prob) {
     }
 
     // start a new recording of all the operations involving adept::adouble variables
-    s.new_recording();
+    if (assembleMatrix) s.new_recording();
 
     // *** Gauss point loop ***
     for (unsigned ig = 0; ig < msh->_finiteElement[ielGeom][soluType]->GetGaussPointNumber(); ig++) {
@@ -569,25 +577,29 @@ void AssembleWillmoreProblem_AD (MultiLevelProblem& ml_prob) {
 
     RES->add_vector_blocked (Res, sysDof);
 
-    Jac.resize ( (2. * nDofs) * (2. * nDofs));
-    // define the dependent variables
-    s.dependent (&aResu[0], nDofs);
-    s.dependent (&aResW[0], nDofs);
+    if (assembleMatrix) {
+      Jac.resize ( (2. * nDofs) * (2. * nDofs));
+      // define the dependent variables
+      s.dependent (&aResu[0], nDofs);
+      s.dependent (&aResW[0], nDofs);
 
-    // define the independent variables
-    s.independent (&solu[0], nDofs);
-    s.independent (&solW[0], nDofs);
-    // get the jacobian matrix (ordered by row)
-    s.jacobian (&Jac[0], true);
+      // define the independent variables
+      s.independent (&solu[0], nDofs);
+      s.independent (&solW[0], nDofs);
+      // get the jacobian matrix (ordered by row)
+      s.jacobian (&Jac[0], true);
 
-    KK->add_matrix_blocked (Jac, sysDof, sysDof);
+      KK->add_matrix_blocked (Jac, sysDof, sysDof);
 
-    s.clear_independents();
-    s.clear_dependents();
+      s.clear_independents();
+      s.clear_dependents();
+    }
   } //end element loop for each process
 
   RES->close();
-  KK->close();
+  if (assembleMatrix) KK->close();
+
+  s.continue_recording();
 
   // ***************** END ASSEMBLY *******************
 }
@@ -290,7 +290,7 @@ void AssemblePoissonProblem(MultiLevelProblem& ml_prob) {
 
     Res.assign(nDofu,0.);    //resize and set to zero
 
-    Jac.resize(nDofu * nDofu, 0);    //resize and set to zero
+    Jac.assign(nDofu * nDofu, 0.);    //resize and set to zero
     
 
     // local storage of global mapping and solution
@@ -110,6 +110,7 @@ int main(int argc, char** args) {
 
       // attach the assembling function to system
       system.SetAssembleFunction(AssembleNonlinearProblem_AD);
+      system.SetOverlapGhostUpdate(true);
 
       // initilaize and solve the system
       system.init();
@@ -499,8 +500,16 @@ void AssembleNonlinearProblem_AD(MultiLevelProblem& ml_prob) {
 
   KK->zero(); // Set to zero all the entries of the Global Matrix
 
-  // element loop: each process loops only on the elements that owns
-  for (int iel = msh->_elementOffset[iproc]; iel < msh->_elementOffset[iproc + 1]; iel++) {
+  // element loop: each process loops only on the elements that owns, first on those with no ghost dofs,
+  // then, when the ghost values of u have arrived, on the interface elements
+  const std::vector < unsigned > &interiorElements = msh->GetInteriorElements();
+  const std::vector < unsigned > &interfaceElements = msh->GetInterfaceElements();
+  unsigned nInterior = interiorElements.size();
+
+  for (unsigned jel = 0; jel < nInterior + interfaceElements.size(); jel++) {
+
+    if (jel == nInterior) sol->EndGhostUpdate();
+    int iel = (jel < nInterior) ? interiorElements[jel] : interfaceElements[jel - nInterior];
 
 
     short unsigned ielGeom = msh->GetElementType(iel);
@@ -624,6 +633,8 @@ void AssembleNonlinearProblem_AD(MultiLevelProblem& ml_prob) {
 
   } //end element loop for each process
 
+  sol->EndGhostUpdate();
+
   RES->close();
 
   KK->close();
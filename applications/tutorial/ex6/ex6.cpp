@@ -19,11 +19,23 @@
 #include "VTKWriter.hpp"
 #include "GMVWriter.hpp"
 #include "NonLinearImplicitSystem.hpp"
+#include "PetscMatrix.hpp"
+#include "Assemble_jacobian.hpp"
 #include "adept.h"
 
+#include <ctime>
+
+// element Jacobian: 0 = adept (taped reverse mode), 1 = DualNumber (forward mode, no tape)
+#define JACOBIAN_DUAL_NUMBER 0
+// before the solve, assemble the finest level with both and check that they agree to round-off, with their timings
+#define JACOBIAN_BACKEND_CHECK 1
+
 
 using namespace femus;
 
+// at least the element dofs: 2 * 9 + 3 on the quadrilateral mesh, for cube_hex.neu use 3 * 27 + 4 <= 128
+typedef DualNumber < 32 > DualNumberNS;
+
 bool SetBoundaryCondition(const std::vector < double >& x, const char SolName[], double& value, const int facename, const double time) {
   bool dirichlet = true; //dirichlet
 
@@ -51,8 +63,11 @@ bool SetBoundaryCondition(const std::vector < double >& x, const char SolName[],
 }
 
 
+template < class real_num >
 void AssembleBoussinesqAppoximation_AD(MultiLevelProblem& ml_prob);    //, unsigned level, const unsigned &levelMax, const bool &assembleMatrix );
 
+void CompareJacobianBackends(MultiLevelProblem& ml_prob, NonLinearImplicitSystem& system);
+
 
 int main(int argc, char** args) {
 
@@ -119,10 +134,19 @@ int main(int argc, char** args) {
   system.AddSolutionToSystemPDE("P");
 
   // attach the assembling function to system
-  system.SetAssembleFunction(AssembleBoussinesqAppoximation_AD);
+#if JACOBIAN_DUAL_NUMBER == 0
+  system.SetAssembleFunction(AssembleBoussinesqAppoximation_AD < adept::adouble >);
+#else
+  system.SetAssembleFunction(AssembleBoussinesqAppoximation_AD < DualNumberNS >);
+#endif
 
   // initilaize and solve the system
   system.init();
+
+#if JACOBIAN_BACKEND_CHECK == 1
+  CompareJacobianBackends(mlProb, system);
+#endif
+
   system.SetOuterSolver(PREONLY);
   system.MGsolve();
 
@@ -137,14 +161,16 @@ int main(int argc, char** args) {
 }
 
 
+template < class real_num >
 void AssembleBoussinesqAppoximation_AD(MultiLevelProblem& ml_prob) {
   //  ml_prob is the global object from/to where get/set all the data
   //  level is the level of the PDE system to be assembled
   //  levelMax is the Maximum level of the MultiLevelProblem
   //  assembleMatrix is a flag that tells if only the residual or also the matrix should be assembled
 
-  // call the adept stack object
+  // call the adept stack object, it is not used by the forward mode
   adept::Stack& s = FemusInit::_adeptStack;
+  const assemble_jacobian < real_num, double > assemble_jac;
 
   //  extract pointers to the several objects that we are going to use
   NonLinearImplicitSystem* mlPdeSys   = &ml_prob.get_system<NonLinearImplicitSystem> ("NS");   // pointer to the linear implicit system named "Poisson"
@@ -190,23 +216,23 @@ void AssembleBoussinesqAppoximation_AD(MultiLevelProblem& ml_prob) {
   unsigned solPPdeIndex;
   solPPdeIndex = mlPdeSys->GetSolPdeIndex("P");    // get the position of "P" in the pdeSys object
 
-  vector < vector < adept::adouble > >  solV(dim);    // local solution
-  vector < adept::adouble >  solP; // local solution
+  // local solution: the dim velocity components and then the pressure, in the order of sysDof
+  vector < vector < real_num > >  solVP(dim + 1);
+  vector < vector < real_num > > & solV = solVP;
+  vector < real_num > & solP = solVP[dim];
 
-  vector< vector < adept::adouble > > aResV(dim);    // local redidual vector
-  vector< adept::adouble > aResP; // local redidual vector
+  vector< real_num > aRes; // local redidual vector, in the order of sysDof
 
   vector < vector < double > > coordX(dim);    // local coordinates
   unsigned coordXType = 2; // get the finite element type for "x", it is always 2 (LAGRANGE QUADRATIC)
 
   for (unsigned  k = 0; k < dim; k++) {
     solV[k].reserve(maxSize);
-    aResV[k].reserve(maxSize);
     coordX[k].reserve(maxSize);
   }
 
   solP.reserve(maxSize);
-  aResP.reserve(maxSize);
+  aRes.reserve((dim + 1) * maxSize);
 
 
   vector <double> phiV;  // local test function for velocity
@@ -221,9 +247,6 @@ void AssembleBoussinesqAppoximation_AD(MultiLevelProblem& ml_prob) {
   vector< int > sysDof; // local to global pdeSys dofs
   sysDof.reserve((dim + 1) * maxSize);
 
-  vector< double > Res; // local redidual vector
-  Res.reserve((dim + 1) * maxSize);
-
   vector < double > Jac;
   Jac.reserve((dim + 1) * maxSize * (dim + 1) * maxSize);
 
@@ -248,10 +271,7 @@ void AssembleBoussinesqAppoximation_AD(MultiLevelProblem& ml_prob) {
     }
     solP.resize(nDofsP);
 
-    for (unsigned  k = 0; k < dim; k++) {
-      aResV[k].assign(nDofsV,0.);
-    }
-    aResP.assign(nDofsP,0.);
+    aRes.assign(nDofsVP, 0.);
 
     // local storage of global mapping and solution
     for (unsigned i = 0; i < nDofsV; i++) {
@@ -277,8 +297,8 @@ void AssembleBoussinesqAppoximation_AD(MultiLevelProblem& ml_prob) {
       }
     }
 
-    // start a new recording of all the operations involving adept::adouble variables
-    s.new_recording();
+    // adept: start a new recording of all the operations, DualNumber: give one derivative lane to each element dof
+    assemble_jac.prepare_before_integration_loop(s, solVP);
 
     // *** Gauss point loop ***
     for (unsigned ig = 0; ig < msh->_finiteElement[ielGeom][solVType]->GetGaussPointNumber(); ig++) {
@@ -286,8 +306,8 @@ void AssembleBoussinesqAppoximation_AD(MultiLevelProblem& ml_prob) {
       msh->_finiteElement[ielGeom][solVType]->Jacobian(coordX, ig, weight, phiV, phiV_x);
       phiP = msh->_finiteElement[ielGeom][solPType]->GetPhi(ig);
 
-      vector < adept::adouble > solV_gss(dim, 0);
-      vector < vector < adept::adouble > > gradSolV_gss(dim);
+      vector < real_num > solV_gss(dim, 0.);
+      vector < vector < real_num > > gradSolV_gss(dim);
 
       for (unsigned  k = 0; k < dim; k++) {
         gradSolV_gss[k].assign(dim,0.);
@@ -304,7 +324,7 @@ void AssembleBoussinesqAppoximation_AD(MultiLevelProblem& ml_prob) {
         }
       }
 
-      adept::adouble solP_gss = 0;
+      real_num solP_gss = 0.;
       for (unsigned i = 0; i < nDofsP; i++) {
         solP_gss += phiP[i] * solP[i];
       }
@@ -313,7 +333,7 @@ void AssembleBoussinesqAppoximation_AD(MultiLevelProblem& ml_prob) {
 
       // *** phiV_i loop ***
       for (unsigned i = 0; i < nDofsV; i++) {
-        vector < adept::adouble > NSV(dim, 0.);
+        vector < real_num > NSV(dim, 0.);
         
         for (unsigned  k = 0; k < dim; k++) { //momentum equation in k 
           for (unsigned j = 0; j < dim; j++) { // second index j in each equation
@@ -323,67 +343,78 @@ void AssembleBoussinesqAppoximation_AD(MultiLevelProblem& ml_prob) {
           NSV[k] += -solP_gss * phiV_x[i * dim + k]; // pressure gradient
         }
         for (unsigned  k = 0; k < dim; k++) {
-          aResV[k][i] += - NSV[k] * weight;
+          aRes[k * nDofsV + i] += - NSV[k] * weight;
         }
       } // end phiV_i loop
 
       // *** phiP_i loop ***
       for (unsigned i = 0; i < nDofsP; i++) {
         for (int k = 0; k < dim; k++) {
-          aResP[i] += - (gradSolV_gss[k][k]) * phiP[i]  * weight;
+          aRes[dim * nDofsV + i] += - (gradSolV_gss[k][k]) * phiP[i]  * weight;
         }
       } // end phiP_i loop
 
     } // end gauss point loop
 
     //--------------------------------------------------------------------------------------------------------
-    // Add the local Matrix/Vector into the global Matrix/Vector
+    // Add the local Matrix/Vector into the global Matrix/Vector: RES gets -aRes and KK the Jacobian of aRes (row-major)
+    Jac.resize(nDofsVP * nDofsVP);
+    assemble_jac.compute_jacobian_outside_integration_loop(s, solVP, aRes, Jac, sysDof, RES, KK);
 
-    //copy the value of the adept::adoube aRes in double Res and store them in RES
-    Res.resize(nDofsVP);    //resize
+  } //end element loop for each process
 
-    for (int i = 0; i < nDofsV; i++) {
-      for (unsigned  k = 0; k < dim; k++) {
-        Res[ k * nDofsV + i ] = -aResV[k][i].value();
-      }
-    }
+  RES->close();
+  KK->close();
+  // ***************** END ASSEMBLY *******************
+}
 
-    for (int i = 0; i < nDofsP; i++) {
-      Res[ dim * nDofsV + i ] = -aResP[i].value();
-    }
 
-    RES->add_vector_blocked(Res, sysDof);
 
-    //Extract and store the Jacobian
+/**
+ * Assemble the finest level with adept and with DualNumber, from the same solution, and compare the two Jacobians and residuals.
+ * They have to agree to round-off, the assembly times of the two backends are printed.
+ **/
+void CompareJacobianBackends(MultiLevelProblem& ml_prob, NonLinearImplicitSystem& system) {
 
-    Jac.resize(nDofsVP * nDofsVP);
-    // define the dependent variables
+  const unsigned level = system.GetGridn() - 1;
+  system.SetLevelToAssemble(level);
 
-    for (unsigned  k = 0; k < dim; k++) {
-      s.dependent(&aResV[k][0], nDofsV);
-    }
-    s.dependent(&aResP[0], nDofsP);
+  LinearEquationSolver* pdeSys = system._LinSolver[level];
+  PetscMatrix* KK = static_cast< PetscMatrix* >(pdeSys->_KK);
+  NumericVector* RES = pdeSys->_RES;
 
-    // define the independent variables
-    for (unsigned  k = 0; k < dim; k++) {
-      s.independent(&solV[k][0], nDofsV);
-    }
-    s.independent(&solP[0], nDofsP);
+  const unsigned nAssemblies = 5;
 
-    // get the and store jacobian matrix (row-major)
-    s.jacobian(&Jac[0] , true);
-    KK->add_matrix_blocked(Jac, sysDof, sysDof);
+  clock_t start = clock();
+  for (unsigned n = 0; n < nAssemblies; n++) AssembleBoussinesqAppoximation_AD < adept::adouble > (ml_prob);
+  const double adeptTime = static_cast < double >(clock() - start) / CLOCKS_PER_SEC / nAssemblies;
 
-    s.clear_independents();
-    s.clear_dependents();
+  Mat KKadept;
+  MatDuplicate(KK->mat(), MAT_COPY_VALUES, &KKadept);
+  std::unique_ptr < NumericVector > RESadept = RES->clone();
 
-  } //end element loop for each process
+  start = clock();
+  for (unsigned n = 0; n < nAssemblies; n++) AssembleBoussinesqAppoximation_AD < DualNumberNS > (ml_prob);
+  const double dualTime = static_cast < double >(clock() - start) / CLOCKS_PER_SEC / nAssemblies;
 
-  RES->close();
-  KK->close();
-  // ***************** END ASSEMBLY *******************
-}
+  double normKK, diffKK;
+  MatNorm(KKadept, NORM_INFINITY, &normKK);
+  MatAXPY(KKadept, -1., KK->mat(), SAME_NONZERO_PATTERN);
+  MatNorm(KKadept, NORM_INFINITY, &diffKK);
+  MatDestroy(&KKadept);
 
+  const double normRES = RESadept->linfty_norm();
+  RESadept->add(-1., *RES);
+  const double diffRES = RESadept->linfty_norm();
 
+  std::cout << "Jacobian backends on level " << level << ": |KK_adept - KK_dual| / |KK_adept| = " << diffKK / normKK
+            << ", |RES_adept - RES_dual| / |RES_adept| = " << ((normRES > 0.) ? diffRES / normRES : diffRES) << std::endl;
+  std::cout << "Assembly time: adept " << adeptTime << " s, DualNumber<" << DualNumberNS::numberOfLanes << "> " << dualTime
+            << " s, speed-up " << adeptTime / dualTime << std::endl;
 
+  if (diffKK > 1.e-12 * normKK || diffRES > 1.e-12 * normRES) {
+    std::cout << "Error in CompareJacobianBackends: the DualNumber and adept Jacobians differ beyond round-off" << std::endl;
+    abort();
+  }
 
+}
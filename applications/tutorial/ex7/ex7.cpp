@@ -148,6 +148,8 @@ int main(int argc, char** args) {
   system.SetPreconditionerFineGrids(ILU_PRECOND);
   //system.SetTolerances(1.e-20, 1.e-20, 1.e+50, 40);
   system.SetTolerances(1.e-3, 1.e-20, 1.e+50, 5);
+  // exact coarse solve: the coarse pattern does not change between the nonlinear iterations, only the numeric LU is redone
+  system.SetCoarseGridDirectSolver();
 
 
   system.ClearVariablesToBeSolved();
@@ -0,0 +1,15 @@
+#ifndef __femus_enums_ExplicitTimeSteppingEnum_hpp__
+#define __femus_enums_ExplicitTimeSteppingEnum_hpp__
+
+enum ExplicitTimeSteppingScheme {
+  CENTRAL_DIFFERENCE = 0,
+  SSP_RK2,
+  SSP_RK3
+};
+
+enum LumpedMassType {
+  ROW_SUM_LUMPING = 0,
+  HRZ_LUMPING
+};
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef __femus_enums_KKTPreconditionerTypeEnum_hpp__
+#define __femus_enums_KKTPreconditionerTypeEnum_hpp__
+
+enum KKTPreconditionerType {
+  KKT_BLOCK_DIAGONAL = 0,
+  KKT_BLOCK_TRIANGULAR,
+  KKT_SCHUR
+};
+
+
+#endif
@@ -29,7 +29,8 @@ enum PreconditionerType {
     FIELDSPLIT_MULTIPLICATIVE_PRECOND, 
     FIELDSPLIT_SYMMETRIC_MULTIPLICATIVE_PRECOND, 
     FIELDSPLIT_SCHUR_PRECOND, 
-    LSC_PRECOND
+    LSC_PRECOND,
+    GAMG_PRECOND
 };
 
 
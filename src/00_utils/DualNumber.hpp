@@ -0,0 +1,278 @@
+/*=========================================================================
+
+ Program: FEMuS
+ Module: DualNumber
+ Authors: Eugenio Aulisa
+
+ Copyright (c) FEMuS
+ All rights reserved.
+
+ This software is distributed WITHOUT ANY WARRANTY; without even
+ the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#ifndef __femus_utils_DualNumber_hpp__
+#define __femus_utils_DualNumber_hpp__
+
+#include <cmath>
+#include <iostream>
+
+namespace femus {
+
+  /**
+   * Forward mode automatic differentiation with N derivative lanes.
+   * A DualNumber carries its value and its derivatives with respect to N independent variables,
+   * the derivatives are a contiguous array of fixed size so that every operation is a short loop the compiler vectorizes.
+   * It replaces adept::adouble in the templated element assembly: the element unknowns are seeded with SetIndependent,
+   * and at the end of the element loop the row i of the element Jacobian is Res[i].derivative(j), with no tape.
+   * N has to be at least the number of element dofs of all the unknowns.
+   */
+  template < unsigned N >
+  class DualNumber {
+
+    public:
+
+      static const unsigned numberOfLanes = N;
+
+      DualNumber() : _value(0.) {
+        for(unsigned j = 0; j < N; j++) _d[j] = 0.;
+      }
+
+      DualNumber(const double &value) : _value(value) {
+        for(unsigned j = 0; j < N; j++) _d[j] = 0.;
+      }
+
+      DualNumber& operator=(const double &value) {
+        _value = value;
+        for(unsigned j = 0; j < N; j++) _d[j] = 0.;
+        return *this;
+      }
+
+      /** Make this number the independent variable of the lane j */
+      void SetIndependent(const unsigned &j) {
+        for(unsigned k = 0; k < N; k++) _d[k] = 0.;
+        _d[j] = 1.;
+      }
+
+      double value() const {
+        return _value;
+      }
+
+      double derivative(const unsigned &j) const {
+        return _d[j];
+      }
+
+      const double* derivatives() const {
+        return _d;
+      }
+
+      DualNumber& operator+=(const DualNumber &b) {
+        _value += b._value;
+        for(unsigned j = 0; j < N; j++) _d[j] += b._d[j];
+        return *this;
+      }
+
+      DualNumber& operator-=(const DualNumber &b) {
+        _value -= b._value;
+        for(unsigned j = 0; j < N; j++) _d[j] -= b._d[j];
+        return *this;
+      }
+
+      DualNumber& operator*=(const DualNumber &b) {
+        for(unsigned j = 0; j < N; j++) _d[j] = _d[j] * b._value + _value * b._d[j];
+        _value *= b._value;
+        return *this;
+      }
+
+      DualNumber& operator/=(const DualNumber &b) {
+        double ib = 1. / b._value;
+        _value *= ib;
+        for(unsigned j = 0; j < N; j++) _d[j] = (_d[j] - _value * b._d[j]) * ib;
+        return *this;
+      }
+
+      DualNumber& operator+=(const double &b) {
+        _value += b;
+        return *this;
+      }
+
+      DualNumber& operator-=(const double &b) {
+        _value -= b;
+        return *this;
+      }
+
+      DualNumber& operator*=(const double &b) {
+        _value *= b;
+        for(unsigned j = 0; j < N; j++) _d[j] *= b;
+        return *this;
+      }
+
+      DualNumber& operator/=(const double &b) {
+        return (*this) *= (1. / b);
+      }
+
+      /** Chain rule: value f(a), derivatives f'(a) * a' */
+      DualNumber Compose(const double &f, const double &df) const {
+        DualNumber c;
+        c._value = f;
+        for(unsigned j = 0; j < N; j++) c._d[j] = df * _d[j];
+        return c;
+      }
+
+    private:
+
+      double _d[N];
+      double _value;
+  };
+
+  // arithmetic
+  template < unsigned N > inline DualNumber<N> operator-(const DualNumber<N> &a) {
+    return a * (-1.);
+  }
+  template < unsigned N > inline DualNumber<N> operator+(const DualNumber<N> &a) {
+    return a;
+  }
+
+  template < unsigned N > inline DualNumber<N> operator+(DualNumber<N> a, const DualNumber<N> &b) {
+    return a += b;
+  }
+  template < unsigned N > inline DualNumber<N> operator+(DualNumber<N> a, const double &b) {
+    return a += b;
+  }
+  template < unsigned N > inline DualNumber<N> operator+(const double &a, DualNumber<N> b) {
+    return b += a;
+  }
+
+  template < unsigned N > inline DualNumber<N> operator-(DualNumber<N> a, const DualNumber<N> &b) {
+    return a -= b;
+  }
+  template < unsigned N > inline DualNumber<N> operator-(DualNumber<N> a, const double &b) {
+    return a -= b;
+  }
+  template < unsigned N > inline DualNumber<N> operator-(const double &a, const DualNumber<N> &b) {
+    return (-b) += a;
+  }
+
+  template < unsigned N > inline DualNumber<N> operator*(DualNumber<N> a, const DualNumber<N> &b) {
+    return a *= b;
+  }
+  template < unsigned N > inline DualNumber<N> operator*(DualNumber<N> a, const double &b) {
+    return a *= b;
+  }
+  template < unsigned N > inline DualNumber<N> operator*(const double &a, DualNumber<N> b) {
+    return b *= a;
+  }
+
+  template < unsigned N > inline DualNumber<N> operator/(DualNumber<N> a, const DualNumber<N> &b) {
+    return a /= b;
+  }
+  template < unsigned N > inline DualNumber<N> operator/(DualNumber<N> a, const double &b) {
+    return a /= b;
+  }
+  template < unsigned N > inline DualNumber<N> operator/(const double &a, const DualNumber<N> &b) {
+    return b.Compose(a / b.value(), -a / (b.value() * b.value()));
+  }
+
+  // comparisons act on the value
+  template < unsigned N > inline bool operator<(const DualNumber<N> &a, const DualNumber<N> &b) {
+    return a.value() < b.value();
+  }
+  template < unsigned N > inline bool operator<(const DualNumber<N> &a, const double &b) {
+    return a.value() < b;
+  }
+  template < unsigned N > inline bool operator<(const double &a, const DualNumber<N> &b) {
+    return a < b.value();
+  }
+  template < unsigned N > inline bool operator>(const DualNumber<N> &a, const DualNumber<N> &b) {
+    return a.value() > b.value();
+  }
+  template < unsigned N > inline bool operator>(const DualNumber<N> &a, const double &b) {
+    return a.value() > b;
+  }
+  template < unsigned N > inline bool operator>(const double &a, const DualNumber<N> &b) {
+    return a > b.value();
+  }
+  template < unsigned N > inline bool operator<=(const DualNumber<N> &a, const DualNumber<N> &b) {
+    return a.value() <= b.value();
+  }
+  template < unsigned N > inline bool operator<=(const DualNumber<N> &a, const double &b) {
+    return a.value() <= b;
+  }
+  template < unsigned N > inline bool operator<=(const double &a, const DualNumber<N> &b) {
+    return a <= b.value();
+  }
+  template < unsigned N > inline bool operator>=(const DualNumber<N> &a, const DualNumber<N> &b) {
+    return a.value() >= b.value();
+  }
+  template < unsigned N > inline bool operator>=(const DualNumber<N> &a, const double &b) {
+    return a.value() >= b;
+  }
+  template < unsigned N > inline bool operator>=(const double &a, const DualNumber<N> &b) {
+    return a >= b.value();
+  }
+  template < unsigned N > inline bool operator==(const DualNumber<N> &a, const DualNumber<N> &b) {
+    return a.value() == b.value();
+  }
+  template < unsigned N > inline bool operator==(const DualNumber<N> &a, const double &b) {
+    return a.value() == b;
+  }
+  template < unsigned N > inline bool operator!=(const DualNumber<N> &a, const DualNumber<N> &b) {
+    return a.value() != b.value();
+  }
+  template < unsigned N > inline bool operator!=(const DualNumber<N> &a, const double &b) {
+    return a.value() != b;
+  }
+
+  // functions
+  template < unsigned N > inline DualNumber<N> sqrt(const DualNumber<N> &a) {
+    double s = std::sqrt(a.value());
+    return a.Compose(s, 0.5 / s);
+  }
+  template < unsigned N > inline DualNumber<N> exp(const DualNumber<N> &a) {
+    double e = std::exp(a.value());
+    return a.Compose(e, e);
+  }
+  template < unsigned N > inline DualNumber<N> log(const DualNumber<N> &a) {
+    return a.Compose(std::log(a.value()), 1. / a.value());
+  }
+  template < unsigned N > inline DualNumber<N> sin(const DualNumber<N> &a) {
+    return a.Compose(std::sin(a.value()), std::cos(a.value()));
+  }
+  template < unsigned N > inline DualNumber<N> cos(const DualNumber<N> &a) {
+    return a.Compose(std::cos(a.value()), -std::sin(a.value()));
+  }
+  template < unsigned N > inline DualNumber<N> tan(const DualNumber<N> &a) {
+    double t = std::tan(a.value());
+    return a.Compose(t, 1. + t * t);
+  }
+  template < unsigned N > inline DualNumber<N> atan(const DualNumber<N> &a) {
+    return a.Compose(std::atan(a.value()), 1. / (1. + a.value() * a.value()));
+  }
+  template < unsigned N > inline DualNumber<N> fabs(const DualNumber<N> &a) {
+    return (a.value() < 0.) ? -a : a;
+  }
+  template < unsigned N > inline DualNumber<N> abs(const DualNumber<N> &a) {
+    return fabs(a);
+  }
+  template < unsigned N > inline DualNumber<N> pow(const DualNumber<N> &a, const double &b) {
+    double p = std::pow(a.value(), b - 1.);
+    return a.Compose(p * a.value(), b * p);
+  }
+  template < unsigned N > inline DualNumber<N> pow(const DualNumber<N> &a, const DualNumber<N> &b) {
+    return exp(b * log(a));
+  }
+  template < unsigned N > inline DualNumber<N> pow(const double &a, const DualNumber<N> &b) {
+    double p = std::pow(a, b.value());
+    return b.Compose(p, p * std::log(a));
+  }
+
+  template < unsigned N > inline std::ostream& operator<<(std::ostream& os, const DualNumber<N> &a) {
+    os << a.value();
+    return os;
+  }
+
+} //end namespace femus
+
+#endif
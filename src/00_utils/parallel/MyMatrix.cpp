@@ -33,14 +33,16 @@ namespace femus {
   }
 
   // ******************
-  template <class Type> MyMatrix<Type>::MyMatrix(const unsigned &rsize, const unsigned &csize, const Type value) {
+  template <class Type> MyMatrix<Type>::MyMatrix(const unsigned &rsize, const unsigned &csize, const Type value, const MPI_Comm &comm) {
     init();
+    SetCommunicator(comm);
     resize(rsize, csize, value);
   }
 
   // ******************
-  template <class Type> MyMatrix<Type>::MyMatrix(const std::vector < unsigned > &offset, const unsigned &csize, const Type value) {
+  template <class Type> MyMatrix<Type>::MyMatrix(const std::vector < unsigned > &offset, const unsigned &csize, const Type value, const MPI_Comm &comm) {
     init();
+    SetCommunicator(comm);
     resize(offset, csize, value);
   }
 
@@ -48,6 +50,7 @@ namespace femus {
   template <class Type> MyMatrix<Type>::MyMatrix(const MyVector < unsigned > &rowSize, const Type value) {
 
     init();
+    SetCommunicator(rowSize.GetCommunicator());
 
     _rowSize = rowSize;
     _begin = _rowSize.begin();
@@ -83,12 +86,30 @@ namespace femus {
     _matIsAllocated = true;
   }
 
+  //*******************
+  template <class Type> void MyMatrix<Type>::SetCommunicator(const MPI_Comm &comm) {
+
+    int iproc, nprocs;
+
+    _comm = comm;
+    MPI_Comm_rank(_comm, &iproc);
+    MPI_Comm_size(_comm, &nprocs);
+
+    _iproc = static_cast < unsigned >(iproc);
+    _nprocs = static_cast < unsigned >(nprocs);
+
+    _rowOffset.SetCommunicator(_comm);
+    _rowSize.SetCommunicator(_comm);
+    _matSize.SetCommunicator(_comm);
+  }
+
   //*******************
   template <class Type> void MyMatrix<Type>::init() {
     int iproc, nprocs;
 
-    MPI_Comm_rank(MPI_COMM_WORLD, &iproc);
-    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+    _comm = MPI_COMM_WORLD;
+    MPI_Comm_rank(_comm, &iproc);
+    MPI_Comm_size(_comm, &nprocs);
 
     _iproc = static_cast < unsigned >(iproc);
     _nprocs = static_cast < unsigned >(nprocs);
@@ -365,7 +386,7 @@ namespace femus {
       _mat.resize(_matSize[lproc]);
     }
 
-    MPI_Bcast(&_mat[0], _matSize[lproc], _MY_MPI_DATATYPE, lproc, MPI_COMM_WORLD);
+    MPI_Bcast(&_mat[0], _matSize[lproc], _MY_MPI_DATATYPE, lproc, _comm);
 
     _begin = _offset[lproc];
     _end = _offset[lproc + 1];
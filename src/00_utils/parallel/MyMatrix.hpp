@@ -38,12 +38,13 @@ namespace femus {
       MyMatrix();
 
       // ******************
-      MyMatrix(const unsigned &rsize, const unsigned &csize, const Type value = 0);
+      MyMatrix(const unsigned &rsize, const unsigned &csize, const Type value = 0, const MPI_Comm &comm = MPI_COMM_WORLD);
 
       // ******************
-      MyMatrix(const std::vector < unsigned > &offset, const unsigned &csize, const Type value = 0);
+      MyMatrix(const std::vector < unsigned > &offset, const unsigned &csize, const Type value = 0, const MPI_Comm &comm = MPI_COMM_WORLD);
 
       // ******************
+      /** The matrix takes the communicator of rowSize */
       MyMatrix(const MyVector < unsigned > &rowSize, const Type value = 0);
 
       // ******************
@@ -52,6 +53,13 @@ namespace femus {
       //*******************
       void init();
 
+      /** Set the communicator of the parallel layout, to be called before resize(offset) and scatter */
+      void SetCommunicator(const MPI_Comm &comm);
+
+      const MPI_Comm &GetCommunicator() const {
+        return _comm;
+      }
+
       // ******************
       void resize(const unsigned &rsize, const unsigned &csize, const Type value = 0);
 
@@ -150,6 +158,7 @@ namespace femus {
       bool _serial;
       bool _matIsAllocated;
 
+      MPI_Comm _comm;
       unsigned _iproc;
       unsigned _nprocs;
       MPI_Datatype _MY_MPI_DATATYPE;
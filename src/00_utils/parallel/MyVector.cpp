@@ -33,14 +33,16 @@ namespace femus {
   }
 
   // ******************
-  template <class Type> MyVector<Type>::MyVector(const unsigned &size, const Type value) {
+  template <class Type> MyVector<Type>::MyVector(const unsigned &size, const Type value, const MPI_Comm &comm) {
     init();
+    SetCommunicator(comm);
     resize(size, value);
   }
 
   // ******************
-  template <class Type> MyVector<Type>::MyVector(const std::vector < unsigned > &offset, const Type value) {
+  template <class Type> MyVector<Type>::MyVector(const std::vector < unsigned > &offset, const Type value, const MPI_Comm &comm) {
     init();
+    SetCommunicator(comm);
     resize(offset, value);
   }
 
@@ -50,15 +52,22 @@ namespace femus {
   }
   
   // ******************
-  template <class Type> void MyVector<Type>::init() {
+  template <class Type> void MyVector<Type>::SetCommunicator(const MPI_Comm &comm) {
 
     int iproc, nprocs;
 
-    MPI_Comm_rank(MPI_COMM_WORLD, &iproc);
-    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+    _comm = comm;
+    MPI_Comm_rank(_comm, &iproc);
+    MPI_Comm_size(_comm, &nprocs);
 
     _iproc = static_cast < unsigned >(iproc);
     _nprocs = static_cast < unsigned >(nprocs);
+  }
+
+  // ******************
+  template <class Type> void MyVector<Type>::init() {
+
+    SetCommunicator(MPI_COMM_WORLD);
 
      Type dummy = 0;
     _MY_MPI_DATATYPE = boost::mpi::get_mpi_datatype(dummy);
@@ -176,8 +185,8 @@ namespace femus {
     
     for(unsigned jproc = 0; jproc<_nprocs; jproc++ ){
       if(jproc != _iproc){
-	MPI_Send(&_size, 1, MPI_UNSIGNED, jproc, 1, MPI_COMM_WORLD);
-	MPI_Recv(&_offset[jproc+1], 1, MPI_UNSIGNED, jproc, 1, MPI_COMM_WORLD, NULL);
+	MPI_Send(&_size, 1, MPI_UNSIGNED, jproc, 1, _comm);
+	MPI_Recv(&_offset[jproc+1], 1, MPI_UNSIGNED, jproc, 1, _comm, NULL);
       }
       else{
 	_offset[_iproc+1]=_size;
@@ -234,7 +243,7 @@ namespace femus {
       _vec.resize(_offset[lproc + 1] - _offset[lproc]);
     }
 
-    MPI_Bcast(&_vec[0], _vec.size(), _MY_MPI_DATATYPE, lproc, MPI_COMM_WORLD);
+    MPI_Bcast(&_vec[0], _vec.size(), _MY_MPI_DATATYPE, lproc, _comm);
 
     _begin = _offset[lproc];
     _end = _offset[lproc + 1];
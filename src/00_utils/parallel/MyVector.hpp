@@ -38,10 +38,10 @@ namespace femus {
       MyVector();
 
       // ******************
-      MyVector(const unsigned &size, const Type value = 0);
+      MyVector(const unsigned &size, const Type value = 0, const MPI_Comm &comm = MPI_COMM_WORLD);
 
       // ******************
-      MyVector(const std::vector < unsigned > &offset, const Type value = 0);
+      MyVector(const std::vector < unsigned > &offset, const Type value = 0, const MPI_Comm &comm = MPI_COMM_WORLD);
 
       // ******************
       ~MyVector();
@@ -49,6 +49,13 @@ namespace femus {
       // ******************
       void init();
 
+      /** Set the communicator of the parallel layout, to be called before resize(offset) and scatter */
+      void SetCommunicator(const MPI_Comm &comm);
+
+      const MPI_Comm &GetCommunicator() const {
+        return _comm;
+      }
+
       //*******************
       void resize(const unsigned &size, const Type value = 0);
 
@@ -125,6 +132,7 @@ namespace femus {
       bool _serial;
       bool _vecIsAllocated;
 
+      MPI_Comm _comm;
       unsigned _iproc;
       unsigned _nprocs;
       MPI_Datatype _MY_MPI_DATATYPE;
@@ -36,9 +36,9 @@ public:
 
     /** Constructor. Requires a reference to the communicator
      * that defines the object's parallel decomposition. */
-    ParallelObject () {
-        MPI_Comm_rank(MPI_COMM_WORLD, &_iproc);
-        MPI_Comm_size(MPI_COMM_WORLD, &_nprocs);
+    ParallelObject (const MPI_Comm &comm = MPI_COMM_WORLD) : _comm(comm) {
+        MPI_Comm_rank(_comm, &_iproc);
+        MPI_Comm_size(_comm, &_nprocs);
     }
 
     /** Destructor. Virtual because we are a base class. */
@@ -54,9 +54,15 @@ public:
         return _iproc;
     }
 
+    /** @returns the communicator of the group. */
+    const MPI_Comm &GetCommunicator() const {
+        return _comm;
+    }
+
 
 protected:
 
+    MPI_Comm _comm;
     int _nprocs;
     int _iproc;
 
@@ -0,0 +1,146 @@
+/*=========================================================================
+
+ Program: FEMuS
+ Module: SharedMemoryBuffer
+ Authors: Eugenio Aulisa
+
+ Copyright (c) FEMuS
+ All rights reserved.
+
+ This software is distributed WITHOUT ANY WARRANTY; without even
+ the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include <cstring>
+
+#include <boost/mpi/datatype.hpp>
+
+#include "SharedMemoryBuffer.hpp"
+
+namespace femus {
+
+  bool SharedMemory::_enabled = false;
+
+  // ******************
+  template <class Type> SharedMemoryBuffer<Type>::SharedMemoryBuffer(const unsigned &n, const MPI_Comm &comm) {
+
+    _size = n;
+    _comm = comm;
+    Type dummy = 0;
+    _datatype = boost::mpi::get_mpi_datatype(dummy);
+
+    _shared = SharedMemory::GetEnabled();
+    _nodeComm = MPI_COMM_NULL;
+    _leaderComm = MPI_COMM_NULL;
+    _nodeRank = 0;
+    _data = NULL;
+
+#if MPI_VERSION >= 3
+    if(_shared) {
+      int iproc, nprocs;
+      MPI_Comm_rank(_comm, &iproc);
+      MPI_Comm_size(_comm, &nprocs);
+
+      MPI_Comm_split_type(_comm, MPI_COMM_TYPE_SHARED, iproc, MPI_INFO_NULL, &_nodeComm);
+      MPI_Comm_rank(_nodeComm, &_nodeRank);
+      MPI_Comm_split(_comm, (_nodeRank == 0) ? 0 : MPI_UNDEFINED, iproc, &_leaderComm);
+
+      // the node leader allocates the whole segment, the other processes of the node point to it
+      MPI_Aint size = (_nodeRank == 0) ? static_cast < MPI_Aint >(_size) * sizeof(Type) : 0;
+      MPI_Win_allocate_shared(size, sizeof(Type), MPI_INFO_NULL, _nodeComm, &_data, &_win);
+      if(_nodeRank != 0) {
+        MPI_Aint leaderSize;
+        int displacementUnit;
+        MPI_Win_shared_query(_win, 0, &leaderSize, &displacementUnit, &_data);
+      }
+      MPI_Win_fence(0, _win);
+    }
+    else
+#endif
+    {
+      _owned.resize(_size);
+      if(_size > 0) _data = &_owned[0];
+    }
+  }
+
+  // ******************
+  template <class Type> SharedMemoryBuffer<Type>::~SharedMemoryBuffer() {
+#if MPI_VERSION >= 3
+    if(_shared) {
+      int finalized;
+      MPI_Finalized(&finalized);
+      if(!finalized) {
+        MPI_Win_free(&_win);
+        if(_leaderComm != MPI_COMM_NULL) MPI_Comm_free(&_leaderComm);
+        MPI_Comm_free(&_nodeComm);
+      }
+    }
+#endif
+  }
+
+  // ******************
+  template <class Type> void SharedMemoryBuffer<Type>::Fence() {
+#if MPI_VERSION >= 3
+    MPI_Win_fence(0, _win);
+#endif
+  }
+
+  // ******************
+  template <class Type> void SharedMemoryBuffer<Type>::Broadcast(const Type *values, const unsigned &lproc) {
+
+    int iproc;
+    MPI_Comm_rank(_comm, &iproc);
+
+    if(_shared) {
+      // lproc writes into its node segment, then the node leaders broadcast it among themselves
+      int leaderRank = (_leaderComm != MPI_COMM_NULL) ? 0 : -1;
+      if(_leaderComm != MPI_COMM_NULL) MPI_Comm_rank(_leaderComm, &leaderRank);
+      MPI_Bcast(&leaderRank, 1, MPI_INT, 0, _nodeComm);
+      MPI_Bcast(&leaderRank, 1, MPI_INT, lproc, _comm);
+
+      if(static_cast < unsigned >(iproc) == lproc && _size > 0) {
+        memcpy(_data, values, _size * sizeof(Type));
+      }
+      Fence();
+      if(_leaderComm != MPI_COMM_NULL && _size > 0) {
+        MPI_Bcast(_data, _size, _datatype, leaderRank, _leaderComm);
+      }
+      Fence();
+    }
+    else if(_size > 0) {
+      if(static_cast < unsigned >(iproc) == lproc) {
+        memcpy(_data, values, _size * sizeof(Type));
+      }
+      MPI_Bcast(_data, _size, _datatype, lproc, _comm);
+    }
+  }
+
+  // ******************
+  template <class Type> void SharedMemoryBuffer<Type>::Set(const Type *values) {
+
+    if(_shared) {
+      if(_nodeRank == 0 && _size > 0) {
+        memcpy(_data, values, _size * sizeof(Type));
+      }
+      Fence();
+    }
+    else if(_size > 0) {
+      memcpy(_data, values, _size * sizeof(Type));
+    }
+  }
+
+  // Explicit template instantiation
+  template class SharedMemoryBuffer<float>;
+  template class SharedMemoryBuffer<double>;
+  template class SharedMemoryBuffer<long double>;
+  template class SharedMemoryBuffer<int>;
+  template class SharedMemoryBuffer<short int>;
+  template class SharedMemoryBuffer<long int>;
+  template class SharedMemoryBuffer<short unsigned int>;
+  template class SharedMemoryBuffer<unsigned int>;
+  template class SharedMemoryBuffer<long unsigned int>;
+  template class SharedMemoryBuffer<char>;
+
+} //end namespace femus
@@ -0,0 +1,115 @@
+/*=========================================================================
+
+ Program: FEMuS
+ Module: SharedMemoryBuffer
+ Authors: Eugenio Aulisa
+
+ Copyright (c) FEMuS
+ All rights reserved.
+
+ This software is distributed WITHOUT ANY WARRANTY; without even
+ the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#ifndef __femus_parallel_SharedMemoryBuffer_hpp__
+#define __femus_parallel_SharedMemoryBuffer_hpp__
+
+#include <vector>
+
+#include <mpi.h>
+
+namespace femus {
+
+  /**
+   * Switch for the node-shared storage of the replicated read-only arrays (SharedMemoryBuffer).
+   * When enabled, these arrays are stored once per node instead of once per process. It needs an MPI-3 library.
+   */
+  class SharedMemory {
+
+    public:
+
+      /** Enable or disable the node-shared storage, it has to be called with the same value on all the processes */
+      static void SetEnabled(const bool &value) {
+        _enabled = value;
+      }
+
+      static bool GetEnabled() {
+#if MPI_VERSION >= 3
+        return _enabled;
+#else
+        return false;
+#endif
+      }
+
+    private:
+
+      static bool _enabled;
+  };
+
+
+  /**
+   * Read-only array of fixed size replicated on all the processes of a communicator.
+   * When SharedMemory is enabled, the values live in one MPI_Win_allocate_shared segment per node, allocated
+   * in the constructor and released in the destructor, otherwise every process owns its copy.
+   * The data pointer is fixed at construction, so the accessor is a plain load. The buffer is not copyable.
+   */
+  template <class Type> class SharedMemoryBuffer {
+
+    public:
+
+      /** Allocate n values, collective on comm */
+      SharedMemoryBuffer(const unsigned &n, const MPI_Comm &comm = MPI_COMM_WORLD);
+
+      /** Release the segment, collective on comm */
+      ~SharedMemoryBuffer();
+
+      /** Copy the n values of the process lproc of comm on every process, collective on comm */
+      void Broadcast(const Type *values, const unsigned &lproc);
+
+      /** Store n values that are already the same on all the processes, collective on comm */
+      void Set(const Type *values);
+
+      const Type& operator[](const unsigned &i) const {
+        return _data[i];
+      }
+
+      const Type* GetData() const {
+        return _data;
+      }
+
+      unsigned size() const {
+        return _size;
+      }
+
+      const MPI_Comm &GetCommunicator() const {
+        return _comm;
+      }
+
+    private:
+
+      SharedMemoryBuffer(const SharedMemoryBuffer &other) = delete;
+      SharedMemoryBuffer& operator=(const SharedMemoryBuffer &other) = delete;
+
+      /** Synchronize the writes into the node segment with the reads of the other processes of the node */
+      void Fence();
+
+      Type *_data;
+      unsigned _size;
+      MPI_Comm _comm;
+      MPI_Datatype _datatype;
+
+      bool _shared;
+      std::vector < Type > _owned;
+      MPI_Comm _nodeComm;
+      MPI_Comm _leaderComm;
+      int _nodeRank;
+#if MPI_VERSION >= 3
+      MPI_Win _win;
+#endif
+  };
+
+} //end namespace femus
+
+#endif
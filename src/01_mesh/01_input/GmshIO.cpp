@@ -0,0 +1,535 @@
+/*=========================================================================
+
+ Program: FEMUS
+ Module: GmshIO
+ Authors: Eugenio Aulisa
+
+ Copyright (c) FEMTTU
+ All rights reserved.
+
+ This software is distributed WITHOUT ANY WARRANTY; without even
+ the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+//local include
+#include "GmshIO.hpp"
+#include "Mesh.hpp"
+
+//C++ include
+#include <cstdlib>
+#include <sstream>
+#include <algorithm>
+
+
+namespace femus {
+
+  const unsigned GmshIO::GmshToFemusVertexIndex[N_GEOM_ELS][MAX_EL_N_NODES] = {
+    {
+      0, 1, 2, 3, 4, 5, 6, 7,
+      8, 11, 16, 9, 17, 10, 18, 19, 12, 15, 13, 14,
+      24, 20, 23, 21, 22, 25, 26
+    },
+    {0, 1, 2, 3, 4, 5, 6, 7, 9, 8},
+    {
+      0, 1, 2, 3, 4, 5,
+      6, 8, 12, 7, 13, 14, 9, 11, 10,
+      15, 17, 16
+    },
+    {0, 1, 2, 3, 4, 5, 6, 7, 8},
+    {0, 1, 2, 3, 4, 5},
+    {0, 1, 2}
+  };
+
+
+  const int GmshIO::GmshElementInfo[18][4] = {
+    {0, 0, -1, N_GEOM_ELS},
+    {2, 2, 1, N_GEOM_ELS},   // Line2
+    {3, 3, 2, N_GEOM_ELS},   // Tri3
+    {4, 4, 2, N_GEOM_ELS},   // Quad4
+    {4, 4, 3, N_GEOM_ELS},   // Tet4
+    {8, 8, 3, N_GEOM_ELS},   // Hex8
+    {6, 6, 3, N_GEOM_ELS},   // Prism6
+    {5, 5, 3, N_GEOM_ELS},   // Pyramid5
+    {3, 2, 1, 5},            // Line3
+    {6, 3, 2, 4},            // Tri6
+    {9, 4, 2, 3},            // Quad9
+    {10, 4, 3, 1},           // Tet10
+    {27, 8, 3, 0},           // Hex27
+    {18, 6, 3, 2},           // Prism18
+    {14, 5, 3, N_GEOM_ELS},  // Pyramid14
+    {1, 1, 0, N_GEOM_ELS},   // Point
+    {8, 4, 2, N_GEOM_ELS},   // Quad8
+    {20, 8, 3, N_GEOM_ELS}   // Hex20
+  };
+
+
+  template < class T >
+  void GmshIO::ReadValues(std::ifstream &inf, T *values, const size_t &n) const {
+    if(n == 0) return;
+    if(_binary) {
+      inf.read(reinterpret_cast < char* >(values), n * sizeof(T));
+    }
+    else {
+      for(size_t i = 0; i < n; i++) inf >> values[i];
+    }
+    if(!inf) {
+      std::cout << "Error in GmshIO::read: unexpected end of file" << std::endl;
+      abort();
+    }
+  }
+
+
+  template < class T >
+  T GmshIO::ReadValue(std::ifstream &inf) const {
+    T value;
+    ReadValues(inf, &value, 1);
+    return value;
+  }
+
+
+  void GmshIO::ReadEndOfSection(std::ifstream &inf, const std::string &section) const {
+    std::string str;
+    inf >> str;
+    if(str.compare("$End" + section) != 0) {
+      std::cout << "Error in GmshIO::read: $End" << section << " not found" << std::endl;
+      abort();
+    }
+  }
+
+
+  void GmshIO::ReadEntities(std::ifstream &inf, const bool &partitioned) {
+
+    if(partitioned) {
+      _numberOfPartitions = ReadValue < size_t >(inf);
+      size_t numberOfGhostEntities = ReadValue < size_t >(inf);
+      std::vector < int > ghostEntities(2 * numberOfGhostEntities);
+      if(numberOfGhostEntities > 0) ReadValues(inf, &ghostEntities[0], ghostEntities.size());
+    }
+
+    size_t numberOfEntities[4];
+    ReadValues(inf, numberOfEntities, 4);
+
+    for(int dim = 0; dim < 4; dim++) {
+      for(size_t i = 0; i < numberOfEntities[dim]; i++) {
+        std::pair < int, int > key(dim, ReadValue < int >(inf));
+
+        if(partitioned) {
+          int parent[2];
+          ReadValues(inf, parent, 2);
+          std::vector < int > partitions(ReadValue < size_t >(inf));
+          if(partitions.size() > 0) {
+            ReadValues(inf, &partitions[0], partitions.size());
+            _entityPartition[key] = partitions[0];
+          }
+        }
+
+        // point coordinates or bounding box
+        double box[6];
+        ReadValues(inf, box, (dim == 0) ? 3 : 6);
+
+        std::vector < int > &physicalTags = _entityPhysicalTags[key];
+        physicalTags.resize(ReadValue < size_t >(inf));
+        if(physicalTags.size() > 0) ReadValues(inf, &physicalTags[0], physicalTags.size());
+
+        if(dim > 0) {
+          std::vector < int > boundingEntities(ReadValue < size_t >(inf));
+          if(boundingEntities.size() > 0) ReadValues(inf, &boundingEntities[0], boundingEntities.size());
+        }
+      }
+    }
+  }
+
+
+  unsigned GmshIO::GetMaterial(const int &dim, const int &physicalTag) const {
+    std::map < std::pair < int, int >, std::string >::const_iterator it = _physicalNames.find(std::pair < int, int >(dim, physicalTag));
+    if(it != _physicalNames.end()) {
+      size_t pos = it->second.rfind('_');
+      if(pos != std::string::npos && pos + 1 < it->second.size()) {
+        int material = atoi(it->second.substr(pos + 1).c_str());
+        if(material > 0) return material;
+      }
+    }
+    return 2;
+  }
+
+
+  void GmshIO::read(const std::string& name, vector < vector < double> > &coords, const double Lref, std::vector<bool> &type_elem_flag, const bool read_groups, const bool read_boundary_groups) {
+
+    Mesh& mesh = GetMesh();
+
+    mesh.SetLevel(0);
+
+    std::ifstream inf(name.c_str(), std::ios::in | std::ios::binary);
+    if(!inf) {
+      std::cout << "Error in GmshIO::read: Gmsh file " << name << " can not be opened" << std::endl;
+      abort();
+    }
+
+    // node tags and coordinates in the file order
+    std::vector < size_t > nodeTag;
+    std::vector < double > nodeCoordinates;
+    size_t maxNodeTag = 0;
+
+    // element blocks: entity dimension, entity tag, Gmsh element type and, for each element, its tag followed by its node tags
+    std::vector < int > blockDim;
+    std::vector < int > blockEntity;
+    std::vector < int > blockType;
+    std::vector < std::vector < size_t > > blockElements;
+
+    bool formatFound = false;
+    bool elementsFound = false;
+
+    std::string line;
+    while(!elementsFound && std::getline(inf, line)) {
+      line.erase(line.find_last_not_of(" \r\t") + 1);
+      if(line.size() == 0) continue;
+
+      // read MESH FORMAT **************** A
+      if(line.compare("$MeshFormat") == 0) {
+        std::getline(inf, line);
+        std::istringstream format(line);
+        double version;
+        int fileType, dataSize;
+        format >> version >> fileType >> dataSize;
+        if(version < 4.1 || version >= 5.) {
+          std::cout << "Error in GmshIO::read: version " << version << " of file " << name << " is not supported, use MSH4.1" << std::endl;
+          abort();
+        }
+        _binary = (fileType == 1);
+        if(_binary) {
+          if(dataSize != sizeof(size_t)) {
+            std::cout << "Error in GmshIO::read: data size " << dataSize << " differs from sizeof(size_t)" << std::endl;
+            abort();
+          }
+          int one;
+          inf.read(reinterpret_cast < char* >(&one), sizeof(int));
+          if(one != 1) {
+            std::cout << "Error in GmshIO::read: the endianness of file " << name << " differs from the one of this machine" << std::endl;
+            abort();
+          }
+        }
+        ReadEndOfSection(inf, "MeshFormat");
+        formatFound = true;
+      }
+      // end read MESH FORMAT **************** A
+
+      else if(!formatFound) {
+        std::cout << "Error in GmshIO::read: $MeshFormat not found at the beginning of " << name << std::endl;
+        abort();
+      }
+
+      // read PHYSICAL NAMES, always ASCII **************** B
+      else if(line.compare("$PhysicalNames") == 0) {
+        unsigned numberOfNames;
+        inf >> numberOfNames;
+        for(unsigned i = 0; i < numberOfNames; i++) {
+          int dim, physicalTag;
+          std::string physicalName;
+          inf >> dim >> physicalTag;
+          std::getline(inf, physicalName);
+          size_t first = physicalName.find('"');
+          size_t last = physicalName.rfind('"');
+          if(first != std::string::npos && last > first) physicalName = physicalName.substr(first + 1, last - first - 1);
+          _physicalNames[std::pair < int, int >(dim, physicalTag)] = physicalName;
+        }
+        ReadEndOfSection(inf, "PhysicalNames");
+      }
+      // end read PHYSICAL NAMES **************** B
+
+      // read ENTITIES **************** C
+      else if(line.compare("$Entities") == 0) {
+        ReadEntities(inf, false);
+        ReadEndOfSection(inf, "Entities");
+      }
+      else if(line.compare("$PartitionedEntities") == 0) {
+        ReadEntities(inf, true);
+        ReadEndOfSection(inf, "PartitionedEntities");
+      }
+      // end read ENTITIES **************** C
+
+      // read NODES **************** D
+      else if(line.compare("$Nodes") == 0) {
+        size_t header[4];  // numEntityBlocks numNodes minNodeTag maxNodeTag
+        ReadValues(inf, header, 4);
+        maxNodeTag = header[3];
+        nodeTag.resize(header[1]);
+        nodeCoordinates.resize(3 * header[1]);
+
+        size_t counter = 0;
+        std::vector < double > buffer;
+        for(size_t k = 0; k < header[0]; k++) {
+          int entity[3];  // entityDim entityTag parametric
+          ReadValues(inf, entity, 3);
+          size_t n = ReadValue < size_t >(inf);
+          if(counter + n > nodeTag.size()) {
+            std::cout << "Error in GmshIO::read: wrong number of nodes" << std::endl;
+            abort();
+          }
+          ReadValues(inf, &nodeTag[counter], n);
+          unsigned nCoordinates = 3 + ((entity[2] != 0) ? entity[0] : 0);
+          if(nCoordinates == 3) {
+            ReadValues(inf, &nodeCoordinates[3 * counter], 3 * n);
+          }
+          else {
+            buffer.resize(nCoordinates * n);
+            ReadValues(inf, &buffer[0], buffer.size());
+            for(size_t i = 0; i < n; i++) {
+              for(unsigned d = 0; d < 3; d++) nodeCoordinates[3 * (counter + i) + d] = buffer[nCoordinates * i + d];
+            }
+          }
+          counter += n;
+        }
+        ReadEndOfSection(inf, "Nodes");
+      }
+      // end read NODES **************** D
+
+      // read ELEMENTS **************** E
+      else if(line.compare("$Elements") == 0) {
+        size_t header[4];  // numEntityBlocks numElements minElementTag maxElementTag
+        ReadValues(inf, header, 4);
+        blockDim.resize(header[0]);
+        blockEntity.resize(header[0]);
+        blockType.resize(header[0]);
+        blockElements.resize(header[0]);
+        for(size_t k = 0; k < header[0]; k++) {
+          int block[3];  // entityDim entityTag elementType
+          ReadValues(inf, block, 3);
+          size_t n = ReadValue < size_t >(inf);
+          if(block[2] < 1 || block[2] > 17) {
+            std::cout << "Error in GmshIO::read: unsupported Gmsh element type " << block[2] << std::endl;
+            abort();
+          }
+          blockDim[k] = block[0];
+          blockEntity[k] = block[1];
+          blockType[k] = block[2];
+          blockElements[k].resize(n * (1 + GmshElementInfo[block[2]][0]));
+          ReadValues(inf, (n > 0) ? &blockElements[k][0] : NULL, blockElements[k].size());
+        }
+        ReadEndOfSection(inf, "Elements");
+        elementsFound = true;
+      }
+      // end read ELEMENTS **************** E
+
+      // skip any other section
+      else if(line[0] == '$') {
+        std::string endSection = "$End" + line.substr(1);
+        while(std::getline(inf, line)) {
+          line.erase(line.find_last_not_of(" \r\t") + 1);
+          if(line.compare(endSection) == 0) break;
+        }
+      }
+    }
+    inf.close();
+
+    if(!elementsFound) {
+      std::cout << "Error in GmshIO::read: $Elements not found in " << name << std::endl;
+      abort();
+    }
+
+    // BEGIN mesh dimension, cells and node numbering
+    int dim = 0;
+    for(unsigned k = 0; k < blockDim.size(); k++) {
+      if(blockDim[k] > dim) dim = blockDim[k];
+    }
+    if(dim == 0) {
+      std::cout << "Error in GmshIO::read: the file " << name << " does not contain any cell" << std::endl;
+      abort();
+    }
+
+    std::vector < int > tagToNode(maxNodeTag + 1, -1);
+    for(size_t i = 0; i < nodeTag.size(); i++) {
+      tagToNode[nodeTag[i]] = i;
+    }
+
+    unsigned nel = 0;
+    std::vector < int > nodeIsUsed(nodeTag.size(), 0);
+    for(unsigned k = 0; k < blockDim.size(); k++) {
+      if(blockDim[k] == dim) {
+        int femusType = GmshElementInfo[blockType[k]][3];
+        if(femusType == N_GEOM_ELS) {
+          std::cout << "Error! Invalid element type " << blockType[k] << " in reading Gmsh File!" << std::endl;
+          std::cout << "Error! Use a second order discretization" << std::endl;
+          abort();
+        }
+        unsigned nve = GmshElementInfo[blockType[k]][0];
+        unsigned n = blockElements[k].size() / (nve + 1);
+        for(unsigned j = 0; j < n; j++) {
+          for(unsigned i = 0; i < nve; i++) {
+            nodeIsUsed[tagToNode[blockElements[k][j * (nve + 1) + 1 + i]]] = 1;
+          }
+        }
+        nel += n;
+      }
+    }
+
+    // the nodes that do not belong to any cell are dropped, the others keep the file order
+    unsigned nvt = 0;
+    std::vector < int > fileToFemusNode(nodeTag.size(), -1);
+    for(size_t i = 0; i < nodeTag.size(); i++) {
+      if(nodeIsUsed[i]) fileToFemusNode[i] = nvt++;
+    }
+    std::vector < int > ().swap(nodeIsUsed);
+
+    mesh.SetDimension(dim);
+    mesh.SetRefinementCellAndFaceIndices(dim);
+    mesh.SetNumberOfElements(nel);
+    mesh.SetNumberOfNodes(nvt);
+    // END mesh dimension, cells and node numbering
+
+    // BEGIN ELEMENT/cell
+    mesh.el = new elem(nel, mesh.GetDimension(), mesh.GetCommunicator());
+
+    std::map < int, unsigned > groups;
+    std::vector < unsigned > materialElementCounter(3, 0);
+    std::vector < unsigned > partition(nel);
+    bool filePartition = (_numberOfPartitions == mesh.n_processors() && Mesh::GetUseMeshFilePartition());
+
+    unsigned iel = 0;
+    for(unsigned k = 0; k < blockDim.size(); k++) {
+      if(blockDim[k] != dim) continue;
+
+      unsigned elementType = GmshElementInfo[blockType[k]][3];
+      unsigned nve = GmshElementInfo[blockType[k]][0];
+      unsigned n = blockElements[k].size() / (nve + 1);
+
+      std::pair < int, int > key(dim, blockEntity[k]);
+      const std::vector < int > &physicalTags = _entityPhysicalTags[key];
+      int group = (read_groups && physicalTags.size() > 0) ? physicalTags[0] : 1;
+      unsigned material = (read_groups && physicalTags.size() > 0) ? GetMaterial(dim, physicalTags[0]) : 2;
+      groups[group] = 1;
+
+      std::map < std::pair < int, int >, int >::const_iterator it = _entityPartition.find(key);
+      if(it == _entityPartition.end()) filePartition = false;
+
+      const char *typeName[N_GEOM_ELS] = {"Hex", "Tet", "Wedge", "Quad", "Triangle", "Line"};
+      if(elementType == 0) type_elem_flag[0] = type_elem_flag[3] = true;
+      else if(elementType == 1) type_elem_flag[1] = type_elem_flag[4] = true;
+      else if(elementType == 2) type_elem_flag[2] = type_elem_flag[3] = type_elem_flag[4] = true;
+      else if(elementType == 3) type_elem_flag[3] = true;
+      else if(elementType == 4) type_elem_flag[4] = true;
+      mesh.el->AddToElementNumber(n, typeName[elementType]);
+
+      for(unsigned j = 0; j < n; j++, iel++) {
+        mesh.el->SetElementType(iel, elementType);
+        mesh.el->SetElementGroup(iel, group);
+        mesh.el->SetElementMaterial(iel, material);
+        if(material == 2) materialElementCounter[0] += 1;
+        else if(material == 3) materialElementCounter[1] += 1;
+        else materialElementCounter[2] += 1;
+        if(filePartition) partition[iel] = it->second - 1;
+
+        const size_t *elementNodeTag = &blockElements[k][j * (nve + 1) + 1];
+        for(unsigned i = 0; i < nve; i++) {
+          unsigned inode = GmshIO::GmshToFemusVertexIndex[elementType][i];
+          mesh.el->SetElementDofIndex(iel, inode, fileToFemusNode[tagToNode[elementNodeTag[i]]]);
+        }
+      }
+    }
+    mesh.el->SetElementGroupNumber(groups.size());
+    mesh.el->SetMaterialElementCounter(materialElementCounter);
+
+    if(filePartition) {
+      mesh.SetMeshFilePartition(partition);
+    }
+    // END ELEMENT/cell
+
+    // BEGIN NODAL COORDINATES
+    coords[0].resize(nvt);
+    coords[1].resize(nvt);
+    coords[2].resize(nvt);
+    for(size_t i = 0; i < nodeTag.size(); i++) {
+      int inode = fileToFemusNode[i];
+      if(inode >= 0) {
+        coords[0][inode] = nodeCoordinates[3 * i] / Lref;
+        coords[1][inode] = (dim > 1) ? nodeCoordinates[3 * i + 1] / Lref : 0.;
+        coords[2][inode] = (dim > 2) ? nodeCoordinates[3 * i + 2] / Lref : 0.;
+      }
+    }
+    // END NODAL COORDINATES
+
+    // BEGIN boundary
+    if(read_boundary_groups) {
+
+      // cells around each vertex, in compressed row format
+      std::vector < unsigned > vertexCellOffset(nvt + 1, 0);
+      for(unsigned jel = 0; jel < nel; jel++) {
+        unsigned elementType = mesh.el->GetElementType(jel);
+        for(unsigned i = 0; i < NVE[elementType][0]; i++) {
+          vertexCellOffset[mesh.el->GetElementDofIndex(jel, i) + 1]++;
+        }
+      }
+      for(unsigned i = 0; i < nvt; i++) vertexCellOffset[i + 1] += vertexCellOffset[i];
+      std::vector < unsigned > vertexCell(vertexCellOffset[nvt]);
+      std::vector < unsigned > vertexCellCounter(vertexCellOffset.begin(), vertexCellOffset.end() - 1);
+      for(unsigned jel = 0; jel < nel; jel++) {
+        unsigned elementType = mesh.el->GetElementType(jel);
+        for(unsigned i = 0; i < NVE[elementType][0]; i++) {
+          vertexCell[vertexCellCounter[mesh.el->GetElementDofIndex(jel, i)]++] = jel;
+        }
+      }
+      std::vector < unsigned > ().swap(vertexCellCounter);
+
+      std::vector < unsigned > boundaryVertices;
+      std::vector < unsigned > faceVertices;
+      unsigned boundaryFacesNotFound = 0;
+
+      for(unsigned k = 0; k < blockDim.size(); k++) {
+        if(blockDim[k] != dim - 1) continue;
+
+        const std::vector < int > &physicalTags = _entityPhysicalTags[std::pair < int, int >(dim - 1, blockEntity[k])];
+        if(physicalTags.size() == 0) continue;
+        int value = -physicalTags[0] - 1;
+
+        unsigned nve = GmshElementInfo[blockType[k]][0];
+        unsigned nv = GmshElementInfo[blockType[k]][1];
+        unsigned n = blockElements[k].size() / (nve + 1);
+        boundaryVertices.resize(nv);
+        for(unsigned j = 0; j < n; j++) {
+          const size_t *elementNodeTag = &blockElements[k][j * (nve + 1) + 1];
+          bool found = false;
+          bool onCells = true;
+          for(unsigned i = 0; i < nv; i++) {
+            int inode = fileToFemusNode[tagToNode[elementNodeTag[i]]];
+            if(inode < 0) onCells = false;
+            boundaryVertices[i] = inode;
+          }
+          if(!onCells) {
+            boundaryFacesNotFound++;
+            continue;
+          }
+          std::sort(boundaryVertices.begin(), boundaryVertices.end());
+
+          unsigned ivertex = boundaryVertices[0];
+          for(unsigned l = vertexCellOffset[ivertex]; l < vertexCellOffset[ivertex + 1] && !found; l++) {
+            unsigned jel = vertexCell[l];
+            unsigned elementType = mesh.el->GetElementType(jel);
+            for(unsigned iface = 0; iface < NFC[elementType][1] && !found; iface++) {
+              unsigned nfv = (dim == 3) ? ((iface < NFC[elementType][0]) ? 4 : 3) : dim;
+              if(nfv != nv) continue;
+              faceVertices.resize(nfv);
+              for(unsigned i = 0; i < nfv; i++) {
+                faceVertices[i] = mesh.el->GetElementDofIndex(jel, ig[elementType][iface][i]);
+              }
+              std::sort(faceVertices.begin(), faceVertices.end());
+              if(faceVertices == boundaryVertices) {
+                mesh.el->SetFaceElementIndex(jel, iface, value);
+                found = true;
+              }
+            }
+          }
+          if(!found) boundaryFacesNotFound++;
+        }
+      }
+
+      if(boundaryFacesNotFound > 0) {
+        std::cout << "Warning in GmshIO::read: " << boundaryFacesNotFound << " boundary elements do not match any element face" << std::endl;
+      }
+    }
+    // END boundary
+
+  }
+
+
+}
@@ -0,0 +1,111 @@
+/*=========================================================================
+
+ Program: FEMUS
+ Module: GmshIO
+ Authors: Eugenio Aulisa
+
+ Copyright (c) FEMTTU
+ All rights reserved.
+
+ This software is distributed WITHOUT ANY WARRANTY; without even
+ the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#ifndef __femus_mesh_GmshIO_hpp__
+#define __femus_mesh_GmshIO_hpp__
+
+
+// Local includes
+#include "MeshInput.hpp"
+#include "GeomElTypeEnum.hpp"
+
+// C++ includes
+#include <fstream>
+#include <map>
+
+namespace femus
+{
+
+// Forward declarations
+class Mesh;
+
+/**
+ * This class implements reading meshes in the Gmsh MSH4.1 format, binary or ASCII.
+ * The cells of the highest dimension are the mesh elements, and they have to be of second order
+ * (Hex27, Tet10, Prism18, Quad9, Tri6, Line3).
+ * The physical tag of a cell is its element group, the material is the number after the last
+ * underscore of the physical name (2 if there is none). The physical tag of a boundary element
+ * is the boundary flag of the matching element face.
+ * If the file is partitioned in as many parts as there are processes, and Mesh::UseMeshFilePartition(true)
+ * has been called, the file partition replaces the Metis one.
+ */
+
+// ------------------------------------------------------------
+// GmshIO class definition
+class GmshIO : public MeshInput<Mesh>
+{
+ public:
+
+  /**
+   * Constructor.  Takes a non-const Mesh reference which it
+   * will fill up with elements via the read() command.
+   */
+  explicit
+  GmshIO (Mesh& mesh);
+
+  /**
+   * Reads in a mesh in the Gmsh *.msh format, version 4.1,
+   * from the file given by name.
+   */
+  virtual void read (const std::string& name, vector < vector < double> > &coords, const double Lref, std::vector<bool> &type_elem_flag, const bool read_groups, const bool read_boundary_groups);
+
+ private:
+
+  /** Read n values of the current section, with one block read in the binary format */
+  template < class T >
+  void ReadValues (std::ifstream &inf, T *values, const size_t &n) const;
+
+  template < class T >
+  T ReadValue (std::ifstream &inf) const;
+
+  /** Read the $Entities or the $PartitionedEntities section and store the physical tags and the partition of each entity */
+  void ReadEntities (std::ifstream &inf, const bool &partitioned);
+
+  void ReadEndOfSection (std::ifstream &inf, const std::string &section) const;
+
+  /** Material number from the physical name "name_material" */
+  unsigned GetMaterial (const int &dim, const int &physicalTag) const;
+
+  /** Map from Gmsh node index to Femus node index */
+  static const unsigned GmshToFemusVertexIndex[N_GEOM_ELS][MAX_EL_N_NODES];
+
+  /** Number of nodes, number of vertices, dimension and Femus type (N_GEOM_ELS if it can not be a mesh cell) of the Gmsh element types 0 to 17 */
+  static const int GmshElementInfo[18][4];
+
+  bool _binary;
+
+  /** Physical tags and partition of the entities, the key is (entity dimension, entity tag) */
+  std::map < std::pair < int, int >, std::vector < int > > _entityPhysicalTags;
+  std::map < std::pair < int, int >, int > _entityPartition;
+  unsigned _numberOfPartitions;
+
+  /** Physical names, the key is (dimension, physical tag) */
+  std::map < std::pair < int, int >, std::string > _physicalNames;
+
+};
+
+
+inline
+GmshIO::GmshIO (Mesh& mesh) :
+   MeshInput<Mesh>  (mesh),
+   _binary (false),
+   _numberOfPartitions (0)
+{
+}
+
+
+} // namespace femus
+
+#endif
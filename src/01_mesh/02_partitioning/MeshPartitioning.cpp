@@ -18,6 +18,7 @@
 //----------------------------------------------------------------------------
 #include "MeshPartitioning.hpp"
 #include "MultiLevelMesh.hpp"
+#include "Mesh.hpp"
 
 
 //C++ include
@@ -27,7 +28,7 @@
 namespace femus {
 
   
-MeshPartitioning::MeshPartitioning(Mesh &mesh) : _mesh(mesh) {
+MeshPartitioning::MeshPartitioning(Mesh &mesh) : ParallelObject(mesh.GetCommunicator()), _mesh(mesh) {
 
 }
 
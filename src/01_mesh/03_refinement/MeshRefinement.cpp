@@ -23,10 +23,14 @@
 #include "NumericVector.hpp"
 #include "GeomElTypeEnum.hpp"
 
+#include <map>
+#include <cmath>
+#include <algorithm>
+
 namespace femus {
 
 //-------------------------------------------------------------------
-  MeshRefinement::MeshRefinement(Mesh& mesh): _mesh(mesh) {
+  MeshRefinement::MeshRefinement(Mesh& mesh): ParallelObject(mesh.GetCommunicator()), _mesh(mesh) {
 
   }
 
@@ -58,7 +62,7 @@ namespace femus {
 
     //BEGIN temporary parallel vector initialization
     NumericVector* numberOfRefinedElement;
-    numberOfRefinedElement = NumericVector::build().release();
+    numberOfRefinedElement = NumericVector::build(LSOLVER, _mesh.GetCommunicator()).release();
 
     if(_nprocs == 1) numberOfRefinedElement->init(_nprocs, 1, false, SERIAL);
     else numberOfRefinedElement->init(_nprocs, 1, false, PARALLEL);
@@ -138,7 +142,7 @@ namespace femus {
 
     //BEGIN temporary parallel vector initialization
     NumericVector* numberOfRefinedElement;
-    numberOfRefinedElement = NumericVector::build().release();
+    numberOfRefinedElement = NumericVector::build(LSOLVER, _mesh.GetCommunicator()).release();
 
     if(_nprocs == 1) numberOfRefinedElement->init(_nprocs, 1, false, SERIAL);
     else numberOfRefinedElement->init(_nprocs, 1, false, PARALLEL);
@@ -215,8 +219,10 @@ void MeshRefinement::RefineMesh(const unsigned& igrid, Mesh* mshc, /*const*/ ele
     unsigned elementOffsetCoarse   = mshc->_elementOffset[_iproc];
     unsigned elementOffsetCoarseP1 = mshc->_elementOffset[_iproc + 1];
 
-    std::vector < double > coarseLocalizedAmrVector;
-    mshc->_topology->_Sol[mshc->GetAmrIndex()]->localize_to_all(coarseLocalizedAmrVector);
+    // replicated on all the processes, once per node when SharedMemory is enabled
+    SharedMemoryBuffer < double > *coarseAmrBuffer = new SharedMemoryBuffer < double > (mshc->_topology->_Sol[mshc->GetAmrIndex()]->size(), elc->GetCommunicator());
+    const SharedMemoryBuffer < double > &coarseLocalizedAmrVector = *coarseAmrBuffer;
+    mshc->_topology->_Sol[mshc->GetAmrIndex()]->localize_to_all(*coarseAmrBuffer);
 
     mshc->el->AllocateChildrenElement(_mesh.GetRefIndex(), mshc);
 
@@ -332,7 +338,7 @@ void MeshRefinement::RefineMesh(const unsigned& igrid, Mesh* mshc, /*const*/ ele
     
     
    
-    std::vector< double > ().swap(coarseLocalizedAmrVector);
+    delete coarseAmrBuffer;
 
 //====== END ELEMENTS ==============================
     
@@ -636,4 +642,303 @@ void MeshRefinement::RefineMesh(const unsigned& igrid, Mesh* mshc, /*const*/ ele
   }
 
 
+//---------------------------------------------------------------------------------------------------------------
+  void MeshRefinement::SplitCoarseMeshAnisotropically(const unsigned& sweep, std::vector < std::vector < double > > &coords) {
+
+    elem* elc = _mesh.el;
+    unsigned dim = _mesh.GetDimension();
+    unsigned nelc = elc->GetElementNumber();
+    unsigned nnodes = _mesh.GetNumberOfNodes();
+
+    if(dim < 2) return;
+
+    const unsigned stride[3] = {1, 3, 9};
+
+    // local node at each lattice position and reference direction of each middle edge node, for the Quad (0) and the Hex (1)
+    unsigned latticeNode[2][27];
+    unsigned edgeDirection[2][27];
+    for(unsigned t = 0; t < 2; t++) {
+      unsigned elt = (t == 0) ? 3 : 0;
+      for(unsigned i = 0; i < NVE[elt][2]; i++) {
+        unsigned position = referenceLatticePosition[t][i];
+        latticeNode[t][position] = i;
+        unsigned lattice[3] = {position % 3, (position / 3) % 3, position / 9};
+        for(unsigned d = 0; d < 3; d++) {
+          if(lattice[d] == 1) edgeDirection[t][i] = d;
+        }
+      }
+    }
+
+    //BEGIN split directions from the user directions
+    std::vector < unsigned > split(nelc, 0);  // bit d is set if the element is split in the reference direction d
+    std::vector < std::vector < double > > directions;
+    std::vector < double > x(3);
+
+    for(unsigned iel = 0; iel < nelc; iel++) {
+      unsigned elt = elc->GetElementType(iel);
+      unsigned nve = NVE[elt][0];
+      x.assign(3, 0.);
+      for(unsigned i = 0; i < nve; i++) {
+        unsigned inode = elc->GetElementDofIndex(iel, i);
+        for(unsigned k = 0; k < 3; k++) x[k] += coords[k][inode] / nve;
+      }
+
+      directions.resize(0);
+      Mesh::_SetAnisotropicSplittingDirections(x, elc->GetElementGroup(iel), sweep, directions);
+      if(directions.size() == 0) continue;
+
+      if(elt != 0 && elt != 3) {
+        std::cout << "Error in MeshRefinement::SplitCoarseMeshAnisotropically: only quadrilaterals and hexahedra can be split anisotropically" << std::endl;
+        abort();
+      }
+      unsigned t = (elt == 3) ? 0 : 1;
+
+      // physical tangent of each reference direction, summed over the edges parallel to it
+      double tangent[3][3] = {{0., 0., 0.}, {0., 0., 0.}, {0., 0., 0.}};
+      for(unsigned i = NVE[elt][0]; i < NVE[elt][1]; i++) {
+        unsigned d = edgeDirection[t][i];
+        unsigned position = referenceLatticePosition[t][i];
+        unsigned i0 = elc->GetElementDofIndex(iel, latticeNode[t][position - stride[d]]);
+        unsigned i2 = elc->GetElementDofIndex(iel, latticeNode[t][position + stride[d]]);
+        for(unsigned k = 0; k < 3; k++) tangent[d][k] += coords[k][i2] - coords[k][i0];
+      }
+
+      for(unsigned l = 0; l < directions.size(); l++) {
+        double bestAlignment = 0.;
+        unsigned bestDirection = dim;
+        for(unsigned d = 0; d < dim; d++) {
+          double tn = 0.;
+          double tt = 0.;
+          for(unsigned k = 0; k < directions[l].size() && k < 3; k++) tn += tangent[d][k] * directions[l][k];
+          for(unsigned k = 0; k < 3; k++) tt += tangent[d][k] * tangent[d][k];
+          double alignment = (tt > 0.) ? fabs(tn) / sqrt(tt) : 0.;
+          if(alignment > bestAlignment) {
+            bestAlignment = alignment;
+            bestDirection = d;
+          }
+        }
+        if(bestDirection < dim) split[iel] |= (1u << bestDirection);
+      }
+    }
+    //END split directions
+
+    //BEGIN conforming closure: an edge is split in all or in none of the elements sharing it
+    // elements around each edge, the edge being identified by its middle node
+    std::vector < unsigned > edgeElementOffset(nnodes + 1, 0);
+    for(unsigned iel = 0; iel < nelc; iel++) {
+      unsigned elt = elc->GetElementType(iel);
+      for(unsigned i = NVE[elt][0]; i < NVE[elt][1]; i++) {
+        edgeElementOffset[elc->GetElementDofIndex(iel, i) + 1]++;
+      }
+    }
+    for(unsigned i = 0; i < nnodes; i++) edgeElementOffset[i + 1] += edgeElementOffset[i];
+    std::vector < unsigned > edgeElement(edgeElementOffset[nnodes]);
+    std::vector < unsigned > edgeElementCounter(edgeElementOffset.begin(), edgeElementOffset.end() - 1);
+    for(unsigned iel = 0; iel < nelc; iel++) {
+      unsigned elt = elc->GetElementType(iel);
+      for(unsigned i = NVE[elt][0]; i < NVE[elt][1]; i++) {
+        edgeElement[edgeElementCounter[elc->GetElementDofIndex(iel, i)]++] = iel;
+      }
+    }
+    std::vector < unsigned > ().swap(edgeElementCounter);
+
+    std::vector < bool > edgeIsSplit(nnodes, false);
+    std::vector < unsigned > edgeStack;
+    for(unsigned iel = 0; iel < nelc; iel++) {
+      if(split[iel]) {
+        unsigned elt = elc->GetElementType(iel);
+        unsigned t = (elt == 3) ? 0 : 1;
+        for(unsigned i = NVE[elt][0]; i < NVE[elt][1]; i++) {
+          unsigned inode = elc->GetElementDofIndex(iel, i);
+          if((split[iel] & (1u << edgeDirection[t][i])) && !edgeIsSplit[inode]) {
+            edgeIsSplit[inode] = true;
+            edgeStack.push_back(inode);
+          }
+        }
+      }
+    }
+
+    while(edgeStack.size() > 0) {
+      unsigned inode = edgeStack.back();
+      edgeStack.pop_back();
+      for(unsigned j = edgeElementOffset[inode]; j < edgeElementOffset[inode + 1]; j++) {
+        unsigned jel = edgeElement[j];
+        unsigned jelt = elc->GetElementType(jel);
+        if(jelt != 0 && jelt != 3) {
+          std::cout << "Error in MeshRefinement::SplitCoarseMeshAnisotropically: the anisotropic splitting reaches the element " << jel
+                    << " that is not a quadrilateral or a hexahedron" << std::endl;
+          abort();
+        }
+        unsigned t = (jelt == 3) ? 0 : 1;
+        unsigned d = dim;
+        for(unsigned i = NVE[jelt][0]; i < NVE[jelt][1]; i++) {
+          if(elc->GetElementDofIndex(jel, i) == inode) d = edgeDirection[t][i];
+        }
+        if(!(split[jel] & (1u << d))) {
+          split[jel] |= (1u << d);
+          for(unsigned i = NVE[jelt][0]; i < NVE[jelt][1]; i++) {
+            unsigned jnode = elc->GetElementDofIndex(jel, i);
+            if(edgeDirection[t][i] == d && !edgeIsSplit[jnode]) {
+              edgeIsSplit[jnode] = true;
+              edgeStack.push_back(jnode);
+            }
+          }
+        }
+      }
+    }
+    //END conforming closure
+
+    unsigned nelf = 0;
+    for(unsigned iel = 0; iel < nelc; iel++) {
+      unsigned nChildren = 1;
+      for(unsigned d = 0; d < dim; d++) {
+        if(split[iel] & (1u << d)) nChildren *= 2;
+      }
+      nelf += nChildren;
+    }
+    if(nelf == nelc) return;
+
+    //BEGIN children elements and nodes
+    elem* elf = new elem(nelf, dim, _mesh.GetCommunicator());
+    elf->SetElementGroupNumber(elc->GetElementGroupNumber());
+
+    std::vector < unsigned > materialElementCounter(3, 0);
+
+    // the new nodes are the centers of the smallest cells of the parent lattice containing them, whose nodes are the key
+    std::map < std::vector < unsigned >, unsigned > newNode;
+    std::vector < unsigned > positions;
+    std::vector < unsigned > key;
+    unsigned parentNode[27];
+
+    unsigned jel = 0;
+    for(unsigned iel = 0; iel < nelc; iel++) {
+      unsigned elt = elc->GetElementType(iel);
+      unsigned gr_mat = elc->GetElementMaterial(iel);
+
+      unsigned n[3] = {1, 1, 1};
+      for(unsigned d = 0; d < dim; d++) {
+        if(split[iel] & (1u << d)) n[d] = 2;
+      }
+      unsigned nChildren = n[0] * n[1] * n[2];
+
+      for(unsigned j = 0; j < nChildren; j++) {
+        elf->SetElementType(jel + j, elt);
+        elf->SetElementGroup(jel + j, elc->GetElementGroup(iel));
+        elf->SetElementMaterial(jel + j, gr_mat);
+        if(gr_mat == 2) materialElementCounter[0] += 1;
+        else if(gr_mat == 3) materialElementCounter[1] += 1;
+        else materialElementCounter[2] += 1;
+      }
+      elf->AddToElementNumber(nChildren, elt);
+
+      if(nChildren == 1) {
+        for(unsigned i = 0; i < NVE[elt][2]; i++) {
+          elf->SetElementDofIndex(jel, i, elc->GetElementDofIndex(iel, i));
+        }
+        for(unsigned iface = 0; iface < NFC[elt][1]; iface++) {
+          int value = elc->GetFaceElementIndex(iel, iface);
+          if(value < -1) elf->SetFaceElementIndex(jel, iface, value);
+        }
+        jel++;
+        continue;
+      }
+
+      unsigned t = (elt == 3) ? 0 : 1;
+      for(unsigned i = 0; i < NVE[elt][2]; i++) {
+        parentNode[referenceLatticePosition[t][i]] = elc->GetElementDofIndex(iel, i);
+      }
+
+      for(unsigned c2 = 0; c2 < n[2]; c2++) {
+        for(unsigned c1 = 0; c1 < n[1]; c1++) {
+          for(unsigned c0 = 0; c0 < n[0]; c0++) {
+            unsigned c[3] = {c0, c1, c2};
+
+            for(unsigned i = 0; i < NVE[elt][2]; i++) {
+              unsigned position = referenceLatticePosition[t][i];
+              unsigned lattice[3] = {position % 3, (position / 3) % 3, position / 9};
+
+              // position of the child node in the parent lattice with half spacing
+              unsigned p[3] = {0, 0, 0};
+              positions.assign(1, 0);
+              for(unsigned d = 0; d < dim; d++) {
+                p[d] = (n[d] == 2) ? 2 * c[d] + lattice[d] : 2 * lattice[d];
+                unsigned size = positions.size();
+                if(p[d] % 2 == 0) {
+                  for(unsigned l = 0; l < size; l++) positions[l] += (p[d] / 2) * stride[d];
+                }
+                else {
+                  positions.resize(2 * size);
+                  for(unsigned l = 0; l < size; l++) {
+                    positions[size + l] = positions[l] + ((p[d] + 1) / 2) * stride[d];
+                    positions[l] += ((p[d] - 1) / 2) * stride[d];
+                  }
+                }
+              }
+
+              unsigned inode;
+              if(positions.size() == 1) {
+                inode = parentNode[positions[0]];
+              }
+              else {
+                key.resize(positions.size());
+                for(unsigned l = 0; l < positions.size(); l++) key[l] = parentNode[positions[l]];
+                std::sort(key.begin(), key.end());
+
+                std::map < std::vector < unsigned >, unsigned >::iterator it = newNode.find(key);
+                if(it != newNode.end()) {
+                  inode = it->second;
+                }
+                else {
+                  inode = nnodes++;
+                  newNode[key] = inode;
+
+                  // the new node is placed on the biquadratic map of the parent element
+                  double phi[3][3] = {{1., 0., 0.}, {1., 0., 0.}, {1., 0., 0.}};
+                  for(unsigned d = 0; d < dim; d++) {
+                    double s = 0.5 * p[d];
+                    phi[d][0] = 0.5 * (s - 1.) * (s - 2.);
+                    phi[d][1] = - s * (s - 2.);
+                    phi[d][2] = 0.5 * s * (s - 1.);
+                  }
+                  for(unsigned k = 0; k < 3; k++) coords[k].push_back(0.);
+                  for(unsigned l = 0; l < NVE[elt][2]; l++) {
+                    double weight = phi[0][l % 3] * phi[1][(l / 3) % 3] * phi[2][l / 9];
+                    if(weight != 0.) {
+                      for(unsigned k = 0; k < 3; k++) coords[k][inode] += weight * coords[k][parentNode[l]];
+                    }
+                  }
+                }
+              }
+              elf->SetElementDofIndex(jel, i, inode);
+            }
+
+            // the child faces on the parent faces inherit the boundary flags
+            for(unsigned iface = 0; iface < NFC[elt][1]; iface++) {
+              unsigned d = referenceFaceDirectionAndSide[iface][0];
+              unsigned side = referenceFaceDirectionAndSide[iface][1];
+              if(n[d] == 1 || c[d] == side) {
+                int value = elc->GetFaceElementIndex(iel, iface);
+                if(value < -1) elf->SetFaceElementIndex(jel, iface, value);
+              }
+            }
+
+            jel++;
+          }
+        }
+      }
+    }
+    //END children elements and nodes
+
+    elf->SetMaterialElementCounter(materialElementCounter);
+    elf->SetNodeNumber(nnodes);
+
+    delete elc;
+    _mesh.el = elf;
+    _mesh.SetNumberOfElements(nelf);
+    _mesh.SetNumberOfNodes(nnodes);
+
+    std::cout << " Anisotropic splitting of the coarse mesh, sweep " << sweep << ": " << nelc << " -> " << nelf << " elements" << std::endl;
+  }
+
+
 }
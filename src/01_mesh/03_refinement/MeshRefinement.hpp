@@ -22,6 +22,8 @@
 #include "ParallelObject.hpp"
 #include "GeomElTypeEnum.hpp"
 
+#include <vector>
+
 
 namespace femus {
 
@@ -59,6 +61,11 @@ public:
     /** Flag the elements to be refined in according to AMR criteria */
     bool FlagElementsToBeRefined();
 
+    /** Split the quadrilaterals and hexahedra of the coarse mesh, before partitioning, in the reference directions
+     * most aligned with the physical directions given by the user function Mesh::_SetAnisotropicSplittingDirections.
+     * The splitting is propagated through the elements sharing a split edge, so the mesh stays conforming */
+    void SplitCoarseMeshAnisotropically(const unsigned &sweep, std::vector < std::vector < double > > &coords);
+
 
 private:
 
@@ -175,6 +182,23 @@ private:
   };
 
 
+  /**
+   * Lattice position i + 3 j + 9 k of the local nodes of the biquadratic Quad (0) and Hex (1),
+   * with i, j, k = 0, 1, 2 along the reference directions
+   **/
+  const unsigned referenceLatticePosition[2][27] = {
+    {0, 2, 8, 6, 1, 5, 7, 3, 4},
+    {
+      0, 2, 8, 6, 18, 20, 26, 24,
+      1, 5, 7, 3, 19, 23, 25, 21, 9, 11, 17, 15,
+      10, 14, 16, 12, 4, 22, 13
+    }
+  };
+
+  /** Reference direction and side (0 = min, 1 = max) of the faces of the Quad and the Hex */
+  const unsigned referenceFaceDirectionAndSide[6][2] = { {1, 0}, {0, 1}, {1, 1}, {0, 0}, {2, 0}, {2, 1} };
+
+
 }   //end namespace femus
 
 
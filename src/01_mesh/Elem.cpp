@@ -39,9 +39,11 @@ namespace femus
   /**
    * This constructor allocates the memory for the \textit{coarsest elem}
    **/
-  elem::elem(const unsigned& other_nel, const unsigned dim_in)
+  elem::elem(const unsigned& other_nel, const unsigned dim_in, const MPI_Comm &comm)
   {
-      
+
+    SetCommunicator(comm);
+
     _dim = dim_in;
       
     _coarseElem = NULL;
@@ -66,9 +68,11 @@ namespace femus
    * This constructor allocates the memory for the \textit{finer elem}
    * starting from the parameters of the \textit{coarser elem}
    **/
-  elem::elem(elem* elc, const unsigned dim_in, const unsigned refindex, const std::vector < double >& coarseAmrVector)
+  elem::elem(elem* elc, const unsigned dim_in, const unsigned refindex, const SharedMemoryBuffer < double >& coarseAmrVector)
   {
-      
+
+    SetCommunicator(elc->_comm);
+
     _dim = dim_in;
       
     _coarseElem = elc;
@@ -85,8 +89,8 @@ namespace femus
     _elementLevel.resize(_nel, _level);
 
     //**************************
-    MyVector <unsigned> rowSizeElDof(_nel);
-    MyVector <unsigned> rowSizeElNearFace(_nel);
+    MyVector <unsigned> rowSizeElDof(_nel, 0, _comm);
+    MyVector <unsigned> rowSizeElNearFace(_nel, 0, _comm);
     unsigned jel = 0;
     for (unsigned isdom = 0; isdom < elc->_nprocs; isdom++) {
       elc->_elementType.broadcast(isdom);
@@ -117,13 +121,31 @@ namespace femus
   {
   }
 
+
+  void elem::SetCommunicator(const MPI_Comm &comm)
+  {
+    _comm = comm;
+
+    _elementLevel.SetCommunicator(_comm);
+    _elementType.SetCommunicator(_comm);
+    _elementGroup.SetCommunicator(_comm);
+    _elementMaterial.SetCommunicator(_comm);
+
+    _elementDof.SetCommunicator(_comm);
+    _elementNearFace.SetCommunicator(_comm);
+    _childElem.SetCommunicator(_comm);
+    _childElemDof.SetCommunicator(_comm);
+    _elementNearVertex.SetCommunicator(_comm);
+    _elementNearElement.SetCommunicator(_comm);
+  }
+
   
   void elem::ShrinkToFit()
   {
 
     _elementDof.shrinkToFit(UINT_MAX);
 
-    MyVector <unsigned> rowSize(_nel);
+    MyVector <unsigned> rowSize(_nel, 0, _comm);
     for (unsigned iel = 0; iel < _nel; iel++) {
       unsigned ielType = GetElementType(iel);
       rowSize[iel] = NFC[ielType][1];
@@ -176,7 +198,7 @@ namespace femus
 
 
     //BEGIN reordering _elementDof (rows)
-    MyVector <unsigned> rowSize(_nel, 0);
+    MyVector <unsigned> rowSize(_nel, 0, _comm);
     for (unsigned i = rowSize.begin(); i < rowSize.end(); i++) {
       rowSize[elementMapping[i]] = _elementDof.size(i);
     }
@@ -447,7 +469,7 @@ namespace femus
 
   void elem::BuildElementNearElement()
   {
-    MyVector < unsigned > rowSize(_elementOffset, 1);
+    MyVector < unsigned > rowSize(_elementOffset, 1, _comm);
     for (unsigned iel = rowSize.begin(); iel < rowSize.end(); iel++) {
       std::map< unsigned, bool> elements;
       for (unsigned i = 0; i < GetElementDofNumber(iel, 0); i++) {
@@ -481,7 +503,7 @@ namespace femus
 
   void elem::BuildElementNearVertex()
   {
-    MyVector <unsigned> rowSize(_nvt, 0);
+    MyVector <unsigned> rowSize(_nvt, 0, _comm);
     for (unsigned iel = 0; iel < _nel; iel++) {
       for (unsigned inode = 0; inode < GetElementDofNumber(iel, 0); inode++) {
         rowSize[GetElementDofIndex(iel, inode)]++;
@@ -568,7 +590,7 @@ namespace femus
 
   void elem::AllocateChildrenElement(const unsigned& refindex, Mesh* msh)
   {
-    MyVector <unsigned> rowSize(_elementOffset, 0);
+    MyVector <unsigned> rowSize(_elementOffset, 0, _comm);
     for (unsigned i = rowSize.begin(); i < rowSize.end(); i++) {
       rowSize[i] = (msh->GetRefinedElementIndex(i) == 1) ? refindex : 1;
     }
@@ -690,7 +712,7 @@ namespace femus
 
     for (unsigned ilevel = 0; ilevel <= _level; ilevel++) {
       //BEGIN interface element search
-      interfaceElement[ilevel] = MyVector <unsigned> (_elementOwned);
+      interfaceElement[ilevel] = MyVector <unsigned> (_elementOwned, 0, _comm);
       unsigned counter = 0;
       for (unsigned i = _elementLevel.begin(); i < _elementLevel.end(); i++) {
         if (ilevel == _elementLevel[i]) {
@@ -709,7 +731,7 @@ namespace femus
 
       //BEGIN interface node search
       std::vector< unsigned > offset = interfaceElement[ilevel].getOffset();
-      interfaceLocalDof[ilevel] = MyMatrix <unsigned>(offset, NVE[0][2], UINT_MAX);
+      interfaceLocalDof[ilevel] = MyMatrix <unsigned>(offset, NVE[0][2], UINT_MAX, _comm);
       for (unsigned i = interfaceElement[ilevel].begin(); i < interfaceElement[ilevel].end(); i++) {
         unsigned iel =  interfaceElement[ilevel][i];
         std::map <unsigned, bool> ldofs;
@@ -897,7 +919,7 @@ namespace femus
 
 
       NumericVector* pvector;
-      pvector = NumericVector::build().release();
+      pvector = NumericVector::build(LSOLVER, _comm).release();
       pvector->init(_nprocs, 1 , false, AUTOMATIC);
 
       unsigned counter = 1;
@@ -906,7 +928,7 @@ namespace femus
 
         //BEGIN  saving the restriction object in parallel vectors and matrices
 
-        MyVector <unsigned> rowSize(restriction[soltype].size(), 0);
+        MyVector <unsigned> rowSize(restriction[soltype].size(), 0, _comm);
         unsigned cnt1 = 0;
         for (std::map<unsigned, std::map<unsigned, double> >::iterator it1 = restriction[soltype].begin(); it1 != restriction[soltype].end(); it1++) {
           rowSize[cnt1] = restriction[soltype][it1->first].size();
@@ -916,7 +938,7 @@ namespace femus
 
         std::vector< unsigned > offset = rowSize.getOffset();
 
-        MyVector <unsigned> masterNode(offset);
+        MyVector <unsigned> masterNode(offset, 0, _comm);
         MyMatrix <unsigned> slaveNodes(rowSize);
         MyMatrix <double> slaveNodesValues(rowSize);
 
@@ -1102,8 +1124,8 @@ namespace femus
 	}
       }
 
-      MyVector <unsigned> InterfaceSolidMarkNode(interfaceSolidMark[soltype].size());
-      MyVector <short unsigned> InterfaceSolidMarkValue(interfaceSolidMark[soltype].size());
+      MyVector <unsigned> InterfaceSolidMarkNode(interfaceSolidMark[soltype].size(), 0, _comm);
+      MyVector <short unsigned> InterfaceSolidMarkValue(interfaceSolidMark[soltype].size(), 0, _comm);
 
       unsigned cnt = 0;
       for (std::map<unsigned, bool >::iterator it = interfaceSolidMark[soltype].begin(); it != interfaceSolidMark[soltype].end(); it++) {
@@ -20,6 +20,7 @@
 #include "GeomElTypeEnum.hpp"
 #include "MyVector.hpp"
 #include "MyMatrix.hpp"
+#include "SharedMemoryBuffer.hpp"
 #include "Basis.hpp"
 #include "PolynomialBases.hpp"
 
@@ -43,10 +44,11 @@ namespace femus {
     public:
 
       /** constructors */
-      elem(const unsigned& other_nel, const unsigned dim_in);
+      elem(const unsigned& other_nel, const unsigned dim_in, const MPI_Comm &comm = MPI_COMM_WORLD);
 
       //elem(elem* elc, const unsigned refindex, const std::vector < double >& coarseAmrLocal, const std::vector < double >& localizedElementType);
-      elem(elem* elc, const unsigned dim_in, const unsigned refindex, const std::vector < double >& coarseAmrLocal);
+      /** The finer elem takes the communicator of the coarser one */
+      elem(elem* elc, const unsigned dim_in, const unsigned refindex, const SharedMemoryBuffer < double >& coarseAmrLocal);
 
       /** destructor */
       ~elem();
@@ -227,6 +229,11 @@ namespace femus {
       /** To be Added */
       unsigned GetChildElement(const unsigned& iel, const unsigned& json);
 
+      /** Number of children of the element iel, 1 if iel has not been refined */
+      unsigned GetNumberOfChildElements(const unsigned& iel) {
+        return _childElem.size(iel);
+      }
+
       const unsigned GetNVE(const unsigned& elementType, const unsigned& doftype) const;
 
       const unsigned GetNFACENODES(const unsigned& elementType, const unsigned& jface, const unsigned& dof) const;
@@ -255,9 +262,16 @@ namespace femus {
       /** To be Added */
       unsigned GetDimension() const { return _dim; }
 
+      /** Communicator of the parallel element and vertex arrays, the one of the mesh */
+      const MPI_Comm &GetCommunicator() const { return _comm; }
+
       
     private:
 
+      /** Set the communicator of all the parallel arrays */
+      void SetCommunicator(const MPI_Comm &comm);
+
+      MPI_Comm _comm;
       unsigned _iproc;
       unsigned _nprocs;
 
@@ -19,8 +19,10 @@
 #include "Mesh.hpp"
 #include "MeshGeneration.hpp"
 #include "GambitIO.hpp"
+#include "GmshIO.hpp"
 #include "MED_IO.hpp"
 #include "MeshMetisPartitioning.hpp"
+#include "MeshRefinement.hpp"
 #include "NumericVector.hpp"
 
 // C++ includes
@@ -45,15 +47,20 @@ namespace femus {
   unsigned Mesh::_dimension = 2;
   unsigned Mesh::_ref_index = 4; // 8*DIM[2]+4*DIM[1]+2*DIM[0];
   unsigned Mesh::_face_index = 2; // 4*DIM[2]+2*DIM[1]+1*DIM[0];
+  bool Mesh::_useMeshFilePartition = false;
+
+  void (* Mesh::_SetAnisotropicSplittingDirections)(const std::vector < double >& x, const int &ElemGroupNumber, const unsigned &sweep, std::vector < std::vector < double > > &directions) = NULL;
+  unsigned Mesh::_numberOfAnisotropicSweeps = 0;
 
 //------------------------------------------------------------------------------------------------------
-  Mesh::Mesh() {
+  Mesh::Mesh(const MPI_Comm &comm) : ParallelObject(comm) {
 
     _coarseMsh = NULL;
 
     for(int i = 0; i < 5; i++) {
       _ProjCoarseToFine[i] = NULL;
     }
+    _elementFatherIsBuilt = false;
 
     for(int itype = 0; itype < 3; itype++) {
       for(int jtype = 0; jtype < 3; jtype++) {
@@ -85,6 +92,10 @@ namespace femus {
         _ProjCoarseToFine[i] = NULL;
       }
     }
+
+    for(unsigned k = 0; k < _coarseCoords.size(); k++) {
+      delete _coarseCoords[k];
+    }
     
   }
   
@@ -146,6 +157,12 @@ namespace femus {
 
     const bool flag_for_ncommon_in_metis = false;
 
+    if(_meshFilePartition.size() == GetNumberOfElements()) {
+      partition.swap(_meshFilePartition);
+      std::vector < unsigned > ().swap(_meshFilePartition);
+      return;
+    }
+
     partition.resize(GetNumberOfElements());
     
     MeshMetisPartitioning meshMetisPartitioning(*this);
@@ -189,6 +206,10 @@ namespace femus {
       GambitIO(*this).read(name, _coords, Lref, type_elem_flag, read_groups, read_boundary_groups);
     }
 
+    else if(name.rfind(".msh") < name.size()) {
+      GmshIO(*this).read(name, _coords, Lref, type_elem_flag, read_groups, read_boundary_groups);
+    }
+
     // else if (name.rfind (".obj") < name.size()) {
     //   obj_io (*this).read (name, _coords, Lref, type_elem_flag);
     // }
@@ -202,6 +223,7 @@ namespace femus {
       std::cerr << " ERROR: Unrecognized file extension: " << name
                 << "\n   I understand the following:\n\n"
                 << "     *.neu -- Gambit Neutral File\n"
+                << "     *.msh -- Gmsh File, version 4.1\n"
                 << "     *.med -- MED File\n"
                 << std::endl;
       abort();
@@ -226,6 +248,8 @@ namespace femus {
 
     AddBiquadraticNodesNotInMeshFile();
 
+    SplitCoarseMeshAnisotropically();
+
     el->ShrinkToFit();
 
     //el->SetNodeNumber(_nnodes);
@@ -249,6 +273,8 @@ namespace femus {
 
     ComputeCharacteristicLength();
 
+    ShareCoarseCoordinates();
+
     PrintInfo();
 
   }
@@ -330,6 +356,19 @@ namespace femus {
   }
   
   
+  void Mesh::ShareCoarseCoordinates() {
+
+    // every process has read the whole coarse mesh, the values are already the same everywhere
+    _coarseCoords.resize(_coords.size());
+    for(unsigned k = 0; k < _coords.size(); k++) {
+      _coarseCoords[k] = new SharedMemoryBuffer < double > (_coords[k].size(), GetCommunicator());
+      _coarseCoords[k]->Set((_coords[k].size() > 0) ? &_coords[k][0] : NULL);
+      std::vector < double > ().swap(_coords[k]);
+    }
+
+  }
+
+
   /**
    *  This function generates the coarse Box Mesh level using the built-in generator
    *   ///@todo seems like GenerateCoarseBoxMesh doesn't assign flags to faces correctly, need to check that
@@ -353,6 +392,8 @@ namespace femus {
 
     AddBiquadraticNodesNotInMeshFile();
 
+    SplitCoarseMeshAnisotropically();
+
     el->ShrinkToFit();
 
     el->SetNodeNumber(_nnodes);  ///@todo are we sure we need it here? On the other ReadCoarse it is commented
@@ -370,6 +411,8 @@ namespace femus {
     BuildTopologyStructures();
 
     ComputeCharacteristicLength();
+
+    ShareCoarseCoordinates();
     
     PrintInfo();
     
@@ -833,10 +876,36 @@ namespace femus {
      
      
         dofmap_all_fe_families_clear_ghost_dof_list_other_procs();
+
+    BuildInteriorAndInterfaceElements();
     
   }
 
 
+  void Mesh::BuildInteriorAndInterfaceElements() {
+
+    _interiorElements.clear();
+    _interfaceElements.clear();
+
+    for(unsigned iel = _elementOffset[_iproc]; iel < _elementOffset[_iproc + 1]; iel++) {
+      bool interior = true;
+      // the discontinuous dofs (k = 3, 4) are always owned by the element owner
+      for(unsigned k = 0; k < 3 && interior; k++) {
+        unsigned nDofs = GetElementDofNumber(iel, k);
+        for(unsigned i = 0; i < nDofs; i++) {
+          unsigned dof = GetSolutionDof(i, iel, k);
+          if(dof < _dofOffset[k][_iproc] || dof >= _dofOffset[k][_iproc + 1]) {
+            interior = false;
+            break;
+          }
+        }
+      }
+      if(interior) _interiorElements.push_back(iel);
+      else _interfaceElements.push_back(iel);
+    }
+  }
+
+
 // *******************************************************
   unsigned Mesh::IsdomBisectionSearch(const unsigned& dof, const short unsigned& solType) const {
 
@@ -995,7 +1064,7 @@ namespace femus {
     unsigned nj = _dofOffset[jtype][_nprocs];
     unsigned nj_loc = _ownSize[jtype][_iproc];
 
-    NumericVector* NNZ_d = NumericVector::build().release();
+    NumericVector* NNZ_d = NumericVector::build(LSOLVER, _comm).release();
 
     if(1 == _nprocs) {  // IF SERIAL
       NNZ_d->init(ni, ni_loc, false, SERIAL);
@@ -1006,7 +1075,7 @@ namespace femus {
 
     NNZ_d->zero();
 
-    NumericVector* NNZ_o = NumericVector::build().release();
+    NumericVector* NNZ_o = NumericVector::build(LSOLVER, _comm).release();
     NNZ_o->init(*NNZ_d);
     NNZ_o->zero();
 
@@ -1030,7 +1099,7 @@ namespace femus {
       nnz_o[i] = static_cast < int >((*NNZ_o)(offset + i));
     }
 
-    _ProjQitoQj[itype][jtype] = SparseMatrix::build().release();
+    _ProjQitoQj[itype][jtype] = SparseMatrix::build(LSOLVER, _comm).release();
     _ProjQitoQj[itype][jtype]->init(ni, nj, ni_loc, nj_loc, nnz_d, nnz_o);
 
     for(unsigned isdom = _iproc; isdom < _iproc + 1; isdom++) {
@@ -1093,7 +1162,7 @@ namespace femus {
       int nc_loc = _coarseMsh->_ownSize[solType][_iproc];
 
       //build matrix sparsity pattern size
-      NumericVector* NNZ_d = NumericVector::build().release();
+      NumericVector* NNZ_d = NumericVector::build(LSOLVER, _comm).release();
 
       if(n_processors() == 1) {  // IF SERIAL
         NNZ_d->init(nf, nf_loc, false, SERIAL);
@@ -1109,7 +1178,7 @@ namespace femus {
 
       NNZ_d->zero();
 
-      NumericVector* NNZ_o = NumericVector::build().release();
+      NumericVector* NNZ_o = NumericVector::build(LSOLVER, _comm).release();
       NNZ_o->init(*NNZ_d);
       NNZ_o->zero();
 
@@ -1136,7 +1205,7 @@ namespace femus {
       delete NNZ_o;
 
       //build matrix
-      _ProjCoarseToFine[solType] = SparseMatrix::build().release();
+      _ProjCoarseToFine[solType] = SparseMatrix::build(LSOLVER, _comm).release();
       _ProjCoarseToFine[solType]->init(nf, nc, nf_loc, nc_loc, nnz_d, nnz_o);
 
       // loop on the coarse grid
@@ -1153,6 +1222,125 @@ namespace femus {
   }
 
 
+  double Mesh::ComputeElementMeasure(const unsigned& iel) {
+
+    short unsigned ielGeom = GetElementType(iel);
+    unsigned nDofsX = GetElementDofNumber(iel, 2);
+
+    std::vector < std::vector < double > > x(_dimension);
+    for(unsigned k = 0; k < _dimension; k++) {
+      x[k].resize(nDofsX);
+    }
+    for(unsigned i = 0; i < nDofsX; i++) {
+      unsigned xDof = GetSolutionDof(i, iel, 2);
+      for(unsigned k = 0; k < _dimension; k++) {
+        x[k][i] = (*_topology->_Sol[k])(xDof);
+      }
+    }
+
+    std::vector < double > phi;
+    std::vector < double > phi_x;
+    double weight;
+    double measure = 0.;
+    for(unsigned ig = 0; ig < _finiteElement[ielGeom][2]->GetGaussPointNumber(); ig++) {
+      _finiteElement[ielGeom][2]->Jacobian(x, ig, weight, phi, phi_x);
+      measure += weight;
+    }
+    return measure;
+  }
+
+
+  void Mesh::BuildElementFather() {
+
+    if(!_coarseMsh) {
+      std::cout << "Error in Mesh::BuildElementFather: the coarse mesh has not been set" << std::endl;
+      abort();
+    }
+
+    unsigned offset = _elementOffset[_iproc];
+    unsigned offsetp1 = _elementOffset[_iproc + 1];
+    ParallelType type = (n_processors() == 1) ? SERIAL : PARALLEL;
+
+    // the children of an element may be owned by another process (AMR partitioning), so the coarse side only sets
+    // and the fine side only adds, both work for off-process entries
+    NumericVector* father = NumericVector::build(LSOLVER, _comm).release();
+    father->init(_elementOffset[_nprocs], offsetp1 - offset, false, type);
+    NumericVector* fatherMeasure = NumericVector::build(LSOLVER, _comm).release();
+    fatherMeasure->init(*father);
+    NumericVector* childrenMeasure = NumericVector::build(LSOLVER, _comm).release();
+    childrenMeasure->init(_coarseMsh->_elementOffset[_nprocs], _coarseMsh->_elementOffset[_iproc + 1] - _coarseMsh->_elementOffset[_iproc], false, type);
+    childrenMeasure->zero();
+
+    for(unsigned iel = _coarseMsh->_elementOffset[_iproc]; iel < _coarseMsh->_elementOffset[_iproc + 1]; iel++) {
+      for(unsigned j = 0; j < _coarseMsh->el->GetNumberOfChildElements(iel); j++) {
+        father->set(_coarseMsh->el->GetChildElement(iel, j), iel);
+      }
+    }
+    father->close();
+
+    _elementFather.resize(offsetp1 - offset);
+    _elementFatherWeight.resize(offsetp1 - offset);
+    for(unsigned iel = offset; iel < offsetp1; iel++) {
+      _elementFather[iel - offset] = static_cast < unsigned >(floor((*father)(iel) + 0.5));
+      _elementFatherWeight[iel - offset] = ComputeElementMeasure(iel);
+      childrenMeasure->add(_elementFather[iel - offset], _elementFatherWeight[iel - offset]);
+    }
+    childrenMeasure->close();
+
+    for(unsigned iel = _coarseMsh->_elementOffset[_iproc]; iel < _coarseMsh->_elementOffset[_iproc + 1]; iel++) {
+      double measure = (*childrenMeasure)(iel);
+      for(unsigned j = 0; j < _coarseMsh->el->GetNumberOfChildElements(iel); j++) {
+        fatherMeasure->set(_coarseMsh->el->GetChildElement(iel, j), measure);
+      }
+    }
+    fatherMeasure->close();
+
+    // dividing by the sum of the children measures, and not by the father measure, makes the restriction exactly conservative
+    for(unsigned iel = offset; iel < offsetp1; iel++) {
+      _elementFatherWeight[iel - offset] /= (*fatherMeasure)(iel);
+    }
+
+    delete father;
+    delete fatherMeasure;
+    delete childrenMeasure;
+
+    _elementFatherIsBuilt = true;
+  }
+
+
+  void Mesh::ProlongElementSolution(NumericVector& solFine, const NumericVector& solCoarse) {
+
+    if(!_coarseMsh) {
+      std::cout << "Error in Mesh::ProlongElementSolution: the coarse mesh has not been set" << std::endl;
+      abort();
+    }
+
+    for(unsigned iel = _coarseMsh->_elementOffset[_iproc]; iel < _coarseMsh->_elementOffset[_iproc + 1]; iel++) {
+      double value = solCoarse(iel);
+      for(unsigned j = 0; j < _coarseMsh->el->GetNumberOfChildElements(iel); j++) {
+        solFine.set(_coarseMsh->el->GetChildElement(iel, j), value);
+      }
+    }
+    solFine.close();
+  }
+
+
+  void Mesh::RestrictElementSolution(NumericVector& solCoarse, const NumericVector& solFine) {
+
+    if(!_elementFatherIsBuilt) {
+      BuildElementFather();
+    }
+
+    unsigned offset = _elementOffset[_iproc];
+
+    solCoarse.zero();
+    for(unsigned iel = offset; iel < _elementOffset[_iproc + 1]; iel++) {
+      solCoarse.add(_elementFather[iel - offset], _elementFatherWeight[iel - offset] * solFine(iel));
+    }
+    solCoarse.close();
+  }
+
+
   short unsigned Mesh::GetRefinedElementIndex(const unsigned& iel) const {
     return static_cast <short unsigned>((*_topology->_Sol[_amrIndex])(iel) + 0.25);
   }
@@ -1216,6 +1404,17 @@ namespace femus {
 
 // *******************************************************
 
+  void Mesh::SplitCoarseMeshAnisotropically() {
+
+    if(_SetAnisotropicSplittingDirections == NULL) return;
+
+    for(unsigned sweep = 0; sweep < _numberOfAnisotropicSweeps; sweep++) {
+      MeshRefinement(*this).SplitCoarseMeshAnisotropically(sweep, _coords);
+    }
+
+  }
+
+
   void Mesh::AddBiquadraticNodesNotInMeshFile() {
 
     unsigned int nnodes = GetNumberOfNodes();
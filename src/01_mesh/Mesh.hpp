@@ -24,6 +24,7 @@
 #include "ElemType.hpp"
 #include "ElemTypeEnum.hpp"
 #include "ParallelObject.hpp"
+#include "SharedMemoryBuffer.hpp"
 
 #include <cassert>
 #include <vector>
@@ -50,9 +51,9 @@ class Mesh : public ParallelObject {
 // =========================
 public:
 
-    /** Constructor */
+    /** Constructor, the mesh is distributed on comm */
     explicit
-    Mesh();
+    Mesh(const MPI_Comm &comm = MPI_COMM_WORLD);
 
     /** destructor */
     ~Mesh();
@@ -107,9 +108,15 @@ private:
     /** MESH: number of nodes */
     unsigned _nnodes;
 
-    /** MESH: node coordinates for each space dimension  @todo beware: this is only filled at coarse reading, then use _topology for the coordinates! */
+    /** MESH: node coordinates for each space dimension, only filled at coarse reading and moved to _coarseCoords when the coarse mesh is built, then use _topology for the coordinates! */
     std::vector < std::vector < double > > _coords;
 
+    /** MESH: coarse node coordinates kept for the life of the mesh, replicated once per node when SharedMemory is enabled */
+    std::vector < SharedMemoryBuffer < double > * > _coarseCoords;
+
+    /** Move _coords into _coarseCoords and release them, collective */
+    void ShareCoarseCoordinates();
+
     void PrintInfoElements() const;
 
 // =========================
@@ -154,6 +161,16 @@ public:
     
     /** MESH: Number of elements per processor (incremental count)  @todo should be private */
     std::vector < unsigned > _elementOffset;
+
+    /** MESH: owned elements with all their dofs owned by this process, they can be assembled while the ghost values are in flight */
+    const std::vector < unsigned > & GetInteriorElements() const {
+      return _interiorElements;
+    }
+
+    /** MESH: owned elements with at least one ghost dof, they have to wait for the ghost update */
+    const std::vector < unsigned > & GetInterfaceElements() const {
+      return _interfaceElements;
+    }
  
   
     
@@ -173,6 +190,11 @@ public:
     };
 
     void ComputeCharacteristicLength();
+
+    /** Coordinate k of the coarse mesh nodes, in the numbering after partitioning, empty on the finer levels */
+    const SharedMemoryBuffer < double > & GetCoarseCoordinates(const unsigned &k) const {
+      return *_coarseCoords[k];
+    }
     
     
 private:
@@ -212,6 +234,13 @@ public:
 
 
     void AddBiquadraticNodesNotInMeshFile();
+
+    /** Split the coarse mesh elements in the directions given by _SetAnisotropicSplittingDirections, _numberOfAnisotropicSweeps times */
+    void SplitCoarseMeshAnisotropically();
+
+    /** User function filling, for the element with center x, the physical directions in which it has to be split at the given sweep */
+    static void (* _SetAnisotropicSplittingDirections)(const std::vector < double >& x, const int &ElemGroupNumber, const unsigned &sweep, std::vector < std::vector < double > > &directions);
+    static unsigned _numberOfAnisotropicSweeps;
     
     /** Boundary names for faces, I think only used for Box mesh so far */
     std::map<unsigned int, std::string> _boundaryinfo;
@@ -234,6 +263,26 @@ public:
     void Partition();
     
     void PartitionForElements(std::vector < unsigned > & partition);
+
+    /** Use the element partition stored in the mesh file, if it has as many parts as processes, in place of the Metis one */
+    static void UseMeshFilePartition(const bool &value) {
+      _useMeshFilePartition = value;
+    }
+
+    static bool GetUseMeshFilePartition() {
+      return _useMeshFilePartition;
+    }
+
+    /** Set by the mesh readers, it is consumed by the partitioning of the coarse mesh */
+    void SetMeshFilePartition(std::vector < unsigned > & partition) {
+      _meshFilePartition.swap(partition);
+    }
+
+private:
+
+    std::vector < unsigned > _meshFilePartition;
+
+    static bool _useMeshFilePartition;
     
 
 // =========================
@@ -355,6 +404,9 @@ public:
     void FillISvectorElemOffsets(std::vector < unsigned >& partition);
   
     void FillISvectorNodeOffsets();
+
+    /** Split the owned elements into interior and interface elements */
+    void BuildInteriorAndInterfaceElements();
     
     
     void dofmap_all_fe_families_initialize();
@@ -390,6 +442,9 @@ private:
     /** FE: DofMap: Number of ghost dofs per FE family and per processor (count, non-incremental) */
     std::vector< std::vector < int > > _ghostDofs[5];
     
+    std::vector < unsigned > _interiorElements;
+    std::vector < unsigned > _interfaceElements;
+
     /** FE: DofMap  k = 0, 1 */
     std::map < unsigned, unsigned > _ownedGhostMap[2];
     /** FE: DofMap  k = 0, 1 */ 
@@ -409,6 +464,14 @@ public:
     /**  FE: Get the coarse to the fine projection matrix*/
     SparseMatrix* GetCoarseToFineProjection(const unsigned& solType);
 
+    /** FE: Prolong a piecewise constant (solType 3) vector of the coarse mesh, every child element takes the value of its father.
+     * No projection matrix is built */
+    void ProlongElementSolution(NumericVector &solFine, const NumericVector &solCoarse);
+
+    /** FE: Restrict a piecewise constant (solType 3) vector to the coarse mesh, every father element takes the volume-weighted
+     * average of its children, so that the integral of the field is preserved. No projection matrix is built */
+    void RestrictElementSolution(NumericVector &solCoarse, const NumericVector &solFine);
+
 private:
     /** FE: Build the coarse to the fine projection matrix */
     void BuildCoarseToFineProjection(const unsigned& solType, const char el_dofs[]);
@@ -416,6 +479,18 @@ private:
     /** FE: The coarse to the fine projection matrix */
     SparseMatrix* _ProjCoarseToFine[5];
 
+    /** FE: Build the father and the restriction weight of the owned elements, collective, done once */
+    void BuildElementFather();
+
+    /** FE: Measure of the element iel, with the biquadratic geometry */
+    double ComputeElementMeasure(const unsigned &iel);
+
+    /** FE: Father in the coarse mesh of the owned elements, indexed by iel - _elementOffset[_iproc] */
+    std::vector < unsigned > _elementFather;
+    /** FE: Measure of the owned elements over the total measure of the children of their father */
+    std::vector < double > _elementFatherWeight;
+    bool _elementFatherIsBuilt;
+
     
     
 // =========================
@@ -49,7 +49,7 @@ MultiLevelMesh::~MultiLevelMesh() {
 }
 
 //---------------------------------------------------------------------------------------------------
-MultiLevelMesh::MultiLevelMesh() : _gridn0(0)
+MultiLevelMesh::MultiLevelMesh(const MPI_Comm &comm) : _comm(comm), _gridn0(0)
   {
 
   InitializeGeomElemFlag();
@@ -271,7 +271,7 @@ MultiLevelMesh::MultiLevelMesh() : _gridn0(0)
       MeshRefinement meshcoarser(*_level0[i-1u]);
       meshcoarser.FlagAllElementsToBeRefined();
 
-      _level0[i] = new Mesh();
+      _level0[i] = new Mesh(_comm);
       MeshRefinement meshfiner(*_level0[i]);
       meshfiner.RefineMesh(i, _level0[i-1], _finiteElement);
     }
@@ -307,7 +307,7 @@ MultiLevelMesh::MultiLevelMesh() : _gridn0(0)
 	//meshcoarser.FlagOnlyEvenElementsToBeRefined();
       }
       
-      _level0[i] = new Mesh();
+      _level0[i] = new Mesh(_comm);
       MeshRefinement meshfiner(*_level0[i]);
       meshfiner.RefineMesh(i,_level0[i-1],_finiteElement);
     
@@ -335,7 +335,7 @@ MultiLevelMesh::MultiLevelMesh() : _gridn0(0)
     _level0.resize(gridn);
 
     //coarse mesh
-    _level0[0] = new Mesh();
+    _level0[0] = new Mesh(_comm);
         
     }
     
@@ -356,7 +356,9 @@ MultiLevelMesh::MultiLevelMesh(const unsigned short &igridn,
                                const char mesh_file[], 
                                const char GaussOrder[], 
                                const double Lref,
-                               bool (* SetRefinementFlag)(const std::vector < double > &x, const int &ElemGroupNumber,const int &level) )  :
+                               bool (* SetRefinementFlag)(const std::vector < double > &x, const int &ElemGroupNumber,const int &level),
+                               const MPI_Comm &comm)  :
+    _comm(comm),
     _gridn0(igridn)
     {
         
@@ -394,6 +396,13 @@ void MultiLevelMesh::ReadCoarseMesh(const char mesh_file[], const char GaussOrde
    
 }
 
+void MultiLevelMesh::SetAnisotropicCoarseMeshSplitting(const unsigned &numberOfSweeps,
+                                                        void (* SetAnisotropicSplittingDirections)(const std::vector < double > &x, const int &ElemGroupNumber, const unsigned &sweep, std::vector < std::vector < double > > &directions))
+{
+    Mesh::_SetAnisotropicSplittingDirections = SetAnisotropicSplittingDirections;
+    Mesh::_numberOfAnisotropicSweeps = numberOfSweeps;
+}
+
 void MultiLevelMesh::ReadCoarseMeshOnlyFileReadingBeforePartitioning(const char mesh_file[], const double Lref, const bool read_groups, const bool read_boundary_groups)
 {
     
@@ -523,7 +532,7 @@ void MultiLevelMesh::AddAMRMeshLevel()
   MeshRefinement meshcoarser(*_level0[_gridn0-1u]);
   meshcoarser.FlagElementsToBeRefined();
 
-  _level0[_gridn0] = new Mesh();
+  _level0[_gridn0] = new Mesh(_comm);
   MeshRefinement meshfiner(*_level0[_gridn0]);
   meshfiner.RefineMesh(_gridn0,_level0[_gridn0-1u],_finiteElement);
 
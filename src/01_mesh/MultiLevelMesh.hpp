@@ -23,6 +23,7 @@ PURPOSE.  See the above copyright notice for more information.
 #include "Writer.hpp"
 
 #include <vector>
+#include <mpi.h>
 
 
 namespace femus {
@@ -46,8 +47,9 @@ class MultiLevelMesh {
 //====================
 public:
 
-    /** Constructor */
-    MultiLevelMesh();
+    /** Constructor, all the meshes and the objects built on them are distributed on comm */
+    explicit
+    MultiLevelMesh(const MPI_Comm &comm = MPI_COMM_WORLD);
 
     /** Constructor with refinement in it */
     MultiLevelMesh(const unsigned short &igridn,
@@ -55,7 +57,8 @@ public:
                    const char mesh_file[],
                    const char GaussOrder[], 
                    const double Lref,
-                   bool (* SetRefinementFlag)(const std::vector < double > &x, const int &ElemGroupNumber, const int &level) );
+                   bool (* SetRefinementFlag)(const std::vector < double > &x, const int &ElemGroupNumber, const int &level),
+                   const MPI_Comm &comm = MPI_COMM_WORLD);
     
     /** Destructor */
     ~MultiLevelMesh();
@@ -69,6 +72,11 @@ public:
 
     /** Print the mesh info for each level */
     void PrintInfo();
+
+    /** Communicator of the meshes */
+    const MPI_Comm &GetCommunicator() const {
+      return _comm;
+    }
     
 
 //====================
@@ -82,6 +90,13 @@ public:
     /** Read the coarse-mesh from an input file (call the right reader from the extension) */
     void ReadCoarseMesh(const char mesh_file[], const char GaussOrder[], const double Lref, const bool read_groups, const bool read_boundary_groups);
     
+    /** Split the quadrilaterals and hexahedra of the coarse mesh numberOfSweeps times, each time in the reference directions
+     * most aligned with the physical directions returned by the user function; the splitting is propagated to keep the mesh conforming.
+     * It has to be called before the coarse mesh is read or generated.
+     * The split mesh becomes level 0: RefineMesh and AddAMRMeshLevel still refine isotropically, there are no anisotropic levels */
+    void SetAnisotropicCoarseMeshSplitting(const unsigned &numberOfSweeps,
+                                            void (* SetAnisotropicSplittingDirections)(const std::vector < double > &x, const int &ElemGroupNumber, const unsigned &sweep, std::vector < std::vector < double > > &directions));
+
     void ReadCoarseMeshOnlyFileReadingBeforePartitioning(const char mesh_file[], const double Lref, const bool read_groups, const bool read_boundary_groups);
 
     void ReadCoarseMeshOnlyFileReading(const char mesh_file[], const double Lref, const bool read_groups, const bool read_boundary_groups);
@@ -169,6 +184,9 @@ private:
     
     void DeleteLevelsZero();
     
+    /** Communicator of all the levels */
+    MPI_Comm _comm;
+
     /** Number of levels for _level0 */
     unsigned short _gridn0;
     /** Number of levels for _level */
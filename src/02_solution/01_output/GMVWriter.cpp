@@ -89,7 +89,7 @@ namespace femus {
       vector2.reserve( ( dim + 1 ) *nel );
 
     NumericVector* numVector;
-    numVector = NumericVector::build().release();
+    numVector = NumericVector::build(LSOLVER, _comm).release();
     numVector->init( mesh->dofmap_get_dof_offset(index, _nprocs), mesh->dofmap_get_own_size(index, _iproc), true, AUTOMATIC );
 
 
@@ -240,7 +240,7 @@ namespace femus {
           else {
             sprintf( buffer, "%s %s", "Eps", _ml_sol->GetSolutionName( i ) );
           }
-          if( name == 0 || ( _debugOutput  && solution->_ResEpsBdcFlag[i] ) ) {
+          if( name == 0 || ( _debugOutput  && solution->_ResEpsBdcFlag[i] && ( name == 1 || solution->HasResEps( i ) ) ) ) {
             if( _ml_sol->GetSolutionType( i ) < 3 ) { // **********  on the nodes **********
               fout.write( ( char* ) buffer, sizeof( char ) * 8 );
               fout.write( ( char* ) &one, sizeof( unsigned ) );
@@ -209,7 +209,8 @@ namespace femus {
    
    unsigned VTKWriter::compute_sol_bdc_res_eps_size(const Solution * solution, const unsigned i) const {
        
-       const unsigned print_sol_size = 1 + 3 * _debugOutput * solution->_ResEpsBdcFlag[i];
+       // Res and Eps exist only for the solutions of a system
+       const unsigned print_sol_size = 1 + _debugOutput * solution->_ResEpsBdcFlag[i] * (1 + 2 * solution->HasResEps(i));
        return  print_sol_size;
        
    }
@@ -381,7 +382,7 @@ namespace femus {
     
     //---- NumericVector used for node-based fields -------------------------------------------------------------------------------------------
     NumericVector* num_vec_aux_for_node_fields;
-    num_vec_aux_for_node_fields = NumericVector::build().release();
+    num_vec_aux_for_node_fields = NumericVector::build(LSOLVER, _comm).release();
 
     if( n_processors() == 1 ) { // IF SERIAL
       num_vec_aux_for_node_fields->init( mesh->dofmap_get_dof_offset(index, _nprocs),
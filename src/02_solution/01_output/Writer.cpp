@@ -38,7 +38,7 @@ namespace femus {
   const unsigned Writer::FemusToVTKorToXDMFConn[27] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 23, 21, 20, 22, 24, 25, 26};
 
   Writer::Writer (MultiLevelSolution* ml_sol) :
-    _ml_sol (ml_sol), _ml_mesh (ml_sol->_mlMesh) {
+    ParallelObject (ml_sol->GetCommunicator()), _ml_sol (ml_sol), _ml_mesh (ml_sol->_mlMesh) {
     _gridn = _ml_mesh->GetNumberOfLevels();
     _moving_mesh = 0;
     _graph = false;
@@ -46,7 +46,7 @@ namespace femus {
   }
 
   Writer::Writer (MultiLevelMesh* ml_mesh) :
-    _ml_sol (NULL), _ml_mesh (ml_mesh) {
+    ParallelObject (ml_mesh->GetCommunicator()), _ml_sol (NULL), _ml_mesh (ml_mesh) {
     _gridn = _ml_mesh->GetNumberOfLevels();
     _moving_mesh = 0;
     _graph = false;
@@ -114,7 +114,7 @@ namespace femus {
     std::vector < double > vector2;
     vector2.reserve( maxDim );
 
-    NumericVector* numVector = NumericVector::build().release();
+    NumericVector* numVector = NumericVector::build(LSOLVER, _comm).release();
     numVector->init( nvt, mesh->dofmap_get_own_size(index_nd, _iproc), true, AUTOMATIC );
 
     //BEGIN XMF FILE PRINT
@@ -189,7 +189,7 @@ namespace femus {
         //Printing biquadratic solution on the nodes
         if( _ml_sol->GetSolutionType( indx ) < 3 ) {
           std::string solName =  _ml_sol->GetSolutionName( indx );
-          for( int name = 0; name < 1 + 3 * _debugOutput * solution->_ResEpsBdcFlag[i]; name++ ) {
+          for( int name = 0; name < 1 + _debugOutput * solution->_ResEpsBdcFlag[i] * ( 1 + 2 * solution->HasResEps( i ) ); name++ ) {
             std::string printName;
             if( name == 0 ) printName = solName;
             else if( name == 1 ) printName = "Bdc" + solName;
@@ -204,7 +204,7 @@ namespace femus {
         }
         else if( _ml_sol->GetSolutionType( indx ) >= 3 ) {   //Printing picewise constant solution on the element
           std::string solName =  _ml_sol->GetSolutionName( indx );
-          for( int name = 0; name < 1 + 3 * _debugOutput * solution->_ResEpsBdcFlag[i]; name++ ) {
+          for( int name = 0; name < 1 + _debugOutput * solution->_ResEpsBdcFlag[i] * ( 1 + 2 * solution->HasResEps( i ) ); name++ ) {
             std::string printName;
             if( name == 0 ) printName = solName;
             else if( name == 1 ) printName = "Bdc" + solName;
@@ -320,7 +320,7 @@ namespace femus {
       for( unsigned i = 0; i < ( 1 - print_all ) *vars.size() + print_all * _ml_sol->GetSolutionSize(); i++ ) {
         unsigned indx = ( print_all == 0 ) ? _ml_sol->GetIndex( vars[i].c_str() ) : i;
         if( _ml_sol->GetSolutionType( indx ) >= 3 ) {
-          for( int name = 0; name < 1 + 3 * _debugOutput * solution->_ResEpsBdcFlag[i]; name++ ) {
+          for( int name = 0; name < 1 + _debugOutput * solution->_ResEpsBdcFlag[i] * ( 1 + 2 * solution->HasResEps( i ) ); name++ ) {
 
             std::string solName =  _ml_sol->GetSolutionName( indx );
             std::string printName;
@@ -365,7 +365,7 @@ namespace femus {
       for( unsigned i = 0; i < ( 1 - print_all ) *vars.size() + print_all * _ml_sol->GetSolutionSize(); i++ ) {
         unsigned indx = ( print_all == 0 ) ? _ml_sol->GetIndex( vars[i].c_str() ) : i;
         if( _ml_sol->GetSolutionType( indx ) < 3 ) {
-          for( int name = 0; name < 1 + 3 * _debugOutput * solution->_ResEpsBdcFlag[i]; name++ ) {
+          for( int name = 0; name < 1 + _debugOutput * solution->_ResEpsBdcFlag[i] * ( 1 + 2 * solution->HasResEps( i ) ); name++ ) {
 
             std::string solName =  _ml_sol->GetSolutionName( indx );
             std::string printName;
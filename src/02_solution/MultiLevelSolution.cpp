@@ -46,6 +46,7 @@ namespace femus {
 
 //---------------------------------------------------------------------------------------------------
   MultiLevelSolution::MultiLevelSolution(MultiLevelMesh* ml_msh) :
+    ParallelObject(ml_msh->GetCommunicator()),
     _gridn(ml_msh->GetNumberOfLevels()),
     _mlMesh(ml_msh) {
     _solution.resize(_gridn);
@@ -103,13 +104,9 @@ namespace femus {
 
     for(unsigned k = 0; k < _solName.size(); k++) {
       _solution[_gridn]->ResizeSolutionVector(_solName[k]);
-      _solution[_gridn]->_Sol[k]->matrix_mult(*_solution[_gridn - 1]->_Sol[k],
-                                              *_mlMesh->GetLevel(_gridn)->GetCoarseToFineProjection(_solType[k]));
-      _solution[_gridn]->_Sol[k]->close();
+      ProlongSolutionVector(*_solution[_gridn]->_Sol[k], *_solution[_gridn - 1]->_Sol[k], _gridn, _solType[k]);
       if(_solTimeOrder[k] == 2) {
-        _solution[_gridn]->_SolOld[k]->matrix_mult(*_solution[_gridn - 1]->_SolOld[k],
-                                                   *_mlMesh->GetLevel(_gridn)->GetCoarseToFineProjection(_solType[k]));
-        _solution[_gridn]->_SolOld[k]->close();
+        ProlongSolutionVector(*_solution[_gridn]->_SolOld[k], *_solution[_gridn - 1]->_SolOld[k], _gridn, _solType[k]);
       }
     }
 
@@ -1043,9 +1040,7 @@ void MultiLevelSolution::GenerateBdc(const char* name, const char* bdc_type, con
 
     for(int gridf = level; gridf < _gridn; gridf++) {
       for(unsigned i = 0; i < _solName.size(); i++) {
-        _solution[gridf]->_Sol[i]->matrix_mult(*_solution[gridf - 1]->_Sol[i],
-                                               *_mlMesh->GetLevel(gridf)->GetCoarseToFineProjection(_solType[i]));
-        _solution[gridf]->_Sol[i]->close();
+        ProlongSolutionVector(*_solution[gridf]->_Sol[i], *_solution[gridf - 1]->_Sol[i], gridf, _solType[i]);
       }
     }
 
@@ -1058,14 +1053,22 @@ void MultiLevelSolution::GenerateBdc(const char* name, const char* bdc_type, con
   /** Refine the solution at (gridf) level from (gridf - 1) */
   void MultiLevelSolution::RefineSolution(const unsigned &gridf) {
 
-    Mesh *msh = _mlMesh->GetLevel(gridf);
-
     for(unsigned k = 0; k < _solType.size(); k++) {
+      ProlongSolutionVector(*_solution[gridf]->_Sol[k], *_solution[gridf - 1]->_Sol[k], gridf, _solType[k]);
+    }
+  }
 
-      unsigned solType = _solType[k];
-      _solution[gridf]->_Sol[k]->matrix_mult(*_solution[gridf - 1]->_Sol[k],
-                                             *msh->GetCoarseToFineProjection(solType));
-      _solution[gridf]->_Sol[k]->close();
+
+  void MultiLevelSolution::ProlongSolutionVector(NumericVector &solFine, const NumericVector &solCoarse, const unsigned &gridf, const unsigned &solType) {
+
+    Mesh *msh = _mlMesh->GetLevel(gridf);
+
+    if(solType == 3) {
+      msh->ProlongElementSolution(solFine, solCoarse);
+    }
+    else {
+      solFine.matrix_mult(solCoarse, *msh->GetCoarseToFineProjection(solType));
+      solFine.close();
     }
   }
 
@@ -1081,8 +1084,13 @@ void MultiLevelSolution::GenerateBdc(const char* name, const char* bdc_type, con
     for(unsigned k = 0; k < _solType.size(); k++) {
 
       unsigned solType = _solType[k];
-      _solution[grid_coarse]->_Sol[k]->matrix_mult_transpose(*(_solution[grid_fine]->_Sol[k]), *(msh->GetCoarseToFineProjectionRestrictionOnCoarse(solType)));
-      _solution[grid_coarse]->_Sol[k]->close();
+      if(solType == 3) { // volume-weighted average of the children, no matrix
+        msh->RestrictElementSolution(*(_solution[grid_coarse]->_Sol[k]), *(_solution[grid_fine]->_Sol[k]));
+      }
+      else {
+        _solution[grid_coarse]->_Sol[k]->matrix_mult_transpose(*(_solution[grid_fine]->_Sol[k]), *(msh->GetCoarseToFineProjectionRestrictionOnCoarse(solType)));
+        _solution[grid_coarse]->_Sol[k]->close();
+      }
     }
 
   }
@@ -1122,6 +1130,45 @@ void MultiLevelSolution::GenerateBdc(const char* name, const char* bdc_type, con
     }
   }
 
+  void MultiLevelSolution::PrintVectorMemory() const {
+
+    int iproc;
+    MPI_Comm_rank(_comm, &iproc);
+
+    unsigned long totalBytes[2] = {0, 0};
+
+    for(unsigned i = 0; i < _solName.size(); i++) {
+      unsigned long localBytes[2] = {0, 0};
+      for(unsigned short ig = 0; ig < _gridn; ig++) {
+        unsigned long allocatedBytes, savedBytes;
+        _solution[ig]->GetVectorMemory(i, allocatedBytes, savedBytes);
+        localBytes[0] += allocatedBytes;
+        localBytes[1] += savedBytes;
+      }
+      unsigned long bytes[2];
+      MPI_Allreduce(localBytes, bytes, 2, MPI_UNSIGNED_LONG, MPI_SUM, _comm);
+      totalBytes[0] += bytes[0];
+      totalBytes[1] += bytes[1];
+
+      if(iproc == 0) {
+        std::cout << " Solution " << _solName[i] << ": vectors " << bytes[0] / 1024. << " KB, saved " << bytes[1] / 1024. << " KB" << std::endl;
+      }
+    }
+    if(iproc == 0) {
+      std::cout << " All solutions: vectors " << totalBytes[0] / 1024. << " KB, saved " << totalBytes[1] / 1024. << " KB" << std::endl;
+    }
+  }
+
+  void MultiLevelSolution::FreeUnusedResEps(const std::vector < bool > &isSolved) {
+    for(unsigned i = 0; i < _solName.size(); i++) {
+      if(!isSolved[i]) {
+        for(unsigned short ig = 0; ig < _gridn; ig++) {
+          if(_solution[ig]->HasResEps(i)) _solution[ig]->FreeResEps(i);
+        }
+      }
+    }
+  }
+
   void MultiLevelSolution::UpdateSolution(const char name[], InitFunc func, const double& time) {
     unsigned i = GetIndex(name);
 
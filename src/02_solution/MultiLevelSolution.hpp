@@ -287,6 +287,10 @@ public:
      // *******************************************************
 
     void RefineSolution( const unsigned &gridf );
+
+    /** Prolong solCoarse of the level gridf - 1 to solFine of the level gridf, piecewise constant vectors are copied
+     * from the father to the children elements, the other families use the coarse to fine projection matrix */
+    void ProlongSolutionVector( NumericVector &solFine, const NumericVector &solCoarse, const unsigned &gridf, const unsigned &solType );
     void CoarsenSolutionByOneLevel_wrong( const unsigned &gridf );
     void CoarsenSolutionByOneLevel( const unsigned &gridf );
 
@@ -297,6 +301,12 @@ public:
     void fill_at_level_from_level(const unsigned lev_out, const unsigned lev_in, const MultiLevelSolution & ml_sol_in);
         
     void CopySolutionToOldSolution();
+
+    /** Print, for each solution, the memory of its vectors summed over levels and processes and the memory saved by the lazy allocation */
+    void PrintVectorMemory() const;
+
+    /** Free, on all levels, the residual and the correction of the solutions that are not solved by any system */
+    void FreeUnusedResEps(const std::vector < bool > &isSolved);
     
     void SetIfFSI(const bool &FSI = true){
 	_FSI = FSI; 
@@ -20,6 +20,8 @@
 #include <ctime>
 #include <fstream>
 #include <algorithm>
+#include <cmath>
+#include <mpi.h>
 #include "Solution.hpp"
 #include "FemusDefault.hpp"
 #include "ElemType.hpp"
@@ -36,7 +38,7 @@ namespace femus {
    *  Constructor
    **/
 // ------------------------------------------------------------------
-  Solution::Solution(Mesh *other_msh) {
+  Solution::Solution(Mesh *other_msh) : ParallelObject(other_msh->GetCommunicator()) {
     _msh = other_msh;
 
     for(int i = 0; i < 5; i++) {
@@ -44,6 +46,9 @@ namespace femus {
       _AMR_flag = 0;
     }
     _FSI = false;
+    _overlapGhostUpdate = false;
+    _solHistoryHead = 0;
+    _solHistorySize = 0;
   }
 
   /**
@@ -278,11 +283,10 @@ _removeNullSpace[old_size + s] = false;
 
     if(_Sol[i])  delete _Sol[i];
 
-    if(_ResEpsBdcFlag[i]) {
-      if(_Res[i]) delete _Res[i];
-
-      if(_Eps[i]) delete _Eps[i];
+    bool resEpsAllocated = HasResEps(i);
+    FreeResEps(i);
 
+    if(_ResEpsBdcFlag[i]) {
       if(_Bdc[i]) delete _Bdc[i];
     }
 
@@ -290,7 +294,7 @@ _removeNullSpace[old_size + s] = false;
       if(_SolOld[i]) delete _SolOld[i];
     }
 
-    _Sol[i] = NumericVector::build().release();
+    _Sol[i] = NumericVector::build(LSOLVER, _comm).release();
 
     if(n_processors() == 1) {  // IF SERIAL
       _Sol[i]->init(_msh->dofmap_get_dof_offset(_SolType[i], n_processors()), 
@@ -320,23 +324,64 @@ _removeNullSpace[old_size + s] = false;
     }
 
     if(_SolTmOrder[i] == 2) {  // only if the variable is time dependent
-      _SolOld[i] = NumericVector::build().release();
+      _SolOld[i] = NumericVector::build(LSOLVER, _comm).release();
       _SolOld[i]->init(*_Sol[i]);
     }
 
     if(_ResEpsBdcFlag[i]) {  //only if the variable is a Pde type
+      _Bdc[i] = NumericVector::build(LSOLVER, _comm).release();
+      _Bdc[i]->init(*_Sol[i]);
 
-      _Res[i] = NumericVector::build().release();
-      _Res[i]->init(*_Sol[i]);
+      // _Res and _Eps are allocated by the systems that solve for the variable
+      if(resEpsAllocated) AllocateResEps(i);
+    }
+  }
 
-      _Eps[i] = NumericVector::build().release();
+  /** Allocate the residual and the correction of the solution i, if they are not allocated yet */
+  void Solution::AllocateResEps(const unsigned &i) {
+    if(!_ResEpsBdcFlag[i]) {
+      std::cout << "Error in Solution::AllocateResEps: " << _SolName[i] << " is not a Pde type solution" << std::endl;
+      abort();
+    }
+    if(_Res[i] == NULL) {
+      _Res[i] = NumericVector::build(LSOLVER, _comm).release();
+      _Res[i]->init(*_Sol[i]);
+    }
+    if(_Eps[i] == NULL) {
+      _Eps[i] = NumericVector::build(LSOLVER, _comm).release();
       _Eps[i]->init(*_Sol[i]);
+    }
+  }
 
-      _Bdc[i] = NumericVector::build().release();
-      _Bdc[i]->init(*_Sol[i]);
+  void Solution::AllocateResEps(const std::vector <unsigned> &solIndex) {
+    for(unsigned k = 0; k < solIndex.size(); k++) {
+      AllocateResEps(solIndex[k]);
     }
   }
 
+  void Solution::FreeResEps(const unsigned &i) {
+    if(_Res[i]) delete _Res[i];
+    _Res[i] = NULL;
+
+    if(_Eps[i]) delete _Eps[i];
+    _Eps[i] = NULL;
+  }
+
+  void Solution::GetVectorMemory(const unsigned &i, unsigned long &allocatedBytes, unsigned long &savedBytes) const {
+
+    unsigned long vectorBytes = (_Sol[i]) ? static_cast < unsigned long >(_Sol[i]->local_size()) * sizeof(double) : 0;
+
+    unsigned nAllocated = 1 + (_SolOld[i] != NULL) + (_Bdc[i] != NULL) + (_Res[i] != NULL) + (_Eps[i] != NULL);
+    for(unsigned j = 0; j < _GradVec[i].size(); j++) {
+      nAllocated += (_GradVec[i][j] != NULL);
+    }
+    // the Pde type solutions used to have always the residual and the correction
+    unsigned nSaved = (_ResEpsBdcFlag[i]) ? (_Res[i] == NULL) + (_Eps[i] == NULL) : 0;
+
+    allocatedBytes = nAllocated * vectorBytes;
+    savedBytes = nSaved * vectorBytes;
+  }
+
 
   /** Init and set to zero The AMR Eps vector */
   void Solution::InitAMREps() {
@@ -344,7 +389,7 @@ _removeNullSpace[old_size + s] = false;
     _AMREps.resize(_Sol.size());
 
     for(int i = 0; i < _Sol.size(); i++) {
-      _AMREps[i] = NumericVector::build().release();
+      _AMREps[i] = NumericVector::build(LSOLVER, _comm).release();
       _AMREps[i]->init(*_Sol[i]);
       _AMREps[i]->zero();
     }
@@ -358,20 +403,16 @@ _removeNullSpace[old_size + s] = false;
    **/
 // ------------------------------------------------------------------
   void Solution::FreeSolutionVectors() {
+    FreeSolutionHistory();
+
     for(unsigned i = 0; i < _Sol.size(); i++) {
       if(_Sol[i]) delete _Sol[i];
 
       _Sol[i] = NULL;
 
-      if(_ResEpsBdcFlag[i]) {
-        if(_Res[i]) delete _Res[i];
-
-        _Res[i] = NULL;
-
-        if(_Eps[i]) delete _Eps[i];
-
-        _Eps[i] = NULL;
+      FreeResEps(i);
 
+      if(_ResEpsBdcFlag[i]) {
         if(_Bdc[i]) delete _Bdc[i];
 
         _Bdc[i] = NULL;
@@ -501,7 +542,8 @@ _removeNullSpace[old_size + s] = false;
     for(unsigned k = 0; k < _SolPdeIndex.size(); k++) {
       unsigned indexSol = _SolPdeIndex[k];
       _Sol[indexSol]->add(*_Eps[indexSol]);
-      _Sol[indexSol]->close();
+      if(_overlapGhostUpdate) _Sol[indexSol]->closeBegin();
+      else _Sol[indexSol]->close();
 
       if(_AMR_flag) {
         _AMREps[indexSol]->add(*_Eps[indexSol]);
@@ -512,6 +554,12 @@ _removeNullSpace[old_size + s] = false;
 
   }
 
+  void Solution::EndGhostUpdate() {
+    for(unsigned i = 0; i < _Sol.size(); i++) {
+      _Sol[i]->closeEnd();
+    }
+  }
+
 
   /**
    * Update _Res: the residual is updated
@@ -562,7 +610,7 @@ _removeNullSpace[old_size + s] = false;
     AMR->_Sol[AMRIndex]->zero();
 
     NumericVector *counter_vec;
-    counter_vec = NumericVector::build().release();
+    counter_vec = NumericVector::build(LSOLVER, _comm).release();
     counter_vec->init(_msh->n_processors(), 1 , false, AUTOMATIC);
     counter_vec->zero();
 
@@ -659,7 +707,7 @@ _removeNullSpace[old_size + s] = false;
       }
 
       NumericVector* parallelVec;
-      parallelVec = NumericVector::build().release();
+      parallelVec = NumericVector::build(LSOLVER, _comm).release();
       parallelVec->init(_msh->n_processors(), 1 , false, AUTOMATIC);
 
       parallelVec->set(iproc, solNorm2);
@@ -877,7 +925,7 @@ _removeNullSpace[old_size + s] = false;
       }
 
       NumericVector* parallelVec;
-      parallelVec = NumericVector::build().release();
+      parallelVec = NumericVector::build(LSOLVER, _comm).release();
       parallelVec->init(_msh->n_processors(), 1 , false, AUTOMATIC);
 
       parallelVec->set(iproc, solNorm2);
@@ -1184,6 +1232,389 @@ _removeNullSpace[old_size + s] = false;
 //   }
 
 
+  double Solution::GetZZErrorEstimator(const unsigned &solIndex, std::vector <double> &elementError2) {
+
+    unsigned iproc = _msh->processor_id();
+    const unsigned dim = _msh->GetDimension();
+    unsigned solType = _SolType[solIndex];
+    unsigned xType = 2;
+
+    if(solType > 2) {
+      std::cout << "Error in Solution::GetZZErrorEstimator: " << _SolName[solIndex] << " is not a Lagrange solution" << std::endl;
+      abort();
+    }
+
+    unsigned elementOffset = _msh->_elementOffset[iproc];
+    unsigned nel = _msh->_elementOffset[iproc + 1] - elementOffset;
+    if(elementError2.size() != nel) elementError2.assign(nel, 0.);
+
+    // element averaged gradients
+    BuildGradMatrixStructure(solType);
+
+    std::vector < NumericVector* > elementGrad(dim);
+    for(unsigned j = 0; j < dim; j++) {
+      elementGrad[j] = NumericVector::build(LSOLVER, _comm).release();
+      elementGrad[j]->init(_msh->dofmap_get_dof_offset(3, _nprocs), _msh->dofmap_get_own_size(3, _iproc), false, AUTOMATIC);
+      elementGrad[j]->matrix_mult(*_Sol[solIndex], *_GradMat[solType][j]);
+    }
+
+    // recovered nodal gradients: volume weighted average of the element gradients of the patch
+    std::vector < NumericVector* > recoveredGrad(dim);
+    for(unsigned j = 0; j < dim; j++) {
+      recoveredGrad[j] = NumericVector::build(LSOLVER, _comm).release();
+      recoveredGrad[j]->init(*_Sol[solIndex]);
+      recoveredGrad[j]->zero();
+    }
+    NumericVector *patchVolume = NumericVector::build(LSOLVER, _comm).release();
+    patchVolume->init(*_Sol[solIndex]);
+    patchVolume->zero();
+
+    vector < double > sol;
+    vector < vector < double > > x(dim);
+    vector < vector < double > > solRecovered(dim);
+    vector < double > phi;
+    vector < double > phi_x;
+    double weight;
+
+    for(int iel = _msh->_elementOffset[iproc]; iel < _msh->_elementOffset[iproc + 1]; iel++) {
+
+      short unsigned ielGeom = _msh->GetElementType(iel);
+      unsigned solDofs  = _msh->GetElementDofNumber(iel, solType);
+      unsigned xDofs  = _msh->GetElementDofNumber(iel, xType);
+
+      for(int k = 0; k < dim; k++) {
+        x[k].resize(xDofs);
+      }
+      for(unsigned i = 0; i < xDofs; i++) {
+        unsigned iDof  = _msh->GetSolutionDof(i, iel, xType);
+        for(unsigned k = 0; k < dim; k++) {
+          x[k][i] = (*_msh->_topology->_Sol[k])(iDof);
+        }
+      }
+
+      double volume = 0.;
+      for(unsigned ig = 0; ig < _msh->_finiteElement[ielGeom][solType]->GetGaussPointNumber(); ig++) {
+        _msh->_finiteElement[ielGeom][solType]->Jacobian(x, ig, weight, phi, phi_x);
+        volume += weight;
+      }
+
+      for(unsigned i = 0; i < solDofs; i++) {
+        unsigned iDof = _msh->GetSolutionDof(i, iel, solType);
+        for(unsigned j = 0; j < dim; j++) {
+          recoveredGrad[j]->add(iDof, volume * (*elementGrad[j])(iel));
+        }
+        patchVolume->add(iDof, volume);
+      }
+    }
+
+    for(unsigned j = 0; j < dim; j++) {
+      recoveredGrad[j]->close();
+    }
+    patchVolume->close();
+
+    // estimator
+    double solNorm2 = 0.;
+
+    for(int iel = _msh->_elementOffset[iproc]; iel < _msh->_elementOffset[iproc + 1]; iel++) {
+
+      short unsigned ielGeom = _msh->GetElementType(iel);
+      unsigned solDofs  = _msh->GetElementDofNumber(iel, solType);
+      unsigned xDofs  = _msh->GetElementDofNumber(iel, xType);
+
+      sol.resize(solDofs);
+      for(unsigned j = 0; j < dim; j++) {
+        solRecovered[j].resize(solDofs);
+      }
+      for(unsigned i = 0; i < solDofs; i++) {
+        unsigned iDof = _msh->GetSolutionDof(i, iel, solType);
+        sol[i] = (*_Sol[solIndex])(iDof);
+        double iVolume = (*patchVolume)(iDof);
+        for(unsigned j = 0; j < dim; j++) {
+          solRecovered[j][i] = (*recoveredGrad[j])(iDof) / iVolume;
+        }
+      }
+
+      for(int k = 0; k < dim; k++) {
+        x[k].resize(xDofs);
+      }
+      for(unsigned i = 0; i < xDofs; i++) {
+        unsigned iDof  = _msh->GetSolutionDof(i, iel, xType);
+        for(unsigned k = 0; k < dim; k++) {
+          x[k][i] = (*_msh->_topology->_Sol[k])(iDof);
+        }
+      }
+
+      double ielError2 = 0.;
+      for(unsigned ig = 0; ig < _msh->_finiteElement[ielGeom][solType]->GetGaussPointNumber(); ig++) {
+        _msh->_finiteElement[ielGeom][solType]->Jacobian(x, ig, weight, phi, phi_x);
+
+        for(unsigned j = 0; j < dim; j++) {
+          double solGradig = 0.;
+          double solRecoveredig = 0.;
+          for(unsigned i = 0; i < solDofs; i++) {
+            solGradig += sol[i] * phi_x[i * dim + j];
+            solRecoveredig += solRecovered[j][i] * phi[i];
+          }
+          ielError2 += (solRecoveredig - solGradig) * (solRecoveredig - solGradig) * weight;
+          solNorm2 += solGradig * solGradig * weight;
+        }
+      }
+      elementError2[iel - elementOffset] += ielError2;
+    }
+
+    for(unsigned j = 0; j < dim; j++) {
+      delete elementGrad[j];
+      delete recoveredGrad[j];
+    }
+    delete patchVolume;
+
+    double solNorm2All;
+    MPI_Allreduce(&solNorm2, &solNorm2All, 1, MPI_DOUBLE, MPI_SUM, _comm);
+    return solNorm2All;
+  }
+
+
+  double Solution::GetResidualErrorEstimator(const unsigned &solIndex, double (*sourceFunction)(const std::vector < double > &x),
+                                             std::vector <double> &elementError2) {
+
+    unsigned iproc = _msh->processor_id();
+    const unsigned dim = _msh->GetDimension();
+    const unsigned dim2 = (3 * (dim - 1) + !(dim - 1));
+    unsigned solType = _SolType[solIndex];
+    unsigned xType = 2;
+
+    if(solType > 2) {
+      std::cout << "Error in Solution::GetResidualErrorEstimator: " << _SolName[solIndex] << " is not a Lagrange solution" << std::endl;
+      abort();
+    }
+
+    unsigned elementOffset = _msh->_elementOffset[iproc];
+    unsigned nel = _msh->_elementOffset[iproc + 1] - elementOffset;
+    if(elementError2.size() != nel) elementError2.assign(nel, 0.);
+
+    // the face neighbors owned by other processes are the ghosts of the element gradient vectors
+    std::vector < int > ghost;
+    for(int iel = _msh->_elementOffset[iproc]; iel < _msh->_elementOffset[iproc + 1]; iel++) {
+      for(unsigned jface = 0; jface < _msh->GetElementFaceNumber(iel); jface++) {
+        int jel = _msh->el->GetFaceElementIndex(iel, jface) - 1;
+        if(jel >= 0 && (jel < _msh->_elementOffset[iproc] || jel >= _msh->_elementOffset[iproc + 1])) {
+          ghost.push_back(jel);
+        }
+      }
+    }
+    std::sort(ghost.begin(), ghost.end());
+    ghost.erase(std::unique(ghost.begin(), ghost.end()), ghost.end());
+
+    std::vector < NumericVector* > elementGrad(dim);
+    for(unsigned j = 0; j < dim; j++) {
+      elementGrad[j] = NumericVector::build(LSOLVER, _comm).release();
+      elementGrad[j]->init(_msh->GetNumberOfElements(), nel, ghost, false, GHOSTED);
+    }
+
+    vector < double > sol;
+    vector < vector < double > > x(dim);
+    vector < double > phi, phiX;
+    vector < double > phi_x, phiX_x;
+    vector < double > phi_xx;
+    double weight;
+    std::vector < double > xg(dim);
+    std::vector < double > hElement(nel);
+
+    double solNorm2 = 0.;
+
+    // element residuals and element averaged gradients
+    for(int iel = _msh->_elementOffset[iproc]; iel < _msh->_elementOffset[iproc + 1]; iel++) {
+
+      short unsigned ielGeom = _msh->GetElementType(iel);
+      unsigned solDofs  = _msh->GetElementDofNumber(iel, solType);
+      unsigned xDofs  = _msh->GetElementDofNumber(iel, xType);
+
+      sol.resize(solDofs);
+      for(unsigned i = 0; i < solDofs; i++) {
+        unsigned iDof = _msh->GetSolutionDof(i, iel, solType);
+        sol[i] = (*_Sol[solIndex])(iDof);
+      }
+
+      for(int k = 0; k < dim; k++) {
+        x[k].resize(xDofs);
+      }
+      for(unsigned i = 0; i < xDofs; i++) {
+        unsigned iDof  = _msh->GetSolutionDof(i, iel, xType);
+        for(unsigned k = 0; k < dim; k++) {
+          x[k][i] = (*_msh->_topology->_Sol[k])(iDof);
+        }
+      }
+
+      double volume = 0.;
+      double residual2 = 0.;
+      std::vector < double > gradAverage(dim, 0.);
+
+      for(unsigned ig = 0; ig < _msh->_finiteElement[ielGeom][solType]->GetGaussPointNumber(); ig++) {
+        _msh->_finiteElement[ielGeom][solType]->Jacobian(x, ig, weight, phi, phi_x, phi_xx);
+        _msh->_finiteElement[ielGeom][xType]->Jacobian(x, ig, weight, phiX, phiX_x);
+
+        for(unsigned k = 0; k < dim; k++) {
+          xg[k] = 0.;
+          for(unsigned i = 0; i < xDofs; i++) {
+            xg[k] += x[k][i] * phiX[i];
+          }
+        }
+
+        double laplace = 0.;
+        for(unsigned i = 0; i < solDofs; i++) {
+          for(unsigned j = 0; j < dim; j++) {
+            laplace += sol[i] * phi_xx[i * dim2 + j];
+          }
+        }
+        for(unsigned j = 0; j < dim; j++) {
+          double solGradig = 0.;
+          for(unsigned i = 0; i < solDofs; i++) {
+            solGradig += sol[i] * phi_x[i * dim + j];
+          }
+          gradAverage[j] += solGradig * weight;
+          solNorm2 += solGradig * solGradig * weight;
+        }
+
+        double f = (sourceFunction) ? sourceFunction(xg) : 0.;
+        residual2 += (f + laplace) * (f + laplace) * weight;
+        volume += weight;
+      }
+
+      hElement[iel - elementOffset] = pow(volume, 1. / dim);
+      elementError2[iel - elementOffset] += hElement[iel - elementOffset] * hElement[iel - elementOffset] * residual2;
+
+      for(unsigned j = 0; j < dim; j++) {
+        elementGrad[j]->set(iel, gradAverage[j] / volume);
+      }
+    }
+
+    for(unsigned j = 0; j < dim; j++) {
+      elementGrad[j]->close();
+    }
+
+    // jumps of the normal gradient on the interior faces
+    vector < vector < double > > faceX(dim);
+    vector < double > normal;
+
+    for(int iel = _msh->_elementOffset[iproc]; iel < _msh->_elementOffset[iproc + 1]; iel++) {
+
+      unsigned xDofs  = _msh->GetElementDofNumber(iel, xType);
+      for(int k = 0; k < dim; k++) {
+        x[k].resize(xDofs);
+      }
+      for(unsigned i = 0; i < xDofs; i++) {
+        unsigned iDof  = _msh->GetSolutionDof(i, iel, xType);
+        for(unsigned k = 0; k < dim; k++) {
+          x[k][i] = (*_msh->_topology->_Sol[k])(iDof);
+        }
+      }
+
+      double jump2 = 0.;
+
+      for(unsigned jface = 0; jface < _msh->GetElementFaceNumber(iel); jface++) {
+        int jel = _msh->el->GetFaceElementIndex(iel, jface) - 1;
+        if(jel >= 0) {
+          std::vector < double > gradJump(dim);
+          for(unsigned j = 0; j < dim; j++) {
+            gradJump[j] = (*elementGrad[j])(iel) - (*elementGrad[j])(jel);
+          }
+
+          const unsigned faceGeom = _msh->GetElementFaceType(iel, jface);
+          unsigned faceDofs = _msh->GetElementFaceDofNumber(iel, jface, xType);
+          for(int k = 0; k < dim; k++) {
+            faceX[k].resize(faceDofs);
+          }
+          for(unsigned i = 0; i < faceDofs; i++) {
+            unsigned inode = _msh->GetLocalFaceVertexIndex(iel, jface, i);
+            for(unsigned k = 0; k < dim; k++) {
+              faceX[k][i] = x[k][inode];
+            }
+          }
+
+          double faceArea = 0.;
+          double faceJump2 = 0.;
+          for(unsigned ig = 0; ig < _msh->_finiteElement[faceGeom][xType]->GetGaussPointNumber(); ig++) {
+            _msh->_finiteElement[faceGeom][xType]->JacobianSur(faceX, ig, weight, phiX, phiX_x, normal);
+            double jump = 0.;
+            for(unsigned j = 0; j < dim; j++) {
+              jump += gradJump[j] * normal[j];
+            }
+            faceJump2 += jump * jump * weight;
+            faceArea += weight;
+          }
+          double hFace = (dim == 1) ? hElement[iel - elementOffset] : pow(faceArea, 1. / (dim - 1));
+          jump2 += 0.5 * hFace * faceJump2;
+        }
+      }
+      elementError2[iel - elementOffset] += jump2;
+    }
+
+    for(unsigned j = 0; j < dim; j++) {
+      delete elementGrad[j];
+    }
+
+    double solNorm2All;
+    MPI_Allreduce(&solNorm2, &solNorm2All, 1, MPI_DOUBLE, MPI_SUM, _comm);
+    return solNorm2All;
+  }
+
+
+  bool Solution::FlagAMRRegionBasedOnDorflerMarking(const std::vector <double> &elementError2, const double &theta) {
+
+    unsigned iproc = _msh->processor_id();
+    unsigned elementOffset = _msh->_elementOffset[iproc];
+
+    Solution* AMR = _msh->_topology;
+    unsigned  AMRIndex = AMR->GetIndex("AMR");
+    AMR->_Sol[AMRIndex]->zero();
+
+    double local[2] = {0., 0.};
+    for(unsigned i = 0; i < elementError2.size(); i++) {
+      local[0] += elementError2[i];
+      local[1] = std::max(local[1], elementError2[i]);
+    }
+    double error2;
+    double error2Max;
+    MPI_Allreduce(&local[0], &error2, 1, MPI_DOUBLE, MPI_SUM, _comm);
+    MPI_Allreduce(&local[1], &error2Max, 1, MPI_DOUBLE, MPI_MAX, _comm);
+
+    // bulk criterion: the sum S(t) of the errors above the threshold t decreases with t,
+    // the largest t with S(t) >= theta * error2 is found by bisection with one reduction per step
+    double tMin = 0.;
+    double tMax = error2Max;
+    while(tMax - tMin > 1.0e-10 * error2Max) {
+      double t = 0.5 * (tMin + tMax);
+      double localSum = 0.;
+      for(unsigned i = 0; i < elementError2.size(); i++) {
+        if(elementError2[i] >= t) localSum += elementError2[i];
+      }
+      double sum;
+      MPI_Allreduce(&localSum, &sum, 1, MPI_DOUBLE, MPI_SUM, _comm);
+      if(sum >= theta * error2) tMin = t;
+      else tMax = t;
+    }
+
+    int localCounter = 0;
+    if(error2 > 0.) {
+      for(unsigned i = 0; i < elementError2.size(); i++) {
+        unsigned iel = elementOffset + i;
+        if(elementError2[i] >= tMin && _msh->el->GetIfElementCanBeRefined(iel)) {
+          AMR->_Sol[AMRIndex]->set(iel, 1.);
+          localCounter++;
+        }
+      }
+    }
+    AMR->_Sol[AMRIndex]->close();
+
+    int counter;
+    MPI_Allreduce(&localCounter, &counter, 1, MPI_INT, MPI_SUM, _comm);
+
+    std::cout << "Dorfler marking: " << counter << " elements flagged, estimated error = " << sqrt(error2) << std::endl;
+
+    return (counter == 0) ? true : false;
+  }
+
+
   void Solution::BuildGradMatrixStructure(unsigned SolType) {
 
     if(SolType < 3 && _GradMat[SolType][0] == 0) {
@@ -1196,7 +1627,7 @@ _removeNullSpace[old_size + s] = false;
       int nc_loc = _msh->dofmap_get_own_size(SolType, _iproc);
 
       for(int i = 0; i < dim; i++) {
-        _GradMat[SolType][i] = SparseMatrix::build().release();
+        _GradMat[SolType][i] = SparseMatrix::build(LSOLVER, _comm).release();
         _GradMat[SolType][i]->init(nr, nc, nr_loc, nc_loc, 27, 27);
       }
 
@@ -1267,12 +1698,20 @@ _removeNullSpace[old_size + s] = false;
           }
         }
 
-        _msh->_finiteElement[ielt][SolType]->Jacobian(coordinates, 0, weight, phi, gradphi, nablaphi);
-
+        double volume = 0.;
+        for(unsigned ig = 0; ig < _msh->_finiteElement[ielt][SolType]->GetGaussPointNumber(); ig++) {
+          _msh->_finiteElement[ielt][SolType]->Jacobian(coordinates, ig, weight, phi, gradphi, nablaphi);
+          for(int i = 0; i < nve; i++) {
+            for(int j = 0; j < dim; j++) {
+              B[j][i] += gradphi[i * dim + j] * weight;
+            }
+          }
+          volume += weight;
+        }
 
         for(int i = 0; i < nve; i++) {
           for(int j = 0; j < dim; j++) {
-            B[j][i] = gradphi[i * dim + j];
+            B[j][i] /= volume;
           }
         }
 
@@ -1309,6 +1748,106 @@ _removeNullSpace[old_size + s] = false;
     }
   }
 
+  void Solution::InitSolutionHistory(const std::vector <unsigned> &solIndex, const unsigned &depth) {
+
+    FreeSolutionHistory();
+
+    _solHistoryIndex = solIndex;
+    _solHistory.resize(depth);
+    _solHistoryTime.assign(depth, 0.);
+
+    for(unsigned k = 0; k < depth; k++) {
+      _solHistory[k].assign(_Sol.size(), NULL);
+      for(unsigned j = 0; j < solIndex.size(); j++) {
+        unsigned i = solIndex[j];
+        _solHistory[k][i] = NumericVector::build(LSOLVER, _comm).release();
+        _solHistory[k][i]->init(*_Sol[i]);
+      }
+    }
+    _solHistoryHead = depth - 1;
+    _solHistorySize = 0;
+  }
+
+  void Solution::FreeSolutionHistory() {
+    for(unsigned k = 0; k < _solHistory.size(); k++) {
+      for(unsigned i = 0; i < _solHistory[k].size(); i++) {
+        if(_solHistory[k][i]) delete _solHistory[k][i];
+      }
+    }
+    _solHistory.clear();
+    _solHistoryTime.clear();
+    _solHistoryIndex.clear();
+    _solHistoryHead = 0;
+    _solHistorySize = 0;
+  }
+
+  void Solution::PushSolutionHistory(const double &time) {
+
+    unsigned depth = _solHistory.size();
+    if(depth == 0) {
+      std::cout << "Error in Solution::PushSolutionHistory: the solution history is not initialized" << std::endl;
+      abort();
+    }
+
+    // the new entry overwrites the oldest one, the other slots are untouched
+    _solHistoryHead = (_solHistoryHead + 1) % depth;
+    for(unsigned j = 0; j < _solHistoryIndex.size(); j++) {
+      unsigned i = _solHistoryIndex[j];
+      *(_solHistory[_solHistoryHead][i]) = *(_Sol[i]);
+    }
+    _solHistoryTime[_solHistoryHead] = time;
+    if(_solHistorySize < depth) _solHistorySize++;
+  }
+
+  NumericVector* Solution::GetSolutionHistory(const unsigned &k, const unsigned &solIndex) {
+    if(k >= _solHistorySize || _solHistory[0][solIndex] == NULL) {
+      std::cout << "Error in Solution::GetSolutionHistory: entry " << k << " of solution " << solIndex << " is not in the history" << std::endl;
+      abort();
+    }
+    unsigned depth = _solHistory.size();
+    return _solHistory[(_solHistoryHead + depth - k) % depth][solIndex];
+  }
+
+  double Solution::GetSolutionHistoryTime(const unsigned &k) const {
+    if(k >= _solHistorySize) {
+      std::cout << "Error in Solution::GetSolutionHistoryTime: entry " << k << " is not in the history" << std::endl;
+      abort();
+    }
+    unsigned depth = _solHistory.size();
+    return _solHistoryTime[(_solHistoryHead + depth - k) % depth];
+  }
+
+  unsigned Solution::ExtrapolateSolution(const double &time, const unsigned &order) {
+
+    if(_solHistorySize == 0) return 0;
+
+    unsigned n = (order + 1 < _solHistorySize) ? order + 1 : _solHistorySize;
+
+    // Lagrange basis of the last n times evaluated at time: with a constant time step and n = 2, 3 it gives
+    // 2 y_n - y_n-1 and 3 y_n - 3 y_n-1 + y_n-2, the predictors consistent with BDF1 and BDF2
+    std::vector <double> c(n, 1.);
+    for(unsigned k = 0; k < n; k++) {
+      double tk = GetSolutionHistoryTime(k);
+      for(unsigned l = 0; l < n; l++) {
+        if(l != k) {
+          double tl = GetSolutionHistoryTime(l);
+          c[k] *= (time - tl) / (tk - tl);
+        }
+      }
+    }
+
+    for(unsigned j = 0; j < _solHistoryIndex.size(); j++) {
+      unsigned i = _solHistoryIndex[j];
+      _Sol[i]->zero();
+      for(unsigned k = 0; k < n; k++) {
+        _Sol[i]->add(c[k], *GetSolutionHistory(k, i));
+      }
+      _Sol[i]->close();
+    }
+
+    return n - 1;
+  }
+
 
 } //end namespace femus
 
@@ -82,6 +82,29 @@ namespace femus {
 //       void UpdateSolAndRes(const vector <unsigned> &_SolPdeIndex,  NumericVector* EPS, NumericVector* RES, const vector <vector <unsigned> > &KKoffset);
 
       void UpdateSol(const std::vector <unsigned> &_SolPdeIndex,  NumericVector* EPS, const std::vector <std::vector <unsigned> > &KKoffset);
+      /** With overlap on, UpdateSol only starts the update of the ghost values of the solution, that is completed by EndGhostUpdate.
+       * Meanwhile only the owned values can be read, e.g. to assemble the interior elements of the mesh */
+      void SetOverlapGhostUpdate(const bool &overlap) {
+        _overlapGhostUpdate = overlap;
+      }
+
+      /** Complete the ghost value update started by UpdateSol, it does nothing if no update is pending */
+      void EndGhostUpdate();
+
+      /** The residual _Res and the correction _Eps of a Pde type solution are allocated on first use, by the systems that solve for it */
+      void AllocateResEps(const unsigned &i);
+
+      void AllocateResEps(const std::vector <unsigned> &solIndex);
+
+      void FreeResEps(const unsigned &i);
+
+      bool HasResEps(const unsigned &i) const {
+        return _Res[i] != NULL;
+      }
+
+      /** Bytes of the owned part of the vectors of the solution i on this process, and bytes saved by not allocating _Res and _Eps */
+      void GetVectorMemory(const unsigned &i, unsigned long &allocatedBytes, unsigned long &savedBytes) const;
+
       /** */
       void UpdateRes(const std::vector <unsigned> &_SolPdeIndex, NumericVector* _RES, const std::vector <std::vector <unsigned> > &KKoffset);
 
@@ -90,6 +113,28 @@ namespace femus {
       
       void ResetSolutionToOldSolution();
 
+      /** Solution history: ring buffer with the last depth solutions solIndex and their times, the old entries are never moved */
+      void InitSolutionHistory(const std::vector <unsigned> &solIndex, const unsigned &depth);
+
+      /** Store the current solution at time in the slot of the oldest entry */
+      void PushSolutionHistory(const double &time);
+
+      /** Number of solutions stored in the history */
+      unsigned GetSolutionHistorySize() const {
+        return _solHistorySize;
+      }
+
+      /** The k-th most recent solution solIndex of the history, k = 0 is the last one pushed */
+      NumericVector* GetSolutionHistory(const unsigned &k, const unsigned &solIndex);
+
+      double GetSolutionHistoryTime(const unsigned &k) const;
+
+      /** Set the solutions of the history to the polynomial extrapolation at time of the last order + 1 entries,
+       * the order is reduced if the history is shorter. It returns the order actually used */
+      unsigned ExtrapolateSolution(const double &time, const unsigned &order);
+
+      void FreeSolutionHistory();
+
       /** Get a const solution (Numeric Vector) by name @todo make the _Sol object private */
       const NumericVector& GetSolutionName(const char* var) const {
         return *_Sol[GetIndex(var)];
@@ -111,8 +156,22 @@ namespace femus {
       bool FlagAMRRegionBasedOnErroNormAdaptive(const std::vector <unsigned> &solIndex, std::vector <double> &AMRthreshold, 
 						const unsigned& normType, const double &neighborThresholdValue);
 
+      /** Zienkiewicz-Zhu estimator: add to elementError2[iel - elementOffset] the squared L2 norm on the owned element iel of the
+       * difference between the recovered (patch averaged) gradient and the FE gradient of the Lagrange solution solIndex.
+       * Return the squared H1 seminorm of the solution, the same on all processes */
+      double GetZZErrorEstimator(const unsigned &solIndex, std::vector <double> &elementError2);
 
-      /** Build Grad Matrix structure for SolType 0,1,2 */
+      /** Residual estimator for - Laplace(u) = f: add to elementError2 h^2 |f + Laplace(u_h)|^2_e + 1/2 sum_F h_F |[grad(u_h).n]|^2_F,
+       * the normal jumps are evaluated with the element averaged gradients. Return the squared H1 seminorm of the solution */
+      double GetResidualErrorEstimator(const unsigned &solIndex, double (*sourceFunction)(const std::vector < double > &x),
+                                       std::vector <double> &elementError2);
+
+      /** Flag for refinement the smallest set of owned elements whose estimated errors sum to at least theta times the total,
+       * the threshold is selected globally by bisection. Return true if no element has been flagged */
+      bool FlagAMRRegionBasedOnDorflerMarking(const std::vector <double> &elementError2, const double &theta);
+
+
+      /** Build Grad Matrix structure for SolType 0,1,2: the row iel gives the element averaged gradient */
       void BuildGradMatrixStructure(unsigned SolType);
 
       /** Init and set to zero The AMR Eps vector */
@@ -192,6 +251,15 @@ namespace femus {
       
       bool _FSI;
 
+      bool _overlapGhostUpdate;
+
+      /** Solution history [slot][solIndex], the slot of the k-th most recent entry is (_solHistoryHead - k) mod depth */
+      std::vector < std::vector <NumericVector*> > _solHistory;
+      std::vector <double> _solHistoryTime;
+      std::vector <unsigned> _solHistoryIndex;
+      unsigned _solHistoryHead;
+      unsigned _solHistorySize;
+
   };
 
 
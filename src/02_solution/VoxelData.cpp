@@ -0,0 +1,267 @@
+/*=========================================================================
+
+ Program: FEMuS
+ Module: VoxelData
+ Authors: Eugenio Aulisa
+
+ Copyright (c) FEMuS
+ All rights reserved.
+
+ This software is distributed WITHOUT ANY WARRANTY; without even
+ the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "VoxelData.hpp"
+#include "MultiLevelSolution.hpp"
+#include "NumericVector.hpp"
+
+#include <mpi.h>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include <stdlib.h>
+
+#ifdef HAVE_HDF5
+#include "hdf5.h"
+#endif
+
+namespace femus {
+
+  // ******************
+  VoxelData::VoxelData(const std::vector < unsigned > &n, const std::vector < double > &origin, const std::vector < double > &h, const unsigned &nComponents) {
+
+    if(n.size() != 3 || origin.size() != 3 || h.size() != 3) {
+      std::cout << "Error in VoxelData::VoxelData: n, origin and h must have size 3" << std::endl;
+      abort();
+    }
+
+    _nComponents = nComponents;
+    for(unsigned d = 0; d < 3; d++) {
+      _n[d] = n[d];
+      _origin[d] = origin[d];
+      _h[d] = h[d];
+      _begin[d] = 0;
+      _end[d] = 0;
+    }
+    _msh = NULL;
+  }
+
+  // ******************
+  void VoxelData::SetLocalBox(Mesh *msh) {
+
+    _msh = msh;
+
+    unsigned iproc = msh->processor_id();
+    unsigned dim = msh->GetDimension();
+
+    double xMin[3] = {0., 0., 0.};
+    double xMax[3] = {0., 0., 0.};
+    bool empty = true;
+
+    for(unsigned iel = msh->_elementOffset[iproc]; iel < msh->_elementOffset[iproc + 1]; iel++) {
+      unsigned nDofx = msh->GetElementDofNumber(iel, 2);
+      for(unsigned i = 0; i < nDofx; i++) {
+        unsigned xDof = msh->GetSolutionDof(i, iel, 2);
+        for(unsigned d = 0; d < dim; d++) {
+          double x = (*msh->_topology->_Sol[d])(xDof);
+          if(empty || x < xMin[d]) xMin[d] = x;
+          if(empty || x > xMax[d]) xMax[d] = x;
+        }
+        empty = false;
+      }
+    }
+
+    for(unsigned d = 0; d < 3; d++) {
+      if(empty) {
+        _begin[d] = 0;
+        _end[d] = 0;
+      }
+      else {
+        // the trilinear stencil of x uses the voxels floor(t) and floor(t) + 1, t = (x - origin) / h - 1/2
+        int begin = static_cast < int >(floor((xMin[d] - _origin[d]) / _h[d] - 0.5));
+        int end = static_cast < int >(floor((xMax[d] - _origin[d]) / _h[d] - 0.5)) + 2;
+        int n = static_cast < int >(_n[d]);
+        _begin[d] = static_cast < unsigned >((begin < 0) ? 0 : ((begin > n - 1) ? n - 1 : begin));
+        _end[d] = static_cast < unsigned >((end < 1) ? 1 : ((end > n) ? n : end));
+      }
+    }
+
+    _data.assign((_end[0] - _begin[0]) * (_end[1] - _begin[1]) * (_end[2] - _begin[2]) * _nComponents, 0.);
+  }
+
+  // ******************
+  void VoxelData::ReadRaw(const std::string &filename, Mesh *msh, const unsigned long &headerBytes) {
+
+    SetLocalBox(msh);
+
+    MPI_File fh;
+    if(MPI_File_open(msh->GetCommunicator(), const_cast < char* >(filename.c_str()), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+      std::cout << "Error in VoxelData::ReadRaw: the file " << filename << " cannot be opened" << std::endl;
+      abort();
+    }
+
+    // every process sees only its sub-box of the [n0][n1][n2][nComponents] array, the read is collective
+    int count = static_cast < int >(_data.size());
+    int sizes[4] = {static_cast < int >(_n[0]), static_cast < int >(_n[1]), static_cast < int >(_n[2]), static_cast < int >(_nComponents)};
+    int subSizes[4] = {1, 1, 1, static_cast < int >(_nComponents)};
+    int starts[4] = {0, 0, 0, 0};
+    if(count > 0) {
+      for(unsigned d = 0; d < 3; d++) {
+        subSizes[d] = static_cast < int >(_end[d] - _begin[d]);
+        starts[d] = static_cast < int >(_begin[d]);
+      }
+    }
+
+    MPI_Datatype fileType;
+    MPI_Type_create_subarray(4, sizes, subSizes, starts, MPI_ORDER_C, MPI_DOUBLE, &fileType);
+    MPI_Type_commit(&fileType);
+
+    MPI_File_set_view(fh, static_cast < MPI_Offset >(headerBytes), MPI_DOUBLE, fileType, const_cast < char* >("native"), MPI_INFO_NULL);
+    MPI_File_read_all(fh, (count > 0) ? &_data[0] : NULL, count, MPI_DOUBLE, MPI_STATUS_IGNORE);
+
+    MPI_Type_free(&fileType);
+    MPI_File_close(&fh);
+  }
+
+  // ******************
+  void VoxelData::ReadHDF5(const std::string &filename, const std::string &datasetName, Mesh *msh) {
+
+#ifdef HAVE_HDF5
+    SetLocalBox(msh);
+
+    hid_t file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if(file < 0) {
+      std::cout << "Error in VoxelData::ReadHDF5: the file " << filename << " cannot be opened" << std::endl;
+      abort();
+    }
+    hid_t dataset = H5Dopen(file, datasetName.c_str(), H5P_DEFAULT);
+    hid_t fileSpace = H5Dget_space(dataset);
+
+    hsize_t start[4] = {_begin[0], _begin[1], _begin[2], 0};
+    hsize_t count[4] = {_end[0] - _begin[0], _end[1] - _begin[1], _end[2] - _begin[2], _nComponents};
+
+    if(_data.size() > 0) {
+      H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, start, NULL, count, NULL);
+      hid_t memSpace = H5Screate_simple(4, count, NULL);
+      H5Dread(dataset, H5T_NATIVE_DOUBLE, memSpace, fileSpace, H5P_DEFAULT, &_data[0]);
+      H5Sclose(memSpace);
+    }
+
+    H5Sclose(fileSpace);
+    H5Dclose(dataset);
+    H5Fclose(file);
+#else
+    std::cout << "Error in VoxelData::ReadHDF5: FEMuS is compiled without HDF5" << std::endl;
+    abort();
+#endif
+  }
+
+  // ******************
+  double VoxelData::Sample(const std::vector < double > &x, const unsigned &component) const {
+
+    unsigned i0[3], i1[3];
+    double f[3];
+
+    for(unsigned d = 0; d < 3; d++) {
+      double t = (d < x.size()) ? (x[d] - _origin[d]) / _h[d] - 0.5 : 0.;
+      int i = static_cast < int >(floor(t));
+      f[d] = t - i;
+      if(i < 0) {
+        i = 0;
+        f[d] = 0.;
+      }
+      else if(i >= static_cast < int >(_n[d]) - 1) {
+        i = _n[d] - 1;
+        f[d] = 0.;
+      }
+      i0[d] = static_cast < unsigned >(i);
+      i1[d] = (i0[d] + 1 < _n[d]) ? i0[d] + 1 : i0[d];
+
+      if(i0[d] < _begin[d] || i1[d] >= _end[d]) {
+        std::cout << "Error in VoxelData::Sample: the point is outside the sub-box read by this process" << std::endl;
+        abort();
+      }
+    }
+
+    unsigned m1 = _end[1] - _begin[1];
+    unsigned m2 = _end[2] - _begin[2];
+
+    double value = 0.;
+    for(unsigned a = 0; a < 2; a++) {
+      unsigned ia = (a == 0) ? i0[0] : i1[0];
+      double wa = (a == 0) ? 1. - f[0] : f[0];
+      for(unsigned b = 0; b < 2; b++) {
+        unsigned ib = (b == 0) ? i0[1] : i1[1];
+        double wb = (b == 0) ? 1. - f[1] : f[1];
+        for(unsigned c = 0; c < 2; c++) {
+          unsigned ic = (c == 0) ? i0[2] : i1[2];
+          double wc = (c == 0) ? 1. - f[2] : f[2];
+          unsigned index = (((ia - _begin[0]) * m1 + (ib - _begin[1])) * m2 + (ic - _begin[2])) * _nComponents + component;
+          value += wa * wb * wc * _data[index];
+        }
+      }
+    }
+    return value;
+  }
+
+  // ******************
+  void VoxelData::Project(MultiLevelSolution &mlSol, const std::vector < std::string > &solName) const {
+
+    unsigned level = mlSol._mlMesh->GetNumberOfLevels() - 1;
+    Mesh *msh = mlSol._mlMesh->GetLevel(level);
+    Solution *sol = mlSol.GetSolutionLevel(level);
+
+    if(msh != _msh) {
+      std::cout << "Error in VoxelData::Project: the voxels were read for a different mesh" << std::endl;
+      abort();
+    }
+    if(solName.size() > _nComponents) {
+      std::cout << "Error in VoxelData::Project: more solutions than voxel components" << std::endl;
+      abort();
+    }
+
+    unsigned iproc = msh->processor_id();
+    unsigned dim = msh->GetDimension();
+    std::vector < double > x(dim);
+
+    for(unsigned k = 0; k < solName.size(); k++) {
+      unsigned solIndex = mlSol.GetIndex(solName[k].c_str());
+      unsigned solType = mlSol.GetSolutionType(solIndex);
+
+      for(unsigned iel = msh->_elementOffset[iproc]; iel < msh->_elementOffset[iproc + 1]; iel++) {
+        if(solType < 3) {
+          unsigned nDofs = msh->GetElementDofNumber(iel, solType);
+          for(unsigned i = 0; i < nDofs; i++) {
+            unsigned solDof = msh->GetSolutionDof(i, iel, solType);
+            if(solDof >= msh->_dofOffset[solType][iproc] && solDof < msh->_dofOffset[solType][iproc + 1]) {
+              unsigned xDof = msh->GetSolutionDof(i, iel, 2);
+              for(unsigned d = 0; d < dim; d++) {
+                x[d] = (*msh->_topology->_Sol[d])(xDof);
+              }
+              sol->_Sol[solIndex]->set(solDof, Sample(x, k));
+            }
+          }
+        }
+        else {
+          unsigned nVertices = msh->GetElementDofNumber(iel, 0);
+          std::fill(x.begin(), x.end(), 0.);
+          for(unsigned i = 0; i < nVertices; i++) {
+            unsigned xDof = msh->GetSolutionDof(i, iel, 2);
+            for(unsigned d = 0; d < dim; d++) {
+              x[d] += (*msh->_topology->_Sol[d])(xDof) / nVertices;
+            }
+          }
+          unsigned nDofs = msh->GetElementDofNumber(iel, solType);
+          for(unsigned i = 0; i < nDofs; i++) {
+            unsigned solDof = msh->GetSolutionDof(i, iel, solType);
+            sol->_Sol[solIndex]->set(solDof, (i == 0) ? Sample(x, k) : 0.);
+          }
+        }
+      }
+      sol->_Sol[solIndex]->close();
+    }
+  }
+
+} //end namespace femus
@@ -0,0 +1,78 @@
+/*=========================================================================
+
+ Program: FEMuS
+ Module: VoxelData
+ Authors: Eugenio Aulisa
+
+ Copyright (c) FEMuS
+ All rights reserved.
+
+ This software is distributed WITHOUT ANY WARRANTY; without even
+ the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#ifndef __femus_solution_VoxelData_hpp__
+#define __femus_solution_VoxelData_hpp__
+
+//----------------------------------------------------------------------------
+// includes :
+//----------------------------------------------------------------------------
+#include "FemusConfig.hpp"
+#include "Mesh.hpp"
+
+#include <vector>
+#include <string>
+
+
+namespace femus {
+
+  class MultiLevelSolution;
+
+  /**
+   * Structured 3D image data (voxels) sampled into finite element fields.
+   * The voxel (i, j, k) has center origin + (i + 1/2, j + 1/2, k + 1/2) h and nComponents double values, the file layout is
+   * C order [n0][n1][n2][nComponents]. Each process reads only the sub-box of voxels around its own elements,
+   * with a collective MPI-IO read of the raw binary file or a hyperslab of an HDF5 dataset, and Project evaluates
+   * the trilinear interpolant at the coordinates of the owned dofs of the solutions, with no global search.
+   */
+
+  class VoxelData {
+
+    public:
+
+      VoxelData(const std::vector < unsigned > &n, const std::vector < double > &origin, const std::vector < double > &h, const unsigned &nComponents);
+
+      /** Read the voxels around the elements of msh owned by this process, the data start after headerBytes bytes */
+      void ReadRaw(const std::string &filename, Mesh *msh, const unsigned long &headerBytes = 0);
+
+      /** Read the voxels around the elements of msh owned by this process from the dataset [n0][n1][n2][nComponents] */
+      void ReadHDF5(const std::string &filename, const std::string &datasetName, Mesh *msh);
+
+      /** Trilinear interpolation of the component at x, x has to be in the sub-box read by this process */
+      double Sample(const std::vector < double > &x, const unsigned &component) const;
+
+      /** Set the component k in the solution solName[k] at the owned dofs of the finest level, the mesh has to be the one used to read.
+       * Lagrange dofs take the value at their node, discontinuous solutions the value at the element center (zero slopes) */
+      void Project(MultiLevelSolution &mlSol, const std::vector < std::string > &solName) const;
+
+    private:
+
+      /** Voxel index range [_begin, _end) that covers the elements of msh owned by this process */
+      void SetLocalBox(Mesh *msh);
+
+      unsigned _nComponents;
+      unsigned _n[3];
+      double _origin[3];
+      double _h[3];
+
+      Mesh *_msh;
+      unsigned _begin[3];
+      unsigned _end[3];
+      std::vector < double > _data;
+  };
+
+} //end namespace femus
+
+#endif
@@ -19,6 +19,14 @@
 =========================================================================*/
 
 #include "ExplicitSystem.hpp"
+#include "MultiLevelProblem.hpp"
+#include "MultiLevelSolution.hpp"
+#include "NumericVector.hpp"
+#include "ElemType.hpp"
+
+#include <cmath>
+#include <limits>
+#include <mpi.h>
 
 
 namespace femus {
@@ -30,16 +38,288 @@ namespace femus {
 ExplicitSystem::ExplicitSystem (MultiLevelProblem& ml_probl,
 				const std::string& name_in,
 				const unsigned int number_in, const LinearEquationSolverType & smoother_type) :
-  System (ml_probl, name_in, number_in, smoother_type)
+  System (ml_probl, name_in, number_in, smoother_type),
+  _explicitScheme(SSP_RK3),
+  _lumpedMassType(HRZ_LUMPING),
+  _lumpedMassIsAssembled(false),
+  _firstStep(true),
+  _waveSpeed(1.),
+  _courantNumber(0.5),
+  _useStableTimeStep(false),
+  _waveSpeedFunction(NULL)
 {
 }
 
 ExplicitSystem::~ExplicitSystem() {
+  ClearExplicitVectors();
 }
   
 
 void ExplicitSystem::init() {
-  
+
+  InitExplicitVectors();
+  AssembleLumpedMass();
+
+  FreeUnusedResEps();
+
+}
+
+// ------------------------------------------------------------
+void ExplicitSystem::InitExplicitVectors() {
+
+  ClearExplicitVectors();
+
+  Solution *sol = _solution[_gridn - 1];
+  unsigned nPde = _SolSystemPdeIndex.size();
+
+  sol->AllocateResEps(_SolSystemPdeIndex);
+
+  _lumpedMass.resize(nPde);
+  _inverseLumpedMass.resize(nPde);
+  _acceleration.resize(nPde);
+  _velocity.resize(nPde);
+  _solutionStart.resize(nPde);
+
+  for(unsigned k = 0; k < nPde; k++) {
+    NumericVector *solK = sol->_Sol[_SolSystemPdeIndex[k]];
+
+    _lumpedMass[k] = NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release();
+    _lumpedMass[k]->init(*solK);
+    _inverseLumpedMass[k] = NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release();
+    _inverseLumpedMass[k]->init(*solK);
+    _acceleration[k] = NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release();
+    _acceleration[k]->init(*solK);
+    _solutionStart[k] = NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release();
+    _solutionStart[k]->init(*solK);
+    _velocity[k] = NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release();
+    _velocity[k]->init(*solK);
+    _velocity[k]->zero();
+  }
+
+  _lumpedMassIsAssembled = false;
+  _firstStep = true;
+}
+
+// ------------------------------------------------------------
+void ExplicitSystem::ClearExplicitVectors() {
+
+  for(unsigned k = 0; k < _lumpedMass.size(); k++) {
+    delete _lumpedMass[k];
+    delete _inverseLumpedMass[k];
+    delete _acceleration[k];
+    delete _velocity[k];
+    delete _solutionStart[k];
+  }
+  _lumpedMass.resize(0);
+  _inverseLumpedMass.resize(0);
+  _acceleration.resize(0);
+  _velocity.resize(0);
+  _solutionStart.resize(0);
+}
+
+// ------------------------------------------------------------
+void ExplicitSystem::AssembleLumpedMass() {
+
+  if(_lumpedMass.size() != _SolSystemPdeIndex.size()) InitExplicitVectors();
+
+  Mesh *msh = _msh[_gridn - 1];
+  unsigned iproc = msh->processor_id();
+  unsigned dim = msh->GetDimension();
+  unsigned xType = 2;
+
+  vector < vector < double > > x(dim);
+  vector < double > phi;
+  vector < double > phi_x;
+  double weight;
+
+  vector < double > mLocal;
+  vector < int > mDof;
+
+  for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
+
+    unsigned solType = _ml_sol->GetSolutionType(_SolSystemPdeIndex[k]);
+    _lumpedMass[k]->zero();
+
+    for(int iel = msh->_elementOffset[iproc]; iel < msh->_elementOffset[iproc + 1]; iel++) {
+
+      short unsigned ielGeom = msh->GetElementType(iel);
+      unsigned solDofs  = msh->GetElementDofNumber(iel, solType);
+      unsigned xDofs  = msh->GetElementDofNumber(iel, xType);
+
+      for(int d = 0; d < dim; d++) {
+        x[d].resize(xDofs);
+      }
+      for(unsigned i = 0; i < xDofs; i++) {
+        unsigned iDof  = msh->GetSolutionDof(i, iel, xType);
+        for(unsigned d = 0; d < dim; d++) {
+          x[d][i] = (*msh->_topology->_Sol[d])(iDof);
+        }
+      }
+
+      // row sum: m_i = int phi_i; HRZ: m_i = int phi_i^2 scaled to preserve the element mass
+      mLocal.assign(solDofs, 0.);
+      double elementMass = 0.;
+      for(unsigned ig = 0; ig < msh->_finiteElement[ielGeom][solType]->GetGaussPointNumber(); ig++) {
+        msh->_finiteElement[ielGeom][solType]->Jacobian(x, ig, weight, phi, phi_x);
+        elementMass += weight;
+        for(unsigned i = 0; i < solDofs; i++) {
+          mLocal[i] += (_lumpedMassType == HRZ_LUMPING) ? phi[i] * phi[i] * weight : phi[i] * weight;
+        }
+      }
+      if(_lumpedMassType == HRZ_LUMPING) {
+        double diagonalMass = 0.;
+        for(unsigned i = 0; i < solDofs; i++) diagonalMass += mLocal[i];
+        for(unsigned i = 0; i < solDofs; i++) mLocal[i] *= elementMass / diagonalMass;
+      }
+
+      mDof.resize(solDofs);
+      for(unsigned i = 0; i < solDofs; i++) {
+        mDof[i] = msh->GetSolutionDof(i, iel, solType);
+      }
+      _lumpedMass[k]->add_vector_blocked(mLocal, mDof);
+    }
+    _lumpedMass[k]->close();
+
+    for(int i = _lumpedMass[k]->first_local_index(); i < _lumpedMass[k]->last_local_index(); i++) {
+      double mi = (*_lumpedMass[k])(i);
+      if(mi <= 0.) {
+        std::cout << "Error in ExplicitSystem::AssembleLumpedMass: non positive lumped mass for the unknown "
+                  << _ml_sol->GetSolutionName(_SolSystemPdeIndex[k]) << ", use HRZ_LUMPING" << std::endl;
+        abort();
+      }
+      _inverseLumpedMass[k]->set(i, 1. / mi);
+    }
+    _inverseLumpedMass[k]->close();
+  }
+
+  _lumpedMassIsAssembled = true;
+}
+
+// ------------------------------------------------------------
+void ExplicitSystem::AssembleResidual() {
+
+  unsigned level = _gridn - 1;
+  Solution *sol = _solution[level];
+
+  for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
+    sol->_Res[_SolSystemPdeIndex[k]]->zero();
+  }
+
+  _levelToAssemble = level;
+  _assemble_system_function(_equation_systems);
+
+  for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
+    NumericVector *res = sol->_Res[_SolSystemPdeIndex[k]];
+    NumericVector *bdc = sol->_Bdc[_SolSystemPdeIndex[k]];
+    res->close();
+    for(int i = res->first_local_index(); i < res->last_local_index(); i++) {
+      if((*bdc)(i) < 1.5) res->set(i, 0.);
+    }
+    res->close();
+  }
+}
+
+// ------------------------------------------------------------
+void ExplicitSystem::ComputeAcceleration() {
+
+  AssembleResidual();
+
+  Solution *sol = _solution[_gridn - 1];
+  for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
+    _acceleration[k]->pointwise_mult(*sol->_Res[_SolSystemPdeIndex[k]], *_inverseLumpedMass[k]);
+  }
+}
+
+// ------------------------------------------------------------
+void ExplicitSystem::Advance(const double &dt) {
+
+  if(!_lumpedMassIsAssembled) AssembleLumpedMass();
+
+  Solution *sol = _solution[_gridn - 1];
+  unsigned nPde = _SolSystemPdeIndex.size();
+
+  if(_explicitScheme == CENTRAL_DIFFERENCE) {
+    // v_{n+1/2} = v_{n-1/2} + dt M^-1 R(u_n), u_{n+1} = u_n + dt v_{n+1/2}, the first step starts from v_0
+    ComputeAcceleration();
+    double dtv = (_firstStep) ? 0.5 * dt : dt;
+    for(unsigned k = 0; k < nPde; k++) {
+      NumericVector *u = sol->_Sol[_SolSystemPdeIndex[k]];
+      _velocity[k]->add(dtv, *_acceleration[k]);
+      u->add(dt, *_velocity[k]);
+      u->close();
+    }
+    _firstStep = false;
+  }
+  else {
+    // Shu-Osher form: u^(i) = a_i u_n + (1 - a_i) (u^(i-1) + dt M^-1 R(u^(i-1)))
+    const double SSP_RK2_COEFF[2] = {0., 0.5};
+    const double SSP_RK3_COEFF[3] = {0., 0.75, 1. / 3.};
+    unsigned nStages = (_explicitScheme == SSP_RK2) ? 2 : 3;
+    const double *a = (_explicitScheme == SSP_RK2) ? SSP_RK2_COEFF : SSP_RK3_COEFF;
+
+    for(unsigned k = 0; k < nPde; k++) {
+      *_solutionStart[k] = *sol->_Sol[_SolSystemPdeIndex[k]];
+    }
+
+    for(unsigned s = 0; s < nStages; s++) {
+      ComputeAcceleration();
+      for(unsigned k = 0; k < nPde; k++) {
+        NumericVector *u = sol->_Sol[_SolSystemPdeIndex[k]];
+        u->add(dt, *_acceleration[k]);
+        if(a[s] != 0.) {
+          u->scale(1. - a[s]);
+          u->add(a[s], *_solutionStart[k]);
+        }
+        u->close();
+      }
+    }
+  }
+}
+
+// ------------------------------------------------------------
+double ExplicitSystem::GetStableTimeStep() {
+
+  Mesh *msh = _msh[_gridn - 1];
+  unsigned iproc = msh->processor_id();
+  unsigned dim = msh->GetDimension();
+
+  // node spacing is half the vertex spacing for quadratic unknowns
+  unsigned nodesPerEdge = 1;
+  for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
+    unsigned solType = _ml_sol->GetSolutionType(_SolSystemPdeIndex[k]);
+    if(solType == 1 || solType == 2) nodesPerEdge = 2;
+  }
+
+  double dtLocal = std::numeric_limits < double >::max();
+
+  for(int iel = msh->_elementOffset[iproc]; iel < msh->_elementOffset[iproc + 1]; iel++) {
+
+    double waveSpeed = (_waveSpeedFunction) ? _waveSpeedFunction(_equation_systems, iel) : _waveSpeed;
+    if(waveSpeed <= 0.) continue;
+
+    unsigned nVertices = msh->GetElementDofNumber(iel, 0);
+    double h2 = std::numeric_limits < double >::max();
+    for(unsigned i = 0; i < nVertices; i++) {
+      unsigned iDof = msh->GetSolutionDof(i, iel, 2);
+      for(unsigned j = i + 1; j < nVertices; j++) {
+        unsigned jDof = msh->GetSolutionDof(j, iel, 2);
+        double d2 = 0.;
+        for(unsigned d = 0; d < dim; d++) {
+          double dx = (*msh->_topology->_Sol[d])(iDof) - (*msh->_topology->_Sol[d])(jDof);
+          d2 += dx * dx;
+        }
+        if(d2 < h2) h2 = d2;
+      }
+    }
+
+    double dt = _courantNumber * sqrt(h2) / (nodesPerEdge * waveSpeed);
+    if(dt < dtLocal) dtLocal = dt;
+  }
+
+  double dtStable;
+  MPI_Allreduce(&dtLocal, &dtStable, 1, MPI_DOUBLE, MPI_MIN, msh->GetCommunicator());
+
+  return dtStable;
 }
 
 
@@ -20,16 +20,27 @@
 // includes :
 //----------------------------------------------------------------------------
 #include "System.hpp"
+#include "TransientSystem.hpp"
+#include "ExplicitTimeSteppingEnum.hpp"
+
+#include <vector>
 
 namespace femus {
 
 //------------------------------------------------------------------------------
 // Forward declarations
 //------------------------------------------------------------------------------
-
+class NumericVector;
 
 /**
- * The explicit system class
+ * The explicit system class.
+ * The system M du/dt = R(u) (SSP Runge-Kutta) or M d2u/dt2 = R(u) (central difference) is advanced in time on the finest level
+ * with the lumped mass matrix M, assembled once, and no matrix is allocated.
+ * Residual contract: the assemble function adds the element contributions of R(u), with the sign of M du/dt = R(u),
+ * to sol->_Res[solIndex] of the pde unknowns of the level GetLevelToAssemble(), in the solution dof numbering (msh->GetSolutionDof),
+ * e.g. with add_vector_blocked. Unlike the implicit systems it does not use the LinearEquationSolver _RES, KKoffset or _RESC.
+ * The vectors _Res are set to zero before the call, closed after it, and the rows of the Dirichlet dofs are set to zero.
+ * See applications/RK/ex3explicit.
  */
 
 class ExplicitSystem : public System {
@@ -56,14 +67,103 @@ public:
         return "Explicit";
     }
 
+    /** Set the time stepping scheme, default SSP_RK3 */
+    void SetExplicitTimeSteppingScheme(const ExplicitTimeSteppingScheme &scheme) {
+        _explicitScheme = scheme;
+    }
+
+    ExplicitTimeSteppingScheme GetExplicitTimeSteppingScheme() const {
+        return _explicitScheme;
+    }
+
+    /** Set the mass lumping, row sum or HRZ (diagonal scaling), default HRZ_LUMPING */
+    void SetLumpedMassType(const LumpedMassType &lumpedMassType) {
+        _lumpedMassType = lumpedMassType;
+        _lumpedMassIsAssembled = false;
+    }
+
+    /** Assemble the lumped mass, call it again after the mesh has changed */
+    void AssembleLumpedMass();
+
+    /** Lumped mass of the pde unknown k */
+    NumericVector* GetLumpedMass(const unsigned &k) {
+        return _lumpedMass[k];
+    }
+
+    /** Half step velocity of the pde unknown k, central difference only. Set it to the initial velocity before the first step */
+    NumericVector* GetVelocity(const unsigned &k) {
+        return _velocity[k];
+    }
+
+    /** Evaluate the residual R(u) element by element calling the assemble function */
+    void AssembleResidual();
+
+    /** Advance the solution of one step dt */
+    void Advance(const double &dt);
+
+    /** Constant wave speed used in the stable time step estimate */
+    void SetWaveSpeed(const double &waveSpeed) {
+        _waveSpeed = waveSpeed;
+    }
+
+    /** Attach a function that returns the maximum wave speed in the element iel, it replaces the constant wave speed */
+    void AttachWaveSpeedFunction(double (* waveSpeedFunction)(MultiLevelProblem &ml_prob, const unsigned &iel)) {
+        _waveSpeedFunction = waveSpeedFunction;
+    }
+
+    void SetCourantNumber(const double &courantNumber) {
+        _courantNumber = courantNumber;
+    }
+
+    /** Stable time step Courant * min(h / c) over the elements of the finest level, h is the node spacing of the element */
+    double GetStableTimeStep();
+
+    /** If true TransientSystem<ExplicitSystem>::MGsolve uses GetStableTimeStep() as time step */
+    void UseStableTimeStep(const bool &value) {
+        _useStableTimeStep = value;
+    }
+
+    bool GetUseStableTimeStep() const {
+        return _useStableTimeStep;
+    }
+
 protected:
 
+    /** vectors with the layout of the pde unknowns */
+    void InitExplicitVectors();
+
+    void ClearExplicitVectors();
+
+    /** _acceleration = M^-1 R(u) */
+    void ComputeAcceleration();
+
+    ExplicitTimeSteppingScheme _explicitScheme;
+    LumpedMassType _lumpedMassType;
+    bool _lumpedMassIsAssembled;
+    bool _firstStep;
+
+    std::vector < NumericVector* > _lumpedMass;
+    std::vector < NumericVector* > _inverseLumpedMass;
+    std::vector < NumericVector* > _acceleration;
+    std::vector < NumericVector* > _velocity;
+    std::vector < NumericVector* > _solutionStart;
+
+    double _waveSpeed;
+    double _courantNumber;
+    bool _useStableTimeStep;
+    double (* _waveSpeedFunction)(MultiLevelProblem &ml_prob, const unsigned &iel);
+
 private:
 
 
 };
 
 
+/** One explicit step: the time step is the stable one if UseStableTimeStep(true) has been called */
+template <>
+void TransientSystem<ExplicitSystem>::MGsolve(const MgSmootherType& mgSmootherType);
+
+
 } //end namespace femus
 
 
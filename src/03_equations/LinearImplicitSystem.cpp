@@ -14,6 +14,8 @@
 =========================================================================*/
 
 #include <iomanip>
+#include <cmath>
+#include <mpi.h>
 #include "LinearImplicitSystem.hpp"
 #include "LinearEquationSolver.hpp"
 #include "SparseMatrix.hpp"
@@ -38,6 +40,14 @@ namespace femus {
     _final_linear_residual(1.e20),
     _linearAbsoluteConvergenceTolerance(1.e-08),
     _mg_type(F_CYCLE),
+    _maxLevelToSolve(UINT_MAX),
+    _pMultigrid(false),
+    _pLinSolver(NULL),
+    _pPP(NULL),
+    _assembleMassMatrix(false),
+    _shiftK(NULL),
+    _shiftM(NULL),
+    _shiftF(NULL),
     _npre(1u),
     _npre0(1u),
     _npost(1u),
@@ -45,6 +55,9 @@ namespace femus {
     _maxAMRlevels(0),
     _AMRnorm(0),
     _AMReighborThresholdValue(0.),
+    _AMRestimator(0),
+    _AMRtheta(0.5),
+    _AMRsourceFunction(NULL),
     _smootherType(smoother_type),
     _includeCoarseLevelSmoother(INCLUDE_COARSE_LEVEL_FALSE),
     _MGmatrixFineReuse(false),
@@ -73,6 +86,20 @@ namespace femus {
       delete _RRamr[ig];
     }
 
+    if(_pLinSolver) {
+      _pLinSolver->DeletePde();
+      delete _pLinSolver;
+    }
+    delete _pPP;
+    delete _shiftK;
+    delete _shiftM;
+    delete _shiftF;
+    for(unsigned ig = 0; ig < _pBdc.size(); ig++) {
+      for(unsigned k = 0; k < _pBdc[ig].size(); k++) {
+        if(_pSolIsCoarsened[k]) delete _pBdc[ig][k];
+      }
+    }
+
     _NSchurVar_test = 0;
     _numblock_test = 0;
     _numblock_all_test = 0;
@@ -141,6 +168,42 @@ namespace femus {
     for(unsigned i = 1; i < _gridn; i++) {
       _LinSolver[i] = LinearEquationSolver::build(i, _solution[i], _smootherType).release();
     }
+
+    if(_pMultigrid) {
+      for(unsigned i = 0; i < _gridn; i++) {
+        if(!_ml_msh->GetLevel(i)->GetIfHomogeneous()) {
+          std::cout << "Error in LinearImplicitSystem::init: p-multigrid is not available on AMR meshes" << std::endl;
+          abort();
+        }
+      }
+
+      // Q2 and serendipity are coarsened to Q1, the discontinuous types are kept
+      _pSolType = _ml_sol->GetSolType();
+      _pSolIsCoarsened.assign(_pSolType.size(), false);
+      for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
+        unsigned solIndex = _SolSystemPdeIndex[k];
+        if(_pSolType[solIndex] == 1 || _pSolType[solIndex] == 2) {
+          _pSolType[solIndex] = 0;
+          _pSolIsCoarsened[solIndex] = true;
+        }
+      }
+
+      _pBdc.resize(_gridn);
+      for(unsigned i = 0; i < _gridn; i++) {
+        BuildPMultigridBdc(i);
+      }
+
+      // the p-level takes the place of the finest mesh level in the h-hierarchy, the finest level is one level above
+      if(_gridn == 1 && _includeCoarseLevelSmoother != INCLUDE_COARSE_LEVEL_TRUE) {
+        _pLinSolver = LinearEquationSolver::build(_gridn - 1, _solution[_gridn - 1], FEMuS_DEFAULT).release();
+        delete _LinSolver[0];
+        _LinSolver[0] = LinearEquationSolver::build(0, _solution[0], _smootherType).release();
+      }
+      else {
+        _pLinSolver = LinearEquationSolver::build(_gridn - 1, _solution[_gridn - 1], _smootherType).release();
+      }
+      _LinSolver[_gridn - 1]->SetMGLevel(_gridn);
+    }
  //****** init: level build part - END *******************
     
     
@@ -196,6 +259,7 @@ namespace femus {
         for(unsigned i = 0; i < _gridn; i++) {
           _LinSolver[i]->SetSparsityPatternMinimumSize(_sparsityPatternMinimumSize, variableIndex);
         }
+        if(_pMultigrid) _pLinSolver->SetSparsityPatternMinimumSize(_sparsityPatternMinimumSize, variableIndex);
       }
       
     } //end at least one dense variable
@@ -205,8 +269,19 @@ namespace femus {
  //****** init:  Sparsity Pattern, conclusion - BEGIN *******************
     for(unsigned i = 0; i < _gridn; i++) {
       _LinSolver[i]->SetNumberOfGlobalVariables(_numberOfGlobalVariables);
-      _LinSolver[i]->InitPde(_SolSystemPdeIndex, _ml_sol->GetSolType(),
-                             _ml_sol->GetSolName(), &_solution[i]->_Bdc, _gridn, _SparsityPattern);
+      if(_pMultigrid && i < _gridn - 1) {
+        _LinSolver[i]->InitPde(_SolSystemPdeIndex, _pSolType,
+                               _ml_sol->GetSolName(), &_pBdc[i], _gridn, _SparsityPattern);
+      }
+      else {
+        _LinSolver[i]->InitPde(_SolSystemPdeIndex, _ml_sol->GetSolType(),
+                               _ml_sol->GetSolName(), &_solution[i]->_Bdc, _gridn, _SparsityPattern);
+      }
+    }
+    if(_pMultigrid) {
+      _pLinSolver->SetNumberOfGlobalVariables(_numberOfGlobalVariables);
+      _pLinSolver->InitPde(_SolSystemPdeIndex, _pSolType,
+                           _ml_sol->GetSolName(), &_pBdc[_gridn - 1], _gridn, _SparsityPattern);
     }
  //****** init:  Sparsity Pattern, conclusion - END *******************
     
@@ -248,6 +323,11 @@ namespace femus {
     for(unsigned ig = 1; ig < _gridn; ig++) {
       ZeroInterpolatorDirichletNodes(ig);
     }
+
+    if(_pMultigrid) {
+      BuildPMultigridProlongatorMatrix();
+      ZeroInterpolatorDirichletNodes(_pPP, NULL, _LinSolver[_gridn - 1], _pLinSolver);
+    }
  //****** init: MG part - END *******************
 
 
@@ -263,6 +343,8 @@ namespace femus {
     // By default we solve for all the PDE variables
     ClearVariablesToBeSolved();
     AddVariableToBeSolved("All");
+
+    FreeUnusedResEps();
     
     
     
@@ -275,6 +357,7 @@ namespace femus {
   void LinearImplicitSystem::MGsolve(const MgSmootherType & mgSmootherType) {
 
     _bitFlipCounter = 0;
+    CheckPMultigrid();
 
     clock_t start_mg_time = clock();
 
@@ -286,7 +369,7 @@ namespace femus {
     }
     else if(_mg_type == V_CYCLE) {
       std::cout << std::endl << " *** Start Linear V-Cycle ***" << std::endl;
-      grid0 = _gridn - 1;
+      grid0 = GetNumberOfLevelsToSolve() - 1;
     }
     else {
       std::cout << "wrong CYCLE type for this solver " << std::endl;
@@ -295,7 +378,7 @@ namespace femus {
 
     unsigned AMRCounter = 0;
 
-    for(unsigned igridn = grid0; igridn < _gridn; igridn++) {     //_igridn
+    for(unsigned igridn = grid0; igridn < GetNumberOfLevelsToSolve(); igridn++) {     //_igridn
       std::cout << std::endl << " ****** Start Level Max " << igridn + 1 << " ******" << std::endl;
 
 
@@ -331,12 +414,13 @@ namespace femus {
 
       _MGmatrixFineReuse = false;
       _MGmatrixCoarseReuse = (igridn - grid0 > 0) ?  true : _MGmatrixFineReuse;
+      if(_pMultigrid) _pLinSolver->_KK->matrix_PtAP(*_pPP, *_LinSolver[igridn]->_KK, _MGmatrixFineReuse);
       for(unsigned i = igridn; i > 0; i--) {
         if(_RR[i]) {
           if(i == igridn)
-            _LinSolver[i - 1u]->_KK->matrix_ABC(*_RR[i], *_LinSolver[i]->_KK, *_PP[i], _MGmatrixFineReuse);
+            _LinSolver[i - 1u]->_KK->matrix_ABC(*_RR[i], *GetHLevelSolver(i)->_KK, *_PP[i], _MGmatrixFineReuse);
           else {
-            _LinSolver[i - 1u]->_KK->matrix_ABC(*_RR[i], *_LinSolver[i]->_KK, *_PP[i], _MGmatrixCoarseReuse);
+            _LinSolver[i - 1u]->_KK->matrix_ABC(*_RR[i], *GetHLevelSolver(i)->_KK, *_PP[i], _MGmatrixCoarseReuse);
             if(_LinSolver[i - 1u]->_KKamr) {
               delete _LinSolver[i - 1u]->_KKamr;
               _LinSolver[i - 1u]->_KKamr = NULL;
@@ -345,9 +429,9 @@ namespace femus {
         }
         else {
           if(i == igridn)
-            _LinSolver[i - 1u]->_KK->matrix_PtAP(*_PP[i], *_LinSolver[i]->_KK, _MGmatrixFineReuse);
+            _LinSolver[i - 1u]->_KK->matrix_PtAP(*_PP[i], *GetHLevelSolver(i)->_KK, _MGmatrixFineReuse);
           else {
-            _LinSolver[i - 1u]->_KK->matrix_PtAP(*_PP[i], *_LinSolver[i]->_KK, _MGmatrixCoarseReuse);
+            _LinSolver[i - 1u]->_KK->matrix_PtAP(*_PP[i], *GetHLevelSolver(i)->_KK, _MGmatrixCoarseReuse);
             if(_LinSolver[i - 1u]->_KKamr) {
               delete _LinSolver[i - 1u]->_KKamr;
               _LinSolver[i - 1u]->_KKamr = NULL;
@@ -358,16 +442,17 @@ namespace femus {
 
       std::cout << std::endl << " ****** Level Max " << igridn + 1 << " PREPARATION TIME:\t" << static_cast<double>((clock() - start_preparation_time)) / CLOCKS_PER_SEC << std::endl;
 
-      _LinSolver[igridn]->MGInit(mgSmootherType, igridn + 1, _mgOuterSolver);
+      _LinSolver[igridn]->MGInit(mgSmootherType, GetNumberOfMGLevels(igridn), _mgOuterSolver);
 
       for(unsigned i = 0; i < igridn + 1; i++) {
         unsigned npre = (i == 0) ? _npre0 : _npre;
         unsigned npost = (i == 0) ? 0 : _npost;
         if(_RR[i])
-          _LinSolver[i]->MGSetLevel(_LinSolver[igridn], igridn, _VariablesToBeSolvedIndex, _PP[i], _RR[i], npre, npost);
+          GetHLevelSolver(i)->MGSetLevel(_LinSolver[igridn], _LinSolver[igridn]->GetMGLevel(), _VariablesToBeSolvedIndex, _PP[i], _RR[i], npre, npost);
         else
-          _LinSolver[i]->MGSetLevel(_LinSolver[igridn], igridn, _VariablesToBeSolvedIndex, _PP[i], _PP[i], npre, npost);
+          GetHLevelSolver(i)->MGSetLevel(_LinSolver[igridn], _LinSolver[igridn]->GetMGLevel(), _VariablesToBeSolvedIndex, _PP[i], _PP[i], npre, npost);
       }
+      if(_pMultigrid) _LinSolver[igridn]->MGSetLevel(_LinSolver[igridn], _LinSolver[igridn]->GetMGLevel(), _VariablesToBeSolvedIndex, _pPP, _pPP, _npre, _npost);
 
       Vcycle(igridn, mgSmootherType);
 
@@ -382,7 +467,7 @@ namespace femus {
         goto restart;
       }
 
-      if(igridn + 1 < _gridn) ProlongatorSol(igridn + 1);
+      if(igridn + 1 < GetNumberOfLevelsToSolve()) ProlongatorSol(igridn + 1);
 
       if(ThisIsAMR) AddAMRLevel(AMRCounter);
 
@@ -399,6 +484,158 @@ namespace femus {
 
   // ********************************************
 
+  void LinearImplicitSystem::MGsolveShiftedFamily(const std::vector < double > &shift, const std::vector < double > &rhsScale,
+                                                  const std::vector < std::string > &solName, const MgSmootherType & mgSmootherType) {
+
+    if(shift.size() != rhsScale.size() || shift.size() != solName.size()) {
+      std::cout << "Error in LinearImplicitSystem::MGsolveShiftedFamily: shift, rhsScale and solName must have the same size" << std::endl;
+      abort();
+    }
+
+    if(_SolSystemPdeIndex.size() != 1) {
+      std::cout << "Error in LinearImplicitSystem::MGsolveShiftedFamily: the system must have exactly one solution" << std::endl;
+      abort();
+    }
+
+    unsigned igridn = GetNumberOfLevelsToSolve() - 1;
+
+    if(!_ml_msh->GetLevel(igridn)->GetIfHomogeneous()) {
+      std::cout << "Error in LinearImplicitSystem::MGsolveShiftedFamily: the finest level can not be an AMR level" << std::endl;
+      abort();
+    }
+
+    _bitFlipCounter = 0;
+    CheckPMultigrid();
+
+    clock_t start_mg_time = clock();
+
+    std::cout << std::endl << " *** Start Linear V-Cycle on " << shift.size() << " shifts ***" << std::endl;
+
+    std::vector < unsigned > targetIndex(solName.size());
+    for(unsigned i = 0; i < solName.size(); i++) {
+      targetIndex[i] = _ml_sol->GetIndex(solName[i].c_str());
+      if(_ml_sol->GetSolutionType(targetIndex[i]) != _ml_sol->GetSolutionType(_SolSystemPdeIndex[0])) {
+        std::cout << "Error in LinearImplicitSystem::MGsolveShiftedFamily: " << solName[i] << " and the system solution have different types" << std::endl;
+        abort();
+      }
+    }
+
+    // K and F at zero solution, then M, copied with their own pattern before the solver zeroes the Dirichlet rows of KK
+    clock_t start_assembly_time = clock();
+
+    _levelToAssemble = igridn;
+    _assembleMatrix = true;
+    unsigned solIndex = _SolSystemPdeIndex[0];
+
+    // Dirichlet lift: the stored solution restricted to the Dirichlet dofs (Bdc = 0) is the starting value of every shift
+    NumericVector* sol = _solution[igridn]->_Sol[solIndex];
+    NumericVector* bdc = _solution[igridn]->_Bdc[solIndex];
+    NumericVector* dirichletLift = sol->clone().release();
+    for(int i = dirichletLift->first_local_index(); i < dirichletLift->last_local_index(); i++) {
+      if((*bdc)(i) > 0.5) dirichletLift->set(i, 0.);
+    }
+    dirichletLift->close();
+
+    sol->zero();
+
+    SparseMatrix* KK = _LinSolver[igridn]->_KK;
+    int localRows = KK->row_stop() - KK->row_start();
+
+    for(unsigned mass = 0; mass < 2; mass++) {
+      _assembleMassMatrix = (mass == 1);
+      _LinSolver[igridn]->SetResZero();
+      _assemble_system_function(_equation_systems);
+
+      SparseMatrix* &copy = (_assembleMassMatrix) ? _shiftM : _shiftK;
+      delete copy;
+      copy = SparseMatrix::build(LSOLVER, _ml_msh->GetCommunicator()).release();
+      copy->init(KK->m(), KK->n(), localRows, localRows);
+      copy->zero();
+      copy->close();
+      copy->matrix_add(1., *KK, "different_nonzero_pattern");
+
+      if(!_assembleMassMatrix) {
+        delete _shiftF;
+        _shiftF = _LinSolver[igridn]->_RES->clone().release();
+      }
+    }
+    _assembleMassMatrix = false;
+
+    std::cout << std::endl << " ****** Level Max " << igridn + 1 << " ASSEMBLY TIME:\t" << static_cast<double>((clock() - start_assembly_time)) / CLOCKS_PER_SEC << std::endl;
+
+    NumericVector* liftProduct = _LinSolver[igridn]->_RES->clone().release();
+
+    for(unsigned ishift = 0; ishift < shift.size(); ishift++) {
+
+      std::cout << std::endl << " ****** Shift " << ishift + 1 << " of " << shift.size() << ": " << shift[ishift] << " ******" << std::endl;
+
+    restart:
+      clock_t start_preparation_time = clock();
+
+      KK->zero();
+      KK->matrix_add(1., *_shiftK, "subset_nonzero_pattern");
+      KK->matrix_add(shift[ishift], *_shiftM, "subset_nonzero_pattern");
+      KK->close();
+
+      // RES = rhsScale F - (K + shift M) g, the correction vanishes on the Dirichlet dofs where the solution starts from g
+      _LinSolver[igridn]->SetResZero();
+      _LinSolver[igridn]->_RES->add(rhsScale[ishift], *_shiftF);
+      liftProduct->matrix_mult(*dirichletLift, *KK);
+      _LinSolver[igridn]->_RES->add(-1., *liftProduct);
+      _LinSolver[igridn]->_RES->close();
+
+      *sol = *dirichletLift;
+
+      // the pattern of the coarse operators does not change with the shift, after the first one only the numeric products are redone
+      bool reuse = (ishift > 0);
+      if(_pMultigrid) _pLinSolver->_KK->matrix_PtAP(*_pPP, *KK, reuse);
+      for(unsigned i = igridn; i > 0; i--) {
+        if(_RR[i]) {
+          _LinSolver[i - 1u]->_KK->matrix_ABC(*_RR[i], *GetHLevelSolver(i)->_KK, *_PP[i], reuse);
+        }
+        else {
+          _LinSolver[i - 1u]->_KK->matrix_PtAP(*_PP[i], *GetHLevelSolver(i)->_KK, reuse);
+        }
+      }
+
+      std::cout << std::endl << " ****** Shift " << ishift + 1 << " PREPARATION TIME:\t" << static_cast<double>((clock() - start_preparation_time)) / CLOCKS_PER_SEC << std::endl;
+
+      _LinSolver[igridn]->MGInit(mgSmootherType, GetNumberOfMGLevels(igridn), _mgOuterSolver);
+
+      for(unsigned i = 0; i < igridn + 1; i++) {
+        unsigned npre = (i == 0) ? _npre0 : _npre;
+        unsigned npost = (i == 0) ? 0 : _npost;
+        if(_RR[i])
+          GetHLevelSolver(i)->MGSetLevel(_LinSolver[igridn], _LinSolver[igridn]->GetMGLevel(), _VariablesToBeSolvedIndex, _PP[i], _RR[i], npre, npost);
+        else
+          GetHLevelSolver(i)->MGSetLevel(_LinSolver[igridn], _LinSolver[igridn]->GetMGLevel(), _VariablesToBeSolvedIndex, _PP[i], _PP[i], npre, npost);
+      }
+      if(_pMultigrid) _LinSolver[igridn]->MGSetLevel(_LinSolver[igridn], _LinSolver[igridn]->GetMGLevel(), _VariablesToBeSolvedIndex, _pPP, _pPP, _npre, _npost);
+
+      Vcycle(igridn, mgSmootherType);
+
+      _LinSolver[igridn]->MGClear();
+
+      if(_bitFlipOccurred && _bitFlipCounter == 1) {
+        goto restart;
+      }
+
+      if(targetIndex[ishift] != solIndex) {
+        *_solution[igridn]->_Sol[targetIndex[ishift]] = *_solution[igridn]->_Sol[solIndex];
+      }
+    }
+
+    delete liftProduct;
+    delete dirichletLift;
+
+    std::cout << std::endl << " *** Linear Solver TIME: " << std::setw(11) << std::setprecision(6) << std::fixed
+              << static_cast<double>((clock() - start_mg_time)) / CLOCKS_PER_SEC << std::endl;
+
+    _totalSolverTime += static_cast<double>((clock() - start_mg_time)) / CLOCKS_PER_SEC;
+  }
+
+  // ********************************************
+
   bool LinearImplicitSystem::IsLinearConverged(const unsigned igridn) {
 
     _bitFlipOccurred = false;
@@ -444,9 +681,7 @@ namespace femus {
       unsigned SolIndex = _SolSystemPdeIndex[k];
       unsigned solType = _ml_sol->GetSolutionType(SolIndex);
 
-      _solution[gridf]->_Sol[SolIndex]->matrix_mult(*_solution[gridf - 1]->_Sol[SolIndex],
-                                                    *_msh[gridf]->GetCoarseToFineProjection(solType));
-      _solution[gridf]->_Sol[SolIndex]->close();
+      _ml_sol->ProlongSolutionVector(*_solution[gridf]->_Sol[SolIndex], *_solution[gridf - 1]->_Sol[SolIndex], gridf, solType);
     }
   }
 
@@ -521,6 +756,34 @@ namespace femus {
       meshcoarser.FlagAllElementsToBeRefined();
       conv_test = false;
     }
+    else if(_AMRestimator > 0) {
+      if(_AMRthreshold.size() == 0) {
+        std::cout << "Error in LinearImplicitSystem::AddAMRLevel: the error estimator needs the relative tolerance, set it with SetAMRSetOptions" << std::endl;
+        abort();
+      }
+
+      std::vector < double > elementError2;
+      double solNorm2 = 0.;
+      for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
+        if(_ml_sol->GetSolutionType(_SolSystemPdeIndex[k]) < 3) {
+          if(_AMRestimator == 1)
+            solNorm2 += _solution[_gridn - 1]->GetZZErrorEstimator(_SolSystemPdeIndex[k], elementError2);
+          else
+            solNorm2 += _solution[_gridn - 1]->GetResidualErrorEstimator(_SolSystemPdeIndex[k], _AMRsourceFunction, elementError2);
+        }
+      }
+      double localError2 = 0.;
+      for(unsigned i = 0; i < elementError2.size(); i++) localError2 += elementError2[i];
+      double error2;
+      MPI_Allreduce(&localError2, &error2, 1, MPI_DOUBLE, MPI_SUM, _ml_msh->GetCommunicator());
+
+      if(error2 <= _AMRthreshold[0] * _AMRthreshold[0] * solNorm2) {
+        conv_test = true;
+      }
+      else {
+        conv_test = _solution[_gridn - 1]->FlagAMRRegionBasedOnDorflerMarking(elementError2, _AMRtheta);
+      }
+    }
     else {
       conv_test = _solution[_gridn - 1]->FlagAMRRegionBasedOnErroNormAdaptive(_SolSystemPdeIndex, _AMRthreshold, _AMRnorm, _AMReighborThresholdValue);
     }
@@ -650,6 +913,23 @@ namespace femus {
   }
 
 
+  void LinearImplicitSystem::SetAMRErrorEstimator(const std::string & estimator, const double & theta,
+                                                  double (* sourceFunction)(const std::vector < double > &x)) {
+    if(!strcmp("ZZ", estimator.c_str()) || !strcmp("zz", estimator.c_str())) {
+      _AMRestimator = 1;
+    }
+    else if(!strcmp("residual", estimator.c_str()) || !strcmp("Residual", estimator.c_str())) {
+      _AMRestimator = 2;
+    }
+    else {
+      std::cout << estimator << " invalid AMR error estimator \n set to default ZZ" << std::endl;
+      _AMRestimator = 1;
+    }
+    _AMRtheta = theta;
+    _AMRsourceFunction = sourceFunction;
+  }
+
+
 //---------------------------------------------------------------------------------------------------
 // This routine generates the matrix for the projection of the FE matrix to finer grids.
 // This is a virtual function overloaded in the class MonolithicFSINonLinearImplicitSystem.
@@ -663,9 +943,9 @@ namespace femus {
     }
 
     int iproc;
-    MPI_Comm_rank(MPI_COMM_WORLD, &iproc);
+    MPI_Comm_rank(_ml_msh->GetCommunicator(), &iproc);
 
-    LinearEquationSolver* LinSolf = _LinSolver[gridf];
+    LinearEquationSolver* LinSolf = GetHLevelSolver(gridf);
     LinearEquationSolver* LinSolc = _LinSolver[gridf - 1];
     Mesh* mshc = _msh[gridf - 1];
     int nf = LinSolf->KKIndex[LinSolf->KKIndex.size() - 1u];
@@ -673,17 +953,17 @@ namespace femus {
     int nf_loc = LinSolf->KKoffset[LinSolf->KKIndex.size() - 1][iproc] - LinSolf->KKoffset[0][iproc];
     int nc_loc = LinSolc->KKoffset[LinSolc->KKIndex.size() - 1][iproc] - LinSolc->KKoffset[0][iproc];
 
-    NumericVector* NNZ_d = NumericVector::build().release();
+    NumericVector* NNZ_d = NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release();
     NNZ_d->init(*LinSolf->_EPS);
     NNZ_d->zero();
 
-    NumericVector* NNZ_o = NumericVector::build().release();
+    NumericVector* NNZ_o = NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release();
     NNZ_o->init(*LinSolf->_EPS);
     NNZ_o->zero();
 
     for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
       unsigned SolIndex = _SolSystemPdeIndex[k];
-      unsigned  SolType = _ml_sol->GetSolutionType(SolIndex);
+      unsigned  SolType = GetHLevelSolutionType(SolIndex);
 
       // loop on the coarse grid
       for(int isdom = iproc; isdom < iproc + 1; isdom++) {
@@ -709,12 +989,12 @@ namespace femus {
     delete NNZ_d;
     delete NNZ_o;
 
-    _PP[gridf] = SparseMatrix::build().release();
+    _PP[gridf] = SparseMatrix::build(LSOLVER, _ml_msh->GetCommunicator()).release();
     _PP[gridf]->init(nf, nc, nf_loc, nc_loc, nnz_d, nnz_o);
 
     for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
       unsigned SolIndex = _SolSystemPdeIndex[k];
-      unsigned  SolType = _ml_sol->GetSolutionType(SolIndex);
+      unsigned  SolType = GetHLevelSolutionType(SolIndex);
 
       // loop on the coarse grid
       for(int isdom = iproc; isdom < iproc + 1; isdom++) {
@@ -732,7 +1012,7 @@ namespace femus {
   void LinearImplicitSystem::BuildAmrProlongatorMatrix(unsigned level) {
 
     int iproc;
-    MPI_Comm_rank(MPI_COMM_WORLD, &iproc);
+    MPI_Comm_rank(_ml_msh->GetCommunicator(), &iproc);
 
     LinearEquationSolver* LinSol = _LinSolver[level];
 
@@ -742,11 +1022,11 @@ namespace femus {
     int n = LinSol->KKIndex[LinSol->KKIndex.size() - 1u];
     int n_loc = LinSol->KKoffset[LinSol->KKIndex.size() - 1][iproc] - LinSol->KKoffset[0][iproc];
 
-    NumericVector* NNZ_d = NumericVector::build().release();
+    NumericVector* NNZ_d = NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release();
     NNZ_d->init(*LinSol->_EPS);
     NNZ_d->zero();
 
-    NumericVector* NNZ_o = NumericVector::build().release();
+    NumericVector* NNZ_o = NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release();
     NNZ_o->init(*LinSol->_EPS);
     NNZ_o->zero();
 
@@ -794,7 +1074,7 @@ namespace femus {
     delete NNZ_d;
     delete NNZ_o;
 
-    _PPamr[level] = SparseMatrix::build().release();
+    _PPamr[level] = SparseMatrix::build(LSOLVER, _ml_msh->GetCommunicator()).release();
     _PPamr[level]->init(n, n, n_loc, n_loc, nnz_d, nnz_o);
 
     for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
@@ -838,93 +1118,188 @@ namespace femus {
   }
 
   void LinearImplicitSystem::ZeroInterpolatorDirichletNodes(const unsigned & level) {
+    ZeroInterpolatorDirichletNodes(_PP[level], _RR[level], GetHLevelSolver(level), _LinSolver[level - 1]);
+  }
 
-    int iproc;
-    MPI_Comm_rank(MPI_COMM_WORLD, &iproc);
+  void LinearImplicitSystem::ZeroInterpolatorDirichletNodes(SparseMatrix *PP, SparseMatrix *RR, LinearEquationSolver *LinSolf, LinearEquationSolver *LinSolc) {
 
-    // Delete the Dirichlet nodes of the fine level (level):
-    // set to zero all the corresponding rows for _PP[level] and columns for _RR[level]
+    // Delete the Dirichlet nodes of the fine level:
+    // set to zero all the corresponding rows for PP and columns for RR
+
+    std::vector < int > dirichletNodeIndex;
+    LinSolf->GetDirichletDofs(dirichletNodeIndex);
+    PP->mat_zero_rows(dirichletNodeIndex, 0);
+
+    if(RR) {
+      SparseMatrix *RRt;
+      RRt = SparseMatrix::build(LSOLVER, _ml_msh->GetCommunicator()).release();
+      RR->get_transpose(*RRt);
+      RRt->mat_zero_rows(dirichletNodeIndex, 0);
+      RRt->get_transpose(*RR);
+      delete RRt;
+    }
+
+    // Delete the Dirichlet nodes of the coarse level:
+    // set to zero all the corresponding columns for PP and rows for RR
+
+    LinSolc->GetDirichletDofs(dirichletNodeIndex);
+
+    SparseMatrix *PPt;
+    PPt = SparseMatrix::build(LSOLVER, _ml_msh->GetCommunicator()).release();
+    PP->get_transpose(*PPt);
+    PPt->mat_zero_rows(dirichletNodeIndex, 0);
+    PPt->get_transpose(*PP);
+    delete PPt;
+
+    if(RR) {
+      RR->mat_zero_rows(dirichletNodeIndex, 0);
+    }
+
+  }
+
+  // ********************************************
+
+  LinearEquationSolver* LinearImplicitSystem::GetHLevelSolver(const unsigned & level) {
+    return (_pMultigrid && level == _gridn - 1) ? _pLinSolver : _LinSolver[level];
+  }
+
+  // ********************************************
+
+  unsigned LinearImplicitSystem::GetHLevelSolutionType(const unsigned & solIndex) {
+    return (_pMultigrid) ? _pSolType[solIndex] : _ml_sol->GetSolutionType(solIndex);
+  }
+
+  // ********************************************
+
+  void LinearImplicitSystem::CheckPMultigrid() {
+    if(_pMultigrid && (_mg_type != V_CYCLE || GetNumberOfLevelsToSolve() != _gridn)) {
+      std::cout << "Error in LinearImplicitSystem: p-multigrid needs a V_CYCLE up to the finest level" << std::endl;
+      abort();
+    }
+  }
+
+  // ********************************************
+
+  void LinearImplicitSystem::BuildPMultigridBdc(const unsigned & level) {
 
-    LinearEquationSolver* LinSol = _LinSolver[level];
     Mesh* mesh = _msh[level];
     Solution* solution = _solution[level];
+    unsigned iproc = mesh->processor_id();
+    unsigned nprocs = mesh->n_processors();
 
-    unsigned BDCIndexSize = LinSol->KKoffset[LinSol->KKIndex.size() - 1][iproc] - LinSol->KKoffset[0][iproc];
-    std::vector < int > dirichletNodeIndex(BDCIndexSize);
-
-    unsigned count = 0;
+    _pBdc[level].assign(solution->_Bdc.size(), NULL);
 
     for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
       unsigned solIndex = _SolSystemPdeIndex[k];
-      unsigned  solType = _ml_sol->GetSolutionType(solIndex);
 
-      for(unsigned inode_mts = mesh->_dofOffset[solType][iproc]; inode_mts < mesh->_dofOffset[solType][iproc + 1]; inode_mts++) {
-        int local_mts = inode_mts - mesh->_dofOffset[solType][iproc];
-        int idof_kk = LinSol->KKoffset[k][iproc] + local_mts;
-        double bcvalue = (*solution->_Bdc[solIndex])(inode_mts);
-        if(bcvalue < 1.5) {
-          dirichletNodeIndex[count] = idof_kk;
-          count++;
+      if(!_pSolIsCoarsened[solIndex]) {
+        _pBdc[level][solIndex] = solution->_Bdc[solIndex];
+        continue;
+      }
+
+      unsigned solType = _ml_sol->GetSolutionType(solIndex);
+      unsigned pSolType = _pSolType[solIndex];
+
+      // only the owned entries are read, no ghost nodes are needed
+      NumericVector* bdc = NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release();
+      if(nprocs == 1) {
+        bdc->init(mesh->dofmap_get_dof_offset(pSolType, nprocs), mesh->dofmap_get_own_size(pSolType, iproc), false, SERIAL);
+      }
+      else {
+        bdc->init(mesh->dofmap_get_dof_offset(pSolType, nprocs), mesh->dofmap_get_own_size(pSolType, iproc), false, PARALLEL);
+      }
+
+      // the linear nodes are the first nodes of the element in all the Lagrange types
+      for(int iel = mesh->_elementOffset[iproc]; iel < mesh->_elementOffset[iproc + 1]; iel++) {
+        unsigned nDofs = mesh->GetElementDofNumber(iel, pSolType);
+        for(unsigned i = 0; i < nDofs; i++) {
+          unsigned idof = mesh->GetSolutionDof(i, iel, solType);
+          bdc->set(mesh->GetSolutionDof(i, iel, pSolType), (*solution->_Bdc[solIndex])(idof));
         }
       }
+      bdc->close();
+
+      _pBdc[level][solIndex] = bdc;
     }
+  }
 
-    dirichletNodeIndex.resize(count);
-    std::vector < PetscInt > (dirichletNodeIndex).swap(dirichletNodeIndex);
-    std::sort(dirichletNodeIndex.begin(), dirichletNodeIndex.end());
-    _PP[level]->mat_zero_rows(dirichletNodeIndex, 0);
+  // ********************************************
 
-    if(_RR[level]) {
-      SparseMatrix *RRt;
-      RRt = SparseMatrix::build().release();
-      _RR[level]->get_transpose(*RRt);
-      RRt->mat_zero_rows(dirichletNodeIndex, 0);
-      RRt->get_transpose(*_RR[level]);
-      delete RRt;
-    }
+  void LinearImplicitSystem::BuildPMultigridProlongatorMatrix() {
+
+    int iproc;
+    MPI_Comm_rank(_ml_msh->GetCommunicator(), &iproc);
 
-    // Delete the Dirichlet nodes of the coarse level (level-1):
-    // set to zero all the corresponding columns for _PP[level] and rows for _RR[level]
+    LinearEquationSolver* LinSolf = _LinSolver[_gridn - 1];
+    LinearEquationSolver* LinSolc = _pLinSolver;
+    Mesh* mesh = _msh[_gridn - 1];
+
+    int nf = LinSolf->KKIndex[LinSolf->KKIndex.size() - 1u];
+    int nc = LinSolc->KKIndex[LinSolc->KKIndex.size() - 1u];
+    int nf_loc = LinSolf->KKoffset[LinSolf->KKIndex.size() - 1][iproc] - LinSolf->KKoffset[0][iproc];
+    int nc_loc = LinSolc->KKoffset[LinSolc->KKIndex.size() - 1][iproc] - LinSolc->KKoffset[0][iproc];
 
-    LinSol = _LinSolver[level - 1];
-    mesh = _msh[level - 1];
-    solution = _solution[level - 1];
+    int ncBegin = LinSolc->KKoffset[0][iproc];
+    int ncEnd = LinSolc->KKoffset[LinSolc->KKIndex.size() - 1][iproc];
 
-    BDCIndexSize = LinSol->KKoffset[LinSol->KKIndex.size() - 1][iproc] - LinSol->KKoffset[0][iproc];
-    dirichletNodeIndex.resize(BDCIndexSize);
+    // the rows of the Qi to Qj projections are copied with the system numbering, identity rows for the solutions that are not coarsened
+    std::vector < std::vector < int > > cols(nf_loc);
+    std::vector < std::vector < double > > values(nf_loc);
+    vector <int> nnz_d(nf_loc, 0);
+    vector <int> nnz_o(nf_loc, 0);
 
-    count = 0;
+    std::vector < int > projCols;
+    std::vector < double > projValues;
 
     for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
       unsigned solIndex = _SolSystemPdeIndex[k];
-      unsigned  solType = _ml_sol->GetSolutionType(solIndex);
+      unsigned solType = _ml_sol->GetSolutionType(solIndex);
+      unsigned pSolType = _pSolType[solIndex];
 
-      for(unsigned inode_mts = mesh->_dofOffset[solType][iproc]; inode_mts < mesh->_dofOffset[solType][iproc + 1]; inode_mts++) {
-        int local_mts = inode_mts - mesh->_dofOffset[solType][iproc];
-        int idof_kk = LinSol->KKoffset[k][iproc] + local_mts;
-        double bcvalue = (*solution->_Bdc[solIndex])(inode_mts);
-        if(bcvalue < 1.5) {
-          dirichletNodeIndex[count] = idof_kk;
-          count++;
+      SparseMatrix* Proj = (_pSolIsCoarsened[solIndex]) ? mesh->GetQitoQjProjection(solType, pSolType) : NULL;
+
+      unsigned solOffset = mesh->_dofOffset[solType][iproc];
+      unsigned solOffsetp1 = mesh->_dofOffset[solType][iproc + 1];
+      unsigned kOffset = LinSolf->KKoffset[k][iproc] - LinSolf->KKoffset[0][iproc];
+
+      for(unsigned i = solOffset; i < solOffsetp1; i++) {
+        unsigned irow = kOffset + (i - solOffset);
+
+        if(Proj == NULL) {
+          cols[irow].assign(1, LinSolc->KKoffset[k][iproc] + (i - solOffset));
+          values[irow].assign(1, 1.);
+        }
+        else {
+          int ncols = Proj->MatGetRowM(i);
+          projCols.resize(ncols);
+          projValues.resize(ncols);
+          if(ncols > 0) Proj->MatGetRowM(i, &projCols[0], &projValues[0]);
+          for(int j = 0; j < ncols; j++) {
+            if(fabs(projValues[j]) > 1.0e-14) {
+              unsigned jproc = mesh->IsdomBisectionSearch(projCols[j], pSolType);
+              cols[irow].push_back(LinSolc->KKoffset[k][jproc] + (projCols[j] - mesh->_dofOffset[pSolType][jproc]));
+              values[irow].push_back(projValues[j]);
+            }
+          }
+        }
+
+        for(unsigned j = 0; j < cols[irow].size(); j++) {
+          if(cols[irow][j] >= ncBegin && cols[irow][j] < ncEnd) nnz_d[irow]++;
+          else nnz_o[irow]++;
         }
       }
     }
 
-    dirichletNodeIndex.resize(count);
-    std::vector < PetscInt > (dirichletNodeIndex).swap(dirichletNodeIndex);
-    std::sort(dirichletNodeIndex.begin(), dirichletNodeIndex.end());
-
-    SparseMatrix *PPt;
-    PPt = SparseMatrix::build().release();
-    _PP[level]->get_transpose(*PPt);
-    PPt->mat_zero_rows(dirichletNodeIndex, 0);
-    PPt->get_transpose(*_PP[level]);
-    delete PPt;
+    _pPP = SparseMatrix::build(LSOLVER, _ml_msh->GetCommunicator()).release();
+    _pPP->init(nf, nc, nf_loc, nc_loc, nnz_d, nnz_o);
 
-    if(_RR[level]) {
-      _RR[level]->mat_zero_rows(dirichletNodeIndex, 0);
+    for(int irow = 0; irow < nf_loc; irow++) {
+      if(cols[irow].size() > 0) {
+        _pPP->insert_row(LinSolf->KKoffset[0][iproc] + irow, cols[irow].size(), cols[irow], &values[irow][0]);
+      }
     }
 
+    _pPP->close();
   }
 
   // ********************************************
@@ -991,6 +1366,7 @@ namespace femus {
     for(unsigned i = 0; i < _gridn; i++) {
       _LinSolver[i]->PrintSolverInfo(_printSolverInfo);
     }
+    if(_pMultigrid) _pLinSolver->PrintSolverInfo(_printSolverInfo);
   }
 
 
@@ -1004,8 +1380,9 @@ namespace femus {
 
     for(unsigned i = 1; i < _gridn; i++) {
       unsigned num_block2 = std::min(_num_block, _msh[i]->GetNumberOfElements());
-      _LinSolver[i]->SetElementBlockNumber(num_block2);
+      GetHLevelSolver(i)->SetElementBlockNumber(num_block2);
     }
+    if(_pMultigrid) _LinSolver[_gridn - 1]->SetElementBlockNumber(std::min(_num_block, _msh[_gridn - 1]->GetNumberOfElements()));
   }
 
   // ********************************************
@@ -1015,14 +1392,15 @@ namespace femus {
     _overlap = overlap;
 
     for(unsigned i = 1; i < _gridn; i++) {
-      _LinSolver[i]->SetElementBlockNumber(all, overlap);
+      GetHLevelSolver(i)->SetElementBlockNumber(all, overlap);
     }
+    if(_pMultigrid) _LinSolver[_gridn - 1]->SetElementBlockNumber(all, overlap);
   }
 
   // ********************************************
 
   void LinearImplicitSystem::SetSolverCoarseGrid(const SolverType & coarseGridSolver) {
-    _LinSolver[0]->set_solver_type(coarseGridSolver);
+    GetHLevelSolver(0)->set_solver_type(coarseGridSolver);
   }
 
 
@@ -1030,8 +1408,9 @@ namespace femus {
     _finegridsolvertype = fineGridSolver;
 
     for(unsigned i = 1; i < _gridn; i++) {
-      _LinSolver[i]->set_solver_type(_finegridsolvertype);
+      GetHLevelSolver(i)->set_solver_type(_finegridsolvertype);
     }
+    if(_pMultigrid) _LinSolver[_gridn - 1]->set_solver_type(_finegridsolvertype);
   }
 
   // ********************************************
@@ -1040,7 +1419,12 @@ namespace femus {
 
 
   void LinearImplicitSystem::SetPreconditionerCoarseGrid(const PreconditionerType & coarseGridPreconditioner) {
-    _LinSolver[0]->set_preconditioner_type(coarseGridPreconditioner);
+    GetHLevelSolver(0)->set_preconditioner_type(coarseGridPreconditioner);
+  }
+
+
+  void LinearImplicitSystem::SetCoarseGridDirectSolver(const PreconditionerType & factorizationType, const unsigned & redundantNumber) {
+    GetHLevelSolver(0)->SetCoarseDirectSolver(factorizationType, redundantNumber);
   }
 
 
@@ -1048,8 +1432,9 @@ namespace femus {
     _finegridpreconditioner = fineGridPreconditioner;
 
     for(unsigned i = 1; i < _gridn; i++) {
-      _LinSolver[i]->set_preconditioner_type(_finegridpreconditioner);
+      GetHLevelSolver(i)->set_preconditioner_type(_finegridpreconditioner);
     }
+    if(_pMultigrid) _LinSolver[_gridn - 1]->set_preconditioner_type(_finegridpreconditioner);
   }
 
   // ********************************************
@@ -1065,6 +1450,7 @@ namespace femus {
     for(unsigned i = 0; i < _gridn; i++) {
       _LinSolver[i]->SetTolerances(_rtol, _atol, _divtol, _maxits, _restart);
     }
+    if(_pMultigrid) _pLinSolver->SetTolerances(_rtol, _atol, _divtol, _maxits, _restart);
   }
 
   // ********************************************
@@ -1074,8 +1460,9 @@ namespace femus {
     _NSchurVar = NSchurVar;
 
     for(unsigned i = 1; i < _gridn; i++) {
-      _LinSolver[i]->SetNumberOfSchurVariables(_NSchurVar);
+      GetHLevelSolver(i)->SetNumberOfSchurVariables(_NSchurVar);
     }
+    if(_pMultigrid) _LinSolver[_gridn - 1]->SetNumberOfSchurVariables(_NSchurVar);
   }
 
   // ********************************************
@@ -1084,6 +1471,7 @@ namespace femus {
     for(unsigned i = 0; i < _gridn; i++) {
       _LinSolver[i]->SetFieldSplitTree(fieldSplitTree);
     }
+    if(_pMultigrid) _pLinSolver->SetFieldSplitTree(fieldSplitTree);
   };
 
 
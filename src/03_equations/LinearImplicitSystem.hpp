@@ -27,6 +27,7 @@
 #include "FemusDefault.hpp"
 
 #include <petscksp.h>
+#include <climits>
 
 namespace femus {
 
@@ -111,6 +112,37 @@ namespace femus {
         _mg_type = mgtype;
       };
 
+      /** Get the type of multigrid */
+      MgType GetMgType() const {
+        return _mg_type;
+      };
+
+      /** Stop the multigrid solver at the level levelMax: the finer levels are neither assembled nor solved */
+      void SetMaxLevelToSolve (const unsigned &levelMax) {
+        _maxLevelToSolve = levelMax;
+      };
+
+      /** Solve again up to the finest level */
+      void ResetMaxLevelToSolve() {
+        _maxLevelToSolve = UINT_MAX;
+      };
+
+      /** Get the number of levels actually solved by MGsolve */
+      unsigned GetNumberOfLevelsToSolve() const {
+        return (_maxLevelToSolve < _gridn) ? _maxLevelToSolve + 1u : _gridn;
+      };
+
+      /** Add a p-level to the multigrid hierarchy: the serendipity and biquadratic solutions are coarsened to linear on the finest mesh
+       * with the Qi to Qj projections, and the h-levels below are linear. The coarse operators are Galerkin, only the V_CYCLE on the finest level is allowed.
+       * To be set before init() */
+      void SetPMultigrid (const bool &pMultigrid = true) {
+        _pMultigrid = pMultigrid;
+      };
+
+      bool GetPMultigrid() const {
+        return _pMultigrid;
+      };
+
       /** Set the modality of handling the BC boundary condition (penalty or elimination)*/
       void SetDirichletBCsHandling (const DirichletBCType DirichletMode);
 
@@ -139,6 +171,10 @@ namespace femus {
       /** Set the preconditioner for the Ksp smoother solver on the fine grids */
       void SetPreconditionerCoarseGrid (const PreconditionerType &preconditioner_type);
 
+      /** Solve the coarse grid exactly with a sparse direct factorization (MUMPS by default), redundant on redundantNumber
+       * sub-communicators if redundantNumber > 0. The symbolic factorization is kept while the coarse sparsity pattern is unchanged */
+      void SetCoarseGridDirectSolver (const PreconditionerType &factorizationType = MLU_PRECOND, const unsigned &redundantNumber = 0);
+
 
       /** Set the Ksp smoother solver on the fine grids. At the coarse solver we always use the LU (Mumps) direct solver */
       void SetSolverFineGrids (const SolverType &solvertype);
@@ -158,6 +194,7 @@ namespace femus {
         for (unsigned i = 0; i < _gridn; i++) {
           _LinSolver[i]->SetRichardsonScaleFactor (_richardsonScaleFactor);
         }
+        if (_pMultigrid) _pLinSolver->SetRichardsonScaleFactor (_richardsonScaleFactor);
       }
 
       void SetRichardsonScaleFactor (const double &richardsonScaleFactorMin, const double &richardsonScaleFactorMax) {
@@ -195,6 +232,12 @@ namespace femus {
         _AMReighborThresholdValue = neighborThresholdValue;
       }
 
+      /** Flag the AMR elements with an a posteriori error estimator, "ZZ" (gradient recovery) or "residual" (for - Laplace(u) = f),
+       * and Dorfler marking with bulk parameter theta. The AMR loop stops when the estimated error is below AMRthreshold
+       * times the H1 seminorm of the solution, AMRthreshold is set with SetAMRSetOptions */
+      void SetAMRErrorEstimator (const std::string& estimator, const double &theta = 0.5,
+                                 double (*sourceFunction) (const std::vector < double > &x) = NULL);
+
       /** Set the options of the Schur-Vanka smoother */
       //void SetVankaSchurOptions(bool Schur, short unsigned NSchurVar);
       void SetNumberOfSchurVariables (const unsigned short &NSchurVar);
@@ -235,6 +278,19 @@ namespace femus {
      
       /** Solves the system. */
       virtual void MGsolve (const MgSmootherType& mgSmootherType = MULTIPLICATIVE);
+
+      /** Solve the family of shifted problems (K + shift[i] M) x_i = rhsScale[i] F on the finest level, x_i is copied into the solution solName[i].
+       * Every shift starts from the Dirichlet values stored in the system solution, whose lift is moved to the right hand side.
+       * The assemble function is called twice at zero solution: with GetAssembleMassMatrix() false it assembles K and F, with it true it assembles M in KK.
+       * K, M and F are kept, the sparsity, the transfer matrices and the symbolic part of the Galerkin products are shared by all the shifts,
+       * and with SetCoarseGridDirectSolver also the symbolic factorization of the coarse operator */
+      void MGsolveShiftedFamily (const std::vector < double > &shift, const std::vector < double > &rhsScale,
+                                 const std::vector < std::string > &solName, const MgSmootherType& mgSmootherType = MULTIPLICATIVE);
+
+      /** True while MGsolveShiftedFamily assembles the mass matrix */
+      bool GetAssembleMassMatrix() const {
+        return _assembleMassMatrix;
+      }
       
     protected:
 
@@ -261,6 +317,24 @@ namespace femus {
       virtual void BuildProlongatorMatrix (unsigned gridf);
       virtual void BuildAmrProlongatorMatrix (unsigned level);
       void ZeroInterpolatorDirichletNodes (const unsigned &level);
+      void ZeroInterpolatorDirichletNodes (SparseMatrix *PP, SparseMatrix *RR, LinearEquationSolver *LinSolf, LinearEquationSolver *LinSolc);
+
+      /** p-multigrid: linear boundary flags of the system solutions on level, the prolongator from the p-level to the finest level */
+      void BuildPMultigridBdc (const unsigned &level);
+      void BuildPMultigridProlongatorMatrix();
+
+      /** Equation of the mesh level in the h-hierarchy, with p-multigrid on the finest mesh it is the p-level */
+      LinearEquationSolver* GetHLevelSolver (const unsigned &level);
+
+      /** Finite element type of the solution in the h-hierarchy */
+      unsigned GetHLevelSolutionType (const unsigned &solIndex);
+
+      /** Number of levels of the multigrid preconditioner of level igridn */
+      unsigned GetNumberOfMGLevels (const unsigned &igridn) const {
+        return (_pMultigrid) ? igridn + 2 : igridn + 1;
+      };
+
+      void CheckPMultigrid();
 
       // member data
       /** The number of linear iterations required to solve the linear system Ax=b. */
@@ -284,6 +358,23 @@ namespace femus {
       /** The type of multigrid, F-cyle, V-cycle, M-cycle */
       MgType _mg_type;
 
+      /** The finest level solved by MGsolve, UINT_MAX means all levels */
+      unsigned _maxLevelToSolve;
+
+      /** p-multigrid: the p-level on the finest mesh, its prolongator, the solution types and the boundary flags [level][solIndex] of the h-hierarchy */
+      bool _pMultigrid;
+      LinearEquationSolver* _pLinSolver;
+      SparseMatrix* _pPP;
+      vector < int > _pSolType;
+      vector < bool > _pSolIsCoarsened;
+      vector < vector < NumericVector* > > _pBdc;
+
+      /** Shifted family: stiffness, mass and right hand side on the finest level */
+      bool _assembleMassMatrix;
+      SparseMatrix* _shiftK;
+      SparseMatrix* _shiftM;
+      NumericVector* _shiftF;
+
       /** To be Added */
       unsigned _npre;
       unsigned _npre0;
@@ -316,6 +407,9 @@ namespace femus {
       short _AMRnorm;
       double _AMReighborThresholdValue;
       std::vector <double> _AMRthreshold;
+      short _AMRestimator;
+      double _AMRtheta;
+      double (*_AMRsourceFunction) (const std::vector < double > &x);
 
       vector <bool> _SparsityPattern;
 
@@ -54,7 +54,7 @@ namespace femus {
     }
 
     int iproc;
-    MPI_Comm_rank(MPI_COMM_WORLD, &iproc);
+    MPI_Comm_rank(_ml_msh->GetCommunicator(), &iproc);
 
     LinearEquationSolver* LinSolf = _LinSolver[gridf];
     LinearEquationSolver* LinSolc = _LinSolver[gridf - 1];
@@ -64,11 +64,11 @@ namespace femus {
     int nf_loc = LinSolf->KKoffset[LinSolf->KKIndex.size() - 1][iproc] - LinSolf->KKoffset[0][iproc];
     int nc_loc = LinSolc->KKoffset[LinSolc->KKIndex.size() - 1][iproc] - LinSolc->KKoffset[0][iproc];
 
-    NumericVector *NNZ_d = NumericVector::build().release();
+    NumericVector *NNZ_d = NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release();
     NNZ_d->init(*LinSolf->_EPS);
     NNZ_d->zero();
 
-    NumericVector *NNZ_o = NumericVector::build().release();
+    NumericVector *NNZ_o = NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release();
     NNZ_o->init(*LinSolf->_EPS);
     NNZ_o->zero();
 
@@ -98,11 +98,11 @@ namespace femus {
     delete NNZ_d;
     delete NNZ_o;
 
-    _PP[gridf] = SparseMatrix::build().release();
+    _PP[gridf] = SparseMatrix::build(LSOLVER, _ml_msh->GetCommunicator()).release();
     _PP[gridf]->init(nf, nc, nf_loc, nc_loc, nnz_d, nnz_o);
 
     SparseMatrix *RRt;
-    RRt = SparseMatrix::build().release();
+    RRt = SparseMatrix::build(LSOLVER, _ml_msh->GetCommunicator()).release();
     RRt->init(nf, nc, nf_loc, nc_loc, nnz_d, nnz_o);
 
     for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
@@ -132,7 +132,7 @@ namespace femus {
     _PP[gridf]->close();
     RRt->close();
 
-    _RR[gridf] = SparseMatrix::build().release();
+    _RR[gridf] = SparseMatrix::build(LSOLVER, _ml_msh->GetCommunicator()).release();
     RRt->get_transpose(*_RR[gridf]);
     delete RRt;
 
@@ -141,7 +141,7 @@ namespace femus {
   void MonolithicFSINonLinearImplicitSystem::BuildAmrProlongatorMatrix(unsigned level) {
 
     int iproc;
-    MPI_Comm_rank(MPI_COMM_WORLD, &iproc);
+    MPI_Comm_rank(_ml_msh->GetCommunicator(), &iproc);
 
     LinearEquationSolver* LinSol = _LinSolver[level];
 
@@ -153,11 +153,11 @@ namespace femus {
     int n = LinSol->KKIndex[LinSol->KKIndex.size() - 1u];
     int n_loc = LinSol->KKoffset[LinSol->KKIndex.size() - 1][iproc] - LinSol->KKoffset[0][iproc];
 
-    NumericVector* NNZ_d = NumericVector::build().release();
+    NumericVector* NNZ_d = NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release();
     NNZ_d->init(*LinSol->_EPS);
     NNZ_d->zero();
 
-    NumericVector* NNZ_o = NumericVector::build().release();
+    NumericVector* NNZ_o = NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release();
     NNZ_o->init(*LinSol->_EPS);
     NNZ_o->zero();
 
@@ -205,10 +205,10 @@ namespace femus {
     delete NNZ_d;
     delete NNZ_o;
 
-    _PPamr[level] = SparseMatrix::build().release();
+    _PPamr[level] = SparseMatrix::build(LSOLVER, _ml_msh->GetCommunicator()).release();
     _PPamr[level]->init(n, n, n_loc, n_loc, nnz_d, nnz_o);
     
-    _RRamr[level] = SparseMatrix::build().release();
+    _RRamr[level] = SparseMatrix::build(LSOLVER, _ml_msh->GetCommunicator()).release();
     _RRamr[level]->init(n, n, n_loc, n_loc, nnz_d, nnz_o);
 
     for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
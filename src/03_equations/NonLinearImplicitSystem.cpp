@@ -14,6 +14,7 @@
 =========================================================================*/
 
 #include <iomanip>
+#include <cmath>
 #include "NonLinearImplicitSystem.hpp"
 #include "LinearEquationSolver.hpp"
 #include "NumericVector.hpp"
@@ -35,13 +36,24 @@ namespace femus {
     _max_nonlinear_convergence_tolerance(1.e-6),
     _maxNumberOfResidualUpdateIterations(1),
     _debug_nonlinear(false),
+    _overlapGhostUpdate(false),
     _debug_function(NULL),
-    _debug_function_is_initialized(false)
+    _debug_function_is_initialized(false),
+    _lineSearchType(NO_LINE_SEARCH),
+    _maxNumberOfLineSearchSteps(10),
+    _lineSearchArmijo(1.e-4),
+    _trustRegion(false),
+    _trustRegionInitialRadius(1.),
+    _trustRegionRadius(1.)
   {
 
   }
 
   NonLinearImplicitSystem::~NonLinearImplicitSystem() {
+    for(unsigned k = 0; k < _lineSearchSolOld.size(); k++) {
+      delete _lineSearchSolOld[k];
+      delete _lineSearchStep[k];
+    }
   }
 
   // ********************************************
@@ -157,11 +169,15 @@ namespace femus {
   void NonLinearImplicitSystem::MGsolve(const MgSmootherType& mgSmootherType) {
 
     _bitFlipCounter = 0;
+    CheckPMultigrid();
     
     clock_t start_mg_time = clock();
 
     double totalAssembyTime = 0.;
 
+    bool globalization = (_lineSearchType != NO_LINE_SEARCH || _trustRegion);
+    _trustRegionRadius = _trustRegionInitialRadius;
+
     unsigned grid0;
 
     if(_mg_type == F_CYCLE) {
@@ -170,7 +186,7 @@ namespace femus {
     }
     else if(_mg_type == V_CYCLE) {
       std::cout << std::endl << " *** Start Nonlinear V-Cycle ***" << std::endl;
-      grid0 = _gridn - 1;
+      grid0 = GetNumberOfLevelsToSolve() - 1;
     }
     else {
       std::cout << "wrong CYCLE type for this solver " << std::endl;
@@ -179,7 +195,7 @@ namespace femus {
 
     unsigned AMRCounter = 0;
 
-    for(unsigned igridn = grid0; igridn < _gridn; igridn++) {     //_igridn
+    for(unsigned igridn = grid0; igridn < GetNumberOfLevelsToSolve(); igridn++) {     //_igridn
       std::cout << std::endl << "   ****** Start Level Max " << igridn + 1 << " ******" << std::endl;
       clock_t start_nl_time = clock();
 
@@ -188,13 +204,15 @@ namespace femus {
 restart:
       if(ThisIsAMR) _solution[igridn]->InitAMREps();
 
+      _solution[igridn]->SetOverlapGhostUpdate(_overlapGhostUpdate && !globalization && !_debug_nonlinear);
+
       
       for(unsigned nonLinearIterator = 0; nonLinearIterator < _n_max_nonlinear_iterations; nonLinearIterator++) {
 
         _nonliniteration = nonLinearIterator;
         
        if (_debug_nonlinear)  {
-                   _eps_fine.push_back(NumericVector::build().release());
+                   _eps_fine.push_back(NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release());
                    _eps_fine.back()->init(*_LinSolver[_gridn-1]->_EPS);  //I'd say init also fills the vector
                    *(_eps_fine.back()) = *(_LinSolver[_gridn-1]->_EPS);
             }
@@ -220,6 +238,12 @@ restart:
           *(_LinSolver[igridn]->_RES) = *(_LinSolver[igridn]->_RESC);
         }
 
+        double phi0 = 0.;
+        if(globalization) {
+          phi0 = GetMerit(igridn);
+          StoreLineSearchSolution(igridn);
+        }
+
         if(_buildSolver) {
 
           _MGmatrixFineReuse = (0 == nonLinearIterator) ? false : true;
@@ -236,12 +260,13 @@ restart:
           }
 
           clock_t mg_proj_mat_time = clock();
+          if(_pMultigrid) _pLinSolver->_KK->matrix_PtAP(*_pPP, *_LinSolver[igridn]->_KK, _MGmatrixFineReuse);
           for(unsigned i = igridn; i > 0; i--) {
             if(_RR[i]) {
               if(i == igridn)
-                _LinSolver[i - 1u]->_KK->matrix_ABC(*_RR[i], *_LinSolver[i]->_KK, *_PP[i], _MGmatrixFineReuse);
+                _LinSolver[i - 1u]->_KK->matrix_ABC(*_RR[i], *GetHLevelSolver(i)->_KK, *_PP[i], _MGmatrixFineReuse);
               else {
-                _LinSolver[i - 1u]->_KK->matrix_ABC(*_RR[i], *_LinSolver[i]->_KK, *_PP[i], _MGmatrixCoarseReuse);
+                _LinSolver[i - 1u]->_KK->matrix_ABC(*_RR[i], *GetHLevelSolver(i)->_KK, *_PP[i], _MGmatrixCoarseReuse);
                 if(_LinSolver[i - 1u]->_KKamr) {
                   delete _LinSolver[i - 1u]->_KKamr;
                   _LinSolver[i - 1u]->_KKamr = NULL;
@@ -250,9 +275,9 @@ restart:
             }
             else {
               if(i == igridn)
-                _LinSolver[i - 1u]->_KK->matrix_PtAP(*_PP[i], *_LinSolver[i]->_KK, _MGmatrixFineReuse);
+                _LinSolver[i - 1u]->_KK->matrix_PtAP(*_PP[i], *GetHLevelSolver(i)->_KK, _MGmatrixFineReuse);
               else {
-                _LinSolver[i - 1u]->_KK->matrix_PtAP(*_PP[i], *_LinSolver[i]->_KK, _MGmatrixCoarseReuse);
+                _LinSolver[i - 1u]->_KK->matrix_PtAP(*_PP[i], *GetHLevelSolver(i)->_KK, _MGmatrixCoarseReuse);
                 if(_LinSolver[i - 1u]->_KKamr) {
                   delete _LinSolver[i - 1u]->_KKamr;
                   _LinSolver[i - 1u]->_KKamr = NULL;
@@ -265,16 +290,17 @@ restart:
 
           clock_t mg_init_time = clock();
           
-            _LinSolver[igridn]->MGInit(mgSmootherType, igridn + 1, _mgOuterSolver);
+            _LinSolver[igridn]->MGInit(mgSmootherType, GetNumberOfMGLevels(igridn), _mgOuterSolver);
 
             for(unsigned i = 0; i <= igridn; i++) {
               unsigned npre = (i == 0)? _npre0 : _npre;  
               unsigned npost = (i == 0)? 0 : _npost;  
               if(_RR[i])
-                _LinSolver[i]->MGSetLevel(_LinSolver[igridn], igridn, _VariablesToBeSolvedIndex, _PP[i], _RR[i], npre, npost);
+                GetHLevelSolver(i)->MGSetLevel(_LinSolver[igridn], _LinSolver[igridn]->GetMGLevel(), _VariablesToBeSolvedIndex, _PP[i], _RR[i], npre, npost);
               else
-                _LinSolver[i]->MGSetLevel(_LinSolver[igridn], igridn, _VariablesToBeSolvedIndex, _PP[i], _PP[i], npre, npost);
+                GetHLevelSolver(i)->MGSetLevel(_LinSolver[igridn], _LinSolver[igridn]->GetMGLevel(), _VariablesToBeSolvedIndex, _PP[i], _PP[i], npre, npost);
             }
+            if(_pMultigrid) _LinSolver[igridn]->MGSetLevel(_LinSolver[igridn], _LinSolver[igridn]->GetMGLevel(), _VariablesToBeSolvedIndex, _pPP, _pPP, _npre, _npost);
          
           std::cout << "   ********* Level Max " << igridn + 1 << " MGINIT TIME:\t" \
                     << static_cast<double>((clock() - mg_init_time)) / CLOCKS_PER_SEC << std::endl;
@@ -317,6 +343,12 @@ restart:
           _LinSolver[igridn]->MGClear();
         }
 
+        if(globalization && !_bitFlipOccurred && phi0 > 0.) {
+          clock_t start_line_search_time = clock();
+          LineSearch(igridn, phi0);
+          totalAssembyTime += static_cast<double>((clock() - start_line_search_time)) / CLOCKS_PER_SEC;
+        }
+
         double nonLinearEps;
         bool nonLinearIsConverged = HasNonLinearConverged(igridn, nonLinearEps);
 
@@ -331,6 +363,9 @@ restart:
         if(nonLinearIsConverged || _bitFlipOccurred) break;
 
       }  //end nonlinear iterations
+
+      _solution[igridn]->EndGhostUpdate();
+      _solution[igridn]->SetOverlapGhostUpdate(false);
       
       _last_nonliniteration = _nonliniteration;
       
@@ -339,7 +374,7 @@ restart:
 	goto restart;
       }
       
-      if(igridn + 1 < _gridn) ProlongatorSol(igridn + 1);
+      if(igridn + 1 < GetNumberOfLevelsToSolve()) ProlongatorSol(igridn + 1);
 
       if(ThisIsAMR) AddAMRLevel(AMRCounter);
 
@@ -361,6 +396,165 @@ restart:
 
 
   
+  // ********************************************
+
+  double NonLinearImplicitSystem::AssembleResidualAndGetMerit(const unsigned &igridn) {
+
+    _levelToAssemble = igridn;
+    _LinSolver[igridn]->SetResZero();
+    _assembleMatrix = false;
+    _assemble_system_function(_equation_systems);
+
+    if(!_ml_msh->GetLevel(igridn)->GetIfHomogeneous()) {
+      if(!_RRamr[igridn]) {
+        (_LinSolver[igridn]->_RESC)->matrix_mult_transpose(*_LinSolver[igridn]->_RES, *_PPamr[igridn]);
+      }
+      else {
+        (_LinSolver[igridn]->_RESC)->matrix_mult(*_LinSolver[igridn]->_RES, *_RRamr[igridn]);
+      }
+      *(_LinSolver[igridn]->_RES) = *(_LinSolver[igridn]->_RESC);
+    }
+
+    return GetMerit(igridn);
+  }
+
+  // ********************************************
+
+  double NonLinearImplicitSystem::GetMerit(const unsigned &igridn) {
+
+    // UpdateRes copies the residual into the solution residuals with zero on the Dirichlet dofs
+    _solution[igridn]->UpdateRes(_SolSystemPdeIndex, _LinSolver[igridn]->_RES, _LinSolver[igridn]->KKoffset);
+
+    double phi = 0.;
+    for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
+      double L2normRes = _solution[igridn]->_Res[_SolSystemPdeIndex[k]]->l2_norm();
+      phi += L2normRes * L2normRes;
+    }
+    return phi;
+  }
+
+  // ********************************************
+
+  void NonLinearImplicitSystem::StoreLineSearchSolution(const unsigned &igridn) {
+
+    if(_lineSearchSolOld.size() != _SolSystemPdeIndex.size()) {
+      _lineSearchSolOld.resize(_SolSystemPdeIndex.size(), NULL);
+      _lineSearchStep.resize(_SolSystemPdeIndex.size(), NULL);
+    }
+
+    for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
+      NumericVector *sol = _solution[igridn]->_Sol[_SolSystemPdeIndex[k]];
+      // the vectors are rebuilt when the level changes in the full cycle
+      if(_lineSearchSolOld[k] == NULL || _lineSearchSolOld[k]->size() != sol->size()) {
+        delete _lineSearchSolOld[k];
+        delete _lineSearchStep[k];
+        _lineSearchSolOld[k] = NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release();
+        _lineSearchSolOld[k]->init(*sol);
+        _lineSearchStep[k] = NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release();
+        _lineSearchStep[k]->init(*sol);
+      }
+      *_lineSearchSolOld[k] = *sol;
+    }
+  }
+
+  // ********************************************
+
+  void NonLinearImplicitSystem::LineSearch(const unsigned &igridn, const double &phi0) {
+
+    // full Newton step, including the interior dofs recovered by the static condensation
+    double deltaNorm = 0.;
+    for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
+      *_lineSearchStep[k] = *_solution[igridn]->_Sol[_SolSystemPdeIndex[k]];
+      _lineSearchStep[k]->add(-1., *_lineSearchSolOld[k]);
+      double L2normStep = _lineSearchStep[k]->l2_norm();
+      deltaNorm += L2normStep * L2normStep;
+    }
+    deltaNorm = sqrt(deltaNorm);
+
+    double alpha = 1.;
+    if(_trustRegion && deltaNorm > _trustRegionRadius) {
+      alpha = _trustRegionRadius / deltaNorm;
+    }
+
+    // phi(alpha) = |R(x + alpha delta)|^2, and phi'(0) = -2 phi(0) for the Newton direction
+    double dphi0 = -2. * phi0;
+    double phi = phi0;
+    double alphaPrev = 0.;
+    double phiPrev = 0.;
+    bool accepted = false;
+
+    for(unsigned lineSearchIterator = 0; lineSearchIterator < _maxNumberOfLineSearchSteps; lineSearchIterator++) {
+
+      for(unsigned k = 0; k < _SolSystemPdeIndex.size(); k++) {
+        NumericVector *sol = _solution[igridn]->_Sol[_SolSystemPdeIndex[k]];
+        *sol = *_lineSearchSolOld[k];
+        sol->add(alpha, *_lineSearchStep[k]);
+        sol->close();
+      }
+
+      phi = AssembleResidualAndGetMerit(igridn);
+
+      std::cout << "     ********* Line search step " << lineSearchIterator + 1 << " alpha = " << std::scientific << alpha
+                << "  ** Res_l2norm^2 = " << phi << "  ** Res0_l2norm^2 = " << phi0 << std::endl;
+
+      if(phi <= phi0 + _lineSearchArmijo * alpha * dphi0) {
+        accepted = true;
+        break;
+      }
+      if(lineSearchIterator + 1 == _maxNumberOfLineSearchSteps) break;
+
+      double alphaNew = 0.5 * alpha;
+      if(_lineSearchType == CUBIC_LINE_SEARCH) {
+        if(lineSearchIterator == 0) {
+          // minimum of the quadratic through phi(0), phi'(0) and phi(alpha)
+          alphaNew = - dphi0 * alpha * alpha / (2. * (phi - phi0 - dphi0 * alpha));
+        }
+        else {
+          // minimum of the cubic through phi(0), phi'(0) and the last two trial steps
+          double r1 = (phi - phi0 - dphi0 * alpha) / (alpha * alpha);
+          double r2 = (phiPrev - phi0 - dphi0 * alphaPrev) / (alphaPrev * alphaPrev);
+          double a = (r1 - r2) / (alpha - alphaPrev);
+          double b = (alpha * r2 - alphaPrev * r1) / (alpha - alphaPrev);
+          if(a == 0.) {
+            alphaNew = - dphi0 / (2. * b);
+          }
+          else {
+            double discriminant = b * b - 3. * a * dphi0;
+            alphaNew = (discriminant >= 0.) ? (-b + sqrt(discriminant)) / (3. * a) : 0.5 * alpha;
+          }
+        }
+        // safeguard, it also catches the nan of a degenerate interpolation
+        if(!(alphaNew > 0.1 * alpha)) alphaNew = 0.1 * alpha;
+        if(!(alphaNew < 0.5 * alpha)) alphaNew = 0.5 * alpha;
+      }
+
+      alphaPrev = alpha;
+      phiPrev = phi;
+      alpha = alphaNew;
+    }
+
+    if(!accepted) {
+      std::cout << "     ********* Warning: no sufficient decrease in " << _maxNumberOfLineSearchSteps
+                << " line search steps, the last step is accepted" << std::endl;
+    }
+
+    if(_trustRegion) {
+      // the Gauss-Newton model predicts |R(x + alpha delta)|^2 = (1 - alpha)^2 |R(x)|^2
+      double stepNorm = alpha * deltaNorm;
+      double predicted = phi0 * alpha * (2. - alpha);
+      double rho = (predicted > 0.) ? (phi0 - phi) / predicted : 0.;
+      if(rho < 0.25) {
+        _trustRegionRadius = 0.25 * stepNorm;
+      }
+      else if(rho > 0.75 && stepNorm > 0.99 * _trustRegionRadius) {
+        _trustRegionRadius *= 2.;
+      }
+      std::cout << "     ********* Trust region rho = " << rho << "  ** radius = " << _trustRegionRadius << std::endl;
+    }
+  }
+
+  // ********************************************
+
   void NonLinearImplicitSystem::print_iteration_and_do_additional_computations(const unsigned nonLinearIterator) const {
   
           if (_debug_nonlinear)  {
@@ -395,7 +589,7 @@ restart:
     for(unsigned nonLinearIterator = 0; nonLinearIterator < index_upper; nonLinearIterator++) {
          
           
-            NumericVector*    eps_fine_temp = NumericVector::build().release();
+            NumericVector*    eps_fine_temp = NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release();
                    eps_fine_temp->init(*_LinSolver[_gridn-1]->_EPS);
                    
                    eps_fine_temp->close();
@@ -28,6 +28,12 @@ namespace femus {
 // Forward declarations
 //------------------------------------------------------------------------------
 
+enum LineSearchType {
+  NO_LINE_SEARCH = 0,
+  BACKTRACKING_LINE_SEARCH,
+  CUBIC_LINE_SEARCH
+};
+
 /**
  * The non linear implicit system abstract class
  */
@@ -81,6 +87,13 @@ public:
         _n_max_nonlinear_iterations = max_nonlin_it;
     };
 
+    /** Overlap the ghost update of the solution after each Newton correction with the next assembly.
+     * The assembly function has to loop first on Mesh::GetInteriorElements(), then call Solution::EndGhostUpdate()
+     * and loop on Mesh::GetInterfaceElements(). It is not used with line search or trust region */
+    void SetOverlapGhostUpdate(const bool &overlap) {
+        _overlapGhostUpdate = overlap;
+    };
+
     /** Set the max nonlinear convergence tolerance */
     void SetNonLinearConvergenceTolerance(double nonlin_convergence_tolerance) {
         _max_nonlinear_convergence_tolerance = nonlin_convergence_tolerance;
@@ -97,6 +110,26 @@ public:
       _linearAbsoluteConvergenceTolerance = tolerance;
     }
     
+    /** Globalize the Newton iterations with a line search on |R|^2. BACKTRACKING_LINE_SEARCH halves the step,
+     * CUBIC_LINE_SEARCH uses the safeguarded quadratic/cubic interpolation of the trial residuals.
+     * The trial residuals are assembled with GetAssembleMatrix() == false: the assemble function should pause the
+     * adept recording and skip the Jacobian and the matrix insertion, so a trial step costs a residual evaluation only */
+    void SetLineSearch(const LineSearchType &lineSearchType) {
+      _lineSearchType = lineSearchType;
+    };
+
+    /** Set the max number of trial steps of the line search, the last one is accepted anyway */
+    void SetMaxNumberOfLineSearchSteps(const unsigned &maxNumberOfSteps) {
+      _maxNumberOfLineSearchSteps = maxNumberOfSteps;
+    };
+
+    /** Bound the l2 norm of the Newton update with a trust region radius, updated with the ratio between the actual
+     * and the predicted reduction of |R|^2. If no line search is set the rejected steps are halved */
+    void SetTrustRegion(const bool &trustRegion, const double &initialRadius = 1.) {
+      _trustRegion = trustRegion;
+      _trustRegionInitialRadius = initialRadius;
+    };
+
     void compute_convergence_rate() const;
     
     /** Solves the system. */
@@ -119,6 +152,18 @@ protected:
         
    void compute_assembly_vs_net_solver_times(const double totalSolverTime, const double totalAssemblyTime);
 
+    /** Residual-only assembly on level igridn, returns |R|^2 */
+    double AssembleResidualAndGetMerit(const unsigned &igridn);
+
+    /** |R|^2 of the system residual on level igridn, without the Dirichlet dofs */
+    double GetMerit(const unsigned &igridn);
+
+    /** Copy the system solutions on level igridn before the Newton update */
+    void StoreLineSearchSolution(const unsigned &igridn);
+
+    /** Replace the full Newton update with alpha times the update, alpha from the line search and the trust region */
+    void LineSearch(const unsigned &igridn, const double &phi0);
+
     /** The final residual for the nonlinear system R(x) */
     double _final_nonlinear_residual;
 
@@ -135,6 +180,8 @@ protected:
     
     /** Flag for printing fields at each nonlinear iteration */
     bool _debug_nonlinear;
+
+    bool _overlapGhostUpdate;
     
     /** Debug function pointer */
     DebugFunc _debug_function;
@@ -148,6 +195,20 @@ protected:
     /** Current nonlinear iteration index */
     unsigned _nonliniteration;
 
+    LineSearchType _lineSearchType;
+    unsigned _maxNumberOfLineSearchSteps;
+
+    /** Armijo sufficient decrease constant */
+    double _lineSearchArmijo;
+
+    bool _trustRegion;
+    double _trustRegionInitialRadius;
+    double _trustRegionRadius;
+
+    /** Solution before the Newton update and full Newton update, one vector for each system solution */
+    std::vector < NumericVector* > _lineSearchSolOld;
+    std::vector < NumericVector* > _lineSearchStep;
+
 };
 
 
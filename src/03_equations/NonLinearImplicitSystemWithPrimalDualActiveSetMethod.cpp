@@ -43,6 +43,7 @@ namespace femus {
   void NonLinearImplicitSystemWithPrimalDualActiveSetMethod::MGsolve (const MgSmootherType& mgSmootherType) {
 
     _bitFlipCounter = 0;
+    CheckPMultigrid();
 
     unsigned AMRCounter = 0;
 
@@ -59,7 +60,7 @@ namespace femus {
     }
     else if (_mg_type == V_CYCLE) {
       std::cout << std::endl << " *** Start Nonlinear V-Cycle ***" << std::endl;
-      grid0 = _gridn - 1;
+      grid0 = GetNumberOfLevelsToSolve() - 1;
     }
     else {
       std::cout << "wrong CYCLE type for this solver " << std::endl;
@@ -68,7 +69,7 @@ namespace femus {
    //---------------------
    
 
-    for (unsigned igridn = grid0; igridn < _gridn; igridn++) {    //_igridn
+    for (unsigned igridn = grid0; igridn < GetNumberOfLevelsToSolve(); igridn++) {    //_igridn
         
       std::cout << std::endl << "   ****** Start Level Max " << igridn + 1 << " ******" << std::endl;
       
@@ -92,7 +93,7 @@ namespace femus {
       }
    //---------------------
 
-      if (igridn + 1 < _gridn) ProlongatorSol (igridn + 1);
+      if (igridn + 1 < GetNumberOfLevelsToSolve()) ProlongatorSol (igridn + 1);
 
       if (ThisIsAMR) AddAMRLevel (AMRCounter);
 
@@ -125,7 +126,7 @@ namespace femus {
         _nonliniteration = nonLinearIterator;
 
         if (_debug_nonlinear)  {
-          _eps_fine.push_back (NumericVector::build().release());
+          _eps_fine.push_back (NumericVector::build(LSOLVER, _ml_msh->GetCommunicator()).release());
           _eps_fine[_eps_fine.size() - 1]->init (*_LinSolver[_gridn - 1]->_EPS);
         }
 
@@ -170,12 +171,13 @@ namespace femus {
           }
 
           clock_t mg_proj_mat_time = clock();
+          if (_pMultigrid) _pLinSolver->_KK->matrix_PtAP (*_pPP, *_LinSolver[igridn]->_KK, _MGmatrixFineReuse);
           for (unsigned i = igridn; i > 0; i--) {
             if (_RR[i]) {
               if (i == igridn)
-                _LinSolver[i - 1u]->_KK->matrix_ABC (*_RR[i], *_LinSolver[i]->_KK, *_PP[i], _MGmatrixFineReuse);
+                _LinSolver[i - 1u]->_KK->matrix_ABC (*_RR[i], *GetHLevelSolver (i)->_KK, *_PP[i], _MGmatrixFineReuse);
               else {
-                _LinSolver[i - 1u]->_KK->matrix_ABC (*_RR[i], *_LinSolver[i]->_KK, *_PP[i], _MGmatrixCoarseReuse);
+                _LinSolver[i - 1u]->_KK->matrix_ABC (*_RR[i], *GetHLevelSolver (i)->_KK, *_PP[i], _MGmatrixCoarseReuse);
                 if (_LinSolver[i - 1u]->_KKamr) {
                   delete _LinSolver[i - 1u]->_KKamr;
                   _LinSolver[i - 1u]->_KKamr = NULL;
@@ -184,9 +186,9 @@ namespace femus {
             }
             else {
               if (i == igridn)
-                _LinSolver[i - 1u]->_KK->matrix_PtAP (*_PP[i], *_LinSolver[i]->_KK, _MGmatrixFineReuse);
+                _LinSolver[i - 1u]->_KK->matrix_PtAP (*_PP[i], *GetHLevelSolver (i)->_KK, _MGmatrixFineReuse);
               else {
-                _LinSolver[i - 1u]->_KK->matrix_PtAP (*_PP[i], *_LinSolver[i]->_KK, _MGmatrixCoarseReuse);
+                _LinSolver[i - 1u]->_KK->matrix_PtAP (*_PP[i], *GetHLevelSolver (i)->_KK, _MGmatrixCoarseReuse);
                 if (_LinSolver[i - 1u]->_KKamr) {
                   delete _LinSolver[i - 1u]->_KKamr;
                   _LinSolver[i - 1u]->_KKamr = NULL;
@@ -199,14 +201,15 @@ namespace femus {
 
           clock_t mg_init_time = clock();
 
-          _LinSolver[igridn]->MGInit (mgSmootherType, igridn + 1, _mgOuterSolver);
+          _LinSolver[igridn]->MGInit (mgSmootherType, GetNumberOfMGLevels (igridn), _mgOuterSolver);
 
           for (unsigned i = 0; i <= igridn; i++) {
             if (_RR[i])
-              _LinSolver[i]->MGSetLevel (_LinSolver[igridn], igridn, _VariablesToBeSolvedIndex, _PP[i], _RR[i], _npre, _npost);
+              GetHLevelSolver (i)->MGSetLevel (_LinSolver[igridn], _LinSolver[igridn]->GetMGLevel(), _VariablesToBeSolvedIndex, _PP[i], _RR[i], _npre, _npost);
             else
-              _LinSolver[i]->MGSetLevel (_LinSolver[igridn], igridn, _VariablesToBeSolvedIndex, _PP[i], _PP[i], _npre, _npost);
+              GetHLevelSolver (i)->MGSetLevel (_LinSolver[igridn], _LinSolver[igridn]->GetMGLevel(), _VariablesToBeSolvedIndex, _PP[i], _PP[i], _npre, _npost);
           }
+          if (_pMultigrid) _LinSolver[igridn]->MGSetLevel (_LinSolver[igridn], _LinSolver[igridn]->GetMGLevel(), _VariablesToBeSolvedIndex, _pPP, _pPP, _npre, _npost);
 
           std::cout << "   ********* Level Max " << igridn + 1 << " MGINIT TIME:\t" \
                     << static_cast<double> ( (clock() - mg_init_time)) / CLOCKS_PER_SEC << std::endl;
@@ -0,0 +1,352 @@
+/*=========================================================================
+
+ Program: FEMUS
+ Module: PartitionedCoupling
+ Authors: Eugenio Aulisa
+
+ Copyright (c) FEMTTU
+ All rights reserved.
+
+ This software is distributed WITHOUT ANY WARRANTY; without even
+ the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "PartitionedCoupling.hpp"
+#include "MultiLevelProblem.hpp"
+#include "MultiLevelSolution.hpp"
+#include "MultiLevelMesh.hpp"
+#include "System.hpp"
+#include "NumericVector.hpp"
+
+#include <mpi.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+
+namespace femus {
+
+  // ********************************************
+
+  PartitionedCoupling::PartitionedCoupling (MultiLevelProblem &ml_prob) :
+    _mlProb (ml_prob),
+    _scheme (GAUSS_SEIDEL_COUPLING),
+    _acceleration (AITKEN_ACCELERATION),
+    _omega0 (0.5),
+    _andersonDepth (5),
+    _maxIterations (50),
+    _tolerance (1.e-8),
+    _residual (0.),
+    _converged (false) {
+
+    _mlSol = ml_prob._ml_sol;
+    _gridn = ml_prob._ml_msh->GetNumberOfLevels();
+  }
+
+  // ********************************************
+
+  PartitionedCoupling::~PartitionedCoupling() {
+    ClearStorage (_oldSolution);
+    ClearStorage (_newSolution);
+  }
+
+  // ********************************************
+
+  void PartitionedCoupling::AddSystem (const char name[]) {
+    _systems.push_back (&_mlProb.get_system (name));
+  }
+
+  // ********************************************
+
+  void PartitionedCoupling::AddInterfaceSolution (const char name[]) {
+    _interfaceIndex.push_back (_mlSol->GetIndex (name));
+  }
+
+  // ********************************************
+
+  unsigned PartitionedCoupling::Solve() {
+
+    if (_systems.size() == 0 || _interfaceIndex.size() == 0) {
+      std::cout << "Error in PartitionedCoupling::Solve: no systems or no interface solutions have been added" << std::endl;
+      abort();
+    }
+
+    std::vector < std::vector < double > > x;
+    std::vector < std::vector < double > > g;
+    std::vector < std::vector < double > > r (_gridn);
+    std::vector < std::vector < double > > xOld;
+    std::vector < std::vector < double > > rOld;
+
+    _dX.resize (0);
+    _dR.resize (0);
+
+    double omega = _omega0;
+    _converged = false;
+
+    GetInterfaceValues (x);
+
+    unsigned iteration = 0;
+    for (; iteration < _maxIterations; iteration++) {
+
+      std::cout << std::endl << " ****** Coupling iteration " << iteration + 1 << " ******" << std::endl;
+
+      Sweep();
+
+      GetInterfaceValues (g);
+      for (unsigned l = 0; l < _gridn; l++) {
+        r[l].resize (x[l].size());
+        for (unsigned i = 0; i < x[l].size(); i++) {
+          r[l][i] = g[l][i] - x[l][i];
+        }
+      }
+
+      double rNorm = sqrt (Dot (r, r));
+      double gNorm = sqrt (Dot (g, g));
+      _residual = (gNorm > 0.) ? rNorm / gNorm : rNorm;
+
+      std::cout << " ****** Coupling iteration " << iteration + 1 << " interface residual = " << _residual << std::endl;
+
+      if (_residual < _tolerance) {
+        _converged = true;
+        iteration++;
+        break;
+      }
+
+      if (_acceleration == AITKEN_ACCELERATION) {
+        if (iteration > 0) {
+          double num = 0.;
+          double den = 0.;
+          std::vector < std::vector < double > > dr (_gridn);
+          for (unsigned l = 0; l < _gridn; l++) {
+            dr[l].resize (r[l].size());
+            for (unsigned i = 0; i < r[l].size(); i++) {
+              dr[l][i] = r[l][i] - rOld[l][i];
+            }
+          }
+          num = Dot (rOld, dr);
+          den = Dot (dr, dr);
+          if (den > 0.) omega = -omega * num / den;
+        }
+        std::cout << " ****** Aitken relaxation = " << omega << std::endl;
+        xOld = x;
+        for (unsigned l = 0; l < _gridn; l++) {
+          for (unsigned i = 0; i < x[l].size(); i++) {
+            x[l][i] += omega * r[l][i];
+          }
+        }
+      }
+      else if (_acceleration == ANDERSON_ACCELERATION) {
+        if (iteration > 0 && _andersonDepth > 0) {
+          if (_dX.size() == _andersonDepth) {
+            _dX.erase (_dX.begin());
+            _dR.erase (_dR.begin());
+          }
+          _dX.resize (_dX.size() + 1, std::vector < std::vector < double > > (_gridn));
+          _dR.resize (_dR.size() + 1, std::vector < std::vector < double > > (_gridn));
+          for (unsigned l = 0; l < _gridn; l++) {
+            _dX.back()[l].resize (x[l].size());
+            _dR.back()[l].resize (x[l].size());
+            for (unsigned i = 0; i < x[l].size(); i++) {
+              _dX.back()[l][i] = x[l][i] - xOld[l][i];
+              _dR.back()[l][i] = r[l][i] - rOld[l][i];
+            }
+          }
+        }
+        std::vector < double > gamma;
+        GetAndersonCoefficients (r, gamma);
+
+        // x_{k+1} = x_k + beta r_k - sum_j gamma_j (dX_j + beta dR_j)
+        xOld = x;
+        for (unsigned l = 0; l < _gridn; l++) {
+          for (unsigned i = 0; i < x[l].size(); i++) {
+            x[l][i] += _omega0 * r[l][i];
+            for (unsigned j = 0; j < gamma.size(); j++) {
+              x[l][i] -= gamma[j] * (_dX[j][l][i] + _omega0 * _dR[j][l][i]);
+            }
+          }
+        }
+      }
+      else {
+        xOld = x;
+        x = g;
+      }
+      rOld = r;
+
+      SetInterfaceValues (x);
+    }
+
+    if (!_converged) {
+      std::cout << " ****** Coupling not converged in " << _maxIterations << " iterations, interface residual = " << _residual << std::endl;
+    }
+
+    ClearStorage (_oldSolution);
+    ClearStorage (_newSolution);
+
+    return iteration;
+  }
+
+  // ********************************************
+
+  void PartitionedCoupling::Sweep() {
+
+    if (_scheme == GAUSS_SEIDEL_COUPLING) {
+      for (unsigned k = 0; k < _systems.size(); k++) {
+        _systems[k]->MGsolve();
+      }
+    }
+    else {
+      // every system sees the solutions of the others at the beginning of the sweep
+      std::vector < unsigned > allIndex;
+      for (unsigned k = 0; k < _systems.size(); k++) {
+        const std::vector < unsigned > &solIndex = _systems[k]->GetSolPdeIndex();
+        allIndex.insert (allIndex.end(), solIndex.begin(), solIndex.end());
+      }
+
+      StoreSolutions (allIndex, _oldSolution);
+      for (unsigned k = 0; k < _systems.size(); k++) {
+        if (k > 0) RestoreSolutions (allIndex, _oldSolution);
+        _systems[k]->MGsolve();
+        StoreSolutions (_systems[k]->GetSolPdeIndex(), _newSolution);
+      }
+      RestoreSolutions (allIndex, _newSolution);
+    }
+  }
+
+  // ********************************************
+
+  void PartitionedCoupling::GetInterfaceValues (std::vector < std::vector < double > > &x) {
+    x.resize (_gridn);
+    for (unsigned l = 0; l < _gridn; l++) {
+      x[l].resize (0);
+      Solution *sol = _mlSol->GetSolutionLevel (l);
+      for (unsigned k = 0; k < _interfaceIndex.size(); k++) {
+        NumericVector *u = sol->_Sol[_interfaceIndex[k]];
+        for (int i = u->first_local_index(); i < u->last_local_index(); i++) {
+          x[l].push_back ( (*u) (i));
+        }
+      }
+    }
+  }
+
+  // ********************************************
+
+  void PartitionedCoupling::SetInterfaceValues (const std::vector < std::vector < double > > &x) {
+    for (unsigned l = 0; l < _gridn; l++) {
+      Solution *sol = _mlSol->GetSolutionLevel (l);
+      unsigned counter = 0;
+      for (unsigned k = 0; k < _interfaceIndex.size(); k++) {
+        NumericVector *u = sol->_Sol[_interfaceIndex[k]];
+        for (int i = u->first_local_index(); i < u->last_local_index(); i++) {
+          u->set (i, x[l][counter]);
+          counter++;
+        }
+        u->close();
+      }
+    }
+  }
+
+  // ********************************************
+
+  double PartitionedCoupling::Dot (const std::vector < std::vector < double > > &a, const std::vector < std::vector < double > > &b) const {
+    const std::vector < double > &af = a[_gridn - 1];
+    const std::vector < double > &bf = b[_gridn - 1];
+    double localDot = 0.;
+    for (unsigned i = 0; i < af.size(); i++) {
+      localDot += af[i] * bf[i];
+    }
+    double dot;
+    MPI_Allreduce (&localDot, &dot, 1, MPI_DOUBLE, MPI_SUM, _mlProb._ml_msh->GetCommunicator());
+    return dot;
+  }
+
+  // ********************************************
+
+  void PartitionedCoupling::StoreSolutions (const std::vector < unsigned > &solIndex, std::vector < std::vector < NumericVector* > > &storage) {
+    storage.resize (_gridn);
+    for (unsigned l = 0; l < _gridn; l++) {
+      Solution *sol = _mlSol->GetSolutionLevel (l);
+      storage[l].resize (sol->_Sol.size(), NULL);
+      for (unsigned k = 0; k < solIndex.size(); k++) {
+        NumericVector *&v = storage[l][solIndex[k]];
+        if (v == NULL) {
+          v = NumericVector::build(LSOLVER, _mlProb._ml_msh->GetCommunicator()).release();
+          v->init (*sol->_Sol[solIndex[k]]);
+        }
+        *v = *sol->_Sol[solIndex[k]];
+      }
+    }
+  }
+
+  // ********************************************
+
+  void PartitionedCoupling::RestoreSolutions (const std::vector < unsigned > &solIndex, const std::vector < std::vector < NumericVector* > > &storage) {
+    for (unsigned l = 0; l < _gridn; l++) {
+      Solution *sol = _mlSol->GetSolutionLevel (l);
+      for (unsigned k = 0; k < solIndex.size(); k++) {
+        *sol->_Sol[solIndex[k]] = *storage[l][solIndex[k]];
+      }
+    }
+  }
+
+  // ********************************************
+
+  void PartitionedCoupling::ClearStorage (std::vector < std::vector < NumericVector* > > &storage) {
+    for (unsigned l = 0; l < storage.size(); l++) {
+      for (unsigned k = 0; k < storage[l].size(); k++) {
+        delete storage[l][k];
+      }
+    }
+    storage.clear();
+  }
+
+  // ********************************************
+
+  void PartitionedCoupling::GetAndersonCoefficients (const std::vector < std::vector < double > > &r, std::vector < double > &gamma) const {
+
+    unsigned m = _dR.size();
+    gamma.assign (m, 0.);
+    if (m == 0) return;
+
+    // normal equations (dR^T dR) gamma = dR^T r, with a small Tikhonov shift for the nearly dependent columns
+    std::vector < double > A (m * m);
+    std::vector < double > b (m);
+    double trace = 0.;
+    for (unsigned i = 0; i < m; i++) {
+      for (unsigned j = i; j < m; j++) {
+        A[i * m + j] = A[j * m + i] = Dot (_dR[i], _dR[j]);
+      }
+      b[i] = Dot (_dR[i], r);
+      trace += A[i * m + i];
+    }
+    if (trace == 0.) return;
+    for (unsigned i = 0; i < m; i++) {
+      A[i * m + i] += 1.e-12 * trace;
+    }
+
+    // Gaussian elimination with partial pivoting
+    for (unsigned k = 0; k < m; k++) {
+      unsigned p = k;
+      for (unsigned i = k + 1; i < m; i++) {
+        if (fabs (A[i * m + k]) > fabs (A[p * m + k])) p = i;
+      }
+      if (p != k) {
+        for (unsigned j = 0; j < m; j++) std::swap (A[k * m + j], A[p * m + j]);
+        std::swap (b[k], b[p]);
+      }
+      for (unsigned i = k + 1; i < m; i++) {
+        double factor = A[i * m + k] / A[k * m + k];
+        for (unsigned j = k; j < m; j++) A[i * m + j] -= factor * A[k * m + j];
+        b[i] -= factor * b[k];
+      }
+    }
+    for (int i = m - 1; i >= 0; i--) {
+      double value = b[i];
+      for (unsigned j = i + 1; j < m; j++) value -= A[i * m + j] * gamma[j];
+      gamma[i] = value / A[i * m + i];
+    }
+  }
+
+} //end namespace femus
@@ -0,0 +1,155 @@
+/*=========================================================================
+
+ Program: FEMUS
+ Module: PartitionedCoupling
+ Authors: Eugenio Aulisa
+
+ Copyright (c) FEMTTU
+ All rights reserved.
+
+ This software is distributed WITHOUT ANY WARRANTY; without even
+ the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#ifndef __femus_equations_PartitionedCoupling_hpp__
+#define __femus_equations_PartitionedCoupling_hpp__
+
+#include <vector>
+#include <string>
+
+namespace femus {
+
+  class MultiLevelProblem;
+  class MultiLevelSolution;
+  class System;
+  class NumericVector;
+
+  enum CouplingSchemeType {
+    GAUSS_SEIDEL_COUPLING = 0,
+    JACOBI_COUPLING
+  };
+
+  enum CouplingAccelerationType {
+    NO_ACCELERATION = 0,
+    AITKEN_ACCELERATION,
+    ANDERSON_ACCELERATION
+  };
+
+  /**
+   * Partitioned solution of a set of coupled systems of the same MultiLevelProblem.
+   * Each coupling iteration is a block Gauss-Seidel (or Jacobi) sweep, i.e. one MGsolve per system in the given order.
+   * The sweep is a fixed point map x -> G(x) on the interface solutions, the ones read by the other systems:
+   * the iterate is relaxed with the dynamic Aitken factor or with Anderson mixing, and the coupling has converged when
+   * the interface residual G(x) - x is small relative to G(x).
+   * With the Gauss-Seidel scheme the interface solutions must be read by the first system of the sweep and computed by
+   * the following ones: a solution computed by the first system is overwritten at every sweep, the relaxation on it has no effect
+   * and the coupling does not converge faster than the plain sweep.
+   */
+  class PartitionedCoupling {
+
+    public:
+
+      /** Constructor */
+      PartitionedCoupling (MultiLevelProblem &ml_prob);
+
+      /** Destructor */
+      ~PartitionedCoupling();
+
+      /** Add the system "name" to the sweep, the systems are solved in the order they are added */
+      void AddSystem (const char name[]);
+
+      /** Add the solution "name" to the interface solutions */
+      void AddInterfaceSolution (const char name[]);
+
+      void SetCouplingScheme (const CouplingSchemeType &scheme) {
+        _scheme = scheme;
+      };
+
+      void SetAcceleration (const CouplingAccelerationType &acceleration) {
+        _acceleration = acceleration;
+      };
+
+      /** Relaxation of the first iteration for Aitken, mixing parameter for Anderson */
+      void SetRelaxation (const double &omega) {
+        _omega0 = omega;
+      };
+
+      /** Number of previous iterates used by Anderson mixing */
+      void SetAndersonDepth (const unsigned &depth) {
+        _andersonDepth = depth;
+      };
+
+      void SetMaxNumberOfCouplingIterations (const unsigned &maxIterations) {
+        _maxIterations = maxIterations;
+      };
+
+      void SetCouplingConvergenceTolerance (const double &tolerance) {
+        _tolerance = tolerance;
+      };
+
+      /** Iterate the sweeps until convergence, return the number of sweeps */
+      unsigned Solve();
+
+      /** Relative interface residual of the last sweep */
+      double GetCouplingResidual() const {
+        return _residual;
+      };
+
+      /** true if the last call to Solve converged */
+      bool GetCouplingConvergence() const {
+        return _converged;
+      };
+
+    private:
+
+      /** One block Gauss-Seidel or Jacobi sweep over the systems */
+      void Sweep();
+
+      /** Copy the owned interface dofs on all the levels into x, level by level */
+      void GetInterfaceValues (std::vector < std::vector < double > > &x);
+
+      /** Copy x back into the interface solutions */
+      void SetInterfaceValues (const std::vector < std::vector < double > > &x);
+
+      /** Global dot product of the finest level components */
+      double Dot (const std::vector < std::vector < double > > &a, const std::vector < std::vector < double > > &b) const;
+
+      /** Copy the solutions solIndex on all the levels into or from the storage vectors */
+      void StoreSolutions (const std::vector < unsigned > &solIndex, std::vector < std::vector < NumericVector* > > &storage);
+      void RestoreSolutions (const std::vector < unsigned > &solIndex, const std::vector < std::vector < NumericVector* > > &storage);
+      void ClearStorage (std::vector < std::vector < NumericVector* > > &storage);
+
+      /** Anderson coefficients gamma that minimize |r - sum_j gamma_j dR_j| on the finest level */
+      void GetAndersonCoefficients (const std::vector < std::vector < double > > &r, std::vector < double > &gamma) const;
+
+      MultiLevelProblem &_mlProb;
+      MultiLevelSolution *_mlSol;
+      unsigned _gridn;
+
+      std::vector < System* > _systems;
+      std::vector < unsigned > _interfaceIndex;
+
+      CouplingSchemeType _scheme;
+      CouplingAccelerationType _acceleration;
+      double _omega0;
+      unsigned _andersonDepth;
+      unsigned _maxIterations;
+      double _tolerance;
+
+      double _residual;
+      bool _converged;
+
+      /** Anderson history of the iterate and residual differences, the most recent last */
+      std::vector < std::vector < std::vector < double > > > _dX;
+      std::vector < std::vector < std::vector < double > > > _dR;
+
+      /** Jacobi storage, [level][solution index] */
+      std::vector < std::vector < NumericVector* > > _oldSolution;
+      std::vector < std::vector < NumericVector* > > _newSolution;
+  };
+
+} //end namespace femus
+
+#endif
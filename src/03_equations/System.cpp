@@ -112,6 +112,18 @@ const unsigned System::GetSolPdeIndex(const char solname[]) const {
 }
 
 
+void System::FreeUnusedResEps() {
+  std::vector < bool > isSolved(_ml_sol->GetSolutionSize(), false);
+  for(MultiLevelProblem::system_iterator it = _equation_systems.begin(); it != _equation_systems.end(); it++) {
+    const std::vector < unsigned > &solPdeIndex = it->second->GetSolPdeIndex();
+    for(unsigned k = 0; k < solPdeIndex.size(); k++) {
+      isSolved[solPdeIndex[k]] = true;
+    }
+  }
+  _ml_sol->FreeUnusedResEps(isSolved);
+}
+
+
  void System::set_unknown_list_for_assembly(const std::vector< Unknown > unknown_in ) {
     _unknown_list_for_assembly = unknown_in; 
  }
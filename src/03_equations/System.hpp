@@ -89,6 +89,10 @@ public:
     /** Init the system PDE structures */
     virtual void init();
 
+    /** Free the residual and the correction of the solutions that no system of the MultiLevelProblem solves for,
+     * e.g. left allocated by a system that has been cleared. It is called by the init of the systems */
+    void FreeUnusedResEps();
+
 
     /** Get the index of the Solution "solname" for this system */
     unsigned GetSolPdeIndex(const char solname[]);
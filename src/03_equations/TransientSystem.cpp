@@ -37,7 +37,9 @@ TransientSystem<Base>::TransientSystem (
   _time(0.),
   _time_step(0),
   _dt(0.1),
-  _assembleCounter(0)
+  _assembleCounter(0),
+  _predictorOrder(0),
+  _totalNonlinearIterations(0)
 {
 
 }
@@ -86,6 +88,17 @@ void TransientSystem<Base>::SetUpForSolve(){
   std::cout<<"assemble counter = "<<_assembleCounter<<std::endl;
   _assembleCounter++;
 
+  //store the solution of the previous time step
+  if(_predictorOrder > 0) {
+    for (int ig=0; ig< this->_gridn; ig++) {
+      Solution* sol = this->_solution[ig];
+      if(sol->GetSolutionHistorySize() == 0 || _time_step == 0) {
+        sol->InitSolutionHistory(this->_SolSystemPdeIndex, _predictorOrder + 1);
+      }
+      sol->PushSolutionHistory(_time);
+    }
+  }
+
 
   //update time
   _time += _dt;
@@ -95,10 +108,29 @@ void TransientSystem<Base>::SetUpForSolve(){
 
   std::cout << " Simulation Time: " << _time << " TimeStep: " << _dt << " Iteration: " << _time_step << std::endl;
 
+  //extrapolated initial guess, the Dirichlet values are then overwritten by UpdateBdc
+  if(_predictorOrder > 0) {
+    unsigned order = 0;
+    for (int ig=0; ig< this->_gridn; ig++) {
+      order = this->_solution[ig]->ExtrapolateSolution(_time, _predictorOrder);
+    }
+    std::cout << " Predictor order: " << order << std::endl;
+  }
+
    //update boundary condition
   this->_ml_sol->UpdateBdc(_time); 
 }
 
+// ------------------------------------------------------------
+/** Number of nonlinear iterations of the last solve, 0 for the systems that do not iterate */
+static unsigned NonlinearIterations(const System& system) {
+  return 0;
+}
+
+static unsigned NonlinearIterations(const NonLinearImplicitSystem& system) {
+  return system.GetNonlinearIt() + 1;
+}
+
 // ------------------------------------------------------------
 template <class Base>
 void TransientSystem<Base>::MGsolve( const MgSmootherType& mgSmootherType ) {
@@ -107,6 +139,13 @@ void TransientSystem<Base>::MGsolve( const MgSmootherType& mgSmootherType ) {
 
   Base::MGsolve( mgSmootherType );
 
+  unsigned nonlinearIterations = NonlinearIterations(*this);
+  if(nonlinearIterations > 0) {
+    _totalNonlinearIterations += nonlinearIterations;
+    std::cout << " TimeStep " << _time_step << ": nonlinear iterations " << nonlinearIterations
+              << " (predictor order " << _predictorOrder << ", total " << _totalNonlinearIterations << ")" << std::endl;
+  }
+
 }
 
 //---------------------------------------------------------------------------------------------------------
@@ -146,6 +185,20 @@ void TransientSystem<Base>::AttachGetTimeIntervalFunction (double (* get_time_in
   _is_selective_timestep = true;
 }
 
+// ------------------------------------------------------------
+template <>
+void TransientSystem<ExplicitSystem>::MGsolve(const MgSmootherType& mgSmootherType) {
+
+  if(this->GetUseStableTimeStep()) {
+    _dt = this->GetStableTimeStep();
+  }
+
+  SetUpForSolve();
+
+  this->Advance(_dt);
+
+}
+
 // ------------------------------------------------------------
 // TransientSystem forward instantiations
 template class TransientSystem<LinearImplicitSystem>;
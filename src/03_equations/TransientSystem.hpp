@@ -111,6 +111,21 @@ public:
         _time = time;
     };
 
+    /** Use as initial guess of every time step the polynomial extrapolation of order predictorOrder (0 = off) of the
+     * last solutions of the system, kept in a history of depth predictorOrder + 1 on each level */
+    void SetPredictorOrder(const unsigned predictorOrder) {
+        _predictorOrder = predictorOrder;
+    };
+
+    unsigned GetPredictorOrder() const {
+        return _predictorOrder;
+    };
+
+    /** Total number of nonlinear iterations over all the time steps, 0 for linear systems */
+    unsigned GetTotalNonlinearIterations() const {
+        return _totalNonlinearIterations;
+    };
+
 protected:
 
     double _dt;
@@ -128,6 +143,10 @@ private:
 
     unsigned _assembleCounter;
 
+    unsigned _predictorOrder;
+
+    unsigned _totalNonlinearIterations;
+
 };
 
 
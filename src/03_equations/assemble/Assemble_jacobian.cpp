@@ -18,6 +18,26 @@ template < >
   
 
 
+ // template specialization for adept::adouble
+template < >
+ void assemble_jacobian< adept::adouble, double > ::prepare_before_integration_loop(adept::Stack & stack, std::vector< std::vector< adept::adouble > > & solu)  const { 
+    
+  stack.new_recording();    // the independent variables are given to the stack after the recording
+
+}   
+  
+
+
+ // template specialization for adept::adouble
+template < >
+ void assemble_jacobian< adept::adouble, double > ::prepare_before_integration_loop(adept::Stack & stack, std::vector< UnknownLocal< adept::adouble > > & unk_vec)  const { 
+    
+  stack.new_recording();    // the independent variables are given to the stack after the recording
+
+}   
+  
+
+
  // template specialization for adept::adouble
 template < > 
  void  assemble_jacobian< adept::adouble, double >::compute_jacobian_inside_integration_loop(const unsigned i,
@@ -3,6 +3,7 @@
 
 #include "Assemble_unknown.hpp"
 #include "MultiLevelProblem.hpp"
+#include "DualNumber.hpp"
 
 namespace femus {
     
@@ -21,7 +22,11 @@ class NumericVector;
 class SparseMatrix;
 
 
-    
+/**
+ * Element Jacobian extraction. real_num is either adept::adouble (reverse mode, one tape per element)
+ * or a forward mode DualNumber<N> (no tape, the Jacobian rows are the derivative lanes of the residual).
+ * The generic definitions below are the forward mode ones, the adept ones are specializations.
+ */
 template < class real_num, class real_num_mov = double >
 class assemble_jacobian/* : public assemble_jacobian_base*/ {
  
@@ -29,8 +34,15 @@ class assemble_jacobian/* : public assemble_jacobian_base*/ {
  public:
     
                                                
+ /** adept only: the forward mode has nothing to seed here and aborts, use one of the overloads below */
  void prepare_before_integration_loop(adept::Stack& stack) const;
 
+ /** Same as above, it also marks the element unknowns solu as independent variables (seeding of the forward mode lanes) */
+ void prepare_before_integration_loop(adept::Stack& stack, std::vector< std::vector< real_num > > & solu) const;
+
+ /** Same as above, for the element unknowns stored in unk_vec: call it after set_elem_dofs */
+ void prepare_before_integration_loop(adept::Stack& stack, std::vector< UnknownLocal < real_num > > & unk_vec) const;
+
  
  void  compute_jacobian_inside_integration_loop(const unsigned i,
                                                 const unsigned dim,
@@ -123,12 +135,226 @@ static void mass_residual (std::vector < real_num > & Res,
  // ===============
  
  
+ private:
  
+ // member templates, so that the explicit instantiation with adept::adouble does not instantiate them
+
+ /** forward mode: abort if the element dof in position lane does not carry the unit derivative of its own lane */
+ template < class dual_num >
+ static void check_seeded_lane(const dual_num & dof, const unsigned lane);
+
+ /** forward mode: copy the value and the derivative lanes of Res into the global residual and Jacobian */
+ template < class dual_num >
+ static void add_forward_jacobian(const std::vector< dual_num > & Res,
+                                  std::vector< real_num_mov > & Jac,
+                                  const std::vector< int > & loc_to_glob_map,
+                                  NumericVector*           RES,
+                                  SparseMatrix*             KK);
 
 
 };
 
 
+// adept specializations, in Assemble_jacobian.cpp
+template < >
+ void assemble_jacobian< adept::adouble, double >::prepare_before_integration_loop(adept::Stack & stack) const;
+
+template < >
+ void assemble_jacobian< adept::adouble, double >::prepare_before_integration_loop(adept::Stack & stack, std::vector< std::vector< adept::adouble > > & solu) const;
+
+template < >
+ void assemble_jacobian< adept::adouble, double >::prepare_before_integration_loop(adept::Stack & stack, std::vector< UnknownLocal < adept::adouble > > & unk_vec) const;
+
+template < >
+ void assemble_jacobian< adept::adouble, double >::compute_jacobian_inside_integration_loop(const unsigned i,
+                                                const unsigned dim,
+                                                const std::vector < unsigned int > Sol_n_el_dofs,
+                                                const unsigned int sum_Sol_n_el_dofs,
+                                                const std::vector< UnknownLocal < adept::adouble > > & unk_vec,
+                                                const std::vector< Phi < double > > &  phi,
+                                                const double weight,
+                                                std::vector< double > & Jac) const;
+
+template < >
+ void assemble_jacobian< adept::adouble, double >::compute_jacobian_outside_integration_loop(adept::Stack & stack,
+                                                const std::vector< std::vector< adept::adouble > > & solu,
+                                                const std::vector< adept::adouble > & Res,
+                                                std::vector< double > & Jac,
+                                                const std::vector< int > & loc_to_glob_map,
+                                                NumericVector*           RES,
+                                                SparseMatrix*             KK) const;
+
+template < >
+ void assemble_jacobian< adept::adouble, double >::compute_jacobian_outside_integration_loop(adept::Stack & stack,
+                                                const std::vector< UnknownLocal < adept::adouble > > & unk_vec,
+                                                const std::vector< adept::adouble > & Res,
+                                                std::vector< double > & Jac,
+                                                const std::vector< int > & loc_to_glob_map,
+                                                NumericVector*           RES,
+                                                SparseMatrix*             KK) const;
+
+
+// forward mode: without the element unknowns no lane is seeded and the Jacobian would be zero
+template < class real_num, class real_num_mov >
+ void assemble_jacobian<real_num, real_num_mov>::prepare_before_integration_loop(adept::Stack & stack) const {
+
+   std::cout << "Error in assemble_jacobian::prepare_before_integration_loop: the forward mode needs the element unknowns to seed, "
+             << "pass solu or unk_vec" << std::endl;
+   abort();
+
+}
+
+
+// forward mode: the element dofs of all the unknowns, in the order of the residual, take one lane each
+template < class real_num, class real_num_mov >
+ void assemble_jacobian<real_num, real_num_mov>::prepare_before_integration_loop(adept::Stack & stack, std::vector< std::vector< real_num > > & solu) const {
+
+   unsigned lane = 0;
+   for (unsigned  k = 0; k < solu.size(); k++) {
+     for (unsigned  i = 0; i < solu[k].size(); i++) {
+       if (lane == real_num::numberOfLanes) {
+         std::cout << "Error in assemble_jacobian::prepare_before_integration_loop: the element has more dofs than the "
+                   << real_num::numberOfLanes << " derivative lanes" << std::endl;
+         abort();
+       }
+       solu[k][i].SetIndependent(lane);
+       lane++;
+     }
+   }
+
+}
+
+
+// forward mode: same as above, the unknowns are taken in the order of unk_vec
+template < class real_num, class real_num_mov >
+ void assemble_jacobian<real_num, real_num_mov>::prepare_before_integration_loop(adept::Stack & stack, std::vector< UnknownLocal < real_num > > & unk_vec) const {
+
+   unsigned lane = 0;
+   for (unsigned  k = 0; k < unk_vec.size(); k++) {
+     std::vector< real_num > & dofs = unk_vec[k].elem_dofs();
+     for (unsigned  i = 0; i < dofs.size(); i++) {
+       if (lane == real_num::numberOfLanes) {
+         std::cout << "Error in assemble_jacobian::prepare_before_integration_loop: the element has more dofs than the "
+                   << real_num::numberOfLanes << " derivative lanes" << std::endl;
+         abort();
+       }
+       dofs[i].SetIndependent(lane);
+       lane++;
+     }
+   }
+
+}
+
+
+template < class real_num, class real_num_mov >
+ void assemble_jacobian<real_num, real_num_mov>::compute_jacobian_inside_integration_loop(const unsigned i,
+                                                const unsigned dim,
+                                                const std::vector < unsigned int > Sol_n_el_dofs,
+                                                const unsigned int sum_Sol_n_el_dofs,
+                                                const std::vector< UnknownLocal < real_num > > & unk_vec,
+                                                const std::vector< Phi < real_num_mov > > &  phi,
+                                                const double weight,
+                                                std::vector< double > & Jac) const { }
+
+
+// forward mode: the element dofs must still carry their seeds, otherwise the Jacobian would be silently wrong
+template < class real_num, class real_num_mov >
+ void assemble_jacobian<real_num, real_num_mov>::compute_jacobian_outside_integration_loop(adept::Stack & stack,
+                                               const std::vector< std::vector< real_num > > & solu,
+                                               const std::vector< real_num > & Res,
+                                               std::vector< real_num_mov > & Jac,
+                                               const std::vector< int > & loc_to_glob_map,
+                                               NumericVector*           RES,
+                                               SparseMatrix*             KK) const {
+
+  unsigned lane = 0;
+  for (unsigned  k = 0; k < solu.size(); k++) {
+    for (unsigned  i = 0; i < solu[k].size(); i++) {
+      check_seeded_lane(solu[k][i], lane);
+      lane++;
+    }
+  }
+
+  if (lane != Res.size()) {
+    std::cout << "Error in assemble_jacobian::compute_jacobian_outside_integration_loop: " << lane
+              << " seeded dofs for a residual of size " << Res.size() << std::endl;
+    abort();
+  }
+
+  add_forward_jacobian(Res, Jac, loc_to_glob_map, RES, KK);
+
+}
+
+
+template < class real_num, class real_num_mov >
+ void assemble_jacobian<real_num, real_num_mov>::compute_jacobian_outside_integration_loop(adept::Stack & stack,
+                                               const std::vector< UnknownLocal < real_num > > & unk_vec,
+                                               const std::vector< real_num > & Res,
+                                               std::vector< real_num_mov > & Jac,
+                                               const std::vector< int > & loc_to_glob_map,
+                                               NumericVector*           RES,
+                                               SparseMatrix*             KK) const {
+
+  unsigned lane = 0;
+  for (unsigned  k = 0; k < unk_vec.size(); k++) {
+    const std::vector< real_num > & dofs = unk_vec[k].elem_dofs();
+    for (unsigned  i = 0; i < dofs.size(); i++) {
+      check_seeded_lane(dofs[i], lane);
+      lane++;
+    }
+  }
+
+  if (lane != Res.size()) {
+    std::cout << "Error in assemble_jacobian::compute_jacobian_outside_integration_loop: " << lane
+              << " seeded dofs for a residual of size " << Res.size() << std::endl;
+    abort();
+  }
+
+  add_forward_jacobian(Res, Jac, loc_to_glob_map, RES, KK);
+
+}
+
+
+template < class real_num, class real_num_mov >
+template < class dual_num >
+ /*static*/ void assemble_jacobian<real_num, real_num_mov>::check_seeded_lane(const dual_num & dof, const unsigned lane) {
+
+  if (lane >= dual_num::numberOfLanes || dof.derivative(lane) != 1.) {
+    std::cout << "Error in assemble_jacobian::compute_jacobian_outside_integration_loop: the element dof " << lane
+              << " is not seeded, call prepare_before_integration_loop with the element unknowns after setting them" << std::endl;
+    abort();
+  }
+
+}
+
+
+// forward mode: row i of the element Jacobian is the derivative lanes of Res[i]
+template < class real_num, class real_num_mov >
+template < class dual_num >
+ /*static*/ void assemble_jacobian<real_num, real_num_mov>::add_forward_jacobian(const std::vector< dual_num > & Res,
+                                                                                  std::vector< real_num_mov > & Jac,
+                                                                                  const std::vector< int > & loc_to_glob_map,
+                                                                                  NumericVector*           RES,
+                                                                                  SparseMatrix*             KK) {
+
+  const unsigned int n = Res.size();
+
+  std::vector < double > Res_double(n);
+
+  for (unsigned i = 0; i < n; i++) {
+    Res_double[i] = - Res[i].value();
+    const double *dRes = Res[i].derivatives();
+    for (unsigned j = 0; j < n; j++) {
+      Jac[i * n + j] = dRes[j];
+    }
+  }
+
+  RES->add_vector_blocked(Res_double, loc_to_glob_map);
+  KK->add_matrix_blocked(Jac, loc_to_glob_map, loc_to_glob_map);
+
+}
+
+
 
 template < class real_num, class real_num_mov >
  inline /*static*/ double assemble_jacobian<real_num, real_num_mov>::laplacian_row(const std::vector < std::vector < std::vector < double > > > & phi_x_fe_qp,
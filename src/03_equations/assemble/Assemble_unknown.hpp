@@ -121,6 +121,8 @@ class UnknownLocal {
 
     inline const std::vector < real_num > & elem_dofs() const { return Sol_eldofs; }
     
+    inline std::vector < real_num > & elem_dofs() { return Sol_eldofs; }
+    
  private:
     
 //these do not change with the element
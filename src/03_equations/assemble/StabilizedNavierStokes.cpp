@@ -0,0 +1,363 @@
+/*=========================================================================
+
+ Program: FEMuS
+ Module: StabilizedNavierStokes
+ Authors: Eugenio Aulisa
+
+ Copyright (c) FEMuS
+ All rights reserved.
+
+ This software is distributed WITHOUT ANY WARRANTY; without even
+ the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "StabilizedNavierStokes.hpp"
+#include "LinearImplicitSystem.hpp"
+#include "MultiLevelSolution.hpp"
+#include "NumericVector.hpp"
+#include "SparseMatrix.hpp"
+#include "FemusInit.hpp"
+#include "adept.h"
+
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include <stdlib.h>
+
+namespace femus {
+
+  // ******************
+  StabilizedNavierStokes::StabilizedNavierStokes(const std::vector < std::string > &velocityName, const std::string &pressureName, const double &mu, const double &rho) :
+    _velocityName(velocityName),
+    _pressureName(pressureName),
+    _mu(mu),
+    _rho(rho),
+    _f(velocityName.size(), 0.),
+    _supg(true),
+    _pspg(true),
+    _lsic(true) {
+  }
+
+  // ******************
+  void StabilizedNavierStokes::SetStabilization(const bool &supg, const bool &pspg, const bool &lsic) {
+    _supg = supg;
+    _pspg = pspg;
+    _lsic = lsic;
+  }
+
+  // ******************
+  void StabilizedNavierStokes::SetBodyForce(const std::vector < double > &f) {
+    if(f.size() != _velocityName.size()) {
+      std::cout << "Error in StabilizedNavierStokes::SetBodyForce: the body force has to have one entry for each velocity component" << std::endl;
+      abort();
+    }
+    _f = f;
+  }
+
+  // ******************
+  void StabilizedNavierStokes::ClearCache() {
+    _elementSize.clear();
+    _tauM.clear();
+    _tauC.clear();
+  }
+
+  // ******************
+  void StabilizedNavierStokes::ComputeElementSize(const unsigned &level, Mesh *msh) {
+
+    unsigned iproc = msh->processor_id();
+    unsigned dim = msh->GetDimension();
+    unsigned offset = msh->_elementOffset[iproc];
+
+    _elementSize[level].resize(msh->_elementOffset[iproc + 1] - offset);
+
+    std::vector < std::vector < double > > x(dim);
+    std::vector < double > phi;
+    std::vector < double > phi_x;
+    double weight;
+
+    for(unsigned iel = offset; iel < msh->_elementOffset[iproc + 1]; iel++) {
+      short unsigned ielGeom = msh->GetElementType(iel);
+      unsigned nDofsX = msh->GetElementDofNumber(iel, 2);
+      for(unsigned k = 0; k < dim; k++) {
+        x[k].resize(nDofsX);
+      }
+      for(unsigned i = 0; i < nDofsX; i++) {
+        unsigned xDof = msh->GetSolutionDof(i, iel, 2);
+        for(unsigned k = 0; k < dim; k++) {
+          x[k][i] = (*msh->_topology->_Sol[k])(xDof);
+        }
+      }
+
+      double measure = 0.;
+      for(unsigned ig = 0; ig < msh->_finiteElement[ielGeom][0]->GetGaussPointNumber(); ig++) {
+        msh->_finiteElement[ielGeom][0]->Jacobian(x, ig, weight, phi, phi_x);
+        measure += weight;
+      }
+      _elementSize[level][iel - offset] = pow(measure, 1. / dim);
+    }
+  }
+
+  // ******************
+  void StabilizedNavierStokes::ComputeTau(const unsigned &level, Mesh *msh, Solution *sol, const std::vector < unsigned > &solVIndex, const unsigned &solVType) {
+
+    unsigned iproc = msh->processor_id();
+    unsigned dim = msh->GetDimension();
+    unsigned offset = msh->_elementOffset[iproc];
+    double nu = _mu / _rho;
+
+    _tauM[level].resize(msh->_elementOffset[iproc + 1] - offset);
+    _tauC[level].resize(msh->_elementOffset[iproc + 1] - offset);
+
+    std::vector < double > uCenter(dim);
+
+    for(unsigned iel = offset; iel < msh->_elementOffset[iproc + 1]; iel++) {
+      // the element center velocity is the mean of the vertex values
+      unsigned nVertices = msh->GetElementDofNumber(iel, 0);
+      std::fill(uCenter.begin(), uCenter.end(), 0.);
+      for(unsigned i = 0; i < nVertices; i++) {
+        unsigned solVDof = msh->GetSolutionDof(i, iel, solVType);
+        for(unsigned k = 0; k < dim; k++) {
+          uCenter[k] += (*sol->_Sol[solVIndex[k]])(solVDof) / nVertices;
+        }
+      }
+      double uNorm = 0.;
+      for(unsigned k = 0; k < dim; k++) {
+        uNorm += uCenter[k] * uCenter[k];
+      }
+      uNorm = sqrt(uNorm);
+
+      double h = _elementSize[level][iel - offset];
+
+      // tauM = 1 / (rho ((2|u|/h)^2 + (4 nu/h^2)^2)^(1/2)), tauC = rho |u| h xi / 2 with xi = min(Re_h / 3, 1), Re_h = |u| h / (2 nu)
+      double advection = 2. * uNorm / h;
+      double diffusion = 4. * nu / (h * h);
+      double denominator = sqrt(advection * advection + diffusion * diffusion);
+      _tauM[level][iel - offset] = (denominator > 0.) ? 1. / (_rho * denominator) : 0.;
+
+      double xi = (nu > 0.) ? std::min(uNorm * h / (6. * nu), 1.) : 1.;
+      _tauC[level][iel - offset] = 0.5 * _rho * uNorm * h * xi;
+    }
+  }
+
+  // ******************
+  void StabilizedNavierStokes::Assemble(MultiLevelProblem &ml_prob, const std::string &systemName) {
+
+    LinearImplicitSystem* mlPdeSys = &ml_prob.get_system < LinearImplicitSystem > (systemName);
+    const unsigned level = mlPdeSys->GetLevelToAssemble();
+    const bool assembleMatrix = mlPdeSys->GetAssembleMatrix();
+
+    Mesh* msh = ml_prob._ml_msh->GetLevel(level);
+    MultiLevelSolution* mlSol = ml_prob._ml_sol;
+    Solution* sol = mlSol->GetSolutionLevel(level);
+
+    LinearEquationSolver* pdeSys = mlPdeSys->_LinSolver[level];
+    SparseMatrix* KK = pdeSys->_KK;
+    NumericVector* RES = pdeSys->_RES;
+
+    const unsigned dim = msh->GetDimension();
+    unsigned iproc = msh->processor_id();
+
+    if(_velocityName.size() != dim) {
+      std::cout << "Error in StabilizedNavierStokes::Assemble: the number of velocity components is not the mesh dimension" << std::endl;
+      abort();
+    }
+
+    adept::Stack& s = FemusInit::_adeptStack;
+    if(assembleMatrix) s.continue_recording();
+    else s.pause_recording();
+
+    std::vector < unsigned > solVIndex(dim);
+    std::vector < unsigned > solVPdeIndex(dim);
+    for(unsigned k = 0; k < dim; k++) {
+      solVIndex[k] = mlSol->GetIndex(_velocityName[k].c_str());
+      solVPdeIndex[k] = mlPdeSys->GetSolPdeIndex(_velocityName[k].c_str());
+    }
+    unsigned solVType = mlSol->GetSolutionType(solVIndex[0]);
+
+    unsigned solPIndex = mlSol->GetIndex(_pressureName.c_str());
+    unsigned solPPdeIndex = mlPdeSys->GetSolPdeIndex(_pressureName.c_str());
+    unsigned solPType = mlSol->GetSolutionType(solPIndex);
+
+    // the strong residual has no viscous term, that is consistent only for linear elements
+    if(solVType != 0 || solPType != 0) {
+      std::cout << "Error in StabilizedNavierStokes::Assemble: velocity and pressure have to be both LAGRANGE FIRST" << std::endl;
+      abort();
+    }
+
+    // element sizes once per level, taus at every matrix assembly
+    unsigned offset = msh->_elementOffset[iproc];
+    unsigned nOwnedElements = msh->_elementOffset[iproc + 1] - offset;
+    unsigned nLevels = ml_prob._ml_msh->GetNumberOfLevels();
+    if(_elementSize.size() != nLevels) {
+      _elementSize.assign(nLevels, std::vector < double > ());
+      _tauM.assign(nLevels, std::vector < double > ());
+      _tauC.assign(nLevels, std::vector < double > ());
+    }
+    if(_elementSize[level].size() != nOwnedElements) {
+      ComputeElementSize(level, msh);
+      _tauM[level].clear();
+    }
+    if(assembleMatrix || _tauM[level].size() != nOwnedElements) {
+      ComputeTau(level, msh, sol, solVIndex, solVType);
+    }
+
+    std::vector < std::vector < adept::adouble > > solV(dim);
+    std::vector < adept::adouble > solP;
+    std::vector < std::vector < double > > x(dim);
+
+    std::vector < std::vector < adept::adouble > > aResV(dim);
+    std::vector < adept::adouble > aResP;
+
+    std::vector < double > phi;
+    std::vector < double > phi_x;
+    double weight;
+
+    std::vector < int > sysDof;
+    std::vector < double > Res;
+    std::vector < double > Jac;
+
+    if(assembleMatrix) KK->zero();
+
+    for(unsigned iel = offset; iel < msh->_elementOffset[iproc + 1]; iel++) {
+
+      short unsigned ielGeom = msh->GetElementType(iel);
+      unsigned nDofs = msh->GetElementDofNumber(iel, solVType);
+      unsigned nDofsX = msh->GetElementDofNumber(iel, 2);
+      unsigned nDofsVP = (dim + 1) * nDofs;
+
+      sysDof.resize(nDofsVP);
+      for(unsigned k = 0; k < dim; k++) {
+        solV[k].resize(nDofs);
+        aResV[k].assign(nDofs, 0.);
+        x[k].resize(nDofsX);
+      }
+      solP.resize(nDofs);
+      aResP.assign(nDofs, 0.);
+
+      for(unsigned i = 0; i < nDofs; i++) {
+        unsigned solDof = msh->GetSolutionDof(i, iel, solVType);
+        for(unsigned k = 0; k < dim; k++) {
+          solV[k][i] = (*sol->_Sol[solVIndex[k]])(solDof);
+          sysDof[k * nDofs + i] = pdeSys->GetSystemDof(solVIndex[k], solVPdeIndex[k], i, iel);
+        }
+        solP[i] = (*sol->_Sol[solPIndex])(solDof);
+        sysDof[dim * nDofs + i] = pdeSys->GetSystemDof(solPIndex, solPPdeIndex, i, iel);
+      }
+
+      for(unsigned i = 0; i < nDofsX; i++) {
+        unsigned xDof = msh->GetSolutionDof(i, iel, 2);
+        for(unsigned k = 0; k < dim; k++) {
+          x[k][i] = (*msh->_topology->_Sol[k])(xDof);
+        }
+      }
+
+      double tauM = _tauM[level][iel - offset];
+      double tauC = _tauC[level][iel - offset];
+
+      if(assembleMatrix) s.new_recording();
+
+      for(unsigned ig = 0; ig < msh->_finiteElement[ielGeom][solVType]->GetGaussPointNumber(); ig++) {
+        msh->_finiteElement[ielGeom][solVType]->Jacobian(x, ig, weight, phi, phi_x);
+
+        std::vector < adept::adouble > solV_gss(dim, 0.);
+        std::vector < std::vector < adept::adouble > > gradSolV_gss(dim, std::vector < adept::adouble > (dim, 0.));
+        std::vector < adept::adouble > gradSolP_gss(dim, 0.);
+        adept::adouble solP_gss = 0.;
+
+        for(unsigned i = 0; i < nDofs; i++) {
+          solP_gss += phi[i] * solP[i];
+          for(unsigned j = 0; j < dim; j++) {
+            gradSolP_gss[j] += phi_x[i * dim + j] * solP[i];
+          }
+          for(unsigned k = 0; k < dim; k++) {
+            solV_gss[k] += phi[i] * solV[k][i];
+            for(unsigned j = 0; j < dim; j++) {
+              gradSolV_gss[k][j] += phi_x[i * dim + j] * solV[k][i];
+            }
+          }
+        }
+
+        adept::adouble divV = 0.;
+        for(unsigned k = 0; k < dim; k++) {
+          divV += gradSolV_gss[k][k];
+        }
+
+        // strong momentum residual, the viscous term div(mu grad u) is zero for linear elements
+        std::vector < adept::adouble > strongRes(dim);
+        for(unsigned k = 0; k < dim; k++) {
+          adept::adouble advection = 0.;
+          for(unsigned j = 0; j < dim; j++) {
+            advection += solV_gss[j] * gradSolV_gss[k][j];
+          }
+          strongRes[k] = _rho * advection + gradSolP_gss[k] - _f[k];
+        }
+
+        for(unsigned i = 0; i < nDofs; i++) {
+          adept::adouble uGradPhi = 0.;
+          for(unsigned j = 0; j < dim; j++) {
+            uGradPhi += solV_gss[j] * phi_x[i * dim + j];
+          }
+
+          for(unsigned k = 0; k < dim; k++) {
+            adept::adouble NSV = 0.;
+            for(unsigned j = 0; j < dim; j++) {
+              NSV += _mu * phi_x[i * dim + j] * gradSolV_gss[k][j];
+              NSV += _rho * phi[i] * solV_gss[j] * gradSolV_gss[k][j];
+            }
+            NSV += - solP_gss * phi_x[i * dim + k] - _f[k] * phi[i];
+
+            if(_supg) NSV += _rho * tauM * uGradPhi * strongRes[k];
+            if(_lsic) NSV += tauC * phi_x[i * dim + k] * divV;
+
+            aResV[k][i] += - NSV * weight;
+          }
+
+          adept::adouble NSP = phi[i] * divV;
+          if(_pspg) {
+            for(unsigned j = 0; j < dim; j++) {
+              NSP += tauM * phi_x[i * dim + j] * strongRes[j];
+            }
+          }
+          aResP[i] += - NSP * weight;
+        }
+      } // end gauss point loop
+
+      Res.resize(nDofsVP);
+      for(unsigned i = 0; i < nDofs; i++) {
+        for(unsigned k = 0; k < dim; k++) {
+          Res[k * nDofs + i] = -aResV[k][i].value();
+        }
+        Res[dim * nDofs + i] = -aResP[i].value();
+      }
+
+      RES->add_vector_blocked(Res, sysDof);
+
+      if(assembleMatrix) {
+        Jac.resize(nDofsVP * nDofsVP);
+        for(unsigned k = 0; k < dim; k++) {
+          s.dependent(&aResV[k][0], nDofs);
+        }
+        s.dependent(&aResP[0], nDofs);
+
+        for(unsigned k = 0; k < dim; k++) {
+          s.independent(&solV[k][0], nDofs);
+        }
+        s.independent(&solP[0], nDofs);
+
+        // row-major jacobian
+        s.jacobian(&Jac[0], true);
+        KK->add_matrix_blocked(Jac, sysDof, sysDof);
+
+        s.clear_independents();
+        s.clear_dependents();
+      }
+    } // end element loop
+
+    RES->close();
+    if(assembleMatrix) KK->close();
+    else s.continue_recording();
+  }
+
+} //end namespace femus
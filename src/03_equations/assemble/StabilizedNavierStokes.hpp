@@ -0,0 +1,109 @@
+/*=========================================================================
+
+ Program: FEMuS
+ Module: StabilizedNavierStokes
+ Authors: Eugenio Aulisa
+
+ Copyright (c) FEMuS
+ All rights reserved.
+
+ This software is distributed WITHOUT ANY WARRANTY; without even
+ the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#ifndef __femus_equations_StabilizedNavierStokes_hpp__
+#define __femus_equations_StabilizedNavierStokes_hpp__
+
+//----------------------------------------------------------------------------
+// includes :
+//----------------------------------------------------------------------------
+#include "MultiLevelProblem.hpp"
+
+#include <vector>
+#include <string>
+
+
+namespace femus {
+
+  class Mesh;
+  class Solution;
+
+  /**
+   * Residual and Newton Jacobian of the steady incompressible Navier-Stokes equations
+   *   rho (u . grad) u - div(mu grad u) + grad p = f,   div u = 0
+   * with equal-order linear Lagrange velocity and pressure (Q1/Q1, P1/P1), stabilized with SUPG, PSPG and LSIC (grad-div).
+   * The strong momentum residual has no viscous term: it vanishes for P1 and for Q1 on affine elements, and it is neglected for Q1
+   * on distorted elements. Assemble aborts for quadratic elements, where dropping it would make SUPG and PSPG inconsistent.
+   * The element size h and the stabilization parameters tauM, tauC are computed once per element from the element-center velocity
+   * and cached per level: h when the level is assembled for the first time, tauM and tauC every time the matrix is assembled.
+   * The residual-only assemblies (line search, residual checks) reuse the cached taus, so that they are frozen in the Newton step and
+   * the Jacobian is consistent with the residual. The unknowns are ordered as the velocity components and the pressure, each one with the
+   * dofs of the system, so the kernel works with any multigrid, field-split or Schur smoother setup of the system.
+   * Call Assemble from the assemble function attached to the system.
+   */
+
+  class StabilizedNavierStokes {
+
+    public:
+
+      /** velocityName has dim entries, mu is the dynamic viscosity and rho the density */
+      StabilizedNavierStokes(const std::vector < std::string > &velocityName, const std::string &pressureName, const double &mu, const double &rho = 1.);
+
+      /** Switch on or off the single stabilization terms, all of them are on by default */
+      void SetStabilization(const bool &supg, const bool &pspg, const bool &lsic);
+
+      /** Constant body force per unit volume, it has dim entries */
+      void SetBodyForce(const std::vector < double > &f);
+
+      /** Change the viscosity (Reynolds number continuation), the cached taus are recomputed at the next matrix assembly */
+      void SetViscosity(const double &mu) {
+        _mu = mu;
+      }
+
+      /** Assemble the residual, and the matrix if the system asks for it, on the level GetLevelToAssemble() of the system systemName */
+      void Assemble(MultiLevelProblem &ml_prob, const std::string &systemName);
+
+      /** Drop the cached element sizes and taus, to be called when the mesh changes */
+      void ClearCache();
+
+      const std::vector < double > &GetElementSize(const unsigned &level) const {
+        return _elementSize[level];
+      }
+
+      const std::vector < double > &GetTauM(const unsigned &level) const {
+        return _tauM[level];
+      }
+
+      const std::vector < double > &GetTauC(const unsigned &level) const {
+        return _tauC[level];
+      }
+
+    private:
+
+      /** h = (element measure)^(1/dim) of the elements owned by this process */
+      void ComputeElementSize(const unsigned &level, Mesh *msh);
+
+      /** tauM and tauC of the elements owned by this process, from the velocity at the element center */
+      void ComputeTau(const unsigned &level, Mesh *msh, Solution *sol, const std::vector < unsigned > &solVIndex, const unsigned &solVType);
+
+      std::vector < std::string > _velocityName;
+      std::string _pressureName;
+      double _mu;
+      double _rho;
+      std::vector < double > _f;
+
+      bool _supg;
+      bool _pspg;
+      bool _lsic;
+
+      /** per level, indexed by iel - _elementOffset[iproc] */
+      std::vector < std::vector < double > > _elementSize;
+      std::vector < std::vector < double > > _tauM;
+      std::vector < std::vector < double > > _tauC;
+  };
+
+} //end namespace femus
+
+#endif
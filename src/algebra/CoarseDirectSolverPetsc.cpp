@@ -0,0 +1,157 @@
+/*=========================================================================
+
+  Program: FEMUS
+  Module: CoarseDirectSolverPetsc
+  Authors: Eugenio Aulisa
+
+  Copyright (c) FEMTTU
+  All rights reserved.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.  See the above copyright notice for more information.
+
+  =========================================================================*/
+
+//----------------------------------------------------------------------------
+// includes :
+//----------------------------------------------------------------------------
+#include "FemusConfig.hpp"
+
+#ifdef HAVE_PETSC
+
+// Local Includes
+#include "CoarseDirectSolverPetsc.hpp"
+#include "PetscPreconditioner.hpp"
+#include <iostream>
+
+namespace femus {
+
+  // ================================================
+
+  CoarseDirectSolverPetsc::CoarseDirectSolverPetsc (const PreconditionerType &factorizationType, const unsigned &redundantNumber) :
+    _isInitialized (false),
+    _sourceId (0),
+    _sourceNonzeroState (0),
+    _factorizationType (factorizationType),
+    _redundantNumber (redundantNumber),
+    _symbolicCounter (0),
+    _numericCounter (0),
+    _printInfo (true) {
+  }
+
+  // ================================================
+
+  CoarseDirectSolverPetsc::~CoarseDirectSolverPetsc() {
+    Clear();
+  }
+
+  // ================================================
+
+  void CoarseDirectSolverPetsc::Clear() {
+    if (_isInitialized) {
+      KSPDestroy (&_ksp);
+      MatDestroy (&_mat);
+      _isInitialized = false;
+    }
+  }
+
+  // ================================================
+
+  bool CoarseDirectSolverPetsc::SameNonzeroPattern (Mat KK) const {
+    // the object id changes when the coarse matrix is rebuilt, the nonzero state when new nonzeros are inserted:
+    // both are local queries, and the nonzero state is kept consistent among the processes by the assembly
+    PetscObjectId id;
+    PetscObjectState nonzeroState;
+    PetscObjectGetId ( (PetscObject) KK, &id);
+    MatGetNonzeroState (KK, &nonzeroState);
+
+    return (id == _sourceId && nonzeroState == _sourceNonzeroState);
+  }
+
+  // ================================================
+
+  void CoarseDirectSolverPetsc::SetUp (Mat KK) {
+
+    PetscLogDouble t1;
+    PetscLogDouble t2;
+    PetscTime (&t1);
+
+    bool reuse = _isInitialized && SameNonzeroPattern (KK);
+
+    if (reuse) {
+      // same pattern: the nonzero state of _mat does not change and the PC does only the numeric factorization
+      MatCopy (KK, _mat, SAME_NONZERO_PATTERN);
+      _numericCounter++;
+    }
+    else {
+      Clear();
+
+      MatDuplicate (KK, MAT_COPY_VALUES, &_mat);
+      PetscObjectGetId ( (PetscObject) KK, &_sourceId);
+      MatGetNonzeroState (KK, &_sourceNonzeroState);
+
+      MPI_Comm comm;
+      PetscObjectGetComm ( (PetscObject) KK, &comm);
+      KSPCreate (comm, &_ksp);
+      KSPSetType (_ksp, KSPPREONLY);
+      KSPSetOperators (_ksp, _mat, _mat);
+      KSPSetOptionsPrefix (_ksp, "coarse-");
+
+      PC pc;
+      KSPGetPC (_ksp, &pc);
+      if (_redundantNumber > 0) {
+        PCSetType (pc, PCREDUNDANT);
+        PCRedundantSetNumber (pc, _redundantNumber);
+        KSP innerKsp;
+        PCRedundantGetKSP (pc, &innerKsp);
+        PC innerPc;
+        KSPGetPC (innerKsp, &innerPc);
+        PCSetType (innerPc, PCLU);
+        PCFactorSetMatSolverType (innerPc, MATSOLVERMUMPS);
+      }
+      else {
+        PetscPreconditioner::set_petsc_preconditioner_type (_factorizationType, pc);
+      }
+      KSPSetFromOptions (_ksp);
+
+      _isInitialized = true;
+      _symbolicCounter++;
+      _numericCounter++;
+    }
+
+    KSPSetUp (_ksp);
+
+    PetscTime (&t2);
+
+    if (_printInfo) {
+      std::cout << "   ********* Coarse direct solver " << ( (reuse) ? "NUMERIC" : "SYMBOLIC + NUMERIC")
+                << " FACTORIZATION TIME:\t" << static_cast<double> (t2 - t1)
+                << " (symbolic " << _symbolicCounter << ", numeric " << _numericCounter << ")" << std::endl;
+    }
+  }
+
+  // ================================================
+
+  void CoarseDirectSolverPetsc::SetShell (PC &subpc) {
+    PCSetType (subpc, PCSHELL);
+    PCShellSetContext (subpc, this);
+    PCShellSetApply (subpc, CoarseDirectSolverPetsc::Apply);
+    PCShellSetName (subpc, "CoarseDirectSolver");
+  }
+
+  // ================================================
+
+  PetscErrorCode CoarseDirectSolverPetsc::Apply (PC pc, Vec x, Vec y) {
+    void* ctx;
+    PetscErrorCode ierr = PCShellGetContext (pc, &ctx);
+    CHKERRQ (ierr);
+    CoarseDirectSolverPetsc* coarseSolver = static_cast<CoarseDirectSolverPetsc*> (ctx);
+    ierr = KSPSolve (coarseSolver->_ksp, x, y);
+    CHKERRQ (ierr);
+    return 0;
+  }
+
+} //end namespace femus
+
+#endif
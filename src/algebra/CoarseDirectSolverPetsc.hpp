@@ -0,0 +1,97 @@
+/*=========================================================================
+
+  Program: FEMUS
+  Module: CoarseDirectSolverPetsc
+  Authors: Eugenio Aulisa
+
+  Copyright (c) FEMTTU
+  All rights reserved.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE.  See the above copyright notice for more information.
+
+  =========================================================================*/
+
+#ifndef __femus_algebra_CoarseDirectSolverPetsc_hpp__
+#define __femus_algebra_CoarseDirectSolverPetsc_hpp__
+
+#include "FemusConfig.hpp"
+
+#ifdef HAVE_PETSC
+
+#ifdef HAVE_MPI
+#include <mpi.h>
+#endif
+
+//----------------------------------------------------------------------------
+// includes :
+//----------------------------------------------------------------------------
+#include "PrecondtypeEnum.hpp"
+#include "petscksp.h"
+
+namespace femus {
+
+  /**
+   * Exact solver for the coarsest multigrid level.
+   * It owns a copy of the coarse matrix and a preonly KSP with a sparse direct factorization, optionally redundant on
+   * sub-communicators (PCREDUNDANT). When the coarse matrix is recomputed with the same sparsity pattern, i.e. it is the same
+   * PETSc object with the same nonzero state (MatGetNonzeroState), the values are copied into the owned matrix,
+   * so PETSc keeps the symbolic factorization and redoes only the numeric one.
+   * The PCMG coarse solve is a PCSHELL that applies this solver.
+   */
+
+  class CoarseDirectSolverPetsc {
+
+    public:
+
+      CoarseDirectSolverPetsc (const PreconditionerType &factorizationType, const unsigned &redundantNumber);
+
+      ~CoarseDirectSolverPetsc();
+
+      /** Copy the values of KK and factorize, keeping the symbolic factorization if the pattern of KK is unchanged */
+      void SetUp (Mat KK);
+
+      /** Make subpc a shell preconditioner that applies this solver */
+      void SetShell (PC &subpc);
+
+      static PetscErrorCode Apply (PC pc, Vec x, Vec y);
+
+      void SetPrintInfo (const bool &printInfo) {
+        _printInfo = printInfo;
+      }
+
+      unsigned GetNumberOfSymbolicFactorizations() const {
+        return _symbolicCounter;
+      }
+
+      unsigned GetNumberOfNumericFactorizations() const {
+        return _numericCounter;
+      }
+
+    private:
+
+      /** True if KK is the matrix of the last symbolic factorization and no nonzero has been added to it since then */
+      bool SameNonzeroPattern (Mat KK) const;
+
+      void Clear();
+
+      KSP _ksp;
+      Mat _mat;
+      bool _isInitialized;
+
+      PetscObjectId _sourceId;
+      PetscObjectState _sourceNonzeroState;
+
+      PreconditionerType _factorizationType;
+      unsigned _redundantNumber;
+
+      unsigned _symbolicCounter;
+      unsigned _numericCounter;
+      bool _printInfo;
+  };
+
+} //end namespace femus
+
+#endif
+#endif
@@ -19,6 +19,9 @@
 #include "FieldSplitTree.hpp"
 #include "LinearEquationSolverPetscFieldSplit.hpp"
 #include "MeshASMPartitioning.hpp"
+#include "ElemType.hpp"
+#include "NumericVector.hpp"
+#include "Solution.hpp"
 
 namespace femus {
 
@@ -190,6 +193,10 @@ namespace femus {
     for (unsigned i = 0; i < _isSplitIndexPt.size(); i++) {
       delete [] _isSplitIndexPt[i];
     }
+
+    for (unsigned i = 0; i < _schurPreMass.size(); i++) {
+      if (_schurPreMass[i] != NULL) MatDestroy (&_schurPreMass[i]);
+    }
   }
 
   void FieldSplitTree::PrintFieldSplitTree (const unsigned& counter) {
@@ -278,7 +285,7 @@ namespace femus {
         }
       }
 
-      ISCreateGeneral (MPI_COMM_WORLD, size, isSplitIndex, PETSC_USE_POINTER, &_isSplit[level][i]);
+      ISCreateGeneral (solver->GetCommunicator(), size, isSplitIndex, PETSC_USE_POINTER, &_isSplit[level][i]);
 
       // on the child branches
 
@@ -318,11 +325,104 @@ namespace femus {
         }
       }
 
+      if (i == GetNumberOfSplits() - 1 && _schurPreMassScaling.size() > 0) {
+        BuildSchurPreLumpedMass (fieldsInSplitOffset, iproc, nprocs, level, solver);
+      }
+
       _child[i]->BuildIndexSet (fieldsInSplitOffset, iproc, nprocs, level, solver);
     }
 
   }
 
+
+  void FieldSplitTree::BuildSchurPreLumpedMass (const std::vector< std::vector < unsigned > >& splitOffset, const unsigned& iproc,
+                                                const unsigned& nprocs, const unsigned& level, const LinearEquationSolverPetscFieldSplit *solver) {
+
+    FieldSplitTree* schur = _child[GetNumberOfSplits() - 1];
+    unsigned nFields = schur->_fieldsAll.size();
+
+    if (_father != NULL || schur->_numberOfSplits != 1 || schur->_solutionType.size() != nFields || _schurPreMassScaling.size() != nFields) {
+      std::cout << "Error in FieldSplitTree::BuildSchurPreLumpedMass: the lumped mass is available on the root split only, and the last split "
+                << _name << " has to be a single split with one solution type and one scaling for each field" << std::endl;
+      abort();
+    }
+
+    // the fields of the last split have been renumbered in increasing order: k-th given field -> _fieldsSplit[0][k]
+    std::vector < unsigned > solType (nFields);
+    std::vector < double > scaling (nFields);
+    for (unsigned k = 0; k < nFields; k++) {
+      solType[schur->_fieldsSplit[0][k]] = schur->_solutionType[k];
+      scaling[schur->_fieldsSplit[0][k]] = _schurPreMassScaling[k];
+    }
+
+    Mesh* msh = solver->_msh;
+    unsigned dim = msh->GetDimension();
+
+    PetscInt localSize = splitOffset[nFields][iproc] - splitOffset[0][iproc];
+    PetscInt globalSize = splitOffset[nFields][nprocs - 1];
+
+    Vec mass;
+    VecCreateMPI (solver->GetCommunicator(), localSize, globalSize, &mass);
+    VecSet (mass, 0.);
+
+    std::vector < std::vector < double > > x (dim);
+    std::vector < double > phi;
+    std::vector < double > phi_x;
+    double weight;
+    std::vector < PetscInt > dofs;
+    std::vector < PetscScalar > lumped;
+
+    for (unsigned iel = msh->_elementOffset[iproc]; iel < msh->_elementOffset[iproc + 1]; iel++) {
+      short unsigned ielGeom = msh->GetElementType (iel);
+      unsigned nDofsX = msh->GetElementDofNumber (iel, 2);
+      for (unsigned d = 0; d < dim; d++) {
+        x[d].resize (nDofsX);
+      }
+      for (unsigned i = 0; i < nDofsX; i++) {
+        unsigned xDof = msh->GetSolutionDof (i, iel, 2);
+        for (unsigned d = 0; d < dim; d++) {
+          x[d][i] = (*msh->_topology->_Sol[d]) (xDof);
+        }
+      }
+
+      for (unsigned k = 0; k < nFields; k++) {
+        unsigned nDofs = msh->GetElementDofNumber (iel, solType[k]);
+        dofs.resize (nDofs);
+        lumped.assign (nDofs, 0.);
+        for (unsigned i = 0; i < nDofs; i++) {
+          dofs[i] = solver->GetSystemDof (solType[k], k, i, iel, splitOffset);
+        }
+        for (unsigned ig = 0; ig < msh->_finiteElement[ielGeom][solType[k]]->GetGaussPointNumber(); ig++) {
+          msh->_finiteElement[ielGeom][solType[k]]->Jacobian (x, ig, weight, phi, phi_x);
+          for (unsigned i = 0; i < nDofs; i++) {
+            lumped[i] += scaling[k] * phi[i] * weight;
+          }
+        }
+        VecSetValues (mass, nDofs, &dofs[0], &lumped[0], ADD_VALUES);
+      }
+    }
+    VecAssemblyBegin (mass);
+    VecAssemblyEnd (mass);
+
+    if (_schurPreMass.size() < level + 1) _schurPreMass.resize (level + 1, NULL);
+    if (_schurPreMass[level] != NULL) MatDestroy (&_schurPreMass[level]);
+
+    MatCreateAIJ (solver->GetCommunicator(), localSize, localSize, globalSize, globalSize, 1, NULL, 0, NULL, &_schurPreMass[level]);
+
+    PetscInt rowStart = splitOffset[0][iproc];
+    PetscScalar* massArray;
+    VecGetArray (mass, &massArray);
+    for (PetscInt i = 0; i < localSize; i++) {
+      PetscInt row = rowStart + i;
+      MatSetValues (_schurPreMass[level], 1, &row, 1, &row, &massArray[i], INSERT_VALUES);
+    }
+    VecRestoreArray (mass, &massArray);
+    MatAssemblyBegin (_schurPreMass[level], MAT_FINAL_ASSEMBLY);
+    MatAssemblyEnd (_schurPreMass[level], MAT_FINAL_ASSEMBLY);
+
+    VecDestroy (&mass);
+  }
+
   /*---------adjusted by Guoyi Ke-----------*/
   void FieldSplitTree::SetTolerances(const double& rtol, const double& abstol, const double& dtol, 
                                      const unsigned& maxits, const unsigned & restart) {
@@ -339,6 +439,10 @@ namespace femus {
   void FieldSplitTree::SetSchurPreType (const SchurPreType& schurPreType) {
     _schurPreType = schurPreType;
   }
+  void FieldSplitTree::SetSchurPreLumpedMass (const std::vector < double >& scaling) {
+    _schurPreMassScaling = scaling;
+    _schurPreType = SCHUR_PRE_USER;
+  }
   /*---------adjusted by Guoyi Ke-----------*/
   void FieldSplitTree::SetPC (KSP& ksp, const unsigned& level) {
 
@@ -367,7 +471,7 @@ namespace femus {
       PetscPreconditioner::set_petsc_preconditioner_type (_preconditioner, pc);
       if (_preconditioner == FIELDSPLIT_SCHUR_PRECOND) {
         SetSchurFactorizationType (pc);
-        SetSchurPreType (pc);
+        SetSchurPreType (pc, level);
       }
 
       for (unsigned i = 0; i < _numberOfSplits; i++) {
@@ -532,7 +636,7 @@ namespace femus {
     }
   }
 
-  void FieldSplitTree::SetSchurPreType (PC &pc) {
+  void FieldSplitTree::SetSchurPreType (PC &pc, const unsigned& level) {
 
     switch (_schurPreType) {
       case  SCHUR_PRE_SELF:
@@ -544,7 +648,7 @@ namespace femus {
         return;
 
       case SCHUR_PRE_USER:
-        PCFieldSplitSetSchurPre (pc, PC_FIELDSPLIT_SCHUR_PRE_USER, NULL);
+        PCFieldSplitSetSchurPre (pc, PC_FIELDSPLIT_SCHUR_PRE_USER, (level < _schurPreMass.size()) ? _schurPreMass[level] : NULL);
         return;
 
       case SCHUR_PRE_A11:
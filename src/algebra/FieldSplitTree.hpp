@@ -66,6 +66,11 @@ namespace femus {
       void SetSchurFactorizationType (const SchurFactType& schurFactType);
       void SetSchurPreType (const SchurPreType& schurPreType);
 
+      /** Precondition the Schur complement of the last split with its lumped mass matrix, scaling[k] multiplies the lumped mass of
+       * the k-th field of the last split, in the order given to its constructor. The last split has to be a single split built with
+       * the solution types, and this tree has to be the root one. It sets SCHUR_PRE_USER */
+      void SetSchurPreLumpedMass (const std::vector < double >& scaling);
+
       void SetRichardsonScaleFactor (const double & richardsonScaleFactor) {
         _richardsonScaleFactor = richardsonScaleFactor;
       }
@@ -102,7 +107,11 @@ namespace femus {
 
       //void SetPetscSolverType (KSP& ksp);
       void SetSchurFactorizationType (PC &pc);
-      void SetSchurPreType (PC &pc);
+      void SetSchurPreType (PC &pc, const unsigned& level);
+
+      /** Diagonal matrix of the scaled lumped mass of the last split, in the numbering splitOffset of the last split */
+      void BuildSchurPreLumpedMass (const std::vector< std::vector < unsigned > >& splitOffset, const unsigned& iproc,
+                                    const unsigned& nprocs, const unsigned& level, const LinearEquationSolverPetscFieldSplit *solver);
 
       SolverType _solver;
       PreconditionerType _preconditioner;
@@ -125,6 +134,9 @@ namespace femus {
       SchurFactType _schurFactType;
       SchurPreType _schurPreType;
 
+      std::vector < double > _schurPreMassScaling;
+      std::vector < Mat > _schurPreMass;
+
       std::vector < std::vector< std::vector < unsigned > > >_MatrixOffset;
 
 
@@ -0,0 +1,121 @@
+/*=========================================================================
+
+  Program: FEMUS
+  Module: KKTFieldSplitTree
+  Authors: Eugenio Aulisa
+
+  Copyright (c) FEMTTU
+  All rights reserved.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE. See the above copyright notice for more information.
+
+  =========================================================================*/
+
+#include "KKTFieldSplitTree.hpp"
+
+namespace femus {
+
+  KKTFieldSplitTree::KKTFieldSplitTree (const KKTPreconditionerType &type,
+                                        const std::vector < unsigned > &stateFields, const std::vector < unsigned > &stateSolutionType,
+                                        const std::vector < unsigned > &adjointFields, const std::vector < unsigned > &adjointSolutionType,
+                                        const std::vector < unsigned > &controlFields, const std::vector < unsigned > &controlSolutionType) {
+
+    if (stateFields.size() == 0 || adjointFields.size() == 0 || controlFields.size() == 0) {
+      std::cout << "Error in KKTFieldSplitTree: the state, adjoint and control blocks can not be empty" << std::endl;
+      abort();
+    }
+
+    _type = type;
+    _numberOfControlFields = controlFields.size();
+
+    std::vector < FieldSplitTree* > branch;
+
+    if (_type == KKT_SCHUR) {
+      _state = BuildApproximateSolve (stateFields, stateSolutionType, "State");
+      _adjoint = BuildApproximateSolve (adjointFields, adjointSolutionType, "Adjoint");
+
+      // the adjoint rows depend on the state through the tracking term, the state rows do not depend on the adjoint
+      std::vector < FieldSplitTree* > stateAdjointBranch (2);
+      stateAdjointBranch[0] = _state;
+      stateAdjointBranch[1] = _adjoint;
+      _stateAdjoint = AddNode (new FieldSplitTree (PREONLY, FIELDSPLIT_MULTIPLICATIVE_PRECOND, stateAdjointBranch, "StateAdjoint"));
+
+      // Jacobi on the diagonal lumped mass matrix is its exact inverse
+      _control = AddNode (new FieldSplitTree (PREONLY, JACOBI_PRECOND, controlFields, controlSolutionType, "Control"));
+
+      branch.resize (2);
+      branch[0] = _stateAdjoint;
+      branch[1] = _control;
+      _root = AddNode (new FieldSplitTree (PREONLY, FIELDSPLIT_SCHUR_PRECOND, branch, "KKT"));
+      _root->SetSchurFactorizationType (SCHUR_FACT_FULL);
+      _root->SetSchurPreLumpedMass (std::vector < double > (_numberOfControlFields, 1.));
+    }
+    else {
+      // state, adjoint and control: Vanka-ASM on the element blocks, the last field (the pressure) is the Schur variable
+      _state = AddNode (new FieldSplitTree (PREONLY, ASM_PRECOND, stateFields, stateSolutionType, "State"));
+      _state->SetAsmBlockSize (4);
+      _state->SetAsmNumeberOfSchurVariables ( (stateFields.size() > 1) ? 1 : 0);
+
+      _adjoint = AddNode (new FieldSplitTree (PREONLY, ASM_PRECOND, adjointFields, adjointSolutionType, "Adjoint"));
+      _adjoint->SetAsmBlockSize (4);
+      _adjoint->SetAsmNumeberOfSchurVariables ( (adjointFields.size() > 1) ? 1 : 0);
+
+      // the control block is a saddle point problem when the control has its own pressure (zero diagonal)
+      _control = AddNode (new FieldSplitTree (PREONLY, ASM_PRECOND, controlFields, controlSolutionType, "Control"));
+      _control->SetAsmBlockSize (4);
+      _control->SetAsmNumeberOfSchurVariables ( (controlFields.size() > 1) ? 1 : 0);
+
+      _stateAdjoint = NULL;
+
+      branch.resize (3);
+      branch[0] = _state;
+      branch[1] = _adjoint;
+      branch[2] = _control;
+      PreconditionerType preconditioner = (_type == KKT_BLOCK_DIAGONAL) ? FIELDSPLIT_ADDITIVE_PRECOND : FIELDSPLIT_MULTIPLICATIVE_PRECOND;
+      _root = AddNode (new FieldSplitTree (PREONLY, preconditioner, branch, "KKT"));
+    }
+  }
+
+  KKTFieldSplitTree::~KKTFieldSplitTree() {
+    for (unsigned i = 0; i < _node.size(); i++) {
+      delete _node[_node.size() - 1 - i];
+    }
+  }
+
+  void KKTFieldSplitTree::SetControlMassScaling (const std::vector < double > &scaling) {
+    if (_type != KKT_SCHUR) {
+      std::cout << "Error in KKTFieldSplitTree::SetControlMassScaling: the control mass is used only by KKT_SCHUR" << std::endl;
+      abort();
+    }
+    if (scaling.size() != _numberOfControlFields) {
+      std::cout << "Error in KKTFieldSplitTree::SetControlMassScaling: one scaling for each control field is needed" << std::endl;
+      abort();
+    }
+    _root->SetSchurPreLumpedMass (scaling);
+  }
+
+  FieldSplitTree* KKTFieldSplitTree::BuildApproximateSolve (const std::vector < unsigned > &fields, const std::vector < unsigned > &solutionType,
+                                                            const std::string &name) {
+
+    if (fields.size() == 1) {
+      return AddNode (new FieldSplitTree (PREONLY, GAMG_PRECOND, fields, solutionType, name));
+    }
+
+    std::vector < unsigned > velocityFields (fields.begin(), fields.end() - 1);
+    std::vector < unsigned > velocityType (solutionType.begin(), solutionType.end() - 1);
+    std::vector < unsigned > pressureField (1, fields.back());
+    std::vector < unsigned > pressureType (1, solutionType.back());
+
+    std::vector < FieldSplitTree* > branch (2);
+    branch[0] = AddNode (new FieldSplitTree (PREONLY, GAMG_PRECOND, velocityFields, velocityType, name + "Velocity"));
+    branch[1] = AddNode (new FieldSplitTree (PREONLY, JACOBI_PRECOND, pressureField, pressureType, name + "Pressure"));
+
+    FieldSplitTree* block = AddNode (new FieldSplitTree (PREONLY, FIELDSPLIT_SCHUR_PRECOND, branch, name));
+    block->SetSchurFactorizationType (SCHUR_FACT_FULL);
+    block->SetSchurPreType (SCHUR_PRE_SELFP);
+    return block;
+  }
+
+} //end namespace femus
@@ -0,0 +1,105 @@
+/*=========================================================================
+
+  Program: FEMUS
+  Module: KKTFieldSplitTree
+  Authors: Eugenio Aulisa
+
+  Copyright (c) FEMTTU
+  All rights reserved.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even
+  the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+  PURPOSE. See the above copyright notice for more information.
+
+  =========================================================================*/
+
+#ifndef __femus_algebra_KKTFieldSplitTree_hpp__
+#define __femus_algebra_KKTFieldSplitTree_hpp__
+
+#include <vector>
+#include <string>
+
+#include "FieldSplitTree.hpp"
+#include "KKTPreconditionerTypeEnum.hpp"
+
+namespace femus {
+
+  /**
+   * PCFieldSplit tree for the monolithic state/adjoint/control system of an optimal control problem.
+   * KKT_BLOCK_DIAGONAL and KKT_BLOCK_TRIANGULAR smooth the state, the adjoint and the control blocks with Vanka-ASM, the last field of
+   * each block (the pressure) being the Schur variable of the element blocks, and combine them additively or multiplicatively in the
+   * order state, adjoint, control. They are smoothers for the multigrid of the system.
+   * KKT_SCHUR is the block preconditioner of the KKT system: the state and the adjoint are eliminated, and
+   *  - the state/adjoint block is solved approximately, block Gauss-Seidel on state and adjoint, each one with an algebraic multigrid
+   *    V-cycle (GAMG) on the velocity and, if there is a pressure, the SELFP Schur complement on the pressure (the velocity diagonal is not zero);
+   *  - the control Schur complement is preconditioned with the inverse of the lumped control mass matrix, field by field scaled
+   *    with SetControlMassScaling (1 by default), e.g. the control cost for the control velocity and the inverse of the control
+   *    viscosity for the control pressure.
+   * The field indices are the system PDE indices (GetSolPdeIndex), the system uses FEMuS_FIELDSPLIT and SetFieldSplitTree(GetFieldSplitTree()).
+   */
+
+  class KKTFieldSplitTree {
+
+    public:
+
+      KKTFieldSplitTree (const KKTPreconditionerType &type,
+                         const std::vector < unsigned > &stateFields, const std::vector < unsigned > &stateSolutionType,
+                         const std::vector < unsigned > &adjointFields, const std::vector < unsigned > &adjointSolutionType,
+                         const std::vector < unsigned > &controlFields, const std::vector < unsigned > &controlSolutionType);
+
+      ~KKTFieldSplitTree();
+
+      /** The root of the tree, to be passed to LinearImplicitSystem::SetFieldSplitTree */
+      FieldSplitTree* GetFieldSplitTree() {
+        return _root;
+      }
+
+      FieldSplitTree* GetStateBlock() {
+        return _state;
+      }
+
+      FieldSplitTree* GetAdjointBlock() {
+        return _adjoint;
+      }
+
+      FieldSplitTree* GetControlBlock() {
+        return _control;
+      }
+
+      KKTPreconditionerType GetType() const {
+        return _type;
+      }
+
+      void PrintFieldSplitTree() {
+        _root->PrintFieldSplitTree();
+      }
+
+      /** KKT_SCHUR only: scaling of the lumped mass of each control field, in the order of controlFields */
+      void SetControlMassScaling (const std::vector < double > &scaling);
+
+    private:
+
+      /** Approximate solve of a state or adjoint block: GAMG on the velocity, SELFP Schur complement on the last field (the pressure) */
+      FieldSplitTree* BuildApproximateSolve (const std::vector < unsigned > &fields, const std::vector < unsigned > &solutionType, const std::string &name);
+
+      FieldSplitTree* AddNode (FieldSplitTree* node) {
+        _node.push_back (node);
+        return node;
+      }
+
+      KKTPreconditionerType _type;
+      unsigned _numberOfControlFields;
+
+      FieldSplitTree* _state;
+      FieldSplitTree* _adjoint;
+      FieldSplitTree* _control;
+      FieldSplitTree* _stateAdjoint;
+      FieldSplitTree* _root;
+
+      /** all the nodes of the tree, they are owned by this object */
+      std::vector < FieldSplitTree* > _node;
+  };
+
+} //end namespace femus
+
+#endif
@@ -38,7 +38,7 @@ namespace femus {
 
 //--------------------------------------------------------------------------------
 
-  LinearEquation::LinearEquation(Solution *other_solution) {
+  LinearEquation::LinearEquation(Solution *other_solution) : ParallelObject(other_solution->GetCommunicator()) {
     _solution = other_solution;
     _msh = _solution->GetMesh();
     _EPS = NULL;
@@ -48,6 +48,7 @@ namespace femus {
     _KK = NULL;
     _KKamr = NULL;
     _numberOfGlobalVariables = 0u;
+    _mgLevel = _msh->GetLevel();
   }
 
 //--------------------------------------------------------------------------------
@@ -201,6 +202,8 @@ namespace femus {
 
     _SparsityPattern = SparsityPattern_other;
 
+    _solution->AllocateResEps(_SolPdeIndex);
+
     //--- Matrix and vectors offsets - BEGIN ---------------------------------------------------------------------------------------------
     KKIndex.resize(_SolPdeIndex.size() + 1u);
     KKIndex[0] = 0;
@@ -262,7 +265,7 @@ namespace femus {
 
     //--- Error and residual: build and init - BEGIN --------------------------------------------------------------------------------------------
     int EPSsize = KKIndex[KKIndex.size() - 1];
-    _EPS = NumericVector::build().release();
+    _EPS = NumericVector::build(LSOLVER, _comm).release();
     if(n_processors() == 1) {  // IF SERIAL
       _EPS->init(EPSsize, EPSsize, false, SERIAL);
     }
@@ -271,13 +274,13 @@ namespace femus {
       _EPS->init(EPSsize, EPS_local_size, KKghost_nd[processor_id()], false, GHOSTED);
     }
 
-    _RES = NumericVector::build().release();
+    _RES = NumericVector::build(LSOLVER, _comm).release();
     _RES->init(*_EPS);
 
-    _EPSC = NumericVector::build().release();
+    _EPSC = NumericVector::build(LSOLVER, _comm).release();
     _EPSC->init(*_EPS);
 
-    _RESC = NumericVector::build().release();
+    _RESC = NumericVector::build(LSOLVER, _comm).release();
     _RESC->init(*_EPS);
     //--- Error and residual: build and init - END --------------------------------------------------------------------------------------------
 
@@ -323,12 +326,12 @@ namespace femus {
     
 
     //--- Matrix: build and init - BEGIN --------------------------------------------------------------------------------------------
-    _KK = SparseMatrix::build().release();
+    _KK = SparseMatrix::build(LSOLVER, _comm).release();
     _KK->init(KK_size, KK_size, KK_local_size, KK_local_size, d_nnz, o_nnz);
     //--- Matrix: build and init - END  --------------------------------------------------------------------------------------------
 
     //--- Matrix AMR: build --------------------------------------------------------------------------------------------
-    _KKamr = SparseMatrix::build().release();
+    _KKamr = SparseMatrix::build(LSOLVER, _comm).release();
     //--- Matrix AMR: build --------------------------------------------------------------------------------------------
 
   }
@@ -339,6 +342,24 @@ namespace femus {
 
   }
 
+//--------------------------------------------------------------------------------
+  void LinearEquation::GetDirichletDofs(std::vector < int > &dirichletDofs) const {
+
+    unsigned iproc = processor_id();
+    dirichletDofs.resize(0);
+
+    for(unsigned k = 0; k < _SolPdeIndex.size(); k++) {
+      unsigned indexSol = _SolPdeIndex[k];
+      unsigned soltype = _SolType[indexSol];
+
+      for(unsigned inode_mts = _msh->_dofOffset[soltype][iproc]; inode_mts < _msh->_dofOffset[soltype][iproc + 1]; inode_mts++) {
+        if((*(*_Bdc)[indexSol])(inode_mts) < 1.5) {
+          dirichletDofs.push_back(KKoffset[k][iproc] + inode_mts - _msh->_dofOffset[soltype][iproc]);
+        }
+      }
+    }
+  }
+
 //--------------------------------------------------------------------------------
   void LinearEquation::AddLevel() {
     _gridn++;
@@ -504,7 +525,7 @@ namespace femus {
       
     } //end el loop
 
-    NumericVector  *sizeDnBM_o = NumericVector::build().release();
+    NumericVector  *sizeDnBM_o = NumericVector::build(LSOLVER, _comm).release();
     sizeDnBM_o->init(*_EPS);
     sizeDnBM_o->zero();
     for(std::map < int, std::map <int, bool > >::iterator it = DnBlgToMe_o.begin(); it != DnBlgToMe_o.end(); ++it) {
@@ -513,7 +534,7 @@ namespace femus {
     sizeDnBM_o->close();
 
 
-    NumericVector  *sizeDnBM_d = NumericVector::build().release();
+    NumericVector  *sizeDnBM_d = NumericVector::build(LSOLVER, _comm).release();
     sizeDnBM_d->init(*_EPS);
     sizeDnBM_d->zero();
     for(std::map < int, std::map <int, bool > >::iterator it = DnBlgToMe_d.begin(); it != DnBlgToMe_d.end(); ++it) {
@@ -103,6 +103,18 @@ public:
   void SetNumberOfGlobalVariables(const unsigned &numberOfGlobalVariables){
     _numberOfGlobalVariables = numberOfGlobalVariables;
   }
+
+  /** Level in the multigrid hierarchy, it is the mesh level unless p-levels are added on the same mesh */
+  void SetMGLevel(const unsigned &mgLevel){
+    _mgLevel = mgLevel;
+  }
+
+  unsigned GetMGLevel() const {
+    return _mgLevel;
+  }
+
+  /** Owned system dofs with a Dirichlet boundary condition, sorted */
+  void GetDirichletDofs(std::vector < int > &dirichletDofs) const;
   
   
   /** Pointer to underlying mesh */
@@ -167,6 +179,8 @@ protected:
   
   unsigned _numberOfGlobalVariables;
 
+  unsigned _mgLevel;
+
 };
 
 } //end namespace femus
@@ -99,6 +99,11 @@ namespace femus {
       
       virtual void SetRichardsonScaleFactor(const double & richardsonScaleFactor) = 0; 
 
+      /** Solve the coarsest level with a sparse direct factorization that keeps its symbolic part while the pattern is unchanged */
+      virtual void SetCoarseDirectSolver(const PreconditionerType &factorizationType, const unsigned &redundantNumber) {
+        std::cout << "Warning SetCoarseDirectSolver(...) is not available for this smoother\n";
+      };
+
       /** Sets the type of solver to use. */
       void set_solver_type (const SolverType st)  {
         _levelSolverType = st;
@@ -137,10 +137,10 @@ namespace femus {
       PetscLogDouble t2;
       PetscTime (&t2);
 
-      PetscPrintf (PETSC_COMM_WORLD, "        *************** ML linear solver time: %e \n", t2 - t1);
-      PetscPrintf (PETSC_COMM_WORLD, "        *************** Number of outer ksp solver iterations = %i \n", its);
-      PetscPrintf (PETSC_COMM_WORLD, "        *************** Convergence reason = %i \n", reason);
-      PetscPrintf (PETSC_COMM_WORLD, "        *************** Residual norm = %10.8g \n", rnorm);
+      PetscPrintf (_comm, "        *************** ML linear solver time: %e \n", t2 - t1);
+      PetscPrintf (_comm, "        *************** Number of outer ksp solver iterations = %i \n", its);
+      PetscPrintf (_comm, "        *************** Convergence reason = %i \n", reason);
+      PetscPrintf (_comm, "        *************** Residual norm = %10.8g \n", rnorm);
     }
 
     //END PRINT
@@ -153,7 +153,7 @@ namespace femus {
     if (!this->initialized())    {
       this->_is_initialized = true;
 
-      KSPCreate (MPI_COMM_WORLD, &_ksp);
+      KSPCreate (_comm, &_ksp);
       KSPGetPC (_ksp, &_pc);
 
       this->SetSolver (_ksp, _levelSolverType);
@@ -182,7 +182,7 @@ namespace femus {
 
   void LinearEquationSolverPetsc::MGInit (const MgSmootherType& mg_smoother_type, const unsigned& levelMax, const SolverType & mgSolverType) {
 
-    KSPCreate (PETSC_COMM_WORLD, &_ksp);
+    KSPCreate (_comm, &_ksp);
 
     _mgSolverType = mgSolverType;
     double otherRCF = _richardsonScaleFactor;
@@ -219,7 +219,7 @@ namespace femus {
     const vector <unsigned>& variable_to_be_solved, SparseMatrix* PP, SparseMatrix* RR,
     const unsigned& npre, const unsigned& npost) {
 
-    unsigned level = _msh->GetLevel();
+    unsigned level = GetMGLevel();
 
     // ***************** NODE/ELEMENT SEARCH *******************
     if (_bdcIndexIsInitialized == 0) BuildBdcIndex (variable_to_be_solved);
@@ -245,7 +245,9 @@ namespace femus {
       _richardsonScaleFactor = 1.;
     }
     
-    this->SetSolver (subksp, _levelSolverType);
+    bool coarseDirect = (level == 0 && _coarseDirectSolver);
+
+    this->SetSolver (subksp, (coarseDirect) ? PREONLY : _levelSolverType);
     std::ostringstream levelName;
     levelName << "level-" << level;
     KSPSetOptionsPrefix (subksp, levelName.str().c_str());
@@ -262,7 +264,13 @@ namespace femus {
 
     PC subpc;
     KSPGetPC (subksp, &subpc);
-    SetPreconditioner (subksp, subpc);
+    if (coarseDirect) {
+      _coarseDirectSolver->SetUp (KK);
+      _coarseDirectSolver->SetShell (subpc);
+    }
+    else {
+      SetPreconditioner (subksp, subpc);
+    }
 
     if (level < levelMax) {
       PCMGSetX (pcMG, level, (static_cast< PetscVector* > (_EPS))->vec());
@@ -343,10 +351,10 @@ namespace femus {
       KSPGetResidualNorm (_ksp, &rnorm);
 
       PetscTime (&t2);
-      PetscPrintf (PETSC_COMM_WORLD, "       *************** MG linear solver time: %e \n", t2 - t1);
-      PetscPrintf (PETSC_COMM_WORLD, "       *************** Number of outer ksp solver iterations = %i \n", its);
-      PetscPrintf (PETSC_COMM_WORLD, "       *************** Convergence reason = %i \n", reason);
-      PetscPrintf (PETSC_COMM_WORLD, "       *************** Residual norm = %10.8g \n", rnorm);
+      PetscPrintf (_comm, "       *************** MG linear solver time: %e \n", t2 - t1);
+      PetscPrintf (_comm, "       *************** Number of outer ksp solver iterations = %i \n", its);
+      PetscPrintf (_comm, "       *************** Convergence reason = %i \n", reason);
+      PetscPrintf (_comm, "       *************** Residual norm = %10.8g \n", rnorm);
     }
   }
 
@@ -359,7 +367,7 @@ namespace femus {
       GetNullSpaceBase (nullspBase);
       if (nullspBase.size() != 0) {
         MatNullSpace   nullsp;
-        MatNullSpaceCreate (PETSC_COMM_WORLD, PETSC_FALSE, nullspBase.size(), &nullspBase[0], &nullsp);
+        MatNullSpaceCreate (_comm, PETSC_FALSE, nullspBase.size(), &nullspBase[0], &nullsp);
 
         PetscBool  isNull;
         MatNullSpaceTest (nullsp, (static_cast< PetscMatrix* > (_KK))->mat(), &isNull);
@@ -668,7 +676,7 @@ namespace femus {
 //
 // #else // 2.2.0 & newer style
       // Create the linear solver context
-      ierr = KSPCreate (MPI_COMM_WORLD, &_ksp);
+      ierr = KSPCreate (_comm, &_ksp);
       CHKERRABORT (MPI_COMM_WORLD, ierr);
       //ierr = PCCreate (MPI_COMM_WORLD, &_pc); CHKERRABORT(MPI_COMM_WORLD,ierr);
       // Create the preconditioner context
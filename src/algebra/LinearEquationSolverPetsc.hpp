@@ -28,6 +28,7 @@
 // includes :
 //----------------------------------------------------------------------------
 #include "LinearEquationSolver.hpp"
+#include "CoarseDirectSolverPetsc.hpp"
 
 namespace femus {
 
@@ -76,6 +77,11 @@ namespace femus {
         _richardsonScaleFactor = richardsonScaleFactor;
       }
 
+      void SetCoarseDirectSolver (const PreconditionerType &factorizationType, const unsigned &redundantNumber) {
+        delete _coarseDirectSolver;
+        _coarseDirectSolver = new CoarseDirectSolverPetsc (factorizationType, redundantNumber);
+      }
+
       virtual void BuildBdcIndex (const vector <unsigned> &variable_to_be_solved);
       virtual void SetPreconditioner (KSP& subksp, PC& subpc);
 
@@ -119,6 +125,9 @@ namespace femus {
 
       double _richardsonScaleFactor;
 
+      /** Exact coarse level solver, NULL if the coarse level uses the KSP smoother settings */
+      CoarseDirectSolverPetsc *_coarseDirectSolver;
+
   };
 
   // =============================================
@@ -146,12 +155,15 @@ namespace femus {
 
     _printSolverInfo = false;
 
+    _coarseDirectSolver = NULL;
+
   }
 
   // =============================================
 
   inline LinearEquationSolverPetsc::~LinearEquationSolverPetsc() {
     this->Clear();
+    delete _coarseDirectSolver;
   }
 
   // ================================================
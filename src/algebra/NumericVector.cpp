@@ -32,19 +32,21 @@ namespace femus
 //------------------------------------------------------------------
 // NumericVector methods
   std::unique_ptr<NumericVector >
-  NumericVector::build(const SolverPackage solver_package)
+  NumericVector::build(const SolverPackage solver_package, const MPI_Comm &comm)
   {
     // Build the appropriate vector
     switch(solver_package) {
 #ifdef HAVE_PETSC
       case PETSC_SOLVERS: {
           std::unique_ptr<NumericVector > ap(new PetscVector);
+          ap->SetCommunicator(comm);
           return ap;
         }
 #endif
 #ifdef LIBMESH_HAVE_TRILINOS
       case TRILINOS_SOLVERS: {
           std::unique_ptr<NumericVector > ap(new EpetraVector<double>);
+          ap->SetCommunicator(comm);
           return ap;
         }
 #endif
@@ -135,6 +137,21 @@ namespace femus
     return norm;
   }
 
+// --------------------------------------------------------
+  void NumericVector::localize_to_all(SharedMemoryBuffer<double>& v_local) const
+  {
+    if(static_cast < int >(v_local.size()) != size()) {
+      std::cout << "Error in NumericVector::localize_to_all: the buffer size " << v_local.size()
+                << " differs from the vector size " << size() << std::endl;
+      abort();
+    }
+
+    // only the process 0 holds the whole vector, the buffer replicates it once per node when shared
+    std::vector < double > v;
+    localize_to_one(v, 0);
+    v_local.Broadcast((v.size() > 0) ? &v[0] : NULL, 0);
+  }
+
 } //end namespace femus
 
 
@@ -22,6 +22,9 @@
 #include "SolverPackageEnum.hpp"
 #include "ParalleltypeEnum.hpp"
 #include "FemusConfig.hpp"
+#include "SharedMemoryBuffer.hpp"
+
+#include <mpi.h>
 
 // C++ includes
 #include <vector>
@@ -74,9 +77,18 @@ public:
                   const ParallelType = AUTOMATIC);
 
   /** Builds a \p NumericVector using the linear solver package */
-  /** specified by \p solver_package */
+  /** specified by \p solver_package, distributed on the communicator \p comm */
   static std::unique_ptr<NumericVector>
-  build(const SolverPackage solver_package = LSOLVER);
+  build(const SolverPackage solver_package = LSOLVER, const MPI_Comm &comm = MPI_COMM_WORLD);
+
+  /** Communicator of the parallel layout, it has to be set before init */
+  void SetCommunicator(const MPI_Comm &comm) {
+    _comm = comm;
+  }
+
+  const MPI_Comm &GetCommunicator() const {
+    return _comm;
+  }
   
   /** Creates a copy of this vector and returns it in an \p AutoPtr. */
   virtual std::unique_ptr<NumericVector > clone () const = 0;
@@ -95,6 +107,13 @@ public:
   /** Call the assemble functions */
   virtual void close () = 0;
   virtual void closeWithMinValues () = 0;
+
+  /** Split close: closeBegin assembles the owned values and starts the update of the ghost values,
+   * closeEnd completes it. Only the owned values can be read in between */
+  virtual void closeBegin () {
+    close ();
+  }
+  virtual void closeEnd () {}
   
   /**
    * Change the dimension of the vector to \p N. The reserved memory for
@@ -321,6 +340,8 @@ public:
                                 const  int proc_id=0) const = 0;
   /// Creates a local copy of the global vector
   virtual void localize_to_all (std::vector<double>& v_local) const = 0;
+  /// Same, but fills a replicated read-only buffer of length size(), on the communicator of \p this
+  void localize_to_all (SharedMemoryBuffer<double>& v_local) const;
   /// @returns \p -1 when \p this is equivalent to \p other_vector,
   virtual int compare (const NumericVector &other_vector,
                        const double threshold = 1.e-20) const;
@@ -364,6 +385,9 @@ protected:
   /** Type of vector */
   ParallelType _type;
 
+  /** Communicator of the vector, MPI_COMM_WORLD by default */
+  MPI_Comm _comm;
+
 };
 
 /**
@@ -372,12 +396,12 @@ protected:
 
 
 inline NumericVector::NumericVector (const ParallelType type) :
-  _is_closed(false),  _is_initialized(false),  _type(type) {}
+  _is_closed(false),  _is_initialized(false),  _type(type),  _comm(MPI_COMM_WORLD) {}
   
 
 inline NumericVector::NumericVector (const  int /*n*/,
                                        const ParallelType type) :
-  _is_closed(false),_is_initialized(false), _type(type) {
+  _is_closed(false),_is_initialized(false), _type(type), _comm(MPI_COMM_WORLD) {
   std::cout<< "Abstract base class! ";
   exit(0); // Abstract base class!
 }
@@ -385,7 +409,7 @@ inline NumericVector::NumericVector (const  int /*n*/,
 
 inline NumericVector::NumericVector (const int /*n*/,const int /*n_local*/,
                                        const ParallelType type) :
-  _is_closed(false),  _is_initialized(false),  _type(type) {
+  _is_closed(false),  _is_initialized(false),  _type(type),  _comm(MPI_COMM_WORLD) {
   std::cout<< "Abstract base class! ";
   exit(0); // Abstract base class!
 }
@@ -394,7 +418,7 @@ inline NumericVector::NumericVector (const int /*n*/,const int /*n_local*/,
 inline NumericVector::NumericVector (const int /*n*/,const int /*n_local*/,
                                        const std::vector<int>& /*ghost*/,
                                        const ParallelType type) :
-  _is_closed(false),  _is_initialized(false),  _type(type) {
+  _is_closed(false),  _is_initialized(false),  _type(type),  _comm(MPI_COMM_WORLD) {
   std::cout<< "Abstract base class! ";
   exit(0); // Abstract base class!
 }
@@ -412,6 +436,7 @@ inline void  NumericVector::swap (NumericVector &v) {
   std::swap(_is_closed, v._is_closed);
   std::swap(_is_initialized, v._is_initialized);
   std::swap(_type, v._type);
+  std::swap(_comm, v._comm);
 }
 
 
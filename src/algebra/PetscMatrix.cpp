@@ -61,9 +61,9 @@ namespace femus {
 
     // processor info
     int proc_id;
-    MPI_Comm_rank (MPI_COMM_WORLD, &proc_id);
+    MPI_Comm_rank (_comm, &proc_id);
     int numprocs;
-    MPI_Comm_size (MPI_COMM_WORLD, &numprocs);
+    MPI_Comm_size (_comm, &numprocs);
     int ierr     = 0;
     int m_global = static_cast<int> (m);
     int n_global = static_cast<int> (n);
@@ -77,7 +77,7 @@ namespace femus {
       assert ( (m_l == m) && (n_l == n));
 
       // Create matrix.  Revisit later to do preallocation and make more efficient
-      ierr = MatCreateSeqAIJ (MPI_COMM_WORLD, m_global, n_global,
+      ierr = MatCreateSeqAIJ (_comm, m_global, n_global,
                               n_nz, PETSC_NULL, &_mat);
       CHKERRABORT (MPI_COMM_WORLD, ierr);
       ierr = MatSetFromOptions (_mat);
@@ -87,7 +87,7 @@ namespace femus {
     else {
       parallel_only();
 
-      ierr = MatCreate (MPI_COMM_WORLD, &_mat);
+      ierr = MatCreate (_comm, &_mat);
       CHKERRABORT (MPI_COMM_WORLD, ierr);
 
       ierr = MatSetSizes (_mat, m_l, n_l, m, n);
@@ -115,7 +115,7 @@ namespace femus {
     }
 
     int numprocs;
-    MPI_Comm_size (MPI_COMM_WORLD, &numprocs);
+    MPI_Comm_size (_comm, &numprocs);
 
     std::cout << "matrix block structure:";
     std::vector < Mat > KK (dim);
@@ -134,7 +134,7 @@ namespace femus {
 
     if (dim != 1) {
       Mat nMat;
-      MatCreateNest (MPI_COMM_WORLD, nr, NULL, nc, NULL, &KK[0], &nMat);
+      MatCreateNest (_comm, nr, NULL, nc, NULL, &KK[0], &nMat);
 
       if (numprocs == 1) {
         MatConvert (nMat, MATSEQAIJ, MAT_INITIAL_MATRIX, &_mat);
@@ -177,14 +177,14 @@ namespace femus {
 
     // processor info
     int n_procs;
-    MPI_Comm_size (MPI_COMM_WORLD, &n_procs);
+    MPI_Comm_size (_comm, &n_procs);
 
     int ierr = 0;
 
 // create a sequential matrix on one processor
     if (n_procs == 1) {
       assert (n_nz.size() == _m_l);
-      ierr = MatCreateSeqAIJ (MPI_COMM_WORLD, _m, _n, 0, &n_nz[0], &_mat);
+      ierr = MatCreateSeqAIJ (_comm, _m, _n, 0, &n_nz[0], &_mat);
       CHKERRABORT (MPI_COMM_WORLD, ierr);
       ierr = MatSetFromOptions (_mat);
       CHKERRABORT (MPI_COMM_WORLD, ierr);
@@ -192,7 +192,7 @@ namespace femus {
     else {
       parallel_only();
       assert ( (n_nz.size() == _m_l) && (n_oz.size() == _m_l));
-      ierr = MatCreate (MPI_COMM_WORLD, &_mat);
+      ierr = MatCreate (_comm, &_mat);
       CHKERRABORT (MPI_COMM_WORLD, ierr);
       ierr = MatSetSizes (_mat, _m_l, _n_l, _m, _n);
       CHKERRABORT (MPI_COMM_WORLD, ierr);
@@ -220,19 +220,19 @@ namespace femus {
 
     // processor info
     int proc_id;
-    MPI_Comm_rank (MPI_COMM_WORLD, &proc_id);
+    MPI_Comm_rank (_comm, &proc_id);
     int numprocs;
-    MPI_Comm_size (MPI_COMM_WORLD, &numprocs);
+    MPI_Comm_size (_comm, &numprocs);
     int ierr     = 0;
 
     // create a sequential matrix on one processor -------------------
     if (numprocs == 1)    {
       assert ( (m_local == m_global) && (n_local == n_global));
       if (n_nz.empty())
-        ierr = MatCreateSeqAIJ (MPI_COMM_WORLD, m_global, n_global,
+        ierr = MatCreateSeqAIJ (_comm, m_global, n_global,
                                 PETSC_DEFAULT, (int*) PETSC_NULL, &_mat);
       else
-        ierr = MatCreateSeqAIJ (MPI_COMM_WORLD, m_global, n_global,
+        ierr = MatCreateSeqAIJ (_comm, m_global, n_global,
                                 PETSC_DEFAULT, (int*) &n_nz[0], &_mat);
       CHKERRABORT (MPI_COMM_WORLD, ierr);
 
@@ -252,7 +252,7 @@ namespace femus {
 //                              &_mat
 //                             );
 
-        ierr = MatCreate (MPI_COMM_WORLD, &_mat);
+        ierr = MatCreate (_comm, &_mat);
         CHKERRABORT (MPI_COMM_WORLD, ierr);
 
         ierr = MatSetSizes (_mat, m_local, n_local, m_global, n_global);
@@ -277,7 +277,7 @@ namespace femus {
 //                              &_mat
 //                             );
 
-        ierr = MatCreate (MPI_COMM_WORLD, &_mat);
+        ierr = MatCreate (_comm, &_mat);
         CHKERRABORT (MPI_COMM_WORLD, ierr);
 
         ierr = MatSetSizes (_mat, m_local, n_local, m_global, n_global);
@@ -327,7 +327,7 @@ namespace femus {
     if (this->initialized())    this->clear();
     this->_is_initialized = true;
     int proc_id = 0;
-    MPI_Comm_rank (MPI_COMM_WORLD, &proc_id);
+    MPI_Comm_rank (_comm, &proc_id);
 
     const unsigned int m   = sparsity_pattern._m;  //this->_dof_map->n_dofs();
     const unsigned int n   = sparsity_pattern._n;
@@ -368,18 +368,18 @@ namespace femus {
     int n_local  = static_cast<int> (n_l);
 
     int numprocs;
-    MPI_Comm_size (MPI_COMM_WORLD, &numprocs);
+    MPI_Comm_size (_comm, &numprocs);
 
     if (numprocs == 1)    {
       assert ( (m_l == m) && (n_l == n));
       if (n_nz.empty())
 //         ierr = MatCreateSeqAIJ(MPI_COMM_WORLD, m_global, n_global, //TODO eugenio
 //                                PETSC_NULL, (int*) PETSC_NULL, &_mat);
-        ierr = MatCreateSeqAIJ (MPI_COMM_WORLD, m_global, n_global, PETSC_DEFAULT, PETSC_NULL, &_mat); //TODO eugenio
+        ierr = MatCreateSeqAIJ (_comm, m_global, n_global, PETSC_DEFAULT, PETSC_NULL, &_mat); //TODO eugenio
       else
 //         ierr = MatCreateSeqAIJ(MPI_COMM_WORLD, m_global, n_global, //TODO eugenio
 //                                PETSC_NULL, (int*) &n_nz[0], &_mat);
-        ierr = MatCreateSeqAIJ (MPI_COMM_WORLD, m_global, n_global, PETSC_DEFAULT, &n_nz[0], &_mat); //TODO eugenio
+        ierr = MatCreateSeqAIJ (_comm, m_global, n_global, PETSC_DEFAULT, &n_nz[0], &_mat); //TODO eugenio
       CHKERRABORT (MPI_COMM_WORLD, ierr);
 
       ierr = MatSetFromOptions (_mat);
@@ -394,7 +394,7 @@ namespace femus {
 //                             PETSC_NULL, (int*) PETSC_NULL,
 //                             PETSC_NULL, (int*) PETSC_NULL, &_mat);
 
-        ierr = MatCreateAIJ (MPI_COMM_WORLD, //TODO eugenio
+        ierr = MatCreateAIJ (_comm, //TODO eugenio
                              m_local, n_local,
                              m_global, n_global,
                              PETSC_DEFAULT, PETSC_NULL,
@@ -406,7 +406,7 @@ namespace femus {
 //                             PETSC_NULL, (int*) &n_nz[0],
 //                             PETSC_NULL, (int*) &n_oz[0], &_mat);
 
-        ierr = MatCreateAIJ (MPI_COMM_WORLD, //TODO eugenio
+        ierr = MatCreateAIJ (_comm, //TODO eugenio
                              m_local, n_local,
                              m_global, n_global,
                              PETSC_DEFAULT, &n_nz[0],
@@ -510,7 +510,7 @@ namespace femus {
 
     PetscErrorCode ierr = 0;
     PetscViewer petsc_viewer;
-    ierr = PetscViewerCreate (MPI_COMM_WORLD,
+    ierr = PetscViewerCreate (_comm,
                               &petsc_viewer);
     CHKERRABORT (MPI_COMM_WORLD, ierr);
 
@@ -522,7 +522,7 @@ namespace femus {
 
       if (format == "binary") {
 
-        ierr = PetscViewerBinaryOpen (MPI_COMM_WORLD,
+        ierr = PetscViewerBinaryOpen (_comm,
                                       name.c_str(),
                                       FILE_MODE_WRITE,
                                       &petsc_viewer);
@@ -532,7 +532,7 @@ namespace femus {
         CHKERRABORT (MPI_COMM_WORLD, ierr);
       }
       else if (format == "ascii") {
-        ierr = PetscViewerASCIIOpen (MPI_COMM_WORLD,
+        ierr = PetscViewerASCIIOpen (_comm,
                                      name.c_str(),
                                      &petsc_viewer);
         CHKERRABORT (MPI_COMM_WORLD, ierr);
@@ -746,6 +746,7 @@ namespace femus {
     }
     else {
       this->clear();
+      this->_comm = A->_comm;
       ierr = MatPtAP (const_cast<PetscMatrix*> (A)->mat(), const_cast<PetscMatrix*> (P)->mat(), MAT_INITIAL_MATRIX , 1.0, &_mat);
       this->_is_initialized = true;
     }
@@ -802,15 +803,15 @@ namespace femus {
 
     MatDestroy (&_mat);
 
-    MatCreate (MPI_COMM_WORLD, &_mat);
+    MatCreate (_comm, &_mat);
     MatSetSizes (_mat, _m_l, _n_l, _m, _n);
 
     int n_procs;
-    MPI_Comm_size (MPI_COMM_WORLD, &n_procs);
+    MPI_Comm_size (_comm, &n_procs);
 
     // create a sequential matrix on one processor
     if (n_procs == 1) {
-      MatCreateSeqAIJ (MPI_COMM_WORLD, _m, _n, 0, &sizeDiag[0], &_mat);
+      MatCreateSeqAIJ (_comm, _m, _n, 0, &sizeDiag[0], &_mat);
       MatSetFromOptions (_mat);
     }
     else {
@@ -850,6 +851,7 @@ namespace femus {
     }
     else {
       this->clear();
+      this->_comm = A->_comm;
       ierr = MatMatMatMult (const_cast<PetscMatrix*> (A)->mat(), const_cast<PetscMatrix*> (B)->mat(),
                             const_cast<PetscMatrix*> (C)->mat(), MAT_INITIAL_MATRIX, 1.0, &_mat);
       this->_is_initialized = true;
@@ -970,14 +972,15 @@ namespace femus {
     // If we're not reusing submatrix and submatrix is already initialized
     // then we need to clear it, otherwise we get a memory leak.
     if (!reuse_submatrix && submatrix.initialized())  submatrix.clear();
+    petsc_submatrix->_comm = _comm;
     // Construct row and column index sets.
     int ierr = 0;
     IS isrow, iscol;
 
-    ierr = ISCreateGeneral (MPI_COMM_WORLD, rows.size(), (int*) &rows[0], PETSC_COPY_VALUES, &isrow); // PETSC_COPY_VALUES is my first choice; see also PETSC_OWN_POINTER, PETSC_USE_POINTER
+    ierr = ISCreateGeneral (_comm, rows.size(), (int*) &rows[0], PETSC_COPY_VALUES, &isrow); // PETSC_COPY_VALUES is my first choice; see also PETSC_OWN_POINTER, PETSC_USE_POINTER
     CHKERRABORT (MPI_COMM_WORLD, ierr);
 
-    ierr = ISCreateGeneral (MPI_COMM_WORLD, cols.size(), (int*) &cols[0], PETSC_COPY_VALUES, &iscol);
+    ierr = ISCreateGeneral (_comm, cols.size(), (int*) &cols[0], PETSC_COPY_VALUES, &iscol);
     CHKERRABORT (MPI_COMM_WORLD, ierr);
 
 //---
@@ -225,6 +225,7 @@ namespace femus {
   inline PetscMatrix::PetscMatrix (Mat m) : _destroy_mat_on_exit (false) {
     this->_mat = m;
     this->_is_initialized = true;
+    PetscObjectGetComm ( (PetscObject) m, &this->_comm);
   }
 
 // ===============================================
@@ -50,8 +50,8 @@ namespace femus {
     }
     //Clear the preconditioner in case it has been created in the past
     if(!this->_is_initialized)  {
-      //Create the preconditioning object
-      PCCreate(MPI_COMM_WORLD, &_pc);
+      //Create the preconditioning object on the communicator of the matrix
+      PCCreate(this->_matrix->GetCommunicator(), &_pc);
       //Set the PCType
       set_petsc_preconditioner_type(this->_preconditioner_type, _pc);
 // #ifdef LIBMESH_HAVE_PETSC_HYPRE
@@ -90,8 +90,10 @@ namespace femus {
 
       case ILU_PRECOND:
       {
+        MPI_Comm comm;
+        PetscObjectGetComm((PetscObject) pc, &comm);
         int nprocs;
-        MPI_Comm_size(MPI_COMM_WORLD, &nprocs); //TODO
+        MPI_Comm_size(comm, &nprocs);
         // In serial, just set the ILU preconditioner type
         if(nprocs == 1)
         {
@@ -114,8 +116,10 @@ namespace femus {
         break;
       }
       case LU_PRECOND: {
+        MPI_Comm comm;
+        PetscObjectGetComm((PetscObject) pc, &comm);
         int nprocs;
-        MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+        MPI_Comm_size(comm, &nprocs);
         if(nprocs == 1) {
           ierr = PCSetType(pc, (char*) PCLU);
           CHKERRABORT(MPI_COMM_WORLD, ierr);
@@ -236,6 +240,11 @@ namespace femus {
         CHKERRABORT(MPI_COMM_WORLD, ierr);
         break;
 
+      case GAMG_PRECOND:
+        ierr = PCSetType(pc, (char*) PCGAMG);
+        CHKERRABORT(MPI_COMM_WORLD, ierr);
+        break;
+
       case LSC_PRECOND:
         ierr = PCSetType(pc, (char*) PCLSC);
         CHKERRABORT(MPI_COMM_WORLD, ierr);
@@ -537,7 +537,7 @@ void PetscVector::localize(
 //   Utility::iota (idx.begin(), idx.end(), 0);
 
   // Create the index set & scatter object
-  ierr = ISCreateGeneral(MPI_COMM_WORLD, n, &idx[0], PETSC_USE_POINTER, &is);
+  ierr = ISCreateGeneral(_comm, n, &idx[0], PETSC_USE_POINTER, &is);
   CHKERRABORT(MPI_COMM_WORLD,ierr);
 
   ierr = VecScatterCreate(_vec,   is,v_local->_vec, is,&scatter);
@@ -594,9 +594,9 @@ void PetscVector::localize(
   for (int i = 0; i != this->local_size(); ++i)   idx[n_sl+i] = i + this->first_local_index();
 
   // Create the index set & scatter object
-  if (idx.empty())  ierr = ISCreateGeneral(MPI_COMM_WORLD,n_sl+this->local_size(),
+  if (idx.empty())  ierr = ISCreateGeneral(_comm,n_sl+this->local_size(),
                              PETSC_NULL, PETSC_USE_POINTER, &is);
-  else  ierr = ISCreateGeneral(MPI_COMM_WORLD,n_sl+this->local_size(),
+  else  ierr = ISCreateGeneral(_comm,n_sl+this->local_size(),
                                  &idx[0],  PETSC_USE_POINTER,&is);
   CHKERRABORT(MPI_COMM_WORLD,ierr);
   ierr = VecScatterCreate(_vec,is,v_local->_vec, is,&scatter);
@@ -637,10 +637,11 @@ void PetscVector::localize(
   int npi=1;
 
   // But we do need to stay in sync for degenerate cases
-  MPI_Comm_size(MPI_COMM_WORLD, &npi);
+  MPI_Comm_size(_comm, &npi);
   if (npi == 1)    return;
   // Build a parallel vector, initialize it with the local parts of (*this)
   PetscVector parallel_vec;
+  parallel_vec.SetCommunicator(_comm);
   parallel_vec.init(size, local_size, true, PARALLEL);
 
   {
@@ -651,7 +652,7 @@ void PetscVector::localize(
     std::iota(idx.begin(), idx.end(), first_local_idx);
 
     // Create the index set & scatter object
-    ierr = ISCreateGeneral(MPI_COMM_WORLD, local_size,
+    ierr = ISCreateGeneral(_comm, local_size,
                            local_size ? &idx[0] : NULL, PETSC_USE_POINTER, &is);
     CHKERRABORT(MPI_COMM_WORLD,ierr);
     ierr = VecScatterCreate(_vec,is, parallel_vec._vec, is, &scatter);
@@ -736,7 +737,7 @@ void PetscVector::localize_to_one(
       ierr = VecRestoreArray(_vec, &values);
       CHKERRABORT(MPI_COMM_WORLD,ierr);
     }
-    ierr = MPI_Reduce(&local_values[0], &v_local[0],n,MPI_DOUBLE,MPI_SUM,pid,MPI_COMM_WORLD);
+    ierr = MPI_Reduce(&local_values[0], &v_local[0],n,MPI_DOUBLE,MPI_SUM,pid,_comm);
   }
 }
 
@@ -771,9 +772,9 @@ void PetscVector::localize_to_all(
       CHKERRABORT(MPI_COMM_WORLD,ierr);
     }
     int nprocs;
-    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+    MPI_Comm_size(_comm, &nprocs);
     for(int iproc=0;iproc<nprocs;iproc++){
-      ierr = MPI_Reduce(&local_values[0], &v_local[0],n,MPI_DOUBLE,MPI_SUM,iproc,MPI_COMM_WORLD);
+      ierr = MPI_Reduce(&local_values[0], &v_local[0],n,MPI_DOUBLE,MPI_SUM,iproc,_comm);
     }
   }
 }
@@ -845,7 +846,8 @@ void PetscVector::create_subvector(
     // entries) is not currently offered by the PetscVector
     // class.  Should we differentiate here between sequential and
     // parallel vector creation based on libMesh::n_processors() ?
-    ierr = VecCreateMPI(MPI_COMM_WORLD,
+    petsc_subvector->_comm = _comm;
+    ierr = VecCreateMPI(_comm,
                         PETSC_DECIDE,          // n_local
                         rows.size(),           // n_global
                         &(petsc_subvector->_vec));
@@ -865,10 +867,10 @@ void PetscVector::create_subvector(
 //   Utility::iota (idx.begin(), idx.end(), 0);
 
   // Construct index sets
-  ierr = ISCreateGeneral(MPI_COMM_WORLD,rows.size(),(int*) &rows[0],
+  ierr = ISCreateGeneral(_comm,rows.size(),(int*) &rows[0],
                          PETSC_USE_POINTER,&parent_is);
   CHKERRABORT(MPI_COMM_WORLD,ierr);
-  ierr = ISCreateGeneral(MPI_COMM_WORLD,rows.size(),(int*) &idx[0],
+  ierr = ISCreateGeneral(_comm,rows.size(),(int*) &idx[0],
                          PETSC_USE_POINTER,&subvector_is);
   CHKERRABORT(MPI_COMM_WORLD,ierr);
   // Construct the scatter object
@@ -895,7 +897,7 @@ void PetscVector::create_subvector(
   void PetscVector::BinaryPrint(const char* fileName){
     
     PetscViewer binv;
-    PetscViewerBinaryOpen(MPI_COMM_WORLD,fileName, FILE_MODE_WRITE, &binv);
+    PetscViewerBinaryOpen(_comm,fileName, FILE_MODE_WRITE, &binv);
     VecView(_vec, binv);
     PetscViewerDestroy(&binv);
    
@@ -905,7 +907,7 @@ void PetscVector::create_subvector(
   void PetscVector::BinaryLoad(const char* fileName){
     
     PetscViewer binv;
-    PetscViewerBinaryOpen(MPI_COMM_WORLD,fileName, FILE_MODE_READ, &binv);
+    PetscViewerBinaryOpen(_comm,fileName, FILE_MODE_READ, &binv);
     VecLoad(_vec, binv);
     PetscViewerDestroy(&binv);
     this->close();
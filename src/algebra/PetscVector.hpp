@@ -90,6 +90,8 @@ namespace femus {
       /// Call the assemble functions
       void close ();
       void closeWithMinValues ();
+      void closeBegin ();
+      void closeEnd ();
       /// This function returns the \p PetscVector to a pristine state.
       void clear ();
 
@@ -267,6 +269,7 @@ namespace femus {
                             const int proc_id = 0) const;
 
       void localize_to_all (std::vector<double>& v_local) const;
+      using NumericVector::localize_to_all;
 
       /// Creates a "subvector" from this vector using the rows indices of the "rows" array.
       void create_subvector (NumericVector& subvector,
@@ -313,6 +316,9 @@ namespace femus {
       /// for the constructor which takes a PETSc Vec object.
       bool _destroy_vec_on_exit;
 
+      /// true between closeBegin and closeEnd of a ghosted vector
+      bool _ghostUpdatePending;
+
 #ifndef NDEBUG
       ///Size of the local form, for being used in assertations.  doublehe
       /// contents of this field are only valid if the vector is ghosted
@@ -332,7 +338,8 @@ namespace femus {
       _local_form (NULL),
       _values (NULL),
       _global_to_local_map(),
-      _destroy_vec_on_exit (true) {
+      _destroy_vec_on_exit (true),
+      _ghostUpdatePending (false) {
     this->_type = type;
   }
 
@@ -341,7 +348,8 @@ namespace femus {
       _local_form (NULL),
       _values (NULL),
       _global_to_local_map(),
-      _destroy_vec_on_exit (true) {
+      _destroy_vec_on_exit (true),
+      _ghostUpdatePending (false) {
     this->init (n, n, false, type);
   }
 
@@ -352,7 +360,8 @@ namespace femus {
       _local_form (NULL),
       _values (NULL),
       _global_to_local_map(),
-      _destroy_vec_on_exit (true) {
+      _destroy_vec_on_exit (true),
+      _ghostUpdatePending (false) {
     this->init (n, n_local, false, type);
   }
 
@@ -364,7 +373,8 @@ namespace femus {
       _local_form (NULL),
       _values (NULL),
       _global_to_local_map(),
-      _destroy_vec_on_exit (true) {
+      _destroy_vec_on_exit (true),
+      _ghostUpdatePending (false) {
     this->init (n, n_local, ghost, false, type);
   }
 
@@ -373,10 +383,12 @@ namespace femus {
       _local_form (NULL),
       _values (NULL),
       _global_to_local_map(),
-      _destroy_vec_on_exit (false) {
+      _destroy_vec_on_exit (false),
+      _ghostUpdatePending (false) {
     this->_vec = v;
     this->_is_closed = true;
     this->_is_initialized = true;
+    PetscObjectGetComm ( (PetscObject) v, &this->_comm);
 
     /* We need to ask PETSc about the (local to global) ghost value
        mapping and create the inverse mapping out of it.  */
@@ -489,7 +501,7 @@ namespace femus {
     // otherwise create an MPI-enabled vector
     else if (this->_type == PARALLEL) {
       assert (n_local <= n);
-      ierr = VecCreateMPI (MPI_COMM_WORLD, petsc_n_local, petsc_n, &_vec);
+      ierr = VecCreateMPI (_comm, petsc_n_local, petsc_n, &_vec);
       CHKERRABORT (MPI_COMM_WORLD, ierr);
       ierr = VecSetFromOptions (_vec);
       CHKERRABORT (MPI_COMM_WORLD, ierr);
@@ -554,7 +566,7 @@ namespace femus {
     }
 
     /* Create vector.  */
-    ierr = VecCreateGhost (MPI_COMM_WORLD, petsc_n_local, petsc_n,
+    ierr = VecCreateGhost (_comm, petsc_n_local, petsc_n,
                            petsc_n_ghost, petsc_ghost, &_vec);
     CHKERRABORT (MPI_COMM_WORLD, ierr);
 
@@ -581,6 +593,7 @@ namespace femus {
     this->_is_closed      = v._is_closed;
     this->_is_initialized = v._is_initialized;
     this->_type = v._type;
+    this->_comm = v._comm;
 
     if (v.size() != 0)   {
       int ierr = 0;
@@ -610,6 +623,33 @@ namespace femus {
     this->_is_closed = true;
   }
 
+  inline void PetscVector::closeBegin () {
+    this->_restore_array();
+    int ierr = 0;
+
+    ierr = VecAssemblyBegin (_vec);
+    CHKERRABORT (MPI_COMM_WORLD, ierr);
+    ierr = VecAssemblyEnd (_vec);
+    CHKERRABORT (MPI_COMM_WORLD, ierr);
+
+    if (this->type() == GHOSTED) {
+      ierr = VecGhostUpdateBegin (_vec, INSERT_VALUES, SCATTER_FORWARD);
+      CHKERRABORT (MPI_COMM_WORLD, ierr);
+      _ghostUpdatePending = true;
+    }
+    this->_is_closed = true;
+  }
+
+  inline void PetscVector::closeEnd () {
+    if (_ghostUpdatePending) {
+      this->_restore_array();
+      int ierr = 0;
+      ierr = VecGhostUpdateEnd (_vec, INSERT_VALUES, SCATTER_FORWARD);
+      CHKERRABORT (MPI_COMM_WORLD, ierr);
+      _ghostUpdatePending = false;
+    }
+  }
+
   inline void PetscVector::closeWithMinValues() {
 
     this->_restore_array();
@@ -800,6 +840,7 @@ namespace femus {
     PetscVector& v = libmeshM_cast_ref<PetscVector&> (other);
     std::swap (_vec, v._vec);
     std::swap (_destroy_vec_on_exit, v._destroy_vec_on_exit);
+    std::swap (_ghostUpdatePending, v._ghostUpdatePending);
     std::swap (_global_to_local_map, v._global_to_local_map);
     std::swap (_array_is_present, v._array_is_present);
     std::swap (_local_form, v._local_form);
@@ -40,19 +40,22 @@ namespace femus {
 /// This function builds a  SparseMatrix using the linear solver
 /// package specified by  solver_package
   std::unique_ptr<SparseMatrix > SparseMatrix::build (// -----
-    const SolverPackage solver_package //  solver_package
+    const SolverPackage solver_package, //  solver_package
+    const MPI_Comm &comm                //  communicator
   ) { // =================================================================================
     // Build the appropriate vector
     switch (solver_package) {
 #ifdef HAVE_PETSC // ------------------------------
       case PETSC_SOLVERS: {
         std::unique_ptr<SparseMatrix > ap (new PetscMatrix);
+        ap->SetCommunicator (comm);
         return ap;
       }
 #endif
 #ifdef HAVE_TRILINOS // ----------------------------
       case TRILINOS_SOLVERSM: {
         std::unique_ptr<SparseMatrix > ap (new EpetraMatrix<double>);
+        ap->SetCommunicator (comm);
         return ap;
       }
 #endif
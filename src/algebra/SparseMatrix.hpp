@@ -28,6 +28,8 @@
 #include "SolverPackageEnum.hpp"
 #include "Graph.hpp"
 
+#include <mpi.h>
+
 
 namespace femus {
 
@@ -49,7 +51,7 @@ namespace femus {
     public:
 
       /** Constructor;  before usage call init(...). */
-      SparseMatrix() : _is_initialized (false) {}
+      SparseMatrix() : _is_initialized (false), _comm (MPI_COMM_WORLD) {}
 
       /** Destructor */
       virtual ~SparseMatrix () {}
@@ -57,8 +59,17 @@ namespace femus {
       /** Release all memory and return */
       virtual void clear () = 0;
 
-      /** Builds a \p SparseMatrix using the linear solver package specified by \p solver_package */
-      static std::unique_ptr<SparseMatrix>  build (const SolverPackage solver_package = LSOLVER);
+      /** Builds a \p SparseMatrix using the linear solver package specified by \p solver_package, distributed on \p comm */
+      static std::unique_ptr<SparseMatrix>  build (const SolverPackage solver_package = LSOLVER, const MPI_Comm &comm = MPI_COMM_WORLD);
+
+      /** Communicator of the parallel layout, it has to be set before init */
+      void SetCommunicator (const MPI_Comm &comm) {
+        _comm = comm;
+      }
+
+      const MPI_Comm &GetCommunicator() const {
+        return _comm;
+      }
 
       /** Initialize */
       virtual void init (const int  m,  const int  n, const int  m_l, const int  n_l,
@@ -300,6 +311,9 @@ namespace femus {
       /** Flag indicating whether or not the matrix has been initialized. */
       bool _is_initialized;
 
+      /** Communicator of the matrix, MPI_COMM_WORLD by default */
+      MPI_Comm _comm;
+
   };
 
   /**
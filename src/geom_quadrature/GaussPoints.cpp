@@ -21,8 +21,18 @@
 namespace femus
 {
 
-  Gauss::Gauss(const char *geom_elem, const char *order_gauss) : _order(order_gauss)
+  Gauss::Gauss(const char *geom_elem, const char *order_gauss_in) : _order(order_gauss_in)
   {
+    // the suffix "_symmetric" selects the symmetric rules, where available
+    std::string order(order_gauss_in);
+    const std::string suffix("_symmetric");
+    bool symmetric = false;
+    if (order.size() > suffix.size() && order.compare(order.size() - suffix.size(), suffix.size(), suffix) == 0) {
+      order.erase(order.size() - suffix.size());
+      symmetric = true;
+    }
+    const char *order_gauss = order.c_str();
+
     if (!strcmp(order_gauss, "zero")  || !strcmp(order_gauss, "first")) {
       gauss_order = 0;
     }
@@ -44,20 +54,20 @@ namespace femus
     }
 
     if (!strcmp(geom_elem, "hex")) {
-      GaussWeight = hex_gauss::Gauss[gauss_order];
-      GaussPoints = hex_gauss::GaussPoints[gauss_order];
+      GaussWeight = (symmetric) ? hex_gauss::SymmetricGauss[gauss_order] : hex_gauss::Gauss[gauss_order];
+      GaussPoints = (symmetric) ? hex_gauss::SymmetricGaussPoints[gauss_order] : hex_gauss::GaussPoints[gauss_order];
     }
     else if (!strcmp(geom_elem, "wedge")) {
-      GaussWeight = wedge_gauss::Gauss[gauss_order];
-      GaussPoints = wedge_gauss::GaussPoints[gauss_order];
+      GaussWeight = (symmetric) ? wedge_gauss::SymmetricGauss[gauss_order] : wedge_gauss::Gauss[gauss_order];
+      GaussPoints = (symmetric) ? wedge_gauss::SymmetricGaussPoints[gauss_order] : wedge_gauss::GaussPoints[gauss_order];
     }
     else if (!strcmp(geom_elem, "tet")) {
-      GaussWeight = tet_gauss::Gauss[gauss_order];
-      GaussPoints = tet_gauss::GaussPoints[gauss_order];
+      GaussWeight = (symmetric) ? tet_gauss::SymmetricGauss[gauss_order] : tet_gauss::Gauss[gauss_order];
+      GaussPoints = (symmetric) ? tet_gauss::SymmetricGaussPoints[gauss_order] : tet_gauss::GaussPoints[gauss_order];
     }
     else if (!strcmp(geom_elem, "quad")) {
-      GaussWeight = quad_gauss::Gauss[gauss_order];
-      GaussPoints = quad_gauss::GaussPoints[gauss_order];
+      GaussWeight = (symmetric) ? quad_gauss::SymmetricGauss[gauss_order] : quad_gauss::Gauss[gauss_order];
+      GaussPoints = (symmetric) ? quad_gauss::SymmetricGaussPoints[gauss_order] : quad_gauss::GaussPoints[gauss_order];
     }
     else if (!strcmp(geom_elem, "tri")) {
       GaussWeight = tri_gauss::Gauss[gauss_order];
@@ -303,5 +313,69 @@ namespace femus
   const double point_gauss::Gauss4[2][1] = {{1}, {0}};
 
 
+  // ************** SYMMETRIC RULES ***************
+
+  const unsigned hex_gauss::SymmetricGaussPoints[5] = {1, 6, 14, 34, 125};
+  const double * hex_gauss::SymmetricGauss[5] = { Gauss0[0], SymmetricGauss1[0], SymmetricGauss2[0], SymmetricGauss3[0], Gauss4[0] };
+
+  // Stroud C3:3-2, the points are inside the cube (the fully symmetric 6 point rule has them at the face centers)
+  const double hex_gauss::SymmetricGauss1[4][6] = {
+    {1.333333333333333, 1.333333333333333, 1.333333333333333, 1.333333333333333, 1.333333333333333, 1.333333333333333},
+    {0.4082482904638631, -0.4082482904638631, -0.8164965809277260, -0.4082482904638631, 0.4082482904638631, 0.8164965809277260},
+    {0.7071067811865475, 0.7071067811865475, 0, -0.7071067811865475, -0.7071067811865475, 0},
+    {-0.5773502691896258, 0.5773502691896258, -0.5773502691896258, 0.5773502691896258, -0.5773502691896258, 0.5773502691896258}
+  };
+
+  const double hex_gauss::SymmetricGauss2[4][14] = {
+    {0.886426592797783, 0.886426592797783, 0.886426592797783, 0.886426592797783, 0.886426592797783, 0.886426592797783, 0.3351800554016625, 0.3351800554016625, 0.3351800554016625, 0.3351800554016625, 0.3351800554016625, 0.3351800554016625, 0.3351800554016625, 0.3351800554016625},
+    {0.7958224257542216, -0.7958224257542216, 0, 0, 0, 0, 0.7587869106393279, 0.7587869106393279, 0.7587869106393279, 0.7587869106393279, -0.7587869106393279, -0.7587869106393279, -0.7587869106393279, -0.7587869106393279},
+    {0, 0, 0.7958224257542216, -0.7958224257542216, 0, 0, 0.7587869106393279, 0.7587869106393279, -0.7587869106393279, -0.7587869106393279, 0.7587869106393279, 0.7587869106393279, -0.7587869106393279, -0.7587869106393279},
+    {0, 0, 0, 0, 0.7958224257542216, -0.7958224257542216, 0.7587869106393279, -0.7587869106393279, 0.7587869106393279, -0.7587869106393279, 0.7587869106393279, -0.7587869106393279, 0.7587869106393279, -0.7587869106393279}
+  };
+
+  const double hex_gauss::SymmetricGauss3[4][34] = {
+    {0.1876244259140321, 0.1876244259140321, 0.1876244259140321, 0.1876244259140321, 0.1876244259140321, 0.1876244259140321, 0.1477854994207292, 0.1477854994207292, 0.1477854994207292, 0.1477854994207292, 0.1477854994207292, 0.1477854994207292, 0.1477854994207292, 0.1477854994207292, 0.4544478204403614, 0.4544478204403614, 0.4544478204403614, 0.4544478204403614, 0.4544478204403614, 0.4544478204403614, 0.4544478204403614, 0.4544478204403614, 0.1713655738022569, 0.1713655738022569, 0.1713655738022569, 0.1713655738022569, 0.1713655738022569, 0.1713655738022569, 0.1713655738022569, 0.1713655738022569, 0.1713655738022569, 0.1713655738022569, 0.1713655738022569, 0.1713655738022569},
+    {0.9987694438109044, -0.9987694438109044, 0, 0, 0, 0, 0.7866077879600873, 0.7866077879600873, 0.7866077879600873, 0.7866077879600873, -0.7866077879600873, -0.7866077879600873, -0.7866077879600873, -0.7866077879600873, -0.4057521169232124, -0.4057521169232124, -0.4057521169232124, -0.4057521169232124, 0.4057521169232124, 0.4057521169232124, 0.4057521169232124, 0.4057521169232124, 0.8377969465053763, 0.8377969465053763, -0.8377969465053763, -0.8377969465053763, 0.8377969465053763, 0.8377969465053763, -0.8377969465053763, -0.8377969465053763, 0, 0, 0, 0},
+    {0, 0, 0.9987694438109044, -0.9987694438109044, 0, 0, 0.7866077879600873, 0.7866077879600873, -0.7866077879600873, -0.7866077879600873, 0.7866077879600873, 0.7866077879600873, -0.7866077879600873, -0.7866077879600873, -0.4057521169232124, -0.4057521169232124, 0.4057521169232124, 0.4057521169232124, -0.4057521169232124, -0.4057521169232124, 0.4057521169232124, 0.4057521169232124, 0.8377969465053763, -0.8377969465053763, 0.8377969465053763, -0.8377969465053763, 0, 0, 0, 0, 0.8377969465053763, 0.8377969465053763, -0.8377969465053763, -0.8377969465053763},
+    {0, 0, 0, 0, 0.9987694438109044, -0.9987694438109044, 0.7866077879600873, -0.7866077879600873, 0.7866077879600873, -0.7866077879600873, 0.7866077879600873, -0.7866077879600873, 0.7866077879600873, -0.7866077879600873, -0.4057521169232124, 0.4057521169232124, -0.4057521169232124, 0.4057521169232124, -0.4057521169232124, 0.4057521169232124, -0.4057521169232124, 0.4057521169232124, 0, 0, 0, 0, 0.8377969465053763, -0.8377969465053763, 0.8377969465053763, -0.8377969465053763, 0.8377969465053763, -0.8377969465053763, 0.8377969465053763, -0.8377969465053763}
+  };
+
+
+  const unsigned wedge_gauss::SymmetricGaussPoints[5] = {1, 8, 16, 52, 95};
+  const double * wedge_gauss::SymmetricGauss[5] = { Gauss0[0], Gauss1[0], SymmetricGauss2[0], Gauss3[0], Gauss4[0] };
+
+  const double wedge_gauss::SymmetricGauss2[4][16] = {
+    {0.2071428343483041, 0.03807558903099739, 0.03807558903099739, 0.03807558903099739, 0.03673080503418892, 0.03673080503418892, 0.03673080503418892, 0.03673080503418892, 0.03673080503418892, 0.03673080503418892, 0.07637426139226171, 0.07637426139226171, 0.07637426139226171, 0.07637426139226171, 0.07637426139226171, 0.07637426139226171},
+    {0.3333333333333333, 0.05176461782716408, 0.05176461782716408, 0.8964707643456719, 0.497664989583891, 0.497664989583891, 0.497664989583891, 0.497664989583891, 0.004670020832217903, 0.004670020832217903, 0.166396769631117, 0.166396769631117, 0.166396769631117, 0.166396769631117, 0.667206460737766, 0.667206460737766},
+    {0.3333333333333333, 0.05176461782716408, 0.8964707643456719, 0.05176461782716408, 0.497664989583891, 0.497664989583891, 0.004670020832217903, 0.004670020832217903, 0.497664989583891, 0.497664989583891, 0.166396769631117, 0.166396769631117, 0.667206460737766, 0.667206460737766, 0.166396769631117, 0.166396769631117},
+    {0, 0, 0, 0, 0.3972616744496599, -0.3972616744496599, 0.3972616744496599, -0.3972616744496599, 0.3972616744496599, -0.3972616744496599, 0.8071634863884445, -0.8071634863884445, 0.8071634863884445, -0.8071634863884445, 0.8071634863884445, -0.8071634863884445}
+  };
+
+
+  const unsigned tet_gauss::SymmetricGaussPoints[5] = {1, 5, 14, 31, 45};
+  const double * tet_gauss::SymmetricGauss[5] = { Gauss0[0], Gauss1[0], SymmetricGauss2[0], Gauss3[0], Gauss4[0] };
+
+  const double tet_gauss::SymmetricGauss2[4][14] = {
+    {0.0187813209530029, 0.0187813209530029, 0.0187813209530029, 0.0187813209530029, 0.01224884051939375, 0.01224884051939375, 0.01224884051939375, 0.01224884051939375, 0.007091003462846686, 0.007091003462846686, 0.007091003462846686, 0.007091003462846686, 0.007091003462846686, 0.007091003462846686},
+    {0.3108859192633008, 0.3108859192633008, 0.3108859192633008, 0.06734224221009766, 0.09273525031089153, 0.09273525031089153, 0.09273525031089153, 0.7217942490673255, 0.4544962958743519, 0.4544962958743519, 0.4544962958743519, 0.04550370412564808, 0.04550370412564808, 0.04550370412564808},
+    {0.3108859192633008, 0.3108859192633008, 0.06734224221009766, 0.3108859192633008, 0.09273525031089153, 0.09273525031089153, 0.7217942490673255, 0.09273525031089153, 0.4544962958743519, 0.04550370412564808, 0.04550370412564808, 0.4544962958743519, 0.4544962958743519, 0.04550370412564808},
+    {0.3108859192633008, 0.06734224221009766, 0.3108859192633008, 0.3108859192633008, 0.09273525031089153, 0.7217942490673255, 0.09273525031089153, 0.09273525031089153, 0.04550370412564808, 0.4544962958743519, 0.04550370412564808, 0.4544962958743519, 0.04550370412564808, 0.4544962958743519}
+  };
+
+
+  const unsigned quad_gauss::SymmetricGaussPoints[5] = {1, 4, 8, 12, 25};
+  const double * quad_gauss::SymmetricGauss[5] = { Gauss0[0], Gauss1[0], SymmetricGauss2[0], SymmetricGauss3[0], Gauss4[0] };
+
+  const double quad_gauss::SymmetricGauss2[3][8] = {
+    {0.8163265306122451, 0.8163265306122451, 0.8163265306122451, 0.8163265306122451, 0.1836734693877549, 0.1836734693877549, 0.1836734693877549, 0.1836734693877549},
+    {0.6831300510639733, -0.6831300510639733, 0, 0, 0.8819171036881971, 0.8819171036881971, -0.8819171036881971, -0.8819171036881971},
+    {0, 0, 0.6831300510639733, -0.6831300510639733, 0.8819171036881971, -0.8819171036881971, 0.8819171036881971, -0.8819171036881971}
+  };
+
+  const double quad_gauss::SymmetricGauss3[3][12] = {
+    {0.2419753086419755, 0.2419753086419755, 0.2419753086419755, 0.2419753086419755, 0.5205929166673939, 0.5205929166673939, 0.5205929166673939, 0.5205929166673939, 0.2374317746906305, 0.2374317746906305, 0.2374317746906305, 0.2374317746906305},
+    {-0.9258200997725513, 0.9258200997725513, 0, 0, -0.3805544332083155, -0.3805544332083155, 0.3805544332083155, 0.3805544332083155, 0.8059797829185986, 0.8059797829185986, -0.8059797829185986, -0.8059797829185986},
+    {0, 0, -0.9258200997725513, 0.9258200997725513, -0.3805544332083155, 0.3805544332083155, -0.3805544332083155, 0.3805544332083155, 0.8059797829185986, -0.8059797829185986, 0.8059797829185986, -0.8059797829185986}
+  };
 
 } //end namespace femus
@@ -21,6 +21,10 @@
 
 namespace femus {
 
+  /** The classes hex_gauss, wedge_gauss, tet_gauss and quad_gauss also provide fully symmetric rules
+   * (SymmetricGauss) with fewer points than the tensor-collapsed ones, for the same degree of exactness.
+   * They are selected with the suffix "_symmetric" in the order string, e.g. "fifth_symmetric".
+   * When no smaller symmetric rule is available the standard one is used. */
   class hex_gauss {
   public:
     static const unsigned GaussPoints[5];
@@ -30,6 +34,11 @@ namespace femus {
     static const double Gauss2[4][27];
     static const double Gauss3[4][64];
     static const double Gauss4[4][125];
+    static const unsigned SymmetricGaussPoints[5];
+    static const double *SymmetricGauss[5];
+    static const double SymmetricGauss1[4][6];
+    static const double SymmetricGauss2[4][14];
+    static const double SymmetricGauss3[4][34];
   };
   
   
@@ -42,6 +51,9 @@ namespace femus {
     static const double Gauss2[4][21];
     static const double Gauss3[4][52];
     static const double Gauss4[4][95];
+    static const unsigned SymmetricGaussPoints[5];
+    static const double *SymmetricGauss[5];
+    static const double SymmetricGauss2[4][16];
   };  
   
   
@@ -54,6 +66,9 @@ namespace femus {
     static const double Gauss2[4][15];
     static const double Gauss3[4][31];
     static const double Gauss4[4][45];
+    static const unsigned SymmetricGaussPoints[5];
+    static const double *SymmetricGauss[5];
+    static const double SymmetricGauss2[4][14];
   };
 
   class quad_gauss {
@@ -65,6 +80,10 @@ namespace femus {
     static const double Gauss2[3][9];
     static const double Gauss3[3][16];
     static const double Gauss4[3][25];
+    static const unsigned SymmetricGaussPoints[5];
+    static const double *SymmetricGauss[5];
+    static const double SymmetricGauss2[3][8];
+    static const double SymmetricGauss3[3][12];
   };
   
 
@@ -0,0 +1,372 @@
+
+#include "multilevelMonteCarlo.hpp"
+
+#include "MultiLevelProblem.hpp"
+#include "MultiLevelMesh.hpp"
+#include "MultiLevelSolution.hpp"
+#include "LinearImplicitSystem.hpp"
+#include "NumericVector.hpp"
+#include "SparseMatrix.hpp"
+
+#include <boost/math/distributions/normal.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <ctime>
+#include <algorithm>
+
+namespace femus {
+
+  multilevelMonteCarlo::multilevelMonteCarlo (MultiLevelProblem &ml_prob, const char systemName[], const unsigned &numberOfStochasticVariables,
+                                              const UqQuadratureType &quadratureType, const bool &output) :
+    _mlProb (ml_prob),
+    _numberOfStochasticVariables (numberOfStochasticVariables),
+    _quadratureType (quadratureType),
+    _output (output),
+    _expectedValue (0.),
+    _setRealizationFunction (NULL),
+    _getQuantityOfInterestFunction (NULL),
+    _normal (0., 1.),
+    _uniform (-1., 1.) {
+
+    _system = &_mlProb.get_system<LinearImplicitSystem> (systemName);
+
+    MPI_Comm_rank (MPI_COMM_WORLD, &_iproc);
+
+    SetLevels (0, _mlProb._ml_msh->GetNumberOfLevels() - 1);
+
+    // the first _numberOfStochasticVariables primes are the bases of the Halton sequence
+    for (unsigned p = 2; _primes.size() < _numberOfStochasticVariables; p++) {
+      bool isPrime = true;
+      for (unsigned j = 0; j < _primes.size() && _primes[j] * _primes[j] <= p; j++) {
+        if (p % _primes[j] == 0) {
+          isPrime = false;
+          break;
+        }
+      }
+      if (isPrime) _primes.push_back (p);
+    }
+  }
+
+  void multilevelMonteCarlo::SetLevels (const unsigned &levelMin, const unsigned &levelMax) {
+
+    if (levelMin > levelMax || levelMax >= _mlProb._ml_msh->GetNumberOfLevels()) {
+      std::cout << "Error in multilevelMonteCarlo::SetLevels: wrong level range [" << levelMin << ", " << levelMax << "]" << std::endl;
+      abort();
+    }
+
+    _levelMin = levelMin;
+    _levelMax = levelMax;
+
+    unsigned numberOfLevels = _levelMax - _levelMin + 1;
+    _N.assign (numberOfLevels, 0);
+    _mean.assign (numberOfLevels, 0.);
+    _variance.assign (numberOfLevels, 0.);
+    _cost.assign (numberOfLevels, 0.);
+  }
+
+  void multilevelMonteCarlo::RestrictSolutionToCoarseLevels (const char solName[]) {
+
+    MultiLevelSolution* mlSol = _mlProb._ml_sol;
+    unsigned solIndex = mlSol->GetIndex (solName);
+    unsigned solType = mlSol->GetSolutionType (solIndex);
+
+    // u_coarse = D^{-1} P^T u_fine, with P the coarse to fine projection and D = diag(P^T 1):
+    // a weighted average of the fine values that preserves constants
+    for (unsigned level = _levelMax; level > _levelMin; level--) {
+
+      SparseMatrix* P = _mlProb._ml_msh->GetLevel (level)->GetCoarseToFineProjection (solType);
+
+      NumericVector* solFine = mlSol->GetSolutionLevel (level)->_Sol[solIndex];
+      NumericVector* solCoarse = mlSol->GetSolutionLevel (level - 1)->_Sol[solIndex];
+
+      NumericVector* ones = NumericVector::build().release();
+      ones->init (*solFine, false);
+      *ones = 1.;
+      ones->close();
+
+      NumericVector* weights = NumericVector::build().release();
+      weights->init (*solCoarse, false);
+      weights->matrix_mult_transpose (*ones, *P);
+
+      solCoarse->matrix_mult_transpose (*solFine, *P);
+
+      for (int i = solCoarse->first_local_index(); i < solCoarse->last_local_index(); i++) {
+        double w = (*weights) (i);
+        if (w > 1.0e-14) solCoarse->set (i, (*solCoarse) (i) / w);
+      }
+      solCoarse->close();
+
+      delete ones;
+      delete weights;
+    }
+  }
+
+  double multilevelMonteCarlo::GetLevelDifference (const unsigned &l, const std::vector <double> &y, double &cost) {
+
+    clock_t start_time = clock();
+
+    _setRealizationFunction (y);
+
+    unsigned level = _levelMin + l;
+
+    _system->SetMaxLevelToSolve (level);
+    _system->MGsolve();
+    double Y = _getQuantityOfInterestFunction (_mlProb, level);
+
+    if (l > 0) {
+      _system->SetMaxLevelToSolve (level - 1);
+      _system->MGsolve();
+      Y -= _getQuantityOfInterestFunction (_mlProb, level - 1);
+    }
+
+    _system->ResetMaxLevelToSolve();
+
+    cost += static_cast<double> (clock() - start_time) / CLOCKS_PER_SEC;
+
+    return Y;
+  }
+
+  void multilevelMonteCarlo::DrawRealization (std::vector <double> &y) {
+
+    y.resize (_numberOfStochasticVariables);
+
+    if (_iproc == 0) {
+      for (unsigned k = 0; k < _numberOfStochasticVariables; k++) {
+        y[k] = (_quadratureType == UQ_HERMITE) ? _normal (_rng) : _uniform (_rng);
+      }
+    }
+
+    MPI_Bcast (&y[0], _numberOfStochasticVariables, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  }
+
+  void multilevelMonteCarlo::MapUnitCubePoint (const std::vector <double> &u, std::vector <double> &y) {
+
+    y.resize (_numberOfStochasticVariables);
+
+    if (_quadratureType == UQ_HERMITE) {
+      boost::math::normal standardNormal;
+      for (unsigned k = 0; k < _numberOfStochasticVariables; k++) {
+        double uk = (u[k] < 1.0e-15) ? 1.0e-15 : ((u[k] > 1. - 1.0e-15) ? 1. - 1.0e-15 : u[k]);
+        y[k] = boost::math::quantile (standardNormal, uk);
+      }
+    }
+    else {
+      for (unsigned k = 0; k < _numberOfStochasticVariables; k++) {
+        y[k] = 2. * u[k] - 1.;
+      }
+    }
+  }
+
+  void multilevelMonteCarlo::GetHaltonPoint (const unsigned &i, std::vector <double> &u) {
+
+    u.resize (_numberOfStochasticVariables);
+
+    // radical inverse of i + 1 in base _primes[k], the origin is skipped
+    for (unsigned k = 0; k < _numberOfStochasticVariables; k++) {
+      double f = 1.;
+      u[k] = 0.;
+      for (unsigned n = i + 1; n > 0; n /= _primes[k]) {
+        f /= _primes[k];
+        u[k] += f * (n % _primes[k]);
+      }
+    }
+  }
+
+  double multilevelMonteCarlo::GetMaxOverProcesses (const double &value) {
+    double maxValue;
+    MPI_Allreduce (&value, &maxValue, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    return maxValue;
+  }
+
+  double multilevelMonteCarlo::Run (const double &epsilon, const unsigned &N0) {
+
+    if (_setRealizationFunction == NULL || _getQuantityOfInterestFunction == NULL) {
+      std::cout << "Error in multilevelMonteCarlo::Run: realization or quantity of interest function not attached" << std::endl;
+      abort();
+    }
+
+    unsigned numberOfLevels = _levelMax - _levelMin + 1;
+
+    std::vector <double> sumY (numberOfLevels, 0.);
+    std::vector <double> sumY2 (numberOfLevels, 0.);
+    std::vector <double> sumCost (numberOfLevels, 0.);
+
+    _N.assign (numberOfLevels, 0);
+    std::vector <unsigned> dN (numberOfLevels, N0);
+
+    std::vector <double> y;
+
+    bool moreSamples = true;
+    while (moreSamples) {
+
+      for (unsigned l = 0; l < numberOfLevels; l++) {
+        for (unsigned i = 0; i < dN[l]; i++) {
+          DrawRealization (y);
+          double Y = GetLevelDifference (l, y, sumCost[l]);
+          sumY[l] += Y;
+          sumY2[l] += Y * Y;
+        }
+        _N[l] += dN[l];
+
+        if (_N[l] > 0) {
+          _mean[l] = sumY[l] / _N[l];
+          _variance[l] = std::max (sumY2[l] / _N[l] - _mean[l] * _mean[l], 0.);
+          _cost[l] = GetMaxOverProcesses (sumCost[l] / _N[l]);
+        }
+      }
+
+      // optimal number of samples: N_l = 2 epsilon^-2 sqrt(V_l / C_l) sum_k sqrt(V_k C_k)
+      double sumSqrtVC = 0.;
+      for (unsigned l = 0; l < numberOfLevels; l++) {
+        sumSqrtVC += sqrt (_variance[l] * _cost[l]);
+      }
+
+      moreSamples = false;
+      for (unsigned l = 0; l < numberOfLevels; l++) {
+        double Nopt = (_cost[l] > 0.) ? ceil (2. / (epsilon * epsilon) * sqrt (_variance[l] / _cost[l]) * sumSqrtVC) : 0.;
+        dN[l] = (Nopt > _N[l]) ? static_cast <unsigned> (Nopt) - _N[l] : 0;
+        if (dN[l] > 0) moreSamples = true;
+      }
+    }
+
+    _expectedValue = 0.;
+    for (unsigned l = 0; l < numberOfLevels; l++) {
+      _expectedValue += _mean[l];
+      // from here on the variance of the level estimator Var(Y_l) / N_l, as after RunQuasi, see GetLevelVariance
+      _variance[l] /= _N[l];
+    }
+
+    if (_output) PrintLevelData ("MLMC");
+
+    return _expectedValue;
+  }
+
+  double multilevelMonteCarlo::RunQuasi (const double &epsilon, const unsigned &N0, const unsigned &numberOfShifts) {
+
+    if (_setRealizationFunction == NULL || _getQuantityOfInterestFunction == NULL) {
+      std::cout << "Error in multilevelMonteCarlo::RunQuasi: realization or quantity of interest function not attached" << std::endl;
+      abort();
+    }
+
+    if (numberOfShifts < 2) {
+      std::cout << "Error in multilevelMonteCarlo::RunQuasi: at least 2 random shifts are needed to estimate the variance" << std::endl;
+      abort();
+    }
+
+    unsigned numberOfLevels = _levelMax - _levelMin + 1;
+
+    // one Cranley-Patterson shift per level and per replica, drawn on process 0
+    std::vector < std::vector < std::vector <double> > > shift (numberOfLevels);
+    boost::random::uniform_real_distribution<> unitUniform (0., 1.);
+    for (unsigned l = 0; l < numberOfLevels; l++) {
+      shift[l].resize (numberOfShifts);
+      for (unsigned r = 0; r < numberOfShifts; r++) {
+        shift[l][r].resize (_numberOfStochasticVariables);
+        if (_iproc == 0) {
+          for (unsigned k = 0; k < _numberOfStochasticVariables; k++) {
+            shift[l][r][k] = unitUniform (_rng);
+          }
+        }
+        MPI_Bcast (&shift[l][r][0], _numberOfStochasticVariables, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+      }
+    }
+
+    std::vector < std::vector <double> > sumY (numberOfLevels);
+    for (unsigned l = 0; l < numberOfLevels; l++) {
+      sumY[l].assign (numberOfShifts, 0.);
+    }
+    std::vector <double> sumCost (numberOfLevels, 0.);
+
+    _N.assign (numberOfLevels, 0);
+    std::vector <unsigned> Nnew (numberOfLevels, N0);
+
+    std::vector <double> u;
+    std::vector <double> uShifted (_numberOfStochasticVariables);
+    std::vector <double> y;
+
+    while (true) {
+
+      for (unsigned l = 0; l < numberOfLevels; l++) {
+        for (unsigned i = _N[l]; i < Nnew[l]; i++) {
+          GetHaltonPoint (i, u);
+          for (unsigned r = 0; r < numberOfShifts; r++) {
+            for (unsigned k = 0; k < _numberOfStochasticVariables; k++) {
+              uShifted[k] = u[k] + shift[l][r][k];
+              uShifted[k] -= floor (uShifted[k]);
+            }
+            MapUnitCubePoint (uShifted, y);
+            sumY[l][r] += GetLevelDifference (l, y, sumCost[l]);
+          }
+        }
+        _N[l] = Nnew[l];
+
+        // the replicas are independent: the estimator variance is the variance of their means over numberOfShifts
+        double mean = 0.;
+        double mean2 = 0.;
+        for (unsigned r = 0; r < numberOfShifts; r++) {
+          double Yr = sumY[l][r] / _N[l];
+          mean += Yr;
+          mean2 += Yr * Yr;
+        }
+        mean /= numberOfShifts;
+        mean2 /= numberOfShifts;
+        _mean[l] = mean;
+        _variance[l] = std::max (mean2 - mean * mean, 0.) / (numberOfShifts - 1);
+        _cost[l] = GetMaxOverProcesses (sumCost[l] / (_N[l] * numberOfShifts));
+      }
+
+      double totalVariance = 0.;
+      for (unsigned l = 0; l < numberOfLevels; l++) {
+        totalVariance += _variance[l];
+      }
+      if (totalVariance <= 0.5 * epsilon * epsilon) break;
+
+      // double the points on the level with the largest variance reduction per unit cost
+      unsigned lMax = 0;
+      double ratioMax = -1.;
+      for (unsigned l = 0; l < numberOfLevels; l++) {
+        double ratio = _variance[l] / (_cost[l] * _N[l]);
+        if (ratio > ratioMax) {
+          ratioMax = ratio;
+          lMax = l;
+        }
+      }
+      Nnew[lMax] = 2 * _N[lMax];
+    }
+
+    _expectedValue = 0.;
+    for (unsigned l = 0; l < numberOfLevels; l++) {
+      _expectedValue += _mean[l];
+    }
+
+    if (_output) PrintLevelData ("MLQMC");
+
+    return _expectedValue;
+  }
+
+  void multilevelMonteCarlo::PrintLevelData (const char method[]) {
+
+    unsigned numberOfLevels = _levelMax - _levelMin + 1;
+
+    std::cout << std::endl << " ************* " << method << " estimator *************" << std::endl;
+    std::cout << " level      N        mean(Y_l)    Var(estimator)   cost(s)" << std::endl;
+
+    double totalCost = 0.;
+    for (unsigned l = 0; l < numberOfLevels; l++) {
+      std::cout << std::setw (6) << _levelMin + l << std::setw (9) << _N[l] << "   " << std::scientific << std::setprecision (4)
+                << std::setw (12) << _mean[l] << "   " << std::setw (12) << _variance[l] << "   " << std::setw (12) << _cost[l] << std::endl;
+      totalCost += _N[l] * _cost[l];
+    }
+
+    // the bias is estimated from the last correction |E[Q_L - Q_{L-1}]|
+    if (numberOfLevels > 1) {
+      std::cout << " estimated bias = " << fabs (_mean[numberOfLevels - 1]) << std::endl;
+    }
+    std::cout << " E[Q] = " << _expectedValue << " , total cost = " << totalCost << " s" << std::endl;
+    std::cout.unsetf (std::ios_base::floatfield);
+  }
+
+}
@@ -0,0 +1,126 @@
+
+#ifndef __multilevelMonteCarlo_hpp__
+#define __multilevelMonteCarlo_hpp__
+
+#include <vector>
+#include <string>
+
+#include <boost/random.hpp>
+#include <boost/random/normal_distribution.hpp>
+
+#include "UqQuadratureTypeEnum.hpp"
+
+namespace femus {
+
+  class MultiLevelProblem;
+  class LinearImplicitSystem;
+
+  /// Multilevel (quasi) Monte Carlo estimator of E[Q] on the levels of a MultiLevelMesh.
+  /// Level l contributes the correlated difference Q_l - Q_{l-1}: both terms are computed
+  /// with the same realization of the stochastic variables, solving the system up to level l and l-1.
+  class multilevelMonteCarlo {
+
+    public:
+
+      multilevelMonteCarlo (MultiLevelProblem &ml_prob, const char systemName[], const unsigned &numberOfStochasticVariables,
+                            const UqQuadratureType &quadratureType, const bool &output);
+
+      ~multilevelMonteCarlo() {};
+
+      /// Attach the function that stores the realization y of the stochastic variables used by the assembly
+      void AttachSetRealizationFunction (void (*setRealizationFunction) (const std::vector <double> &y)) {
+        _setRealizationFunction = setRealizationFunction;
+      };
+
+      /// Attach the function that returns the quantity of interest at the given level, it must return the same value on all processes
+      void AttachGetQuantityOfInterestFunction (double (*getQuantityOfInterestFunction) (MultiLevelProblem &ml_prob, const unsigned &level)) {
+        _getQuantityOfInterestFunction = getQuantityOfInterestFunction;
+      };
+
+      /// Set the coarsest and the finest level of the estimator, by default all the levels of the mesh
+      void SetLevels (const unsigned &levelMin, const unsigned &levelMax);
+
+      /// Restrict the solution solName from the finest level of the estimator to the coarser ones
+      void RestrictSolutionToCoarseLevels (const char solName[]);
+
+      /// Run standard MLMC with N0 warm-up samples per level, until the estimated variance is below epsilon^2/2
+      double Run (const double &epsilon, const unsigned &N0);
+
+      /// Run MLQMC with randomly shifted Halton points, numberOfShifts shifts and N0 initial points per shift
+      double RunQuasi (const double &epsilon, const unsigned &N0, const unsigned &numberOfShifts);
+
+      /// Get the estimated expected value of the quantity of interest
+      double GetExpectedValue() const {
+        return _expectedValue;
+      };
+
+      /// Get the number of samples used on level l (relative to the coarsest level of the estimator)
+      unsigned GetNumberOfSamples (const unsigned &l) const {
+        return _N[l];
+      };
+
+      /// Get the estimated mean of Q_l - Q_{l-1}
+      double GetLevelMean (const unsigned &l) const {
+        return _mean[l];
+      };
+
+      /// Get the estimated variance of the level estimator, i.e. of the sample mean of Q_l - Q_{l-1}, not of a single sample:
+      /// Var(Q_l - Q_{l-1}) / N_l after Run, the variance over the random shifts after RunQuasi. The sum over l is the estimator variance
+      double GetLevelVariance (const unsigned &l) const {
+        return _variance[l];
+      };
+
+      /// Get the measured cost in seconds of one sample of Q_l - Q_{l-1}
+      double GetLevelCost (const unsigned &l) const {
+        return _cost[l];
+      };
+
+    private:
+
+      /// Compute the sample of Q_l - Q_{l-1} for the realization y, and add the elapsed time to cost
+      double GetLevelDifference (const unsigned &l, const std::vector <double> &y, double &cost);
+
+      /// Draw y from the distribution prescribed by _quadratureType on process 0 and broadcast it
+      void DrawRealization (std::vector <double> &y);
+
+      /// Map the point u of the unit cube into y, through the inverse cdf of _quadratureType
+      void MapUnitCubePoint (const std::vector <double> &u, std::vector <double> &y);
+
+      /// Get the i-th point of the Halton sequence
+      void GetHaltonPoint (const unsigned &i, std::vector <double> &u);
+
+      /// Return the cost of the slowest process
+      double GetMaxOverProcesses (const double &value);
+
+      void PrintLevelData (const char method[]);
+
+      MultiLevelProblem &_mlProb;
+      LinearImplicitSystem *_system;
+
+      unsigned _numberOfStochasticVariables;
+      UqQuadratureType _quadratureType;
+      bool _output;
+      int _iproc;
+
+      unsigned _levelMin;
+      unsigned _levelMax;
+
+      std::vector <unsigned> _primes;
+
+      std::vector <unsigned> _N;
+      std::vector <double> _mean;
+      std::vector <double> _variance;
+      std::vector <double> _cost;
+      double _expectedValue;
+
+      void (*_setRealizationFunction) (const std::vector <double> &y);
+      double (*_getQuantityOfInterestFunction) (MultiLevelProblem &ml_prob, const unsigned &level);
+
+      boost::mt19937 _rng;
+      boost::normal_distribution<> _normal;
+      boost::random::uniform_real_distribution<> _uniform;
+  };
+
+}
+
+#endif
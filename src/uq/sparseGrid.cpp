@@ -1,5 +1,6 @@
 #include <math.h>
 #include "sparseGrid.hpp"
+#include <mpi.h>
 #include <iostream>
 #include <cstdlib>
 #include <numeric>
@@ -144,126 +145,80 @@ namespace femus
         //END
 
 
-        //BEGIN construction of dofIdentifier and storing memory for _nodalValuesPDF
-
-        _dofIdentifier.resize ( _numberOfWs );
-        _nodalValuesPDF.resize ( _numberOfWs );
+        //BEGIN construction of dofIdentifier, _hierarchicalDofsCoordinates and storing memory for _nodalValuesPDF
 
         if ( _output )  std::cout << "-------------------------- Number of W sets = " << _numberOfWs <<  "-------------------------- " << std::endl;
 
-        for ( unsigned w = 0; w < _numberOfWs; w++ ) {
-            unsigned identifiersOfW = 1;
-
-            for ( unsigned n = 0; n < _N; n++ ) {
-
-                identifiersOfW *= _hierarchicalDofs[n][_indexSetW[w][n]].size();
-
-            }
-
-            _dofIdentifier[w].resize ( identifiersOfW );
-            _nodalValuesPDF[w].resize ( identifiersOfW );
+        std::vector < std::vector < unsigned > > indexSetW;
+        indexSetW.swap ( _indexSetW );
+        _numberOfWs = 0;
 
-            if ( _output ) std::cout << "identifiersOfW = " << identifiersOfW << std::endl;
+        for ( unsigned w = 0; w < indexSetW.size(); w++ ) {
+            AddW ( indexSetW[w] );
         }
 
-        //Here we create the dofs for each W
-        std::vector<std::vector< std::vector < unsigned > > > dofsW;
-        dofsW.resize ( _numberOfWs );
-
-        std::vector < unsigned> counterW ( _numberOfWs, 0 );
-
-        for ( unsigned w = 0; w < _numberOfWs; w++ ) {
-
-            dofsW[w].resize ( _dofIdentifier[w].size() );
-
-            std::vector< std::vector <int> > inputCartesian ( _N );
-
-            for ( unsigned n = 0; n < _N; n++ ) {
-                inputCartesian[n].resize ( _hierarchicalDofs[n][_indexSetW[w][n]].size() );
+        //END
 
-                for ( unsigned i1 = 0; i1 < _hierarchicalDofs[n][_indexSetW[w][n]].size(); i1++ ) {
-                    inputCartesian[n][i1] = _hierarchicalDofs[n][_indexSetW[w][n]][i1];
-                }
-            }
+    }
 
-            CartesianProduct ( inputCartesian, dofsW[w] );
+    void sparseGrid::AddW ( const std::vector < unsigned > &indexW )
+    {
 
+        unsigned w = _numberOfWs;
 
-            if ( _output ) {
-                for ( unsigned i = 0; i < dofsW[w].size(); i++ ) {
-                    for ( unsigned n = 0; n < _N; n++ ) {
-                        std::cout << "dofsW[" << w << "][" << i << "][" << n << "] = " << dofsW[w][i][n] << " ";
-                    }
+        _indexSetW.push_back ( indexW );
+        _numberOfWs++;
 
-                    std::cout << std::endl;
-                }
-            }
+        unsigned identifiersOfW = 1;
 
+        for ( unsigned n = 0; n < _N; n++ ) {
+            identifiersOfW *= _hierarchicalDofs[n][indexW[n]].size();
         }
 
+        if ( _output ) std::cout << "identifiersOfW = " << identifiersOfW << std::endl;
 
-        //now we need to store these dofs in _dofIdentifier
-        for ( unsigned w = 0; w < _numberOfWs; w++ ) {
-            for ( unsigned i = 0; i < _dofIdentifier[w].size(); i++ ) {
-                _dofIdentifier[w][i].resize ( _N );
-
-                for ( unsigned n = 0; n < _N; n++ ) {
-                    _dofIdentifier[w][i][n].resize ( 3 );
-                    _dofIdentifier[w][i][n][0] = n;
-                    _dofIdentifier[w][i][n][1] = _indexSetW[w][n];
-                    _dofIdentifier[w][i][n][2] = dofsW[w][i][n];
-                }
-            }
-        }
+        _dofIdentifier.resize ( _numberOfWs );
+        _nodalValuesPDF.resize ( _numberOfWs );
+        _hierarchicalDofsCoordinates.resize ( _numberOfWs );
 
-        if ( _output ) {
-            for ( unsigned w = 0; w < _numberOfWs; w++ ) {
-                std::cout << " ------------------------- w = " << w << " ------------------------- " << std::endl;
+        _nodalValuesPDF[w].assign ( identifiersOfW, 0. );
 
-                for ( unsigned i = 0; i < _dofIdentifier[w].size(); i++ ) {
-                    std::cout << " ------------------------- i = " << i << " ------------------------- " << std::endl;
+        //Here we create the dofs of W
+        std::vector< std::vector < unsigned > > dofsW;
 
-                    for ( unsigned n = 0; n < _N; n++ ) {
-                        std::cout << " ------------------------- dim = " << n << " ------------------------- " << std::endl;
+        std::vector< std::vector <int> > inputCartesian ( _N );
 
-                        for ( unsigned j = 0; j < 3; j++ ) {
-                            std::cout << "_dofIdentifier[" << w << "][" << i << "][" << n << "][" << j << "] = " << _dofIdentifier[w][i][n][j] << " " ;
-                        }
+        for ( unsigned n = 0; n < _N; n++ ) {
+            inputCartesian[n].resize ( _hierarchicalDofs[n][indexW[n]].size() );
 
-                        std::cout << std::endl;
-                    }
-                }
+            for ( unsigned i1 = 0; i1 < _hierarchicalDofs[n][indexW[n]].size(); i1++ ) {
+                inputCartesian[n][i1] = _hierarchicalDofs[n][indexW[n]][i1];
             }
         }
 
-        //END
-
-
-        //BEGIN construction of _hierarchicalDofsCoordinates
+        CartesianProduct ( inputCartesian, dofsW );
 
+        //now we need to store these dofs in _dofIdentifier and their coordinates in _hierarchicalDofsCoordinates
+        _dofIdentifier[w].resize ( identifiersOfW );
+        _hierarchicalDofsCoordinates[w].resize ( identifiersOfW );
 
-        _hierarchicalDofsCoordinates.resize ( _numberOfWs );
-
-        for ( unsigned w = 0; w < _numberOfWs; w++ ) {
-
-            _hierarchicalDofsCoordinates[w].resize ( _dofIdentifier[w].size() );
+        for ( unsigned i = 0; i < identifiersOfW; i++ ) {
+            _dofIdentifier[w][i].resize ( _N );
+            _hierarchicalDofsCoordinates[w][i].resize ( _N );
 
-            for ( unsigned i = 0; i < _dofIdentifier[w].size(); i++ ) {
-
-                _hierarchicalDofsCoordinates[w][i].resize ( _N );
-
-                for ( unsigned n = 0; n < _N; n++ ) {
+            for ( unsigned n = 0; n < _N; n++ ) {
+                _dofIdentifier[w][i][n].resize ( 3 );
+                _dofIdentifier[w][i][n][0] = n;
+                _dofIdentifier[w][i][n][1] = indexW[n];
+                _dofIdentifier[w][i][n][2] = dofsW[i][n];
 
-                    _hierarchicalDofsCoordinates[w][i][n] = _nodes[_dofIdentifier[w][i][n][0]][_dofIdentifier[w][i][n][1]][_dofIdentifier[w][i][n][2]];
+                _hierarchicalDofsCoordinates[w][i][n] = _nodes[n][indexW[n]][dofsW[i][n]];
 
-                }
+                if ( _output ) std::cout << "_dofIdentifier[" << w << "][" << i << "][" << n << "] = "
+                                             << n << " " << indexW[n] << " " << dofsW[i][n] << std::endl;
             }
         }
 
-        //END
-
-
-
     }
 
     void sparseGrid::EvaluateOneDimensionalPhi ( double &phi, const double &x, const unsigned &n, const unsigned &l, const unsigned &i, const bool &scale )
@@ -352,62 +307,187 @@ namespace femus
     void sparseGrid::EvaluateNodalValuesPDF ( std::vector < std::vector < double > >  &samples )
     {
 
-        double supportMeasureLowest = 1.;
+        for ( unsigned w = 0; w < _numberOfWs; w++ ) {
+            EvaluateNodalValuesPDF ( w, samples );
+        }
 
-        for ( unsigned n = 0; n < _N; n++ ) {
-            supportMeasureLowest *=  2. * _hs[n][_dofIdentifier[0][0][n][1]];
+    }
+
+    void sparseGrid::EvaluateNodalValuesPDF ( const unsigned &w, std::vector < std::vector < double > >  &samples )
+    {
+
+        if ( w == 0 ) {
+
+            double supportMeasureLowest = 1.;
+
+            for ( unsigned n = 0; n < _N; n++ ) {
+                supportMeasureLowest *=  2. * _hs[n][_dofIdentifier[0][0][n][1]];
+            }
+
+            _nodalValuesPDF[0][0] = 1. / ( supportMeasureLowest );
+
+            return;
         }
 
-        _nodalValuesPDF[0][0] = 1. / ( supportMeasureLowest );
+        unsigned dofsOfW =  _nodalValuesPDF[w].size();
 
+        //the samples are split among the processes, the counts in the supports are then summed
+        int iproc = 0;
+        int nprocs = 1;
+        int mpiIsInitialized;
+        MPI_Initialized ( &mpiIsInitialized );
 
-        for ( unsigned w = 1; w < _numberOfWs; w++ ) {
-            for ( unsigned i = 0; i < _nodalValuesPDF[w].size(); i++ ) {
-                _nodalValuesPDF[w][i] = 0.;
+        if ( mpiIsInitialized ) {
+            MPI_Comm_rank ( MPI_COMM_WORLD, &iproc );
+            MPI_Comm_size ( MPI_COMM_WORLD, &nprocs );
+        }
+
+        std::vector < double > samplesInSupport ( dofsOfW, 0. );
+
+        for ( unsigned i = 0; i < dofsOfW; i++ ) {
+            for ( unsigned m = iproc; m < _M; m += nprocs ) {
+                double valuePhi;
+                PiecewiseConstPhi ( valuePhi, samples[m], _dofIdentifier[w][i] );
+                samplesInSupport[i] += valuePhi;
             }
         }
 
-        for ( unsigned w = 1; w < _numberOfWs; w++ ) {
-            unsigned dofsOfW =  _nodalValuesPDF[w].size();
+        if ( nprocs > 1 ) {
+            MPI_Allreduce ( MPI_IN_PLACE, &samplesInSupport[0], dofsOfW, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+        }
 
-            for ( unsigned i = 0; i < dofsOfW; i++ ) {
+        for ( unsigned i = 0; i < dofsOfW; i++ ) {
 
-                double supportMeasure = 1.;
+            double supportMeasure = 1.;
+
+            for ( unsigned n = 0; n < _N; n++ ) {
+                supportMeasure *=  2. * _hs[n][_dofIdentifier[w][i][n][1]];
+            }
+
+            _nodalValuesPDF[w][i] = samplesInSupport[i] / ( supportMeasure * _M );
+
+            for ( unsigned w1 = 0; w1 < w; w1++ ) {
+                unsigned dofsOfWLower = _nodalValuesPDF[w1].size();
+
+                for ( unsigned i1 = 0; i1 < dofsOfWLower; i1++ ) {
+
+                    unsigned isThere;
+                    InSupport ( isThere, _hierarchicalDofsCoordinates[w][i], _dofIdentifier[w1][i1] );
+
+                    bool doThey;
+                    SupportIsContained ( doThey, w, i, w1, i1 );
 
-                for ( unsigned n = 0; n < _N; n++ ) {
-                    supportMeasure *=  2. * _hs[n][_dofIdentifier[w][i][n][1]];
-                }
 
-                for ( unsigned m = 0; m < _M; m++ ) {
+                    if ( isThere == 1 && dofsOfWLower < dofsOfW && doThey == true ) {
 
-                    double valuePhi;
-                    PiecewiseConstPhi ( valuePhi, samples[m], _dofIdentifier[w][i] );
-                    _nodalValuesPDF[w][i] += valuePhi / ( supportMeasure * _M );
+                        _nodalValuesPDF[w][i] -=  _nodalValuesPDF[w1][i1];
+
+                    }
 
                 }
+            }
 
+        }
 
-                for ( unsigned w1 = 0; w1 < w; w1++ ) {
-                    unsigned dofsOfWLower = _nodalValuesPDF[w1].size();
+    }
 
-                    for ( unsigned i1 = 0; i1 < dofsOfWLower; i1++ ) {
+    double sparseGrid::ComputeSurplusIndicator ( const unsigned &w )
+    {
 
-                        unsigned isThere;
-                        InSupport ( isThere, _hierarchicalDofsCoordinates[w][i], _dofIdentifier[w1][i1] );
+        //contribution of W to the integral of |PDF|, the hierarchical surplus weighted by the support measure
+        double indicator = 0.;
 
-                        bool doThey;
-                        SupportIsContained ( doThey, w, i, w1, i1 );
+        for ( unsigned i = 0; i < _nodalValuesPDF[w].size(); i++ ) {
 
+            double supportMeasure = 1.;
 
-                        if ( isThere == 1 && dofsOfWLower < dofsOfW && doThey == true ) {
+            for ( unsigned n = 0; n < _N; n++ ) {
+                supportMeasure *= 2. * _hs[n][_dofIdentifier[w][i][n][1]];
+            }
 
-                            _nodalValuesPDF[w][i] -=  _nodalValuesPDF[w1][i1];
+            indicator += fabs ( _nodalValuesPDF[w][i] ) * supportMeasure;
+        }
+
+        return indicator;
+    }
+
+    void sparseGrid::BuildDimensionAdaptive ( std::vector < std::vector < double > >  &samples, const double &tolerance, const unsigned &maxNumberOfWs )
+    {
+
+        //Gerstner-Griebel: the W with the largest indicator in the active set is moved to the old set,
+        //and its forward neighbors are added if all their backward neighbors are in the old set
+
+        _indexSetW.clear();
+        _dofIdentifier.clear();
+        _nodalValuesPDF.clear();
+        _hierarchicalDofsCoordinates.clear();
+        _numberOfWs = 0;
+
+        std::map < std::vector < unsigned >, unsigned > position; // position of each W in _indexSetW
+        std::vector < bool > isOld;
+        std::vector < double > indicator;
+
+        AddW ( std::vector < unsigned > ( _N, 0 ) );
+        EvaluateNodalValuesPDF ( 0, samples );
+        position[_indexSetW[0]] = 0;
+        isOld.push_back ( false );
+        indicator.push_back ( ComputeSurplusIndicator ( 0 ) );
+
+        while ( _numberOfWs < maxNumberOfWs ) {
+
+            double activeIndicator = 0.;
+            int wMax = -1;
+
+            for ( unsigned w = 0; w < _numberOfWs; w++ ) {
+                if ( !isOld[w] ) {
+                    activeIndicator += indicator[w];
+
+                    if ( wMax < 0 || indicator[w] > indicator[wMax] ) wMax = w;
+                }
+            }
 
-                        }
+            if ( _output ) std::cout << "number of W sets = " << _numberOfWs << " active indicator = " << activeIndicator << std::endl;
 
+            if ( wMax < 0 || activeIndicator < tolerance ) break;
+
+            isOld[wMax] = true;
+
+            for ( unsigned n = 0; n < _N && _numberOfWs < maxNumberOfWs; n++ ) {
+
+                std::vector < unsigned > forward = _indexSetW[wMax];
+                forward[n]++;
+
+                if ( forward[n] >= _L || position.find ( forward ) != position.end() ) continue;
+
+                bool admissible = true;
+
+                for ( unsigned m = 0; m < _N && admissible; m++ ) {
+                    if ( forward[m] > 0 ) {
+                        std::vector < unsigned > backward = forward;
+                        backward[m]--;
+                        std::map < std::vector < unsigned >, unsigned >::iterator it = position.find ( backward );
+                        admissible = ( it != position.end() && isOld[it->second] );
                     }
                 }
 
+                if ( admissible ) {
+                    unsigned w = _numberOfWs;
+                    AddW ( forward );
+                    EvaluateNodalValuesPDF ( w, samples );
+                    position[forward] = w;
+                    isOld.push_back ( false );
+                    indicator.push_back ( ComputeSurplusIndicator ( w ) );
+                }
+            }
+        }
+
+        if ( _output ) {
+            for ( unsigned w = 0; w < _numberOfWs; w++ ) {
+                for ( unsigned n = 0; n < _N; n++ ) {
+                    std::cout << "_indexSetW[" << w << "][" << n << "]= " << _indexSetW[w][n] << " ";
+                }
+
+                std::cout << " indicator = " << indicator[w] << std::endl;
             }
         }
 
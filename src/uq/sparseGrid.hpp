@@ -28,6 +28,24 @@ namespace femus
         void PiecewiseConstPhi( double &phi, const std::vector <double> &x, std::vector < std::vector < unsigned > > identifier );
 
         void EvaluateNodalValuesPDF ( std::vector < std::vector < double > >  &samples );
+
+        void EvaluateNodalValuesPDF ( const unsigned &w, std::vector < std::vector < double > >  &samples );
+
+        /** Replace the isotropic index set with a dimension-adaptive one (Gerstner-Griebel) and compute its nodal values:
+         * the W sets are added until the sum of the surplus indicators of the active sets is below tolerance or maxNumberOfWs is reached */
+        void BuildDimensionAdaptive ( std::vector < std::vector < double > >  &samples, const double &tolerance, const unsigned &maxNumberOfWs );
+
+        double ComputeSurplusIndicator ( const unsigned &w );
+
+        unsigned GetNumberOfWs() const {
+            return _numberOfWs;
+        }
+
+        unsigned GetNumberOfDofs() const {
+            unsigned dofs = 0;
+            for ( unsigned w = 0; w < _numberOfWs; w++ ) dofs += _nodalValuesPDF[w].size();
+            return dofs;
+        }
         
         void EvaluatePDF (double &pdfValue, std::vector < double >  &x, const bool &print);
         
@@ -44,6 +62,9 @@ namespace femus
         void CartesianProduct ( std::vector<std::vector<int> >& inputCartesian, std::vector<std::vector<unsigned> >& dofsWi );
 
     private:
+
+        /** Append the W subspace indexW with its dof identifiers and coordinates */
+        void AddW ( const std::vector < unsigned > &indexW );
         //defining parameters
         unsigned _N; //number of dimensions of the parameter space
         unsigned _M; //number of samples for each dimension, has to be expressed as M=pow(10,alpha), with unsigned alpha
@@ -112,6 +112,7 @@ int main(int argc,char **args) {
 //  input_files.push_back("dome_quad.med");
 //   input_files.push_back("square_quad.neu");
   input_files.push_back("parametric_square_4x5.med");
+  input_files.push_back("hex27_boundary_groups.msh"); // Gmsh MSH4.1: 2 Hex27, boundary groups inflow (2), outflow (3), walls (4)
 //   input_files.push_back("./geom_elem_many_Quad9_Four_boundaries_groups.med");
 //   input_files.push_back("./geom_elem_many_Quad9_Nine_without_groups.med"); //Some boundary face was not set in the mesh MED file
 //   input_files.push_back("./geom_elem_many_Tri6_Two_boundaries.med"); //error
@@ -156,6 +157,44 @@ int main(int argc,char **args) {
 //   ml_mesh.EraseCoarseLevels(erased_levels);
   
   ml_mesh.PrintInfo();
+
+  // ======= Boundary groups of the Gmsh fixture: count the boundary faces of each group on the coarse level ========================
+  if(input_files[m] == "hex27_boundary_groups.msh") {
+    Mesh* msh = ml_mesh.GetLevel(0);
+    unsigned iproc = msh->processor_id();
+
+    const unsigned numberOfGroups = 5;
+    const unsigned expectedFaces[numberOfGroups] = {0, 0, 1, 1, 8}; // indexed by the physical tag
+    unsigned localFaces[numberOfGroups] = {0, 0, 0, 0, 0};
+    unsigned localHex = 0;
+
+    for(int iel = msh->_elementOffset[iproc]; iel < msh->_elementOffset[iproc + 1]; iel++) {
+      if(msh->GetElementType(iel) == HEX) localHex++;
+      for(unsigned jface = 0; jface < msh->GetElementFaceNumber(iel); jface++) {
+        if(msh->el->GetFaceElementIndex(iel, jface) < 0) {
+          int group = msh->el->GetBoundaryIndex(iel, jface);
+          if(group >= 0 && group < static_cast < int >(numberOfGroups)) localFaces[group]++;
+        }
+      }
+    }
+
+    unsigned faces[numberOfGroups];
+    unsigned numberOfHex;
+    MPI_Allreduce(localFaces, faces, numberOfGroups, MPI_UNSIGNED, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(&localHex, &numberOfHex, 1, MPI_UNSIGNED, MPI_SUM, MPI_COMM_WORLD);
+
+    if(numberOfHex != 2) {
+      std::cout << "Error in reading " << input_files[m] << ": " << numberOfHex << " hexahedra instead of 2" << std::endl;
+      return 1;
+    }
+    for(unsigned group = 0; group < numberOfGroups; group++) {
+      if(faces[group] != expectedFaces[group]) {
+        std::cout << "Error in reading " << input_files[m] << ": " << faces[group] << " boundary faces in the group " << group
+                  << " instead of " << expectedFaces[group] << std::endl;
+        return 1;
+      }
+    }
+  }
   
 #if FEMUS_TEST_SOLUTION != 0
   
@@ -0,0 +1,129 @@
+#include "FemusInit.hpp"
+#include "GaussPoints.hpp"
+
+#include <cmath>
+#include <iostream>
+
+using namespace femus;
+
+
+// The symmetric rules ("_symmetric" suffix) of hex, quad, wedge and tet have to integrate exactly
+// every monomial up to the degree of the order string, on the reference element of each geometry, with all the points
+// strictly inside the element (points on the faces are shared by the neighbors and fall on the discontinuities of the fields).
+// Where there is no symmetric rule the standard table is used: some of them are printed with fewer digits and
+// have points on the edges, e.g. the 31 point tet rule, so they are checked only for exactness with a looser tolerance
+
+
+double Factorial(const unsigned &n) {
+  double value = 1.;
+  for(unsigned i = 2; i <= n; i++) value *= i;
+  return value;
+}
+
+/** Integral of x^a over [-1,1] */
+double IntervalMoment(const unsigned &a) {
+  return (a % 2 == 0) ? 2. / (a + 1) : 0.;
+}
+
+/** Integral of x^a y^b z^c over the reference element */
+double ExactMoment(const std::string &geom, const unsigned &a, const unsigned &b, const unsigned &c) {
+  if(geom == "hex") {
+    return IntervalMoment(a) * IntervalMoment(b) * IntervalMoment(c);
+  }
+  else if(geom == "quad") {
+    return IntervalMoment(a) * IntervalMoment(b);
+  }
+  else if(geom == "wedge") {  // unit triangle times [-1,1]
+    return Factorial(a) * Factorial(b) / Factorial(a + b + 2) * IntervalMoment(c);
+  }
+  else {  // unit tetrahedron
+    return Factorial(a) * Factorial(b) * Factorial(c) / Factorial(a + b + c + 3);
+  }
+}
+
+/** True if the point x is strictly inside the reference element */
+bool IsInside(const std::string &geom, const double x[3]) {
+  if(geom == "hex") {
+    return fabs(x[0]) < 1. && fabs(x[1]) < 1. && fabs(x[2]) < 1.;
+  }
+  else if(geom == "quad") {
+    return fabs(x[0]) < 1. && fabs(x[1]) < 1.;
+  }
+  else if(geom == "wedge") {
+    return x[0] > 0. && x[1] > 0. && x[0] + x[1] < 1. && fabs(x[2]) < 1.;
+  }
+  else {
+    return x[0] > 0. && x[1] > 0. && x[2] > 0. && x[0] + x[1] + x[2] < 1.;
+  }
+}
+
+
+int main(int argc, char** args) {
+
+  FemusInit mpinit(argc, args, MPI_COMM_WORLD);
+
+  const unsigned numberOfGeoms = 4;
+  const std::string geom[numberOfGeoms] = {"hex", "quad", "wedge", "tet"};
+  const unsigned dim[numberOfGeoms] = {3, 2, 3, 3};
+
+  const unsigned numberOfOrders = 4;
+  const std::string order[numberOfOrders] = {"first_symmetric", "third_symmetric", "fifth_symmetric", "seventh_symmetric"};
+  const unsigned degree[numberOfOrders] = {1, 3, 5, 7};
+
+  const double tolerance = 1.e-12;
+  const double standardTableTolerance = 1.e-8;
+
+  bool passed = true;
+
+  for(unsigned g = 0; g < numberOfGeoms; g++) {
+    for(unsigned o = 0; o < numberOfOrders; o++) {
+
+      Gauss gauss(geom[g].c_str(), order[o].c_str());
+      const unsigned n = gauss.GetGaussPointsNumber();
+
+      std::string standardOrder = order[o].substr(0, order[o].find("_symmetric"));
+      Gauss standardGauss(geom[g].c_str(), standardOrder.c_str());
+      bool isStandardTable = (gauss.GetGaussWeightsPointer() == standardGauss.GetGaussWeightsPointer());
+
+      const double* x[3] = {gauss.GetGaussCoordinatePointer(0), gauss.GetGaussCoordinatePointer(1), NULL};
+      if(dim[g] == 3) x[2] = gauss.GetGaussCoordinatePointer(2);
+
+      bool inside = true;
+      for(unsigned ig = 0; ig < n; ig++) {
+        double xg[3] = {x[0][ig], x[1][ig], (dim[g] == 3) ? x[2][ig] : 0.};
+        inside = inside && IsInside(geom[g], xg);
+      }
+
+      double maxError = 0.;
+      for(unsigned a = 0; a <= degree[o]; a++) {
+        for(unsigned b = 0; a + b <= degree[o]; b++) {
+          for(unsigned c = 0; a + b + c <= degree[o]; c++) {
+            if(dim[g] == 2 && c > 0) break;
+
+            double moment = 0.;
+            for(unsigned ig = 0; ig < n; ig++) {
+              double monomial = pow(x[0][ig], a) * pow(x[1][ig], b);
+              if(dim[g] == 3) monomial *= pow(x[2][ig], c);
+              moment += gauss.GetGaussWeight(ig) * monomial;
+            }
+            maxError = std::max(maxError, fabs(moment - ExactMoment(geom[g], a, b, c)));
+          }
+        }
+      }
+
+      std::cout << geom[g] << " " << order[o] << ": " << n << " points" << ((isStandardTable) ? " (standard table)" : "")
+                << ", max monomial error up to degree " << degree[o] << " = " << maxError << std::endl;
+
+      if(maxError > ((isStandardTable) ? standardTableTolerance : tolerance)) {
+        std::cout << "Error: the rule " << order[o] << " of " << geom[g] << " is not exact up to degree " << degree[o] << std::endl;
+        passed = false;
+      }
+      if(!isStandardTable && !inside) {
+        std::cout << "Error: the rule " << order[o] << " of " << geom[g] << " has points on the boundary of the element" << std::endl;
+        passed = false;
+      }
+    }
+  }
+
+  return (passed) ? 0 : 1;
+}